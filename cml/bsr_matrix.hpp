@@ -0,0 +1,361 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "config.hpp"
+#include "definitions.hpp"
+#include "dynamic_matrix.hpp"
+#include "matrix.hpp"
+#include "parallel.hpp"
+#include "span.hpp"
+#include "simd/bsr.hpp"
+
+// Block sparse row matrices: the non zero BlockSize x BlockSize blocks of each block row, sorted by column, in one
+// contiguous array, with the usual compressed row index (CSR with blocks). Built from (row, column, block) triplets, as
+// a finite element or cloth assembly produces them, duplicates being summed.
+// The products are split by block rows between the threads of a parallel::thread_pool: each thread writes its own rows
+// of y, so no locks and the same results on any number of threads. The transposed product gathers through a column
+// index built with the matrix instead of scattering into y. 3 x 3 float blocks use SSE kernels.
+
+namespace cml
+{
+    /// @brief Block (row, column) of a bsr_matrix, in block coordinates
+    template<typename ValueType, size_t BlockSize = 3>
+    struct bsr_triplet
+    {
+        size_t row = 0;
+        size_t column = 0;
+        implementation::matrix<BlockSize, BlockSize, ValueType, implementation::matrix_kind::normal> block;
+    };
+
+    /// @brief Sparse matrix of block_rows() x block_columns() blocks of BlockSize x BlockSize components, of which only
+    /// the non zero ones (block_count()) are stored. The product with a vector applies each block to the block of the
+    /// vector it faces as column vector maths do: y_i = sum over j of A_ij x_j, the rows of A_ij dotted with x_j (which
+    /// is x_j * transpose(A_ij) with the row vectors of cml). The vectors are arrays of vector<BlockSize, ValueType>.
+    template<typename ValueType, size_t BlockSize = 3>
+    class bsr_matrix
+    {
+    public:
+        using value_type = ValueType;
+        using index_type = std::uint32_t;
+        using block_type = implementation::matrix<BlockSize, BlockSize, ValueType, implementation::matrix_kind::normal>;
+        using vector_type = vector<BlockSize, ValueType>;
+        using triplet_type = bsr_triplet<ValueType, BlockSize>;
+        static constexpr size_t block_size = BlockSize;
+
+        bsr_matrix() = default;
+
+        /// @brief block_rows x block_columns blocks, the given ones (duplicates summed in their order in triplets) and
+        /// zeros elsewhere. Triplets out of the matrix throw a std::runtime_error.
+        bsr_matrix(size_t block_rows, size_t block_columns, span<const triplet_type> triplets)
+        : m_block_rows(block_rows), m_block_columns(block_columns)
+        {
+            constexpr size_t max_index = std::numeric_limits<index_type>::max();
+            if (block_rows > max_index || block_columns > max_index || triplets.size() > max_index)
+                throw std::runtime_error("bsr_matrix is too big for its 32 bit indexes");
+            for (const triplet_type& t : triplets)
+                if (t.row >= block_rows || t.column >= block_columns)
+                    throw std::runtime_error("bsr_matrix triplet out of the matrix");
+
+            // counting sort of the triplets by row, then by column within the rows (stable, for the duplicates)
+            std::vector<index_type> order(triplets.size());
+            std::vector<size_t> offsets(block_rows + 1, 0);
+            for (const triplet_type& t : triplets)
+                ++offsets[t.row + 1];
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+            {
+                std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+                for (size_t i = 0; i < triplets.size(); ++i)
+                    order[next[triplets[i].row]++] = index_type(i);
+            }
+
+            m_row_offsets.assign(block_rows + 1, 0);
+            m_columns.reserve(triplets.size());
+            m_blocks.reserve(triplets.size());
+            for (size_t row = 0; row < block_rows; ++row)
+            {
+                const auto first = order.begin() + offsets[row], last = order.begin() + offsets[row + 1];
+                std::stable_sort(first, last, [&triplets](index_type a, index_type b) { return triplets[a].column < triplets[b].column; });
+                for (auto it = first; it != last; ++it)
+                {
+                    const triplet_type& t = triplets[*it];
+                    if (m_columns.size() > m_row_offsets[row] && m_columns.back() == t.column)
+                    {
+                        m_blocks.back() += t.block;
+                    }
+                    else
+                    {
+                        m_columns.push_back(index_type(t.column));
+                        m_blocks.push_back(t.block);
+                    }
+                }
+                m_row_offsets[row + 1] = index_type(m_columns.size());
+            }
+            build_column_index();
+        }
+
+        /// @brief Number of rows and columns of blocks
+        size_t block_rows() const noexcept { return m_block_rows; }
+        size_t block_columns() const noexcept { return m_block_columns; }
+
+        /// @brief Number of rows and columns of components
+        size_t rows() const noexcept { return m_block_rows * BlockSize; }
+        size_t columns() const noexcept { return m_block_columns * BlockSize; }
+
+        /// @brief Number of stored blocks
+        size_t block_count() const noexcept { return m_blocks.size(); }
+
+        /// @brief Stored blocks of row i: [row_offsets()[i], row_offsets()[i + 1]) in column_indices() and blocks()
+        span<const index_type> row_offsets() const noexcept { return span<const index_type>(m_row_offsets.data(), m_row_offsets.size()); }
+        span<const index_type> column_indices() const noexcept { return span<const index_type>(m_columns.data(), m_columns.size()); }
+
+        /// @brief The stored blocks, row after row. Their values can be changed in place (a new frame of a simulation
+        /// with the same structure), not the structure.
+        span<const block_type> blocks() const noexcept { return span<const block_type>(m_blocks.data(), m_blocks.size()); }
+        span<block_type> blocks() noexcept { return span<block_type>(m_blocks.data(), m_blocks.size()); }
+
+        /// @brief Stored block (row, column), nullptr if it isn't stored (a zero block)
+        const block_type* find(size_t row, size_t column) const noexcept
+        {
+            if (row >= m_block_rows)
+                return nullptr;
+            const index_type* first = m_columns.data() + m_row_offsets[row];
+            const index_type* last = m_columns.data() + m_row_offsets[row + 1];
+            const index_type* it = std::lower_bound(first, last, column);
+            return it != last && *it == column ? &m_blocks[size_t(it - m_columns.data())] : nullptr;
+        }
+
+        block_type* find(size_t row, size_t column) noexcept
+        {
+            return const_cast<block_type*>(static_cast<const bsr_matrix&>(*this).find(row, column));
+        }
+
+        /// @brief y = A x. x has block_columns() vectors, y block_rows(), and they must not overlap.
+        void multiply(parallel::thread_pool& pool, span<const vector_type> x, span<vector_type> y) const
+        {
+            if (x.size() != m_block_columns || y.size() != m_block_rows)
+                throw std::runtime_error("bsr_matrix::multiply vector sizes don't match the matrix");
+            pool.run(m_block_rows, row_chunk(m_block_rows), [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const size_t first = m_row_offsets[i];
+                    row_product(m_blocks.data() + first, m_columns.data() + first, m_row_offsets[i + 1] - first, x.data(), y[i]);
+                }
+            });
+        }
+
+        void multiply(span<const vector_type> x, span<vector_type> y) const
+        {
+            multiply(parallel::thread_pool::global(), x, y);
+        }
+
+        /// @brief y = transpose(A) x: y_j = sum over i of x_i * A_ij. x has block_rows() vectors, y block_columns(),
+        /// and they must not overlap.
+        void multiply_transposed(parallel::thread_pool& pool, span<const vector_type> x, span<vector_type> y) const
+        {
+            if (x.size() != m_block_rows || y.size() != m_block_columns)
+                throw std::runtime_error("bsr_matrix::multiply_transposed vector sizes don't match the matrix");
+            pool.run(m_block_columns, row_chunk(m_block_columns), [&](size_t begin, size_t end)
+            {
+                for (size_t j = begin; j < end; ++j)
+                {
+                    const size_t first = m_column_offsets[j];
+                    column_product(m_blocks.data(), m_column_blocks.data() + first, m_column_rows.data() + first, m_column_offsets[j + 1] - first, x.data(), y[j]);
+                }
+            });
+        }
+
+        void multiply_transposed(span<const vector_type> x, span<vector_type> y) const
+        {
+            multiply_transposed(parallel::thread_pool::global(), x, y);
+        }
+
+    private:
+        static constexpr bool has_simd_kernels()
+        {
+#ifdef CML_SIMD_SSE2
+            return std::is_same<ValueType, float>::value && BlockSize == 3;
+#else
+            return false;
+#endif
+        }
+
+        /// @brief Rows (or columns) per chunk of the thread pool: about parallel::chunk_bytes of blocks each
+        size_t row_chunk(size_t count) const noexcept
+        {
+            const size_t bytes = m_blocks.size() * (sizeof(block_type) + sizeof(index_type));
+            const size_t chunks = std::max<size_t>(1, bytes / parallel::chunk_bytes);
+            return std::max<size_t>(1, count / chunks);
+        }
+
+        /// @brief The column index: the blocks of each column with their rows, in row order
+        void build_column_index()
+        {
+            m_column_offsets.assign(m_block_columns + 1, 0);
+            for (index_type column : m_columns)
+                ++m_column_offsets[column + 1];
+            std::partial_sum(m_column_offsets.begin(), m_column_offsets.end(), m_column_offsets.begin());
+            m_column_blocks.resize(m_blocks.size());
+            m_column_rows.resize(m_blocks.size());
+            std::vector<index_type> next(m_column_offsets.begin(), m_column_offsets.end() - 1);
+            for (size_t row = 0; row < m_block_rows; ++row)
+            {
+                for (size_t k = m_row_offsets[row]; k < m_row_offsets[row + 1]; ++k)
+                {
+                    const index_type at = next[m_columns[k]]++;
+                    m_column_blocks[at] = index_type(k);
+                    m_column_rows[at] = index_type(row);
+                }
+            }
+        }
+
+        static void row_product(const block_type* blocks, const index_type* columns, size_t count, const vector_type* x, vector_type& y) noexcept
+        {
+            // empty rows: no block nor vector to take the components of
+            if (count == 0)
+            {
+                y = vector_type(ValueType(0));
+                return;
+            }
+#ifdef CML_SIMD_SSE2
+            if constexpr(has_simd_kernels())
+            {
+                implementation::simd::bsr3_row(blocks->components.data(), columns, count, x->components.data(), y.components.data());
+                return;
+            }
+#endif
+            vector_type r(ValueType(0));
+            for (size_t k = 0; k < count; ++k)
+            {
+                const auto& b = blocks[k].components;
+                const auto& v = x[columns[k]].components;
+                for (size_t row = 0; row < BlockSize; ++row)
+                    for (size_t column = 0; column < BlockSize; ++column)
+                        r.components[row] += b[row * BlockSize + column] * v[column];
+            }
+            y = r;
+        }
+
+        static void column_product(const block_type* blocks, const index_type* indices, const index_type* rows, size_t count, const vector_type* x, vector_type& y) noexcept
+        {
+            if (count == 0)
+            {
+                y = vector_type(ValueType(0));
+                return;
+            }
+#ifdef CML_SIMD_SSE2
+            if constexpr(has_simd_kernels())
+            {
+                implementation::simd::bsr3_column(blocks->components.data(), indices, rows, count, x->components.data(), y.components.data());
+                return;
+            }
+#endif
+            vector_type r(ValueType(0));
+            for (size_t k = 0; k < count; ++k)
+            {
+                const auto& b = blocks[indices[k]].components;
+                const auto& v = x[rows[k]].components;
+                for (size_t row = 0; row < BlockSize; ++row)
+                    for (size_t column = 0; column < BlockSize; ++column)
+                        r.components[column] += v[row] * b[row * BlockSize + column];
+            }
+            y = r;
+        }
+
+        size_t m_block_rows = 0;
+        size_t m_block_columns = 0;
+        std::vector<index_type> m_row_offsets = std::vector<index_type>(1, 0);
+        std::vector<index_type> m_columns;
+        std::vector<block_type, aligned_allocator<block_type>> m_blocks;
+        std::vector<index_type> m_column_offsets = std::vector<index_type>(1, 0);
+        std::vector<index_type> m_column_blocks;
+        std::vector<index_type> m_column_rows;
+    };
+
+    /// @brief Collects the triplets of a bsr_matrix as an assembly loop produces them, in any order and with
+    /// duplicates, then builds the matrix
+    template<typename ValueType, size_t BlockSize = 3>
+    class bsr_builder
+    {
+    public:
+        using matrix_type = bsr_matrix<ValueType, BlockSize>;
+        using block_type = typename matrix_type::block_type;
+        using triplet_type = bsr_triplet<ValueType, BlockSize>;
+
+        bsr_builder(size_t block_rows, size_t block_columns)
+        : m_block_rows(block_rows), m_block_columns(block_columns)
+        {
+        }
+
+        void reserve(size_t blocks) { m_triplets.reserve(blocks); }
+
+        /// @brief Adds block to the block (row, column), in block coordinates
+        void add(size_t row, size_t column, const block_type& block)
+        {
+            if (row >= m_block_rows || column >= m_block_columns)
+                throw std::runtime_error("bsr_builder::add block out of the matrix");
+            m_triplets.push_back(triplet_type{row, column, block});
+        }
+
+        void add(span<const triplet_type> triplets)
+        {
+            for (const triplet_type& t : triplets)
+                add(t.row, t.column, t.block);
+        }
+
+        /// @brief Adds value to the component (row, column), in component coordinates
+        void add_value(size_t row, size_t column, ValueType value)
+        {
+            block_type block(ValueType(0));
+            block.components[(row % BlockSize) * BlockSize + column % BlockSize] = value;
+            add(row / BlockSize, column / BlockSize, block);
+        }
+
+        /// @brief Number of triplets added so far
+        size_t size() const noexcept { return m_triplets.size(); }
+
+        void clear() noexcept { m_triplets.clear(); }
+
+        matrix_type build() const
+        {
+            return matrix_type(m_block_rows, m_block_columns, span<const triplet_type>(m_triplets.data(), m_triplets.size()));
+        }
+
+    private:
+        size_t m_block_rows;
+        size_t m_block_columns;
+        std::vector<triplet_type> m_triplets;
+    };
+
+    using bsr_mat3 = bsr_matrix<float, 3>;
+    using dbsr_mat3 = bsr_matrix<double, 3>;
+} // namespace cml
@@ -28,8 +28,15 @@
 #include "operators.hpp"
 
 #include "angle.hpp"
+#include "bsr_matrix.hpp"
 #include "definitions.hpp"
+#include "dynamic_matrix.hpp"
 #include "equality.hpp"
+#include "frame_arena.hpp"
+#include "lazy.hpp"
+#include "parallel.hpp"
+#include "soa_array.hpp"
+#include "span.hpp"
 #include "tau.hpp"
 #include "traits.hpp"
 
@@ -38,20 +45,27 @@
 #include "functions/clamp.hpp"
 #include "functions/cos.hpp"
 #include "functions/cross.hpp"
+#include "functions/determinant.hpp"
 #include "functions/distance.hpp"
 #include "functions/dot.hpp"
 #include "functions/exp.hpp"
 #include "functions/factorial.hpp"
+#include "functions/inverse.hpp"
 #include "functions/length.hpp"
 #include "functions/lerp.hpp"
+#include "functions/lut.hpp"
 #include "functions/max.hpp"
 #include "functions/min.hpp"
 #include "functions/normalize.hpp"
 #include "functions/pow.hpp"
+#include "functions/quaternion.hpp"
 #include "functions/reflect.hpp"
+#include "functions/rsqrt.hpp"
 #include "functions/sin.hpp"
+#include "functions/sincos.hpp"
 #include "functions/sqrt.hpp"
 #include "functions/tan.hpp"
+#include "functions/transform.hpp"
 #include "functions/transpose.hpp"
 
 /// @brief Main cml namespace
@@ -0,0 +1,64 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+// Instruction sets the runtime kernels are allowed to use. They follow the flags the translation unit is compiled with
+// (-msse4.1, -mavx, /arch:AVX, ...). Define CML_NO_SIMD to always use the constexpr implementations.
+#ifndef CML_NO_SIMD
+#   if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#       define CML_SIMD_SSE2 1
+#   endif
+#   if defined(__SSE4_1__) || (defined(_MSC_VER) && defined(__AVX__))
+#       define CML_SIMD_SSE4_1 1
+#   endif
+#   if defined(__AVX__)
+#       define CML_SIMD_AVX 1
+#   endif
+#   if defined(__AVX2__)
+#       define CML_SIMD_AVX2 1
+#   endif
+#endif
+
+#if defined(__has_builtin)
+#   if __has_builtin(__builtin_is_constant_evaluated)
+#       define CML_HAS_IS_CONSTANT_EVALUATED 1
+#   endif
+#endif
+#if !defined(CML_HAS_IS_CONSTANT_EVALUATED) && ((defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925))
+#   define CML_HAS_IS_CONSTANT_EVALUATED 1
+#endif
+
+namespace cml::implementation
+{
+    /// @brief Tell if the current call is evaluated at compile time (std::is_constant_evaluated is c++20).
+    /// Without compiler support every call is considered constant evaluated so the constexpr paths are always used.
+    constexpr bool is_constant_evaluated() noexcept
+    {
+#ifdef CML_HAS_IS_CONSTANT_EVALUATED
+        return __builtin_is_constant_evaluated();
+#else
+        return true;
+#endif
+    }
+} // namespace cml::implementation
@@ -165,6 +165,27 @@ namespace cml
     using f0131mat3 = f0131mat<3, 3>;
     using f0131mat4 = f0131mat<4, 4>;
 
+    // Aligned vectors and matrices (see matrix_kind::aligned)
+    template<size_t Dim, typename ValueType>
+    using aligned_vector = implementation::matrix<Dim, 1, ValueType, implementation::matrix_kind::aligned>;
+    template<size_t DimX, size_t DimY, typename ValueType>
+    using aligned_matrix = implementation::matrix<DimX, DimY, ValueType, implementation::matrix_kind::aligned>;
+
+    /// @brief vec3 padded to 16 bytes
+    using avec3 = aligned_vector<3, float>;
+    using avec4 = aligned_vector<4, float>;
+    using advec4 = aligned_vector<4, double>;
+    using amat4 = aligned_matrix<4, 4, float>;
+    using admat4 = aligned_matrix<4, 4, double>;
+
+    // Quaternions, stored (x, y, z, w): the vector part then the scalar part. * is the Hamilton product between
+    // quaternions (and stays component wise with scalars), see functions/quaternion.hpp for the rest.
+    template<typename ValueType>
+    using quaternion = implementation::matrix<4, 1, ValueType, implementation::matrix_kind::quaternion>;
+
+    using quat = quaternion<float>;
+    using dquat = quaternion<double>;
+
     // Scalar
     template<typename ValueType>
     using scalar = implementation::matrix<1, 1, ValueType, implementation::matrix_kind::normal>;
@@ -0,0 +1,639 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "matrix.hpp"
+#include "parallel.hpp"
+#include "soa_array.hpp"
+#include "span.hpp"
+#include "traits.hpp"
+#include "functions/sqrt.hpp"
+#include "operator/multiply_impl.hpp"
+
+namespace cml
+{
+    /// @brief Allocator of Alignment bytes aligned blocks (a cache line by default), the default allocator of
+    /// dynamic_matrix
+    template<typename ValueType, size_t Alignment = parallel::cache_line_size>
+    class aligned_allocator
+    {
+    public:
+        using value_type = ValueType;
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+        static constexpr size_t alignment = Alignment > alignof(ValueType) ? Alignment : alignof(ValueType);
+
+        template<typename Other>
+        struct rebind
+        {
+            using other = aligned_allocator<Other, Alignment>;
+        };
+
+        aligned_allocator() noexcept = default;
+
+        template<typename Other>
+        aligned_allocator(const aligned_allocator<Other, Alignment>&) noexcept {}
+
+        ValueType* allocate(size_t count)
+        {
+            return static_cast<ValueType*>(::operator new(count * sizeof(ValueType), std::align_val_t(alignment)));
+        }
+
+        void deallocate(ValueType* p, size_t) noexcept
+        {
+            ::operator delete(p, std::align_val_t(alignment));
+        }
+
+        template<typename Other>
+        bool operator == (const aligned_allocator<Other, Alignment>&) const noexcept { return true; }
+        template<typename Other>
+        bool operator != (const aligned_allocator<Other, Alignment>&) const noexcept { return false; }
+    };
+
+    namespace implementation
+    {
+        /// @brief Call body(soa_lane<L>, i) for every index of [0, count) (see soa_loop), the chunks of
+        /// parallel::chunk_size<ValueType>() elements being shared between the threads of the global pool. A single
+        /// chunk runs on the calling thread, without starting the pool.
+        template<typename ValueType, typename Body>
+        inline void dynamic_loop(size_t count, Body&& body)
+        {
+            constexpr size_t chunk = parallel::chunk_size<ValueType>();
+            auto run = [&body](size_t begin, size_t end)
+            {
+                soa_loop<ValueType>(end - begin, [&body, begin](auto lane, size_t i) { body(lane, begin + i); });
+            };
+            if (count <= chunk)
+                run(0, count);
+            else
+                parallel::thread_pool::global().run(count, chunk, run);
+        }
+
+        template<typename ValueType, size_t DimX, size_t DimY> class dynamic_block;
+
+        template<typename T> struct is_dynamic_block : public std::false_type {};
+        template<typename ValueType, size_t DimX, size_t DimY> struct is_dynamic_block<dynamic_block<ValueType, DimX, DimY>> : public std::true_type {};
+
+        /// @brief Blocks are evaluated before being used as operands
+        template<typename Type>
+        decltype(auto) dynamic_block_operand(const Type& o)
+        {
+            if constexpr(is_dynamic_block<Type>::value)
+                return o.eval();
+            else
+                return o;
+        }
+
+        /// @brief View on a DimX x DimY block of a dynamic_matrix, returned by dynamic_matrix::block(): a pointer to its
+        /// first component and the row stride of the matrix. It converts to a matrix (the operators and functions of
+        /// matrices do the work: a 4x4 block times a mat4 is a mat4 product), and the assignments and compound
+        /// operators write the rows back to the dynamic_matrix. ValueType is const for the blocks of const matrices.
+        template<typename ValueType, size_t DimX, size_t DimY>
+        class dynamic_block
+        {
+        public:
+            using value_type = std::remove_const_t<ValueType>;
+            using matrix_type = matrix<DimX, DimY, value_type, matrix_kind::normal>;
+
+        public:
+            dynamic_block(ValueType* data, size_t stride) noexcept : m_data(data), m_stride(stride) {}
+            dynamic_block(const dynamic_block&) noexcept = default;
+
+            /// @brief Assign the components (a block is never re-seated)
+            dynamic_block& operator = (const dynamic_block& o) noexcept
+            {
+                return *this = o.eval();
+            }
+
+            template<typename Type, matrix_kind Kind>
+            dynamic_block& operator = (const matrix<DimX, DimY, Type, Kind>& m) noexcept
+            {
+                static_assert(!std::is_const<ValueType>::value, "the blocks of a const dynamic_matrix are read only");
+                for (size_t y = 0; y < DimY; ++y)
+                {
+                    for (size_t x = 0; x < DimX; ++x)
+                        m_data[x + y * m_stride] = value_type(m.components[x + y * DimX]);
+                }
+                return *this;
+            }
+
+            template<typename Type> dynamic_block& operator += (const Type& o) noexcept { return *this = eval() + dynamic_block_operand(o); }
+            template<typename Type> dynamic_block& operator -= (const Type& o) noexcept { return *this = eval() - dynamic_block_operand(o); }
+            template<typename Type> dynamic_block& operator *= (const Type& o) noexcept { return *this = eval() * dynamic_block_operand(o); }
+            template<typename Type> dynamic_block& operator /= (const Type& o) noexcept { return *this = eval() / dynamic_block_operand(o); }
+
+            /// @brief The components, as a matrix
+            matrix_type eval() const noexcept
+            {
+                matrix_type ret;
+                for (size_t y = 0; y < DimY; ++y)
+                    std::copy_n(m_data + y * m_stride, DimX, ret.components.data() + y * DimX);
+                return ret;
+            }
+
+            /// @brief Convert to a matrix (to another value type only if no precision is lost, like matrices)
+            template<typename Type, matrix_kind Kind>
+            operator matrix<DimX, DimY, Type, Kind>() const
+            {
+                return eval();
+            }
+
+            /// @brief Component of the column x of the row y of the block
+            ValueType& at(size_t x, size_t y) const noexcept { return m_data[x + y * m_stride]; }
+
+        public: // operators: the block is evaluated and the matrix operators do the rest
+#define CML_DYNAMIC_BLOCK_OPERATOR(op) \
+            template<typename Type> \
+            friend auto operator op (dynamic_block a, const Type& b) { return a.eval() op dynamic_block_operand(b); } \
+            friend auto operator op (value_type a, dynamic_block b) { return a op b.eval(); } \
+            template<size_t ODimX, size_t ODimY, matrix_kind Kind> \
+            friend auto operator op (const matrix<ODimX, ODimY, value_type, Kind>& a, dynamic_block b) { return a op b.eval(); }
+
+            CML_DYNAMIC_BLOCK_OPERATOR(+)
+            CML_DYNAMIC_BLOCK_OPERATOR(-)
+            CML_DYNAMIC_BLOCK_OPERATOR(*)
+            CML_DYNAMIC_BLOCK_OPERATOR(/)
+#undef CML_DYNAMIC_BLOCK_OPERATOR
+
+            template<typename Type>
+            friend bool operator == (dynamic_block a, const Type& b) { return a.eval() == dynamic_block_operand(b); }
+            friend bool operator == (const matrix_type& a, dynamic_block b) { return a == b.eval(); }
+            template<typename Type>
+            friend bool operator != (dynamic_block a, const Type& b) { return a.eval() != dynamic_block_operand(b); }
+            friend bool operator != (const matrix_type& a, dynamic_block b) { return a != b.eval(); }
+
+            friend matrix_type& operator += (matrix_type& a, dynamic_block b) { return a += b.eval(); }
+            friend matrix_type& operator -= (matrix_type& a, dynamic_block b) { return a -= b.eval(); }
+            friend matrix_type& operator *= (matrix_type& a, dynamic_block b) { return a *= b.eval(); }
+            friend matrix_type& operator /= (matrix_type& a, dynamic_block b) { return a /= b.eval(); }
+
+        private:
+            ValueType* m_data;
+            size_t m_stride;
+        };
+    } // namespace implementation
+
+    /// @brief Matrix whose dimensions are only known at runtime: dimy() rows of dimx() components, contiguous and row
+    /// major like cml::matrix, in an aligned block of the allocator. A vector is a matrix with a single row
+    /// (dynamic_vector). It can only be moved, clone() makes the copies explicit.
+    /// The operators and functions work a register of floats or doubles at a time, and big matrices are split between
+    /// the threads of parallel::thread_pool::global(). Sizes that don't match throw a std::runtime_error.
+    template<typename ValueType, typename Allocator = aligned_allocator<ValueType>>
+    class dynamic_matrix
+    {
+        using allocator_traits = std::allocator_traits<Allocator>;
+
+    public:
+        using value_type = ValueType;
+        using allocator_type = Allocator;
+
+        /// @brief Views returned by block(): a pointer and the row stride (see implementation::dynamic_block)
+        template<size_t DimX, size_t DimY>
+        using block_type = implementation::dynamic_block<ValueType, DimX, DimY>;
+        template<size_t DimX, size_t DimY>
+        using const_block_type = implementation::dynamic_block<const ValueType, DimX, DimY>;
+
+    public:
+        dynamic_matrix() noexcept(noexcept(Allocator())) = default;
+
+        explicit dynamic_matrix(const Allocator& allocator) noexcept
+        : m_allocator(allocator)
+        {
+        }
+
+        /// @brief dimy rows of dimx components (dimy = 1: a vector), all set to value
+        explicit dynamic_matrix(size_t dimx, size_t dimy = 1, const ValueType& value = ValueType(), const Allocator& allocator = Allocator())
+        : m_allocator(allocator)
+        {
+            create(dimx, dimy, [&value](ValueType* p, size_t count) { std::uninitialized_fill_n(p, count, value); });
+        }
+
+        /// @brief Row major components
+        dynamic_matrix(size_t dimx, size_t dimy, std::initializer_list<ValueType> values, const Allocator& allocator = Allocator())
+        : m_allocator(allocator)
+        {
+            if (values.size() != dimx * dimy)
+                throw std::runtime_error("dynamic_matrix sizes differ");
+            create(dimx, dimy, [&values](ValueType* p, size_t) { std::uninitialized_copy(values.begin(), values.end(), p); });
+        }
+
+        template<size_t DimX, size_t DimY, implementation::matrix_kind Kind>
+        explicit dynamic_matrix(const implementation::matrix<DimX, DimY, ValueType, Kind>& m, const Allocator& allocator = Allocator())
+        : m_allocator(allocator)
+        {
+            create(DimX, DimY, [&m](ValueType* p, size_t) { std::uninitialized_copy(m.components.begin(), m.components.end(), p); });
+        }
+
+        dynamic_matrix(const dynamic_matrix&) = delete;
+        dynamic_matrix& operator = (const dynamic_matrix&) = delete;
+
+        dynamic_matrix(dynamic_matrix&& o) noexcept
+        : m_allocator(std::move(o.m_allocator))
+        {
+            steal(o);
+        }
+
+        dynamic_matrix& operator = (dynamic_matrix&& o)
+        {
+            if (this == &o)
+                return *this;
+            if constexpr(allocator_traits::propagate_on_container_move_assignment::value)
+            {
+                release();
+                m_allocator = std::move(o.m_allocator);
+                steal(o);
+            }
+            else
+            {
+                if (m_allocator == o.m_allocator)
+                {
+                    release();
+                    steal(o);
+                }
+                else
+                {
+                    // the memory of o can't be freed by our allocator: move the components instead
+                    dynamic_matrix moved(m_allocator);
+                    moved.create(o.m_dimx, o.m_dimy, [&o](ValueType* p, size_t) { std::uninitialized_copy(std::make_move_iterator(o.begin()), std::make_move_iterator(o.end()), p); });
+                    release();
+                    steal(moved);
+                }
+            }
+            return *this;
+        }
+
+        ~dynamic_matrix() noexcept
+        {
+            release();
+        }
+
+        /// @brief Explicit copy, with the same allocator
+        dynamic_matrix clone() const
+        {
+            dynamic_matrix ret(allocator_traits::select_on_container_copy_construction(m_allocator));
+            ret.create(m_dimx, m_dimy, [this](ValueType* p, size_t) { std::uninitialized_copy(begin(), end(), p); });
+            return ret;
+        }
+
+        allocator_type get_allocator() const noexcept { return m_allocator; }
+
+        /// @brief Number of columns
+        size_t dimx() const noexcept { return m_dimx; }
+        /// @brief Number of rows
+        size_t dimy() const noexcept { return m_dimy; }
+        size_t size() const noexcept { return m_dimx * m_dimy; }
+        bool empty() const noexcept { return size() == 0; }
+        /// @brief A single row or a single column
+        bool is_vector() const noexcept { return m_dimx == 1 || m_dimy == 1; }
+
+        ValueType* data() noexcept { return m_data; }
+        const ValueType* data() const noexcept { return m_data; }
+        ValueType* begin() noexcept { return m_data; }
+        const ValueType* begin() const noexcept { return m_data; }
+        ValueType* end() noexcept { return m_data + size(); }
+        const ValueType* end() const noexcept { return m_data + size(); }
+
+        /// @brief Component x + y * dimx(), as cml::matrix::components
+        ValueType& operator [] (size_t index) noexcept { return m_data[index]; }
+        const ValueType& operator [] (size_t index) const noexcept { return m_data[index]; }
+
+        /// @brief Component of the column x of the row y
+        ValueType& at(size_t x, size_t y) noexcept { return m_data[x + y * m_dimx]; }
+        const ValueType& at(size_t x, size_t y) const noexcept { return m_data[x + y * m_dimx]; }
+
+        span<ValueType> row(size_t y) noexcept { return span<ValueType>(m_data + y * m_dimx, m_dimx); }
+        span<const ValueType> row(size_t y) const noexcept { return span<const ValueType>(m_data + y * m_dimx, m_dimx); }
+
+        /// @brief View of the DimX x DimY block starting at the column x of the row y, without copies: it converts to
+        /// and from the matrices of ValueType and takes part in their operators
+        template<size_t DimX, size_t DimY>
+        block_type<DimX, DimY> block(size_t x, size_t y)
+        {
+            check_block(DimX, DimY, x, y);
+            return block_type<DimX, DimY>(&at(x, y), m_dimx);
+        }
+
+        template<size_t DimX, size_t DimY>
+        const_block_type<DimX, DimY> block(size_t x, size_t y) const
+        {
+            check_block(DimX, DimY, x, y);
+            return const_block_type<DimX, DimY>(&at(x, y), m_dimx);
+        }
+
+        dynamic_matrix& operator += (const dynamic_matrix& o) { return apply(o, [](auto a, auto b) { return a + b; }); }
+        dynamic_matrix& operator -= (const dynamic_matrix& o) { return apply(o, [](auto a, auto b) { return a - b; }); }
+        dynamic_matrix& operator += (ValueType s) { return apply(s, [](auto a, auto b) { return a + b; }); }
+        dynamic_matrix& operator -= (ValueType s) { return apply(s, [](auto a, auto b) { return a - b; }); }
+        dynamic_matrix& operator *= (ValueType s) { return apply(s, [](auto a, auto b) { return a * b; }); }
+        dynamic_matrix& operator /= (ValueType s) { return apply(s, [](auto a, auto b) { return a / b; }); }
+
+        /// @brief this = this * o (matrix product)
+        dynamic_matrix& operator *= (const dynamic_matrix& o)
+        {
+            return *this = *this * o;
+        }
+
+    private:
+        /// @brief Allocate the dimx * dimy components of an empty matrix and construct them with construct(p, count).
+        /// The matrix only takes the memory once they are all constructed: if construct throws, the memory is given
+        /// back and the matrix stays empty.
+        template<typename Construct>
+        void create(size_t dimx, size_t dimy, Construct&& construct)
+        {
+            const size_t count = dimx * dimy;
+            if (count > 0)
+            {
+                ValueType* p = allocator_traits::allocate(m_allocator, count);
+                try
+                {
+                    construct(p, count);
+                }
+                catch (...)
+                {
+                    allocator_traits::deallocate(m_allocator, p, count);
+                    throw;
+                }
+                m_data = p;
+            }
+            m_dimx = dimx;
+            m_dimy = dimy;
+        }
+
+        void release() noexcept
+        {
+            if (m_data != nullptr)
+            {
+                std::destroy_n(m_data, size());
+                allocator_traits::deallocate(m_allocator, m_data, size());
+            }
+            m_data = nullptr;
+            m_dimx = 0;
+            m_dimy = 0;
+        }
+
+        void steal(dynamic_matrix& o) noexcept
+        {
+            m_data = std::exchange(o.m_data, nullptr);
+            m_dimx = std::exchange(o.m_dimx, 0);
+            m_dimy = std::exchange(o.m_dimy, 0);
+        }
+
+        void check_block(size_t dimx, size_t dimy, size_t x, size_t y) const
+        {
+            if (x + dimx > m_dimx || y + dimy > m_dimy)
+                throw std::runtime_error("dynamic_matrix block out of bounds");
+        }
+
+        template<typename Op>
+        dynamic_matrix& apply(const dynamic_matrix& o, Op op)
+        {
+            if (o.m_dimx != m_dimx || o.m_dimy != m_dimy)
+                throw std::runtime_error("dynamic_matrix sizes differ");
+            ValueType* out = m_data;
+            const ValueType* in = o.m_data;
+            implementation::dynamic_loop<ValueType>(size(), [out, in, &op](auto lane, size_t i)
+            {
+                using L = typename decltype(lane)::type;
+                implementation::soa_store(out + i, L(op(implementation::soa_load<L>(out + i), implementation::soa_load<L>(in + i))));
+            });
+            return *this;
+        }
+
+        template<typename Op>
+        dynamic_matrix& apply(ValueType s, Op op)
+        {
+            ValueType* out = m_data;
+            implementation::dynamic_loop<ValueType>(size(), [out, s, &op](auto lane, size_t i)
+            {
+                using L = typename decltype(lane)::type;
+                implementation::soa_store(out + i, L(op(implementation::soa_load<L>(out + i), L(s))));
+            });
+            return *this;
+        }
+
+    private:
+        ValueType* m_data = nullptr;
+        size_t m_dimx = 0;
+        size_t m_dimy = 0;
+        Allocator m_allocator;
+    };
+
+    /// @brief A dynamic_matrix with a single row
+    template<typename ValueType, typename Allocator = aligned_allocator<ValueType>>
+    using dynamic_vector = dynamic_matrix<ValueType, Allocator>;
+
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator + (const dynamic_matrix<ValueType, Allocator>& a, const dynamic_matrix<ValueType, Allocator>& b) { dynamic_matrix<ValueType, Allocator> ret = a.clone(); ret += b; return ret; }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator + (dynamic_matrix<ValueType, Allocator>&& a, const dynamic_matrix<ValueType, Allocator>& b) { a += b; return std::move(a); }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator - (const dynamic_matrix<ValueType, Allocator>& a, const dynamic_matrix<ValueType, Allocator>& b) { dynamic_matrix<ValueType, Allocator> ret = a.clone(); ret -= b; return ret; }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator - (dynamic_matrix<ValueType, Allocator>&& a, const dynamic_matrix<ValueType, Allocator>& b) { a -= b; return std::move(a); }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator + (const dynamic_matrix<ValueType, Allocator>& a, ValueType s) { dynamic_matrix<ValueType, Allocator> ret = a.clone(); ret += s; return ret; }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator + (dynamic_matrix<ValueType, Allocator>&& a, ValueType s) { a += s; return std::move(a); }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator + (ValueType s, const dynamic_matrix<ValueType, Allocator>& a) { return a + s; }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator + (ValueType s, dynamic_matrix<ValueType, Allocator>&& a) { return std::move(a) + s; }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator - (const dynamic_matrix<ValueType, Allocator>& a, ValueType s) { dynamic_matrix<ValueType, Allocator> ret = a.clone(); ret -= s; return ret; }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator - (dynamic_matrix<ValueType, Allocator>&& a, ValueType s) { a -= s; return std::move(a); }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator * (const dynamic_matrix<ValueType, Allocator>& a, ValueType s) { dynamic_matrix<ValueType, Allocator> ret = a.clone(); ret *= s; return ret; }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator * (dynamic_matrix<ValueType, Allocator>&& a, ValueType s) { a *= s; return std::move(a); }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator * (ValueType s, const dynamic_matrix<ValueType, Allocator>& a) { return a * s; }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator * (ValueType s, dynamic_matrix<ValueType, Allocator>&& a) { return std::move(a) * s; }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator / (const dynamic_matrix<ValueType, Allocator>& a, ValueType s) { dynamic_matrix<ValueType, Allocator> ret = a.clone(); ret /= s; return ret; }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator / (dynamic_matrix<ValueType, Allocator>&& a, ValueType s) { a /= s; return std::move(a); }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator - (const dynamic_matrix<ValueType, Allocator>& a) { return a * ValueType(-1); }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator - (dynamic_matrix<ValueType, Allocator>&& a) { return std::move(a) * ValueType(-1); }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator - (ValueType s, const dynamic_matrix<ValueType, Allocator>& a) { return -a + s; }
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator - (ValueType s, dynamic_matrix<ValueType, Allocator>&& a) { return -std::move(a) + s; }
+
+    /// @brief Matrix product (a vector is a single row: v * m), a.dimx() must be b.dimy(). Blocked for the caches and
+    /// tiled for the registers as the products of big cml::matrix (see mm_mul_blocked), the rows of the result are
+    /// shared between the threads.
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> operator * (const dynamic_matrix<ValueType, Allocator>& a, const dynamic_matrix<ValueType, Allocator>& b)
+    {
+        if (a.dimx() != b.dimy())
+            throw std::runtime_error("Cannot multiply matrices when the number of columns of the first matrix is different from the number of rows of the second matrix");
+        dynamic_matrix<ValueType, Allocator> ret(b.dimx(), a.dimy(), ValueType(0), a.get_allocator());
+        const ValueType* pa = a.data();
+        const ValueType* pb = b.data();
+        ValueType* pc = ret.data();
+        const size_t n = b.dimx();
+        const size_t k = a.dimx();
+        auto rows = [pa, pb, pc, n, k](size_t begin, size_t end) { implementation::mm_mul_blocked(pa, pb, pc, n, k, begin, end); };
+        // at least mc rows per task, and enough of them for a chunk of work
+        constexpr size_t mc = implementation::mm_mul_blocking<ValueType>::mc;
+        const size_t row_work = std::max<size_t>(1, n * k);
+        const size_t chunk = std::max(mc, (parallel::chunk_bytes / sizeof(ValueType) + row_work - 1) / row_work);
+        if (a.dimy() <= chunk)
+            rows(0, a.dimy());
+        else
+            parallel::thread_pool::global().run(a.dimy(), chunk, rows);
+        return ret;
+    }
+
+    /// @brief True when the sizes and all the components are equal
+    template<typename ValueType, typename Allocator>
+    bool operator == (const dynamic_matrix<ValueType, Allocator>& a, const dynamic_matrix<ValueType, Allocator>& b)
+    {
+        return a.dimx() == b.dimx() && a.dimy() == b.dimy() && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    /// @brief As for cml::matrix: true when the sizes differ or when all the components differ
+    template<typename ValueType, typename Allocator>
+    bool operator != (const dynamic_matrix<ValueType, Allocator>& a, const dynamic_matrix<ValueType, Allocator>& b)
+    {
+        if (a.dimx() != b.dimx() || a.dimy() != b.dimy())
+            return true;
+        for (size_t i = 0; i < a.size(); ++i)
+            if (a[i] == b[i])
+                return false;
+        return true;
+    }
+
+    /// @brief Sum of the products of the components of two vectors of the same size. Each chunk of
+    /// parallel::chunk_size<ValueType>() components is summed a register at a time, then the chunks in order: the result
+    /// doesn't depend on the thread count.
+    template<typename ValueType, typename Allocator>
+    ValueType dot(const dynamic_matrix<ValueType, Allocator>& a, const dynamic_matrix<ValueType, Allocator>& b)
+    {
+        if (!a.is_vector() || a.dimx() != b.dimx() || a.dimy() != b.dimy())
+            throw std::runtime_error("dot needs two vectors of the same size");
+        constexpr size_t chunk = parallel::chunk_size<ValueType>();
+        const ValueType* pa = a.data();
+        const ValueType* pb = b.data();
+        std::vector<ValueType, Allocator> partials((a.size() + chunk - 1) / chunk, ValueType(0), a.get_allocator());
+        auto sum = [pa, pb, &partials](size_t begin, size_t end)
+        {
+            ValueType partial = ValueType(0);
+            size_t i = begin;
+#ifdef CML_SIMD_SSE2
+            using pack = typename implementation::simd::pack_of<ValueType>::type;
+            if constexpr(!std::is_void<pack>::value)
+            {
+                pack acc(ValueType(0));
+                for (; i + pack::size <= end; i += pack::size)
+                    acc = acc + pack::load(pa + i) * pack::load(pb + i);
+                ValueType lanes[pack::size];
+                acc.store(lanes);
+                for (const ValueType lane : lanes)
+                    partial += lane;
+            }
+#endif
+            for (; i < end; ++i)
+                partial += pa[i] * pb[i];
+            partials[begin / chunk] = partial;
+        };
+        if (a.size() <= chunk)
+            sum(0, a.size());
+        else
+            parallel::thread_pool::global().run(a.size(), chunk, sum);
+        ValueType ret = ValueType(0);
+        for (const ValueType partial : partials)
+            ret += partial;
+        return ret;
+    }
+
+    template<typename ValueType, typename Allocator>
+    ValueType length(const dynamic_matrix<ValueType, Allocator>& v)
+    {
+        return cml::sqrt(dot(v, v));
+    }
+
+    /// @brief Same as normalize: v * (1 / length(v)), in place for a temporary
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> normalize(dynamic_matrix<ValueType, Allocator>&& v)
+    {
+        v *= ValueType(1) / length(v);
+        return std::move(v);
+    }
+
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> normalize(const dynamic_matrix<ValueType, Allocator>& v)
+    {
+        return normalize(v.clone());
+    }
+
+    /// @brief Transposed copy, by tiles of 32x32 components so both matrices are read and written a few cache lines at a
+    /// time, the tiles rows being shared between the threads
+    template<typename ValueType, typename Allocator>
+    dynamic_matrix<ValueType, Allocator> transpose(const dynamic_matrix<ValueType, Allocator>& m)
+    {
+        constexpr size_t tile = 32;
+        dynamic_matrix<ValueType, Allocator> ret(m.dimy(), m.dimx(), ValueType(), m.get_allocator());
+        const ValueType* in = m.data();
+        ValueType* out = ret.data();
+        const size_t dimx = m.dimx();
+        const size_t dimy = m.dimy();
+        auto rows = [in, out, dimx, dimy](size_t begin, size_t end)
+        {
+            for (size_t y0 = begin; y0 < end; y0 += tile)
+            {
+                const size_t y1 = std::min(y0 + tile, end);
+                for (size_t x0 = 0; x0 < dimx; x0 += tile)
+                {
+                    const size_t x1 = std::min(x0 + tile, dimx);
+                    for (size_t y = y0; y < y1; ++y)
+                        for (size_t x = x0; x < x1; ++x)
+                            out[y + x * dimy] = in[x + y * dimx];
+                }
+            }
+        };
+        const size_t chunk = std::max(tile, (parallel::chunk_size<ValueType>() / std::max<size_t>(1, dimx) + tile - 1) / tile * tile);
+        if (dimy <= chunk)
+            rows(0, dimy);
+        else
+            parallel::thread_pool::global().run(dimy, chunk, rows);
+        return ret;
+    }
+} // namespace cml
@@ -75,8 +75,18 @@ namespace cml
         };
     } // namespace implementation
 
-    /// @brief As float is a floating point, fixed is a fixed point
     template<typename Type, size_t FractionnalBits = sizeof(Type) * 8 / 2>
+    struct fixed;
+
+    namespace implementation
+    {
+        /// @brief The types a fixed point can be converted from: arithmetic types and other fixed points
+        template<typename T> struct is_fixed_conversion_source : public std::is_arithmetic<T> {};
+        template<typename T, size_t X> struct is_fixed_conversion_source<fixed<T, X>> : public std::true_type {};
+    } // namespace implementation
+
+    /// @brief As float is a floating point, fixed is a fixed point
+    template<typename Type, size_t FractionnalBits>
     struct fixed
     {
         static_assert(std::is_integral<Type>::value, "fixed point base type needs to be an integral type");
@@ -97,7 +107,7 @@ namespace cml
         constexpr fixed(const fixed&) noexcept = default;
         constexpr fixed& operator = (const fixed&) noexcept = default;
 
-        template<typename ConvType>
+        template<typename ConvType, typename = std::enable_if_t<implementation::is_fixed_conversion_source<ConvType>::value>>
         constexpr fixed(ConvType value) noexcept
         : data(from(value).data)
         {
@@ -167,7 +177,7 @@ namespace cml
         constexpr fixed& operator += (const fixed& o) noexcept { data += o.data; return *this; }
         constexpr fixed& operator -= (const fixed& o) noexcept { data -= o.data; return *this; }
         constexpr fixed& operator *= (const fixed& o) noexcept { data = static_cast<Type>((static_cast<upper_type>(data) * static_cast<upper_type>(o.data)) >> FractionnalBits); return *this; }
-        constexpr fixed& operator /= (const fixed& o) noexcept { data = static_cast<Type>((static_cast<upper_type>(data) << FractionnalBits) / o.data); return *this; }
+        constexpr fixed& operator /= (const fixed& o) noexcept { data = static_cast<Type>((static_cast<upper_type>(data) * (upper_type(1) << FractionnalBits)) / o.data); return *this; }
 
         constexpr fixed& operator <<= (size_t o) noexcept { data <<= o; return *this; }
         constexpr fixed& operator >>= (size_t o) noexcept { data >>= o; }
@@ -189,7 +199,7 @@ namespace cml
         constexpr fixed operator + (const fixed& o) const noexcept { return {from_fixed, static_cast<Type>(data + o.data)}; }
         constexpr fixed operator - (const fixed& o) const noexcept { return {from_fixed, static_cast<Type>(data - o.data)}; }
         constexpr fixed operator * (const fixed& o) const noexcept { return {from_fixed, static_cast<Type>((static_cast<upper_type>(data) * static_cast<upper_type>(o.data)) >> FractionnalBits)}; }
-        constexpr fixed operator / (const fixed& o) const noexcept { return {from_fixed, static_cast<Type>((static_cast<upper_type>(data) << FractionnalBits) / o.data)}; }
+        constexpr fixed operator / (const fixed& o) const noexcept { return {from_fixed, static_cast<Type>((static_cast<upper_type>(data) * (upper_type(1) << FractionnalBits)) / o.data)}; }
 
         constexpr fixed operator << (size_t o) const noexcept { return {from_fixed, data << o}; }
         constexpr fixed operator >> (size_t o) const noexcept { return {from_fixed, data >> o}; }
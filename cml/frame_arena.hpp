@@ -0,0 +1,328 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "parallel.hpp"
+#include "span.hpp"
+
+namespace cml
+{
+    /// @brief Statistics of a frame_arena, in bytes (alignment padding included)
+    struct frame_arena_stats
+    {
+        /// @brief Size of the blocks owned by the arena
+        size_t capacity = 0;
+        /// @brief Currently allocated
+        size_t used = 0;
+        /// @brief Largest value of used since the creation of the arena (or reset_high_water_mark())
+        size_t high_water_mark = 0;
+        /// @brief Number of allocations since the creation of the arena
+        size_t allocations = 0;
+        /// @brief Number of times the current block was full and a new one was chained
+        size_t overflows = 0;
+    };
+
+    /// @brief Bump allocator for the temporary buffers of a frame: allocating moves a pointer forward in a preallocated
+    /// block, and the whole frame is freed at once by reset() (or by rewinding to a mark(), see frame_arena::scope).
+    /// deallocate() only gives back the last allocation. When the block is full a bigger one is chained instead of
+    /// failing, and the next reset() replaces all of them by a single block as big as the high water mark, so the
+    /// following frames allocate from a single block again. Rewinding to the start of the arena (the end of the outer
+    /// scope of a frame) merges them the same way.
+    /// Nothing is destroyed on reset: the arena is meant for trivially destructible types (vectors, matrices, scalars).
+    /// An arena isn't thread safe, each thread uses its own (local()).
+    class frame_arena
+    {
+    public:
+        /// @brief Capacity of the thread local arenas
+        static constexpr size_t default_capacity = size_t(1) << 20;
+
+        /// @brief Position in the arena, to rewind to (a null block is the start of the arena, whatever its first block)
+        struct marker
+        {
+            void* block = nullptr;
+            size_t offset = 0;
+        };
+
+        /// @brief Rewind the arena to its position at the construction of the scope when the scope ends
+        class scope
+        {
+        public:
+            explicit scope(frame_arena& arena) noexcept : m_arena(arena), m_marker(arena.mark()) {}
+            scope(const scope&) = delete;
+            scope& operator = (const scope&) = delete;
+            ~scope() noexcept { m_arena.rewind(m_marker); }
+
+        private:
+            frame_arena& m_arena;
+            marker m_marker;
+        };
+
+    public:
+        explicit frame_arena(size_t capacity = default_capacity)
+        {
+            m_block = new_block(capacity, nullptr);
+            m_stats.capacity = m_block->size;
+        }
+
+        frame_arena(const frame_arena&) = delete;
+        frame_arena& operator = (const frame_arena&) = delete;
+
+        ~frame_arena() noexcept
+        {
+            free_blocks(nullptr);
+        }
+
+        /// @brief The arena of the calling thread (default_capacity bytes at first)
+        static frame_arena& local()
+        {
+            static thread_local frame_arena arena;
+            return arena;
+        }
+
+        /// @brief bytes aligned on alignment (a power of two)
+        void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t))
+        {
+            std::uintptr_t p = align_up(top(), alignment);
+            if (p + bytes > end())
+            {
+                grow(bytes + alignment);
+                p = align_up(top(), alignment);
+            }
+            m_offset = p + bytes - begin();
+            ++m_stats.allocations;
+            update_used();
+            return reinterpret_cast<void*>(p);
+        }
+
+        /// @brief Give back memory: only the last allocation moves the arena back, the others are freed by reset()
+        void deallocate(void* p, size_t bytes) noexcept
+        {
+            const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(p);
+            if (address + bytes == top() && address >= begin())
+            {
+                m_offset = address - begin();
+                update_used();
+            }
+        }
+
+        /// @brief count default constructed values of Type
+        template<typename Type>
+        span<Type> allocate_span(size_t count)
+        {
+            static_assert(std::is_trivially_destructible<Type>::value, "frame_arena doesn't destroy what it holds");
+            Type* p = static_cast<Type*>(allocate(count * sizeof(Type), alignof(Type)));
+            std::uninitialized_default_construct_n(p, count);
+            return span<Type>(p, count);
+        }
+
+        marker mark() const noexcept
+        {
+            if (m_block->previous == nullptr && m_offset == 0)
+                return marker{};
+            return marker{m_block, m_offset};
+        }
+
+        /// @brief Free everything allocated after mark() returned m (the markers taken before a reset() are invalid)
+        void rewind(const marker& m) noexcept
+        {
+            if (m.block == nullptr && m_block->previous != nullptr)
+            {
+                // back to the start after an overflow: merged as in reset(), without memory for that the last block
+                // (the biggest) becomes the first one
+                block* merged = new_block(std::max(first_block()->size, m_stats.high_water_mark), nullptr, std::nothrow);
+                if (merged == nullptr)
+                {
+                    merged = m_block;
+                    m_block = merged->previous;
+                    merged->previous = nullptr;
+                    merged->base = 0;
+                }
+                free_blocks(nullptr);
+                m_block = merged;
+                m_stats.capacity = merged->size;
+            }
+            else
+            {
+                free_blocks(m.block != nullptr ? static_cast<block*>(m.block) : first_block());
+            }
+            m_offset = m.offset;
+            update_used();
+        }
+
+        /// @brief Free everything. When the high water mark went over the capacity of the first block (blocks were
+        /// chained), the blocks are replaced by a single one as big as the high water mark.
+        void reset()
+        {
+            if (m_block->previous != nullptr || m_stats.high_water_mark > first_block()->size)
+            {
+                block* merged = new_block(std::max(first_block()->size, m_stats.high_water_mark), nullptr);
+                free_blocks(nullptr);
+                m_block = merged;
+                m_stats.capacity = merged->size;
+            }
+            m_offset = 0;
+            update_used();
+        }
+
+        size_t capacity() const noexcept { return m_stats.capacity; }
+        size_t used() const noexcept { return m_stats.used; }
+        size_t high_water_mark() const noexcept { return m_stats.high_water_mark; }
+        const frame_arena_stats& stats() const noexcept { return m_stats; }
+
+        void reset_high_water_mark() noexcept { m_stats.high_water_mark = m_stats.used; }
+
+    private:
+        /// @brief Header of the blocks, the memory follows it
+        struct alignas(parallel::cache_line_size) block
+        {
+            block* previous;
+            size_t size;
+            /// @brief Bytes used in the previous blocks
+            size_t base;
+        };
+
+        static std::uintptr_t align_up(std::uintptr_t p, size_t alignment) noexcept
+        {
+            return (p + alignment - 1) & ~std::uintptr_t(alignment - 1);
+        }
+
+        block* first_block() const noexcept
+        {
+            block* b = m_block;
+            while (b->previous != nullptr)
+                b = b->previous;
+            return b;
+        }
+
+        std::uintptr_t begin() const noexcept { return reinterpret_cast<std::uintptr_t>(m_block + 1); }
+        std::uintptr_t top() const noexcept { return begin() + m_offset; }
+        std::uintptr_t end() const noexcept { return begin() + m_block->size; }
+
+        static block* new_block(size_t size, block* previous)
+        {
+            size = align_up(std::max<size_t>(size, 1), parallel::cache_line_size);
+            void* memory = ::operator new(sizeof(block) + size, std::align_val_t(alignof(block)));
+            return new (memory) block{previous, size, 0};
+        }
+
+        /// @brief new_block, nullptr when out of memory
+        static block* new_block(size_t size, block* previous, const std::nothrow_t&) noexcept
+        {
+            size = align_up(std::max<size_t>(size, 1), parallel::cache_line_size);
+            void* memory = ::operator new(sizeof(block) + size, std::align_val_t(alignof(block)), std::nothrow);
+            return memory != nullptr ? new (memory) block{previous, size, 0} : nullptr;
+        }
+
+        /// @brief Free the blocks chained after last (all of them for nullptr), last becomes the current block
+        void free_blocks(block* last) noexcept
+        {
+            while (m_block != last && m_block != nullptr)
+            {
+                block* previous = m_block->previous;
+                m_stats.capacity -= m_block->size;
+                m_block->~block();
+                ::operator delete(m_block, std::align_val_t(alignof(block)));
+                m_block = previous;
+            }
+        }
+
+        /// @brief Chain a block of at least bytes, twice as big as the current one
+        void grow(size_t bytes)
+        {
+            block* b = new_block(std::max(bytes, 2 * m_block->size), m_block);
+            b->base = m_block->base + m_offset;
+            m_block = b;
+            m_offset = 0;
+            m_stats.capacity += b->size;
+            ++m_stats.overflows;
+        }
+
+        void update_used() noexcept
+        {
+            m_stats.used = m_block->base + m_offset;
+            m_stats.high_water_mark = std::max(m_stats.high_water_mark, m_stats.used);
+        }
+
+    private:
+        block* m_block = nullptr;
+        size_t m_offset = 0;
+        frame_arena_stats m_stats;
+    };
+
+    /// @brief Allocator taking its memory from a frame_arena (the thread local one by default), so the containers
+    /// (dynamic_matrix, soa_array, std::vector...) can hold temporary buffers. The blocks are Alignment bytes aligned,
+    /// a cache line by default as aligned_allocator. Deallocating is free, the memory comes back at the reset of the
+    /// arena.
+    template<typename ValueType, size_t Alignment = parallel::cache_line_size>
+    class arena_allocator
+    {
+    public:
+        using value_type = ValueType;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+        static constexpr size_t alignment = Alignment > alignof(ValueType) ? Alignment : alignof(ValueType);
+
+        template<typename Other>
+        struct rebind
+        {
+            using other = arena_allocator<Other, Alignment>;
+        };
+
+        arena_allocator() noexcept : m_arena(&frame_arena::local()) {}
+        explicit arena_allocator(frame_arena& arena) noexcept : m_arena(&arena) {}
+
+        template<typename Other>
+        arena_allocator(const arena_allocator<Other, Alignment>& o) noexcept : m_arena(&o.arena()) {}
+
+        ValueType* allocate(size_t count)
+        {
+            return static_cast<ValueType*>(m_arena->allocate(count * sizeof(ValueType), alignment));
+        }
+
+        void deallocate(ValueType* p, size_t count) noexcept
+        {
+            m_arena->deallocate(p, count * sizeof(ValueType));
+        }
+
+        frame_arena& arena() const noexcept { return *m_arena; }
+
+        template<typename Other>
+        bool operator == (const arena_allocator<Other, Alignment>& o) const noexcept { return m_arena == &o.arena(); }
+        template<typename Other>
+        bool operator != (const arena_allocator<Other, Alignment>& o) const noexcept { return m_arena != &o.arena(); }
+
+    private:
+        frame_arena* m_arena;
+    };
+} // namespace cml
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <stdexcept>
 #include "sin.hpp"
 
 namespace cml
@@ -29,8 +30,9 @@ namespace cml
     namespace implementation
     {
         template<typename ValueType>
-        constexpr auto cos_impl(const ValueType v) -> ValueType
+        constexpr auto cos_impl(ValueType v) -> ValueType
         {
+            v = trig_reduce_series(v);
             return trig_series(v, ValueType{1}, ValueType{2}, ValueType{3}, ValueType{-1}, v*v);
         }
 
@@ -43,10 +45,20 @@ namespace cml
         }
     }
 
+    /// @brief Cosine. float and double use a range reduced polynomial at runtime (see trig_kernel.hpp), the series is
+    /// used when constant evaluated. Fixed points always use the integer CORDIC kernel (see fixed_kernel.hpp).
     template<typename ValueType, implementation::angle_kind AK>
     constexpr auto cos(const implementation::angle<ValueType, AK> v) -> ValueType
     {
-        return implementation::cos_impl(static_cast<ValueType>(implementation::radian<ValueType>{v}));
+        const ValueType r = static_cast<ValueType>(implementation::radian<ValueType>{v});
+        if constexpr(is_fixed_point<ValueType>::value)
+            return implementation::cos_fixed(r);
+        else if constexpr(implementation::has_trig_kernel<ValueType>::value)
+        {
+            if (!implementation::is_constant_evaluated())
+                return implementation::cos_runtime(r);
+        }
+        return implementation::cos_impl(r);
     }
 
     template<typename ValueType, implementation::angle_kind AK>
@@ -55,16 +67,24 @@ namespace cml
         return implementation::acos_impl(static_cast<ValueType>(implementation::radian<ValueType>{v}));
     }
 
+    /// @brief (e^v + e^-v) / 2, from a single exponential
     template<typename ValueType>
     constexpr auto cosh(const ValueType v) -> ValueType
     {
-        return (exp(v) + exp(-v)) / ValueType{2};
+        const ValueType e = exp(v < ValueType{0} ? -v : v);
+        return (e + ValueType{1} / e) / ValueType{2};
     }
 
+    /// @brief log(v + sqrt(v^2 - 1)), through log1p below 2 (fdlibm's acosh)
     template<typename ValueType>
     constexpr auto acosh(const ValueType v) -> ValueType
     {
-        return v >= 1 ? log(v + sqrt(v*v - ValueType{1})) : throw std::runtime_error("acosh is greater then 1");
+        if (!(v >= 1))
+            throw std::runtime_error("acosh is greater then 1");
+        if (v > ValueType{2})
+            return log(ValueType{2} * v - ValueType{1} / (v + sqrt(v * v - ValueType{1})));
+        const ValueType t = v - ValueType{1};
+        return log1p(t + sqrt(ValueType{2} * t + t * t));
     }
 }
 
@@ -83,6 +103,11 @@ static_assert(cml::is_close_zero(0.l, cml::cos(cml::radian<long double>(cml::hal
 // cos(1) == 0.540302305868139717400936607442976603732310420617922227670
 static_assert(cml::is_equal(cml::cos(cml::radian<double>(1)), 0.5403023058681397), "cos(1.0)");
 
+// cos(1) == 0.5403023058681398 is 35409.49 in 16.16, 139.32 in 8.8
+static_assert(cml::cos(cml::radian<cml::f1616>(1)).data == 35409, "cos(f1616(1))");
+static_assert(cml::cos(cml::radian<cml::f88>(1)).data == 138 || cml::cos(cml::radian<cml::f88>(1)).data == 139, "cos(f88(1))");
+static_assert(cml::cos(cml::radian<cml::f1616>(cml::pi<cml::f1616>)).data == -65536, "cos(f1616(pi))");
+
 static_assert(cml::is_equal(cml::acos(cml::radian<float>(0)), cml::half_pi<float>), "acos(0.f)");
 static_assert(cml::is_equal(cml::acos(cml::radian<double>(0)), cml::half_pi<double>), "acos(0.0)");
 static_assert(cml::is_equal(cml::acos(cml::radian<long double>(0)), cml::half_pi<long double>), "acos(0.l)");
@@ -21,6 +21,7 @@
 //
 
 #pragma once
+#include "../swizzle.hpp"
 #include "../traits.hpp"
 #include "max.hpp"
 
@@ -37,13 +38,20 @@ namespace cml
         }
     }
 
-    template<typename ValueType>
+    template<typename ValueType, typename = std::enable_if_t<!implementation::is_swizzle<ValueType>::value>>
     constexpr auto cross(const ValueType& v1, const ValueType& v2) -> auto
     {
         static_assert(is_vector<ValueType>::value, "can only cross vectors");
         static_assert(max(matrix_traits<ValueType>::dimx, matrix_traits<ValueType>::dimy) == 3, "can only cross 3 component vectors");
         return implementation::cross_impl(v1, v2);
     }
+
+    /// @brief Swizzles are crossed as vectors
+    template<typename ValueType1, typename ValueType2, typename = std::enable_if_t<implementation::any_swizzle<ValueType1, ValueType2>::value>>
+    constexpr auto cross(const ValueType1& v1, const ValueType2& v2) -> auto
+    {
+        return cross(implementation::swizzle_operand(v1), implementation::swizzle_operand(v2));
+    }
 }
 
 #ifdef CML_COMPILE_TEST_CASE
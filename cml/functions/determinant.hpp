@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include "../matrix.hpp"
+
+namespace cml
+{
+    namespace implementation
+    {
+        /// @brief The 2x2 determinants of the two top rows (s) and the two bottom rows (c) of a 4x4 matrix, shared by
+        /// determinant and inverse (Laplace expansion along the two top rows)
+        template<typename ValueType>
+        struct mat4_minors
+        {
+            ValueType s[6];
+            ValueType c[6];
+
+            constexpr ValueType determinant() const
+            {
+                return s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+            }
+        };
+
+        template<typename ValueType, matrix_kind Kind>
+        constexpr mat4_minors<ValueType> make_mat4_minors(const matrix<4, 4, ValueType, Kind>& m)
+        {
+            const auto& a = m.components;
+            return mat4_minors<ValueType>
+            {
+                {
+                    a[0] * a[5] - a[4] * a[1],
+                    a[0] * a[6] - a[4] * a[2],
+                    a[0] * a[7] - a[4] * a[3],
+                    a[1] * a[6] - a[5] * a[2],
+                    a[1] * a[7] - a[5] * a[3],
+                    a[2] * a[7] - a[6] * a[3],
+                },
+                {
+                    a[8] * a[13] - a[12] * a[9],
+                    a[8] * a[14] - a[12] * a[10],
+                    a[8] * a[15] - a[12] * a[11],
+                    a[9] * a[14] - a[13] * a[10],
+                    a[9] * a[15] - a[13] * a[11],
+                    a[10] * a[15] - a[14] * a[11],
+                },
+            };
+        }
+
+        /// @brief Fraction free gaussian elimination (Bareiss): every division is exact for integers, the biggest pivot
+        /// of the column is used to keep floating points stable
+        template<size_t Dim, typename ValueType, matrix_kind Kind>
+        constexpr ValueType determinant_elimination(const matrix<Dim, Dim, ValueType, Kind>& m)
+        {
+            std::array<ValueType, Dim * Dim> a = m.components;
+            ValueType previous = ValueType(1);
+            bool negate = false;
+            for (size_t k = 0; k + 1 < Dim; ++k)
+            {
+                size_t pivot = k;
+                for (size_t i = k + 1; i < Dim; ++i)
+                {
+                    const ValueType v = a[k + i * Dim] < ValueType(0) ? ValueType(0) - a[k + i * Dim] : a[k + i * Dim];
+                    const ValueType p = a[k + pivot * Dim] < ValueType(0) ? ValueType(0) - a[k + pivot * Dim] : a[k + pivot * Dim];
+                    if (p < v)
+                        pivot = i;
+                }
+                if (a[k + pivot * Dim] == ValueType(0))
+                    return ValueType(0);
+                if (pivot != k)
+                {
+                    for (size_t j = 0; j < Dim; ++j)
+                    {
+                        const ValueType t = a[j + k * Dim];
+                        a[j + k * Dim] = a[j + pivot * Dim];
+                        a[j + pivot * Dim] = t;
+                    }
+                    negate = !negate;
+                }
+
+                for (size_t i = k + 1; i < Dim; ++i)
+                {
+                    for (size_t j = k + 1; j < Dim; ++j)
+                        a[j + i * Dim] = (a[j + i * Dim] * a[k + k * Dim] - a[k + i * Dim] * a[j + k * Dim]) / previous;
+                }
+                previous = a[k + k * Dim];
+            }
+            return negate ? ValueType(0) - a[Dim * Dim - 1] : a[Dim * Dim - 1];
+        }
+    } // namespace implementation
+
+    /// @brief Determinant of a square matrix: closed forms up to 4x4, gaussian elimination for bigger ones
+    template<typename ValueType, size_t DimX, size_t DimY, implementation::matrix_kind Kind>
+    constexpr ValueType determinant(const implementation::matrix<DimX, DimY, ValueType, Kind>& m)
+    {
+        static_assert(DimX == DimY, "Only square matrices have a determinant");
+        const auto& a = m.components;
+        if constexpr(DimX == 1)
+            return a[0];
+        else if constexpr(DimX == 2)
+            return a[0] * a[3] - a[1] * a[2];
+        else if constexpr(DimX == 3)
+            return a[0] * (a[4] * a[8] - a[5] * a[7]) - a[1] * (a[3] * a[8] - a[5] * a[6]) + a[2] * (a[3] * a[7] - a[4] * a[6]);
+        else if constexpr(DimX == 4)
+            return implementation::make_mat4_minors(m).determinant();
+        else
+            return implementation::determinant_elimination(m);
+    }
+} // namespace cml
+
+#ifdef CML_COMPILE_TEST_CASE
+
+#include "../definitions.hpp"
+
+static_assert(cml::determinant(cml::imat2(1, 2, 3, 4)) == -2);
+static_assert(cml::determinant(cml::imat3(2, 0, 1, 1, 3, 2, 1, 1, 2)) == 6);
+static_assert(cml::determinant(cml::imat4(1, 0, 2, -1, 3, 0, 0, 5, 2, 1, 4, -3, 1, 0, 5, 0)) == 30);
+static_assert(cml::determinant(cml::imat<5, 5>(2, 0, 0, 0, 1, 0, 3, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 4, 0, 0, 0, 2, 0, 1)) == 24);
+static_assert(cml::determinant(cml::mat4::identity()) == 1.f);
+
+#endif
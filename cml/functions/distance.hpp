@@ -34,6 +34,12 @@ namespace cml
         static_assert(is_vector<implementation::matrix<DimX, DimY, ValueType, Kind>>::value, "Can only find the distance of two vectors.");
         return length(v1 - v2);
     }
+
+    template<typename ValueType1, typename ValueType2, typename = std::enable_if_t<implementation::any_swizzle<ValueType1, ValueType2>::value>>
+    constexpr auto distance(const ValueType1& v1, const ValueType2& v2)
+    {
+        return distance(implementation::swizzle_operand(v1), implementation::swizzle_operand(v2));
+    }
 }
 
 #ifdef CML_COMPILE_TEST_CASE
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "../matrix.hpp"
+#include "../operator/fixed_impl.hpp"
 
 namespace cml
 {
@@ -48,6 +49,18 @@ namespace cml
         static_assert(DimX == 1 || DimY == 1, "you can only perform dot products on vectors");
         constexpr size_t dim = (DimX == 1 ? DimY : DimX);
 
+        if constexpr(implementation::has_simd_fixed<ValueType, dim>::value)
+        {
+            if (!implementation::is_constant_evaluated())
+                return implementation::fixed_dot_simd(v1.components, v2.components);
+        }
         return implementation::dot_impl(std::make_index_sequence<dim>{}, v1, v2);
     }
+
+    /// @brief Swizzles (v._<'xy'>()) are evaluated to vectors first
+    template<typename ValueType1, typename ValueType2, typename = std::enable_if_t<implementation::any_swizzle<ValueType1, ValueType2>::value>>
+    constexpr auto dot(const ValueType1& v1, const ValueType2& v2)
+    {
+        return dot(implementation::swizzle_operand(v1), implementation::swizzle_operand(v2));
+    }
 } // namespace cml
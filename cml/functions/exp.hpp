@@ -22,23 +22,51 @@
 
 #pragma once
 #include "../equality.hpp"
+#include "../fixed_point.hpp"
+#include "exp_log_kernel.hpp"
+#include "fixed_kernel.hpp"
 #include <cstdint>
 
 namespace cml
 {
-    namespace implementation
+    /// @brief e^v, range reduced to 2^k e^r (see exp_log_kernel.hpp). Fixed points use an integer only kernel (see
+    /// fixed_kernel.hpp)
+    template<typename ValueType>
+    constexpr auto exp(ValueType v) -> ValueType
     {
-        template<typename ValueType>
-        constexpr auto exp_impl(ValueType x, ValueType sum, ValueType n, std::size_t i, ValueType t) -> ValueType
+        if constexpr(is_fixed_point<ValueType>::value)
+            return implementation::exp_fixed(v);
+        else
         {
-            return is_equal(sum, sum + t / n) ? sum : exp_impl(x, sum + t / n, n * static_cast<ValueType>(i), i + 1, t * x);
+            using kernel_type = typename implementation::exp_log_kernel_type<ValueType>::type;
+            return static_cast<ValueType>(implementation::exp_kernel(static_cast<kernel_type>(v)));
         }
     }
 
+    /// @brief 2^v
     template<typename ValueType>
-    constexpr auto exp(ValueType v) -> ValueType
+    constexpr auto exp2(ValueType v) -> ValueType
+    {
+        if constexpr(is_fixed_point<ValueType>::value)
+            return implementation::exp2_fixed(v);
+        else
+        {
+            using kernel_type = typename implementation::exp_log_kernel_type<ValueType>::type;
+            return static_cast<ValueType>(implementation::exp2_kernel(static_cast<kernel_type>(v)));
+        }
+    }
+
+    /// @brief e^v - 1, precise for v close to 0
+    template<typename ValueType>
+    constexpr auto expm1(ValueType v) -> ValueType
     {
-        return implementation::exp_impl(v, ValueType{1}, ValueType{1}, 2, v);
+        if constexpr(is_fixed_point<ValueType>::value)
+            return implementation::exp_fixed(v) - ValueType(1);
+        else
+        {
+            using kernel_type = typename implementation::exp_log_kernel_type<ValueType>::type;
+            return static_cast<ValueType>(implementation::expm1_kernel(static_cast<kernel_type>(v)));
+        }
     }
 }
 
@@ -49,4 +77,16 @@ static_assert(cml::is_equal(2.718282f, cml::exp(1.0f)), "exp(1.0f)");
 static_assert(cml::is_equal(2.7182818284590454, cml::exp(1.0)), "exp(1.0)");
 static_assert(cml::is_equal(2.7182818284590452354l, cml::exp(1.0l)), "exp(1.0l)");
 
+static_assert(cml::is_equal(8.0, cml::exp2(3.0)), "exp2(3.0)");
+static_assert(cml::exp2(10.0) == 1024.0, "exp2(10.0) is exact");
+static_assert(cml::exp2(-1074.0) == std::numeric_limits<double>::denorm_min(), "exp2(-1074.0)");
+static_assert(cml::exp(-800.0) == 0.0, "exp underflows");
+static_assert(cml::exp(800.0) == std::numeric_limits<double>::infinity(), "exp overflows");
+static_assert(cml::expm1(1e-10) > 1e-10 && cml::expm1(1e-10) < 1.0000000001e-10, "expm1(1e-10)");
+static_assert(cml::is_equal(1.718281828459045, cml::expm1(1.0)), "expm1(1.0)");
+static_assert(cml::exp2(cml::fixed<int32_t, 16>(3)) == cml::fixed<int32_t, 16>(8), "exp2(f1616(3))");
+static_assert(cml::exp2(cml::fixed<int32_t, 16>(-1)) == cml::fixed<int32_t, 16>(0.5), "exp2(f1616(-1))");
+static_assert(cml::exp2(cml::fixed<int32_t, 16>(20)).data == std::numeric_limits<int32_t>::max(), "exp2 saturates");
+static_assert(cml::exp(cml::fixed<int32_t, 16>(1)).data == 178145, "exp(f1616(1))");
+
 #endif
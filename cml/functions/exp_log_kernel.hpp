@@ -0,0 +1,533 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include "../config.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+// Range reduced exp / log kernels, with a fixed number of operations whatever the argument. They are constexpr, and at
+// runtime double and the x87 long double only replace the exact power of two scalings and exponent extractions by bit
+// manipulations: the results are the same at compile time and at runtime. float is evaluated in double.
+//
+//  - exp:  x = k ln2 + r with |r| <= ln2 / 2 (ln2 split in two for an exact k ln2), e^r = 1 + 2r / (2 - c) with
+//          c = r - (r coth(r / 2) - 2), whose series in r^2 has Bernoulli numbers as coefficients (fdlibm's exp, with
+//          the series instead of a minimax polynomial), then e^x = 2^k e^r.
+//  - log:  x = m 2^e with m in [sqrt(2) / 2, sqrt(2)), log(m) = 2 atanh(s) with s = (m - 1) / (m + 1), evaluated as
+//          f - (f^2 / 2 - s (f^2 / 2 + R(s^2))) with f = m - 1 (fdlibm's log, with the series of atanh).
+//  - exp2, expm1, log2 and log1p reuse these reductions.
+//
+// Error, measured on 2 * 10^6 random arguments per function against higher precision results:
+//  - float:       < 0.501 ulp (the double result is rounded once)
+//  - double:      exp 0.90, exp2 0.87, expm1 1.09, log 0.75, log2 0.62, log1p 0.80 ulp
+//  - long double: exp 0.86, exp2 0.93, expm1 1.04, log 0.64, log2 0.49, log1p 1.02 ulp (x87 80 bit)
+//
+// pow is e^(y log(x)) evaluated in a wider type: double for float (0.5 ulp), the x87 long double for double (0.71 ulp).
+// Without a wider type the error of y log(x) is amplified by |y log(x)|, up to several hundred ulp for huge results.
+namespace cml::implementation
+{
+    namespace exp_log_constants
+    {
+        /// @brief ln(2) in two parts, ln2_hi has 32 significant bits so that k * ln2_hi is exact
+        constexpr long double ln2_hi = 0.69314718036912381649017333984375l;
+        constexpr long double ln2_lo = 1.9082149292705878161442656807550013436e-10l;
+        constexpr long double ln2 = 0.69314718055994530941723212145817656808l;
+        constexpr long double log2_e = 1.4426950408889634073599246810018921374l;
+        /// @brief log2(e) in two parts, log2_e_hi has 32 significant bits
+        constexpr long double log2_e_hi = 1.4426950407214462757110595703125l;
+        constexpr long double log2_e_lo = 1.6751713164886511068939213742664595415e-10l;
+        constexpr long double sqrt2 = 1.4142135623730950488016887242096980786l;
+    }
+
+    /// @brief Type the kernels are evaluated in (double for float and the integers)
+    template<typename ValueType> struct exp_log_kernel_type { using type = std::conditional_t<std::is_floating_point<ValueType>::value, ValueType, double>; };
+    template<> struct exp_log_kernel_type<float> { using type = double; };
+
+    /// @brief Type pow is evaluated in: y log(x) needs more bits than the result (up to 11 more for double), double
+    /// uses long double when it is wider (x87)
+    template<typename ValueType> struct pow_kernel_type { using type = typename exp_log_kernel_type<ValueType>::type; };
+    template<> struct pow_kernel_type<double> { using type = std::conditional_t<(std::numeric_limits<long double>::digits > std::numeric_limits<double>::digits), long double, double>; };
+
+    /// @brief The 80 bit x87 long double (64 bit mantissa with an explicit integer bit, then a 15 bit exponent and the
+    /// sign), its exponent can be read and written directly at runtime
+    template<typename ValueType>
+    struct is_x87_long_double : public std::false_type {};
+#if defined(__i386__) || defined(__x86_64__)
+    template<>
+    struct is_x87_long_double<long double> : public std::bool_constant<std::numeric_limits<long double>::digits == 64 && std::numeric_limits<long double>::max_exponent == 16384> {};
+#endif
+
+    /// @brief Number of bits of the biggest exponent of a normal value
+    template<typename ValueType>
+    constexpr int exponent_bits() noexcept
+    {
+        int bits = 0;
+        for (int e = std::numeric_limits<ValueType>::max_exponent - 1; e != 0; e >>= 1)
+            ++bits;
+        return bits;
+    }
+
+    /// @brief 2^k, exact, for k in the exponent range of the normal values
+    template<typename ValueType>
+    constexpr ValueType pow2_int(const int k) noexcept
+    {
+        if constexpr(std::is_same<ValueType, double>::value && std::numeric_limits<double>::is_iec559)
+        {
+            if (!is_constant_evaluated())
+            {
+                const std::uint64_t bits = static_cast<std::uint64_t>(k + 1023) << 52;
+                double ret = 0;
+                std::memcpy(&ret, &bits, sizeof(ret));
+                return ret;
+            }
+        }
+        else if constexpr(is_x87_long_double<ValueType>::value)
+        {
+            if (!is_constant_evaluated())
+            {
+                const std::uint64_t mantissa = 1ull << 63;
+                const std::uint16_t exponent = static_cast<std::uint16_t>(k + 16383);
+                long double ret = 0;
+                std::memcpy(&ret, &mantissa, sizeof(mantissa));
+                std::memcpy(reinterpret_cast<unsigned char*>(&ret) + sizeof(mantissa), &exponent, sizeof(exponent));
+                return ret;
+            }
+        }
+        // square and multiply on the bits of |k|, the squares are not computed past the last bit (they would overflow)
+        constexpr int bits = exponent_bits<ValueType>();
+        ValueType base = k < 0 ? ValueType(0.5) : ValueType(2);
+        const unsigned n = static_cast<unsigned>(k < 0 ? -k : k);
+        ValueType ret = 1;
+        for (int i = 0; i < bits; ++i)
+        {
+            if (n & (1u << i))
+                ret *= base;
+            if (i + 1 < bits)
+                base *= base;
+        }
+        return ret;
+    }
+
+    /// @brief Whether the sign bit of v is set (-0 included). Constant evaluated, only gcc tells -0 from +0.
+    template<typename ValueType>
+    constexpr bool sign_bit(const ValueType v) noexcept
+    {
+#if defined(__GNUC__) && !defined(__clang__)
+        return __builtin_signbit(v);
+#else
+        if (is_constant_evaluated())
+            return v < ValueType(0);
+        return std::signbit(v);
+#endif
+    }
+
+    /// @brief v * 2^k, rounded once when the result is subnormal
+    template<typename ValueType>
+    constexpr ValueType scale2(const ValueType v, const int k) noexcept
+    {
+        if (k > std::numeric_limits<ValueType>::max_exponent - 1 || k < std::numeric_limits<ValueType>::min_exponent - 1)
+        {
+            const int half = k / 2;
+            return v * pow2_int<ValueType>(half) * pow2_int<ValueType>(k - half);
+        }
+        return v * pow2_int<ValueType>(k);
+    }
+
+    /// @brief Veltkamp split: v = hi + lo, hi has Shift bits less than the type (the products of hi are exact)
+    template<int Shift, typename ValueType>
+    constexpr void veltkamp_split(const ValueType v, ValueType& hi, ValueType& lo) noexcept
+    {
+        constexpr ValueType splitter = pow2_int<ValueType>(Shift) + ValueType(1);
+        const ValueType t = splitter * v;
+        hi = t - (t - v);
+        lo = v - hi;
+    }
+
+    /// @brief a * b = p + e exactly (Dekker's product)
+    template<typename ValueType>
+    constexpr void two_product(const ValueType a, const ValueType b, ValueType& p, ValueType& e) noexcept
+    {
+        constexpr int shift = (std::numeric_limits<ValueType>::digits + 1) / 2;
+        ValueType ah = 0, al = 0, bh = 0, bl = 0;
+        veltkamp_split<shift>(a, ah, al);
+        veltkamp_split<shift>(b, bh, bl);
+        p = a * b;
+        e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+    }
+
+    /// @brief Splits v > 0 (finite) in m * 2^e with m in [1, 2)
+    template<typename ValueType>
+    constexpr ValueType split_exponent(ValueType v, int& e) noexcept
+    {
+        e = 0;
+        if (v < std::numeric_limits<ValueType>::min())
+        {
+            v *= pow2_int<ValueType>(std::numeric_limits<ValueType>::digits);
+            e = -std::numeric_limits<ValueType>::digits;
+        }
+
+        if constexpr(std::is_same<ValueType, double>::value && std::numeric_limits<double>::is_iec559)
+        {
+            if (!is_constant_evaluated())
+            {
+                std::uint64_t bits = 0;
+                std::memcpy(&bits, &v, sizeof(v));
+                e += static_cast<int>(bits >> 52) - 1023;
+                bits = (bits & 0x000fffffffffffffull) | 0x3ff0000000000000ull;
+                std::memcpy(&v, &bits, sizeof(v));
+                return v;
+            }
+        }
+        else if constexpr(is_x87_long_double<ValueType>::value)
+        {
+            if (!is_constant_evaluated())
+            {
+                std::uint16_t exponent = 0;
+                unsigned char* const bytes = reinterpret_cast<unsigned char*>(&v);
+                std::memcpy(&exponent, bytes + sizeof(std::uint64_t), sizeof(exponent));
+                e += static_cast<int>(exponent) - 16383; // v > 0, there is no sign bit
+                exponent = 16383;
+                std::memcpy(bytes + sizeof(std::uint64_t), &exponent, sizeof(exponent));
+                return v;
+            }
+        }
+
+        // binary search of the exponent: powers[i] = 2^(2^i)
+        constexpr int bits = exponent_bits<ValueType>();
+        ValueType powers[bits] = {};
+        powers[0] = 2;
+        for (int i = 1; i < bits; ++i)
+            powers[i] = powers[i - 1] * powers[i - 1];
+
+        if (v >= ValueType(1))
+        {
+            for (int i = bits - 1; i >= 0; --i)
+            {
+                if (v >= powers[i])
+                {
+                    v /= powers[i];
+                    e += 1 << i;
+                }
+            }
+        }
+        else
+        {
+            for (int i = bits - 1; i >= 0; --i)
+            {
+                if (v * powers[i] < ValueType(2))
+                {
+                    v *= powers[i];
+                    e -= 1 << i;
+                }
+            }
+        }
+        return v;
+    }
+
+    /// @brief Nearest integer of |v| < 2^30
+    template<typename ValueType>
+    constexpr int round_to_int(const ValueType v) noexcept
+    {
+        return static_cast<int>(v < 0 ? v - ValueType(0.5) : v + ValueType(0.5));
+    }
+
+    /// @brief c = r - (r coth(r / 2) - 2), the series has the Bernoulli numbers B2n as coefficients: 2 B2n / (2n)!
+    template<typename ValueType>
+    constexpr ValueType exp_c(const ValueType r) noexcept
+    {
+        constexpr ValueType P1 = ValueType(1) / ValueType(6);
+        constexpr ValueType P2 = ValueType(-1) / ValueType(360);
+        constexpr ValueType P3 = ValueType(1) / ValueType(15120);
+        constexpr ValueType P4 = ValueType(-1) / ValueType(604800);
+        constexpr ValueType P5 = ValueType(1) / ValueType(23950080);
+        constexpr ValueType P6 = ValueType(-691) / ValueType(653837184000.l);
+        constexpr ValueType P7 = ValueType(1) / ValueType(37362124800.l);
+        constexpr ValueType P8 = ValueType(-3617) / ValueType(5335311421440000.l);
+
+        const ValueType z = r * r;
+        return r - z * (P1 + z * (P2 + z * (P3 + z * (P4 + z * (P5 + z * (P6 + z * (P7 + z * P8)))))));
+    }
+
+    /// @brief e^(hi - lo) for |hi - lo| <= ln2 / 2
+    template<typename ValueType>
+    constexpr ValueType exp_reduced(const ValueType hi, const ValueType lo) noexcept
+    {
+        const ValueType r = hi - lo;
+        const ValueType c = exp_c(r);
+        return ValueType(1) - ((lo - (r * c) / (ValueType(2) - c)) - hi);
+    }
+
+    /// @brief False when 2^t over / underflows, special is then the result
+    template<typename ValueType>
+    constexpr bool exp_in_range(const ValueType t, ValueType& special) noexcept
+    {
+        using limits = std::numeric_limits<ValueType>;
+        if (t > ValueType(limits::max_exponent + 1))
+        {
+            special = limits::infinity();
+            return false;
+        }
+        if (t < ValueType(limits::min_exponent - limits::digits - 3))
+        {
+            special = ValueType(0);
+            return false;
+        }
+        return true;
+    }
+
+    template<typename ValueType>
+    constexpr ValueType exp_kernel(const ValueType v) noexcept
+    {
+        using namespace exp_log_constants;
+        if (v != v)
+            return v;
+
+        ValueType special = 0;
+        if (!exp_in_range(v * ValueType(log2_e), special))
+            return special;
+
+        const int k = round_to_int(v * ValueType(log2_e));
+        const ValueType hi = v - ValueType(k) * ValueType(ln2_hi);
+        const ValueType lo = ValueType(k) * ValueType(ln2_lo);
+        return scale2(exp_reduced(hi, lo), k);
+    }
+
+    template<typename ValueType>
+    constexpr ValueType exp2_kernel(const ValueType v) noexcept
+    {
+        using namespace exp_log_constants;
+        if (v != v)
+            return v;
+
+        ValueType special = 0;
+        if (!exp_in_range(v, special))
+            return special;
+
+        // 2^v = 2^k e^(f ln2): f ln2 is kept exact in two parts, with the part of ln2 that the type can't hold
+        const int k = round_to_int(v);
+        const ValueType f = v - ValueType(k);
+        constexpr ValueType ln2_t = ValueType(ln2);
+        constexpr ValueType ln2_tail = ValueType(ln2 - static_cast<long double>(ln2_t));
+        ValueType hi = 0;
+        ValueType e = 0;
+        two_product(f, ln2_t, hi, e);
+        return scale2(exp_reduced(hi, -(e + f * ln2_tail)), k);
+    }
+
+    /// @brief e^v - 1, without cancellation for small v
+    template<typename ValueType>
+    constexpr ValueType expm1_kernel(const ValueType v) noexcept
+    {
+        using namespace exp_log_constants;
+        using limits = std::numeric_limits<ValueType>;
+        if (v != v)
+            return v;
+
+        const ValueType t = v * ValueType(log2_e);
+        if (t > ValueType(limits::max_exponent + 1))
+            return limits::infinity();
+        if (t < -ValueType(limits::digits + 3))
+            return ValueType(-1);
+
+        // e^r - 1 = 2r / (2 - c) = r + r c / (2 - c), kept as r + tail (tail also has the rounding of r). There is no
+        // reduction when |v| <= ln2 / 2, the result is then r + tail with r = v.
+        const int k = v > ValueType(ln2 / 2) || v < -ValueType(ln2 / 2) ? round_to_int(t) : 0;
+        const ValueType hi = v - ValueType(k) * ValueType(ln2_hi);
+        const ValueType lo = ValueType(k) * ValueType(ln2_lo);
+        const ValueType r = hi - lo;
+        const ValueType c = exp_c(r);
+        const ValueType tail = (r * c) / (ValueType(2) - c) + ((hi - r) - lo) * (ValueType(1) + r);
+        if (k == 0)
+            return r + tail;
+        if (k > limits::digits + 2)
+            return scale2(ValueType(1) + (r + tail), k);
+
+        // 2^k (1 + r + tail) - 1 = (2^k - 1) + 2^k r + 2^k tail: |2^k - 1| >= |2^k r| and both are exact, so the
+        // rounding error of their sum is exact too (Fast2Sum)
+        const ValueType a = pow2_int<ValueType>(k) - ValueType(1);
+        const ValueType b = scale2(r, k);
+        const ValueType sum = a + b;
+        const ValueType error = (a - sum) + b;
+        return sum + (error + scale2(tail, k));
+    }
+
+    /// @brief log(m) for m in [sqrt(2) / 2, sqrt(2)): log(1 + f) = 2 atanh(s) = 2s + 2s^3 / 3 + 2s^5 / 5..., written as
+    /// f - (hfsq - s (hfsq + R)) with hfsq = f^2 / 2 and R = 2s^3 / 3 + ... (the terms past s^23 are below 2^-64)
+    template<typename ValueType>
+    constexpr void log_reduced(const ValueType f, ValueType& hfsq, ValueType& tail) noexcept
+    {
+        const ValueType s = f / (ValueType(2) + f);
+        const ValueType z = s * s;
+        ValueType R = ValueType(2) / ValueType(23);
+        for (int n = 10; n >= 1; --n)
+            R = ValueType(2) / ValueType(2 * n + 1) + z * R;
+        R *= z;
+        hfsq = ValueType(0.5) * f * f;
+        tail = s * (hfsq + R);
+    }
+
+    /// @brief v = m 2^e with m in [sqrt(2) / 2, sqrt(2)), returns f = m - 1 (exact)
+    template<typename ValueType>
+    constexpr ValueType log_split(const ValueType v, int& e) noexcept
+    {
+        ValueType m = split_exponent(v, e);
+        if (m > ValueType(exp_log_constants::sqrt2))
+        {
+            m *= ValueType(0.5);
+            ++e;
+        }
+        return m - ValueType(1);
+    }
+
+    /// @brief The special values of log: NaN for v < 0, -inf for 0 and +inf for +inf (true if v is one of them)
+    template<typename ValueType>
+    constexpr bool log_special(const ValueType v, ValueType& special) noexcept
+    {
+        using limits = std::numeric_limits<ValueType>;
+        if (v != v || v < 0)
+            special = limits::quiet_NaN();
+        else if (v == 0)
+            special = -limits::infinity();
+        else if (v == limits::infinity())
+            special = v;
+        else
+            return false;
+        return true;
+    }
+
+    template<typename ValueType>
+    constexpr ValueType log_kernel(const ValueType v) noexcept
+    {
+        using namespace exp_log_constants;
+        ValueType special = 0;
+        if (log_special(v, special))
+            return special;
+
+        int e = 0;
+        const ValueType f = log_split(v, e);
+        ValueType hfsq = 0;
+        ValueType tail = 0;
+        log_reduced(f, hfsq, tail);
+        const ValueType k = ValueType(e);
+        return k * ValueType(ln2_hi) - ((hfsq - (tail + k * ValueType(ln2_lo))) - f);
+    }
+
+    template<typename ValueType>
+    constexpr ValueType log2_kernel(const ValueType v) noexcept
+    {
+        using namespace exp_log_constants;
+        ValueType special = 0;
+        if (log_special(v, special))
+            return special;
+
+        int e = 0;
+        const ValueType f = log_split(v, e);
+        ValueType hfsq = 0;
+        ValueType tail = 0;
+        log_reduced(f, hfsq, tail);
+
+        // log(m) = hi + lo with hi * log2_e_hi exact, then e + the product is summed with its rounding error (fdlibm's
+        // log2)
+        ValueType hi = 0;
+        ValueType unused = 0;
+        veltkamp_split<32>(f - hfsq, hi, unused);
+        const ValueType lo = (f - hi) - hfsq + tail;
+        const ValueType val_hi = hi * ValueType(log2_e_hi);
+        const ValueType val_lo = (lo + hi) * ValueType(log2_e_lo) + lo * ValueType(log2_e_hi);
+        const ValueType y = ValueType(e);
+        const ValueType w = y + val_hi;
+        return (val_lo + ((y - w) + val_hi)) + w;
+    }
+
+    /// @brief log(1 + v), without cancellation for small v: the rounding error c of u = 1 + v is added as c / u (fdlibm's
+    /// log1p)
+    template<typename ValueType>
+    constexpr ValueType log1p_kernel(const ValueType v) noexcept
+    {
+        using namespace exp_log_constants;
+        const ValueType u = ValueType(1) + v;
+        if (u == ValueType(1))
+            return v;
+        ValueType special = 0;
+        if (log_special(u, special))
+            return special;
+
+        int e = 0;
+        const ValueType f = log_split(u, e);
+        // the subtractions are exact (Sterbenz): u - 1 for u <= 2, u - v for v >= 1
+        ValueType c = 0;
+        if (e < std::numeric_limits<ValueType>::digits + 2)
+            c = (u > ValueType(2) ? ValueType(1) - (u - v) : v - (u - ValueType(1))) / u;
+        ValueType hfsq = 0;
+        ValueType tail = 0;
+        log_reduced(f, hfsq, tail);
+        const ValueType k = ValueType(e);
+        return k * ValueType(ln2_hi) - ((hfsq - (tail + (k * ValueType(ln2_lo) + c))) - f);
+    }
+
+    /// @brief x^y = e^(y log(x)), with the special values of std::pow: negative bases only have integer powers (NaN
+    /// otherwise), negative for the odd ones
+    template<typename ValueType>
+    constexpr ValueType pow_kernel(ValueType x, const ValueType y) noexcept
+    {
+        using limits = std::numeric_limits<ValueType>;
+        if (y == ValueType(0) || x == ValueType(1))
+            return ValueType(1);
+        if (x != x || y != y)
+            return limits::quiet_NaN();
+        const ValueType abs_y = y < ValueType(0) ? -y : y;
+        if (x == ValueType(-1) && abs_y == limits::infinity())
+            return ValueType(1);
+
+        bool negative = false;
+        if (x == ValueType(0))
+        {
+            // -0 keeps its sign for the odd integer powers
+            if (sign_bit(x) && abs_y < pow2_int<ValueType>(64))
+            {
+                const std::uint64_t n = static_cast<std::uint64_t>(abs_y);
+                negative = static_cast<ValueType>(n) == abs_y && (n & 1u) != 0;
+            }
+            x = ValueType(0);
+        }
+        else if (x < ValueType(0))
+        {
+            // the values above 2^64 are even integers
+            if (abs_y < pow2_int<ValueType>(64))
+            {
+                const std::uint64_t n = static_cast<std::uint64_t>(abs_y);
+                if (static_cast<ValueType>(n) != abs_y)
+                    return limits::quiet_NaN();
+                negative = (n & 1u) != 0;
+            }
+            x = -x;
+        }
+
+        const ValueType ret = x == ValueType(0) ? (y > ValueType(0) ? ValueType(0) : limits::infinity()) : exp_kernel(y * log_kernel(x));
+        return negative ? -ret : ret;
+    }
+} // namespace cml::implementation
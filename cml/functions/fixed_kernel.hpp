@@ -0,0 +1,358 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#pragma once
+
+#include "../fixed_point.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Integer only sin/cos/atan2/exp2/log2/pow for the fixed point types: no floating point operation is done, at runtime
+// or when constant evaluated, so the results are the same on every platform (lockstep simulations).
+//
+// The computations are done on int64_t with 30 fractional bits (q30) and rounded to the fractional bits FB of the type
+// at the end. The number of iterations grows with FB, so the precision follows the type (for FB <= 28):
+//  - sin, cos:  CORDIC in rotation mode, FB / 2 + 2 iterations and a first order correction of the residual angle.
+//               Error < 2^-FB + the reduction error (|x| / 2pi * 2^-31: 2^-17 at the biggest f1616 angle).
+//  - atan2:     CORDIC in vectoring mode, same iterations, the residual angle is added as y / x. Error < 2^-FB.
+//  - exp2, exp: 2^i shifts, 2^f = product of 2^(2^-k) for the bits of f (a table), FB + 4 bits of f for exp.
+//               Relative error < 2^-FB, saturated to the biggest value.
+//  - log2, log: position of the highest bit, then the bits of the fractional part by repeated squaring of the
+//               normalized mantissa. Error < 2^-FB, the lowest value for x <= 0.
+//  - pow:       2^(y log2(x)) with FB + 4 bits of log2(x). Error < 2^-FB max(1, x^y) for |y log2(x)| < 16, 0 for
+//               x <= 0.
+namespace cml::implementation
+{
+    namespace fixed_constants
+    {
+        inline constexpr std::int64_t one = std::int64_t(1) << 30;
+        inline constexpr std::int64_t pi = 3373259426;
+        inline constexpr std::int64_t half_pi = 1686629713;
+        inline constexpr std::int64_t two_pi = 6746518852;
+        inline constexpr std::int64_t log2_e = 1549082005;
+        inline constexpr std::int64_t ln_2 = 744261118;
+
+        /// @brief 1 / prod(sqrt(1 + 2^-2i)), the CORDIC gain
+        inline constexpr std::int64_t cordic_gain = 652032874;
+
+        /// @brief atan(2^-i)
+        inline constexpr std::int64_t cordic_atan[31] = {
+            843314857, 497837829, 263043837, 133525159, 67021687, 33543516, 16775851, 8388437, 4194283, 2097149, 1048576,
+            524288, 262144, 131072, 65536, 32768, 16384, 8192, 4096, 2048, 1024, 512, 256, 128, 64, 32, 16, 8, 4, 2, 1};
+
+        /// @brief 2^(2^-(i + 1))
+        inline constexpr std::int64_t exp2_bits[30] = {
+            1518500250, 1276901417, 1170923762, 1121280436, 1097253708, 1085434106, 1079572136, 1076653033, 1075196443,
+            1074468888, 1074105294, 1073923544, 1073832680, 1073787251, 1073764537, 1073753181, 1073747502, 1073744663,
+            1073743244, 1073742534, 1073742179, 1073742001, 1073741913, 1073741868, 1073741846, 1073741835, 1073741830,
+            1073741827, 1073741825, 1073741825};
+    }
+
+    /// @brief Fractional bits used internally: the ones of the type plus 4 guard bits, at most 30
+    template<size_t FB>
+    constexpr size_t fixed_work_bits = FB + 4 <= 30 ? FB + 4 : 30;
+
+    /// @brief v * 2^Shift (Shift can be negative, the result is then rounded to the nearest)
+    template<int Shift>
+    constexpr std::int64_t fixed_scale(std::int64_t v) noexcept
+    {
+        if constexpr(Shift >= 0)
+            return v * (std::int64_t(1) << Shift);
+        else
+            return (v + (std::int64_t(1) << (-Shift - 1))) >> -Shift;
+    }
+
+    /// @brief (a * b) >> 30, rounded to the nearest (|a * b| must fit in 62 bits)
+    constexpr std::int64_t fixed_mul_q30(std::int64_t a, std::int64_t b) noexcept
+    {
+        return (a * b + (std::int64_t(1) << 29)) >> 30;
+    }
+
+    template<typename Type>
+    constexpr Type fixed_saturate(std::int64_t v) noexcept
+    {
+        return v > std::numeric_limits<Type>::max() ? std::numeric_limits<Type>::max() :
+               v < std::numeric_limits<Type>::min() ? std::numeric_limits<Type>::min() :
+               static_cast<Type>(v);
+    }
+
+    /// @brief Index of the highest set bit of v > 0
+    constexpr int fixed_highest_bit(std::uint64_t v) noexcept
+    {
+        int ret = 0;
+        for (int shift = 32; shift != 0; shift /= 2)
+        {
+            if (v >> shift)
+            {
+                v >>= shift;
+                ret += shift;
+            }
+        }
+        return ret;
+    }
+
+    /// @brief sin and cos of a q30 angle
+    template<size_t FB>
+    constexpr void sincos_q30(std::int64_t r, std::int64_t& s, std::int64_t& c) noexcept
+    {
+        using namespace fixed_constants;
+
+        // to [-pi, pi], then [-pi/2, pi/2]: sin(pi - r) = sin(r) and cos(pi - r) = -cos(r)
+        if (r > pi || r < -pi)
+            r -= ((r + (r >= 0 ? pi : -pi)) / two_pi) * two_pi;
+        bool negate_cos = false;
+        if (r > half_pi)
+        {
+            r = pi - r;
+            negate_cos = true;
+        }
+        else if (r < -half_pi)
+        {
+            r = -pi - r;
+            negate_cos = true;
+        }
+
+        // the direction of each rotation is random: it is applied as a sign mask instead of a branch
+        constexpr size_t iterations = FB / 2 + 2 <= 30 ? FB / 2 + 2 : 30;
+        std::int64_t x = cordic_gain;
+        std::int64_t y = 0;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            const std::int64_t sign = r >> 63; // 0 when rotating towards +, -1 otherwise
+            const std::int64_t dx = ((y >> i) ^ sign) - sign;
+            const std::int64_t dy = ((x >> i) ^ sign) - sign;
+            x -= dx;
+            y += dy;
+            r -= (cordic_atan[i] ^ sign) - sign;
+        }
+
+        // rotation by the residual angle r, to the first order: the error is r^2 / 2
+        s = y + fixed_mul_q30(x, r);
+        c = x - fixed_mul_q30(y, r);
+        if (negate_cos)
+            c = -c;
+    }
+
+    template<typename Type, size_t FB>
+    constexpr void sincos_fixed(const fixed<Type, FB> v, fixed<Type, FB>& s, fixed<Type, FB>& c) noexcept
+    {
+        static_assert(fixed<Type, FB>::is_signed && FB <= 30, "the fixed point kernels need a signed type with at most 30 fractional bits");
+        std::int64_t sq = 0;
+        std::int64_t cq = 0;
+        sincos_q30<FB>(fixed_scale<30 - int(FB)>(v.data), sq, cq);
+        s = fixed<Type, FB>{fixed<Type, FB>::from_fixed, fixed_saturate<Type>(fixed_scale<int(FB) - 30>(sq))};
+        c = fixed<Type, FB>{fixed<Type, FB>::from_fixed, fixed_saturate<Type>(fixed_scale<int(FB) - 30>(cq))};
+    }
+
+    template<typename Type, size_t FB>
+    constexpr fixed<Type, FB> sin_fixed(const fixed<Type, FB> v) noexcept
+    {
+        fixed<Type, FB> s, c;
+        sincos_fixed(v, s, c);
+        return s;
+    }
+
+    template<typename Type, size_t FB>
+    constexpr fixed<Type, FB> cos_fixed(const fixed<Type, FB> v) noexcept
+    {
+        fixed<Type, FB> s, c;
+        sincos_fixed(v, s, c);
+        return c;
+    }
+
+    /// @brief Angle of the point (x, y) in [-pi, pi] (cml::atan2 argument order)
+    template<typename Type, size_t FB>
+    constexpr fixed<Type, FB> atan2_fixed(const fixed<Type, FB> fx, const fixed<Type, FB> fy) noexcept
+    {
+        static_assert(fixed<Type, FB>::is_signed && FB <= 30, "the fixed point kernels need a signed type with at most 30 fractional bits");
+        using namespace fixed_constants;
+
+        std::int64_t x = fx.data;
+        std::int64_t y = fy.data;
+        if (x == 0 && y == 0)
+            return fixed<Type, FB>{};
+
+        // the scale does not change the angle: the biggest coordinate is brought to 2^29 for the precision of the
+        // shifts (the CORDIC gain keeps it below 2^31)
+        const int highest = fixed_highest_bit(static_cast<std::uint64_t>(x < 0 ? -x : x) | static_cast<std::uint64_t>(y < 0 ? -y : y));
+        if (highest < 29)
+        {
+            x *= std::int64_t(1) << (29 - highest);
+            y *= std::int64_t(1) << (29 - highest);
+        }
+        else
+        {
+            x >>= highest - 29;
+            y >>= highest - 29;
+        }
+
+        // to the right half plane: a rotation by pi
+        std::int64_t z = 0;
+        if (x < 0)
+        {
+            z = y >= 0 ? pi : -pi;
+            x = -x;
+            y = -y;
+        }
+
+        constexpr size_t iterations = FB / 2 + 2 <= 30 ? FB / 2 + 2 : 30;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            const std::int64_t dx = y >> i;
+            const std::int64_t dy = x >> i;
+            if (y > 0)
+            {
+                x += dx;
+                y -= dy;
+                z += cordic_atan[i];
+            }
+            else
+            {
+                x -= dx;
+                y += dy;
+                z -= cordic_atan[i];
+            }
+        }
+
+        // the residual angle is small: atan(y / x) ~ y / x
+        z += (y * one) / x;
+        return fixed<Type, FB>{fixed<Type, FB>::from_fixed, fixed_saturate<Type>(fixed_scale<int(FB) - 30>(z))};
+    }
+
+    /// @brief 2^v for v with Bits fractional bits, as a raw value with FB fractional bits (saturated)
+    template<typename Type, size_t FB, size_t Bits>
+    constexpr Type exp2_raw(std::int64_t v) noexcept
+    {
+        using namespace fixed_constants;
+
+        // v = i + f with f in [0, 1): 2^f is the product of 2^(2^-k) for the bits k of f, 2^i is a shift
+        const std::int64_t i = v >> Bits;
+        const std::int64_t f = v - i * (std::int64_t(1) << Bits);
+        constexpr std::int64_t integer_bits = std::numeric_limits<Type>::digits - std::int64_t(FB);
+        if (i >= integer_bits)
+            return std::numeric_limits<Type>::max();
+        if (i < -std::int64_t(FB) - 1)
+            return Type(0);
+
+        // the bits of f are random: a multiplication by one (masked factor) is cheaper than a mispredicted branch
+        std::int64_t m = one;
+        for (size_t k = 0; k < Bits; ++k)
+            m = fixed_mul_q30(m, one + ((exp2_bits[k] - one) & -((f >> (Bits - 1 - k)) & 1)));
+
+        // m * 2^(i + FB - 30), i + FB - 30 <= digits - 30 so there is no overflow
+        const std::int64_t shift = i + std::int64_t(FB) - 30;
+        const std::int64_t ret = shift >= 0 ? m * (std::int64_t(1) << shift) : (m + (std::int64_t(1) << (-shift - 1))) >> -shift;
+        return fixed_saturate<Type>(ret);
+    }
+
+    template<typename Type, size_t FB>
+    constexpr fixed<Type, FB> exp2_fixed(const fixed<Type, FB> v) noexcept
+    {
+        static_assert(fixed<Type, FB>::is_signed && FB <= 30, "the fixed point kernels need a signed type with at most 30 fractional bits");
+        return fixed<Type, FB>{fixed<Type, FB>::from_fixed, exp2_raw<Type, FB, FB>(v.data)};
+    }
+
+    /// @brief e^v = 2^(v * log2(e)), the product is kept with fixed_work_bits fractional bits
+    template<typename Type, size_t FB>
+    constexpr fixed<Type, FB> exp_fixed(const fixed<Type, FB> v) noexcept
+    {
+        static_assert(fixed<Type, FB>::is_signed && FB <= 30, "the fixed point kernels need a signed type with at most 30 fractional bits");
+        constexpr size_t bits = fixed_work_bits<FB>;
+        const std::int64_t t = fixed_scale<int(bits) - int(FB) - 30>(std::int64_t(v.data) * fixed_constants::log2_e);
+        return fixed<Type, FB>{fixed<Type, FB>::from_fixed, exp2_raw<Type, FB, bits>(t)};
+    }
+
+    /// @brief log2(v) for v > 0 as an integer part and a fractional part with Bits bits (rounded)
+    template<size_t FB, size_t Bits>
+    constexpr void log2_raw(std::int64_t v, std::int64_t& integer, std::int64_t& fraction) noexcept
+    {
+        using namespace fixed_constants;
+
+        // v = m * 2^highest with m in [1, 2): log2(v) = highest - FB + log2(m)
+        const int highest = fixed_highest_bit(static_cast<std::uint64_t>(v));
+        std::int64_t m = highest <= 30 ? v * (std::int64_t(1) << (30 - highest)) : v >> (highest - 30);
+        integer = highest - std::int64_t(FB);
+
+        // log2(m^2) = 2 log2(m): each squaring gives the next bit, m^2 < 4 so the bit is the one above 2^30 (no branch)
+        fraction = 0;
+        for (size_t k = 0; k <= Bits; ++k)
+        {
+            m = (m * m) >> 30;
+            const std::int64_t bit = m >> 31;
+            m >>= bit;
+            fraction = fraction * 2 + bit;
+        }
+        fraction = (fraction + 1) >> 1; // the extra bit rounds
+        if (fraction >> Bits)
+        {
+            fraction = 0;
+            integer += 1;
+        }
+    }
+
+    template<typename Type, size_t FB>
+    constexpr fixed<Type, FB> log2_fixed(const fixed<Type, FB> v) noexcept
+    {
+        static_assert(fixed<Type, FB>::is_signed && FB <= 30, "the fixed point kernels need a signed type with at most 30 fractional bits");
+        if (v.data <= 0)
+            return fixed<Type, FB>{fixed<Type, FB>::from_fixed, std::numeric_limits<Type>::min()};
+
+        std::int64_t integer = 0;
+        std::int64_t fraction = 0;
+        log2_raw<FB, FB>(v.data, integer, fraction);
+        return fixed<Type, FB>{fixed<Type, FB>::from_fixed, fixed_saturate<Type>(integer * (std::int64_t(1) << FB) + fraction)};
+    }
+
+    /// @brief ln(v) = log2(v) * ln(2), log2 is computed with fixed_work_bits fractional bits
+    template<typename Type, size_t FB>
+    constexpr fixed<Type, FB> log_fixed(const fixed<Type, FB> v) noexcept
+    {
+        static_assert(fixed<Type, FB>::is_signed && FB <= 30, "the fixed point kernels need a signed type with at most 30 fractional bits");
+        if (v.data <= 0)
+            return fixed<Type, FB>{fixed<Type, FB>::from_fixed, std::numeric_limits<Type>::min()};
+
+        constexpr size_t bits = fixed_work_bits<FB>;
+        std::int64_t integer = 0;
+        std::int64_t fraction = 0;
+        log2_raw<FB, bits>(v.data, integer, fraction);
+        const std::int64_t q30 = integer * fixed_constants::ln_2 + fixed_scale<-int(bits)>(fraction * fixed_constants::ln_2);
+        return fixed<Type, FB>{fixed<Type, FB>::from_fixed, fixed_saturate<Type>(fixed_scale<int(FB) - 30>(q30))};
+    }
+
+    /// @brief x^y = 2^(y log2(x)) for x > 0 (0 otherwise), log2(x) and the product keep fixed_work_bits fractional bits
+    template<typename Type, size_t FB>
+    constexpr fixed<Type, FB> pow_fixed(const fixed<Type, FB> x, const fixed<Type, FB> y) noexcept
+    {
+        static_assert(fixed<Type, FB>::is_signed && FB <= 30, "the fixed point kernels need a signed type with at most 30 fractional bits");
+        if (x.data <= 0)
+            return fixed<Type, FB>{fixed<Type, FB>::from_fixed, Type(0)};
+
+        constexpr size_t bits = fixed_work_bits<FB>;
+        std::int64_t integer = 0;
+        std::int64_t fraction = 0;
+        log2_raw<FB, bits>(x.data, integer, fraction);
+        // the integer part and the fraction of log2(x) are multiplied by y separately, so the products fit in 62 bits
+        const std::int64_t t = fixed_scale<int(bits) - int(FB)>(integer * y.data) + fixed_scale<-int(FB)>(fraction * y.data);
+        return fixed<Type, FB>{fixed<Type, FB>::from_fixed, exp2_raw<Type, FB, bits>(t)};
+    }
+}
@@ -0,0 +1,287 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include "../config.hpp"
+#include "../matrix.hpp"
+#include "../simd/mat4.hpp"
+#include "determinant.hpp"
+
+namespace cml
+{
+    namespace implementation
+    {
+        /// @brief v / det, floating points multiply by the reciprocal of the determinant (computed once when inlined)
+        template<typename ValueType>
+        constexpr ValueType divide_by_determinant(const ValueType v, const ValueType det)
+        {
+            if constexpr(std::is_floating_point<ValueType>::value)
+                return v * (ValueType(1) / det);
+            else
+                return v / det;
+        }
+
+        /// @brief adjugate / determinant
+        template<size_t Dim, typename ValueType, matrix_kind Kind, size_t... Idxs>
+        constexpr matrix<Dim, Dim, ValueType, Kind> inverse_from_adjugate(std::index_sequence<Idxs...>, const std::array<ValueType, Dim * Dim>& adjugate, const ValueType det)
+        {
+            return matrix<Dim, Dim, ValueType, Kind>(std::array<ValueType, Dim * Dim>{{divide_by_determinant(adjugate[Idxs], det)...}});
+        }
+
+        template<size_t Dim, typename ValueType, matrix_kind Kind>
+        constexpr matrix<Dim, Dim, ValueType, Kind> inverse_from_adjugate(const std::array<ValueType, Dim * Dim>& adjugate, const ValueType det)
+        {
+            return inverse_from_adjugate<Dim, ValueType, Kind>(std::make_index_sequence<Dim * Dim>{}, adjugate, det);
+        }
+
+        template<typename ValueType, matrix_kind Kind>
+        constexpr matrix<4, 4, ValueType, Kind> inverse_mat4(const matrix<4, 4, ValueType, Kind>& m)
+        {
+            const auto& a = m.components;
+            const mat4_minors<ValueType> mn = make_mat4_minors(m);
+            const ValueType* s = mn.s;
+            const ValueType* c = mn.c;
+            return inverse_from_adjugate<4, ValueType, Kind>(
+            {{
+                a[5] * c[5] - a[6] * c[4] + a[7] * c[3],
+                a[2] * c[4] - a[1] * c[5] - a[3] * c[3],
+                a[13] * s[5] - a[14] * s[4] + a[15] * s[3],
+                a[10] * s[4] - a[9] * s[5] - a[11] * s[3],
+
+                a[6] * c[2] - a[4] * c[5] - a[7] * c[1],
+                a[0] * c[5] - a[2] * c[2] + a[3] * c[1],
+                a[14] * s[2] - a[12] * s[5] - a[15] * s[1],
+                a[8] * s[5] - a[10] * s[2] + a[11] * s[1],
+
+                a[4] * c[4] - a[5] * c[2] + a[7] * c[0],
+                a[1] * c[2] - a[0] * c[4] - a[3] * c[0],
+                a[12] * s[4] - a[13] * s[2] + a[15] * s[0],
+                a[9] * s[2] - a[8] * s[4] - a[11] * s[0],
+
+                a[5] * c[1] - a[4] * c[3] - a[6] * c[0],
+                a[0] * c[3] - a[1] * c[1] + a[2] * c[0],
+                a[13] * s[1] - a[12] * s[3] - a[14] * s[0],
+                a[8] * s[3] - a[9] * s[1] + a[10] * s[0],
+            }}, mn.determinant());
+        }
+
+        /// @brief Gauss-Jordan elimination with partial pivoting
+        template<size_t Dim, typename ValueType, matrix_kind Kind>
+        constexpr matrix<Dim, Dim, ValueType, Kind> inverse_elimination(const matrix<Dim, Dim, ValueType, Kind>& m)
+        {
+            std::array<ValueType, Dim * Dim> a = m.components;
+            std::array<ValueType, Dim * Dim> ret = matrix<Dim, Dim, ValueType, Kind>::identity().components;
+            for (size_t k = 0; k < Dim; ++k)
+            {
+                size_t pivot = k;
+                for (size_t i = k + 1; i < Dim; ++i)
+                {
+                    const ValueType v = a[k + i * Dim] < ValueType(0) ? ValueType(0) - a[k + i * Dim] : a[k + i * Dim];
+                    const ValueType p = a[k + pivot * Dim] < ValueType(0) ? ValueType(0) - a[k + pivot * Dim] : a[k + pivot * Dim];
+                    if (p < v)
+                        pivot = i;
+                }
+                if (pivot != k)
+                {
+                    for (size_t j = 0; j < Dim; ++j)
+                    {
+                        const ValueType ta = a[j + k * Dim];
+                        a[j + k * Dim] = a[j + pivot * Dim];
+                        a[j + pivot * Dim] = ta;
+                        const ValueType tr = ret[j + k * Dim];
+                        ret[j + k * Dim] = ret[j + pivot * Dim];
+                        ret[j + pivot * Dim] = tr;
+                    }
+                }
+
+                const ValueType p = a[k + k * Dim];
+                for (size_t j = 0; j < Dim; ++j)
+                {
+                    a[j + k * Dim] = a[j + k * Dim] / p;
+                    ret[j + k * Dim] = ret[j + k * Dim] / p;
+                }
+                for (size_t i = 0; i < Dim; ++i)
+                {
+                    if (i == k)
+                        continue;
+                    const ValueType f = a[k + i * Dim];
+                    for (size_t j = 0; j < Dim; ++j)
+                    {
+                        a[j + i * Dim] = a[j + i * Dim] - f * a[j + k * Dim];
+                        ret[j + i * Dim] = ret[j + i * Dim] - f * ret[j + k * Dim];
+                    }
+                }
+            }
+            return matrix<Dim, Dim, ValueType, Kind>(ret);
+        }
+
+        /// @brief Whether a runtime SIMD kernel exists for the inverse (float mat4, normal or aligned)
+        template<typename ValueType, size_t Dim, matrix_kind Kind>
+        struct has_simd_inverse
+        {
+#ifdef CML_SIMD_SSE2
+            static constexpr bool value = std::is_same<ValueType, float>::value && Dim == 4 && (Kind == matrix_kind::normal || Kind == matrix_kind::aligned);
+#else
+            static constexpr bool value = false;
+#endif
+        };
+
+        template<typename ValueType, size_t Dim, matrix_kind Kind>
+        inline matrix<Dim, Dim, ValueType, Kind> inverse_simd(const matrix<Dim, Dim, ValueType, Kind>& m)
+        {
+            alignas(matrix_alignment<ValueType, Dim * Dim, Kind>::value) std::array<ValueType, Dim * Dim> ret; // left uninitialized, the kernel writes every component
+#ifdef CML_SIMD_SSE2
+            simd::mat4_inverse<Kind == matrix_kind::aligned>(m.components.data(), ret.data());
+#endif
+            return matrix<Dim, Dim, ValueType, Kind>(ret);
+        }
+    } // namespace implementation
+
+    /// @brief Inverse of a square matrix: closed forms (adjugate / determinant) up to 4x4, gaussian elimination for bigger
+    /// ones. The matrix must be invertible, the result is not finite otherwise (and integers/fixed points divide by 0).
+    /// At runtime the float mat4 inverse uses a SSE kernel, which can differ from the constexpr result by a few ulps.
+    template<typename ValueType, size_t DimX, size_t DimY, implementation::matrix_kind Kind>
+    constexpr implementation::matrix<DimX, DimY, ValueType, Kind> inverse(const implementation::matrix<DimX, DimY, ValueType, Kind>& m)
+    {
+        static_assert(DimX == DimY, "Only square matrices can be inverted");
+        const auto& a = m.components;
+        if constexpr(DimX == 1)
+        {
+            return implementation::inverse_from_adjugate<1, ValueType, Kind>({{ValueType(1)}}, a[0]);
+        }
+        else if constexpr(DimX == 2)
+        {
+            return implementation::inverse_from_adjugate<2, ValueType, Kind>({{a[3], ValueType(0) - a[1], ValueType(0) - a[2], a[0]}}, determinant(m));
+        }
+        else if constexpr(DimX == 3)
+        {
+            const ValueType c0 = a[4] * a[8] - a[5] * a[7];
+            const ValueType c1 = a[5] * a[6] - a[3] * a[8];
+            const ValueType c2 = a[3] * a[7] - a[4] * a[6];
+            return implementation::inverse_from_adjugate<3, ValueType, Kind>(
+            {{
+                c0, a[2] * a[7] - a[1] * a[8], a[1] * a[5] - a[2] * a[4],
+                c1, a[0] * a[8] - a[2] * a[6], a[2] * a[3] - a[0] * a[5],
+                c2, a[1] * a[6] - a[0] * a[7], a[0] * a[4] - a[1] * a[3],
+            }}, a[0] * c0 + a[1] * c1 + a[2] * c2);
+        }
+        else if constexpr(DimX == 4)
+        {
+            if constexpr(implementation::has_simd_inverse<ValueType, DimX, Kind>::value)
+            {
+                if (!implementation::is_constant_evaluated())
+                    return implementation::inverse_simd(m);
+            }
+            return implementation::inverse_mat4(m);
+        }
+        else
+        {
+            return implementation::inverse_elimination(m);
+        }
+    }
+
+    /// @brief Inverse of an affine transform, for matrices applied as v * m (the cml convention) whose last column is
+    /// (0, ..., 0, 1): | A  0 |^-1 = | inverse(A)       0 |
+    ///                 | t  1 |      | -t * inverse(A)  1 |
+    /// Only the upper left block is inverted. The last column is not checked.
+    template<typename ValueType, size_t DimX, size_t DimY, implementation::matrix_kind Kind>
+    constexpr implementation::matrix<DimX, DimY, ValueType, Kind> inverse_affine(const implementation::matrix<DimX, DimY, ValueType, Kind>& m)
+    {
+        static_assert(DimX == DimY && DimX >= 2, "Only square matrices can be affine transforms");
+        constexpr size_t dim = DimX - 1;
+        const auto& a = m.components;
+
+        if constexpr(DimX == 4)
+        {
+            const ValueType c0 = a[5] * a[10] - a[6] * a[9];
+            const ValueType c1 = a[6] * a[8] - a[4] * a[10];
+            const ValueType c2 = a[4] * a[9] - a[5] * a[8];
+            const ValueType det = a[0] * c0 + a[1] * c1 + a[2] * c2;
+            const ValueType i[9] =
+            {
+                implementation::divide_by_determinant(c0, det),
+                implementation::divide_by_determinant(a[2] * a[9] - a[1] * a[10], det),
+                implementation::divide_by_determinant(a[1] * a[6] - a[2] * a[5], det),
+                implementation::divide_by_determinant(c1, det),
+                implementation::divide_by_determinant(a[0] * a[10] - a[2] * a[8], det),
+                implementation::divide_by_determinant(a[2] * a[4] - a[0] * a[6], det),
+                implementation::divide_by_determinant(c2, det),
+                implementation::divide_by_determinant(a[1] * a[8] - a[0] * a[9], det),
+                implementation::divide_by_determinant(a[0] * a[5] - a[1] * a[4], det),
+            };
+            return implementation::matrix<4, 4, ValueType, Kind>
+            {
+                i[0], i[1], i[2], ValueType(0),
+                i[3], i[4], i[5], ValueType(0),
+                i[6], i[7], i[8], ValueType(0),
+                ValueType(0) - (a[12] * i[0] + a[13] * i[3] + a[14] * i[6]),
+                ValueType(0) - (a[12] * i[1] + a[13] * i[4] + a[14] * i[7]),
+                ValueType(0) - (a[12] * i[2] + a[13] * i[5] + a[14] * i[8]),
+                ValueType(1),
+            };
+        }
+        else
+        {
+            std::array<ValueType, dim * dim> block{};
+            for (size_t y = 0; y < dim; ++y)
+            {
+                for (size_t x = 0; x < dim; ++x)
+                    block[x + y * dim] = a[x + y * DimX];
+            }
+            const std::array<ValueType, dim * dim> inv = inverse(implementation::matrix<dim, dim, ValueType, Kind>(block)).components;
+
+            std::array<ValueType, DimX * DimY> ret{};
+            for (size_t y = 0; y < dim; ++y)
+            {
+                for (size_t x = 0; x < dim; ++x)
+                    ret[x + y * DimX] = inv[x + y * dim];
+            }
+            for (size_t x = 0; x < dim; ++x)
+            {
+                ValueType t = ValueType(0);
+                for (size_t k = 0; k < dim; ++k)
+                    t = t - a[k + dim * DimX] * inv[x + k * dim];
+                ret[x + dim * DimX] = t;
+            }
+            ret[DimX * DimY - 1] = ValueType(1);
+            return implementation::matrix<DimX, DimY, ValueType, Kind>(ret);
+        }
+    }
+} // namespace cml
+
+#ifdef CML_COMPILE_TEST_CASE
+
+#include "../definitions.hpp"
+#include "../operators.hpp"
+
+static_assert(cml::inverse(cml::dmat2(4, 2, 2, 3)) == cml::dmat2(0.375, -0.25, -0.25, 0.5));
+static_assert(cml::inverse(cml::dmat3(2, 1, 0, 1, 1, 1, 0, 2, 2)) == cml::dmat3(0, 1, -0.5, 1, -2, 1, -1, 2, -0.5));
+static_assert(cml::inverse(cml::dmat4(2, 0, 0, 0, 0, 4, 0, 0, 0, 0, 8, 0, 1, 2, 3, 1)) == cml::dmat4(0.5, 0, 0, 0, 0, 0.25, 0, 0, 0, 0, 0.125, 0, -0.5, -0.5, -0.375, 1));
+static_assert(cml::inverse_affine(cml::dmat4(2, 0, 0, 0, 0, 4, 0, 0, 0, 0, 8, 0, 1, 2, 3, 1)) == cml::dmat4(0.5, 0, 0, 0, 0, 0.25, 0, 0, 0, 0, 0.125, 0, -0.5, -0.5, -0.375, 1));
+static_assert(cml::inverse_affine(cml::dmat3(0, 2, 0, -4, 0, 0, 1, 2, 1)) == cml::dmat3(0, -0.25, 0, 0.5, 0, 0, -1, 0.25, 1));
+static_assert(cml::inverse(cml::dmat<5, 5>(2, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0.5, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 8)) == cml::dmat<5, 5>(0.5, 0, 0, 0, 0, 0, 0.25, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0.125));
+
+#endif
@@ -51,6 +51,12 @@ namespace cml
         constexpr size_t dim = (DimX == 1 ? DimY : DimX);
         return length_impl(std::make_index_sequence<dim>{}, v);
     }
+
+    template<typename MatrixType, size_t... Idxs>
+    constexpr auto length(const implementation::swizzle<MatrixType, Idxs...>& v)
+    {
+        return length(v.eval());
+    }
 }
 
 
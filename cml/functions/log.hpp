@@ -24,6 +24,8 @@
 
 #include "exp.hpp"
 
+#include <limits>
+
 namespace cml
 {
     namespace implementation
@@ -34,40 +36,69 @@ namespace cml
             return y + ValueType{2} * (x - exp(y)) / (x + exp(y));
         }
 
+        /// @brief Each iteration moves y by less than 2 until it gets close to log(x), the iterations stop after
+        /// max_exponent + 64 of them (enough to start from 0 for any value of the type)
         template<typename ValueType>
-        constexpr auto log_helper(const ValueType x, const ValueType y) -> ValueType
+        constexpr auto log_helper(const ValueType x, ValueType y) -> ValueType
         {
-            return is_equal(y, log_iter(x, y)) ? y : log_helper(x, log_iter(x, y));
+            constexpr int max_iterations = std::numeric_limits<ValueType>::max_exponent + 64;
+            for (int i = 0; i < max_iterations; ++i)
+            {
+                const ValueType next = log_iter(x, y);
+                if (is_equal(y, next))
+                    break;
+                y = next;
+            }
+            return y;
         }
+    }
 
-        template<typename ValueType>
-        constexpr ValueType log_e = static_cast<ValueType>(2.71828182845904523536l);
-
-        template<typename ValueType>
-        constexpr auto log_gt(const ValueType v) -> ValueType
-        {
-            auto e = log_e<ValueType>;
-            return v > static_cast<ValueType>(0.25) ? log_helper(v, ValueType{0}) : log_gt(v * e * e * e * e * e) - ValueType{5};
-        }
+    /// @brief Newton iterations on log(x) starting from y, y should be close to log(x)
+    template<typename ValueType>
+    constexpr auto log(const ValueType x, const ValueType y) -> ValueType
+    {
+        return implementation::log_helper(x, y);
+    }
 
-        template<typename ValueType>
-        constexpr auto log_lt(const ValueType v) -> ValueType
+    /// @brief Natural logarithm, from the exponent and a series on the mantissa (see exp_log_kernel.hpp): NaN for v < 0
+    /// and -inf for 0. Fixed points use an integer only kernel (see fixed_kernel.hpp), they return the lowest value for
+    /// v <= 0
+    template<typename ValueType>
+    constexpr auto log(const ValueType v) -> ValueType
+    {
+        if constexpr(is_fixed_point<ValueType>::value)
+            return implementation::log_fixed(v);
+        else
         {
-            auto e = log_e<ValueType>;
-            return v < ValueType{1024} ? log_helper(v, ValueType{0}) : log_lt(v / (e * e * e * e * e)) + ValueType{5};
+            using kernel_type = typename implementation::exp_log_kernel_type<ValueType>::type;
+            return static_cast<ValueType>(implementation::log_kernel(static_cast<kernel_type>(v)));
         }
     }
 
+    /// @brief Base 2 logarithm
     template<typename ValueType>
-    constexpr auto log(const ValueType x, const ValueType y) -> ValueType
+    constexpr auto log2(const ValueType v) -> ValueType
     {
-        return implementation::log_helper(x, y);
+        if constexpr(is_fixed_point<ValueType>::value)
+            return implementation::log2_fixed(v);
+        else
+        {
+            using kernel_type = typename implementation::exp_log_kernel_type<ValueType>::type;
+            return static_cast<ValueType>(implementation::log2_kernel(static_cast<kernel_type>(v)));
+        }
     }
 
+    /// @brief log(1 + v), precise for v close to 0
     template<typename ValueType>
-    constexpr auto log(const ValueType v) -> ValueType
+    constexpr auto log1p(const ValueType v) -> ValueType
     {
-        return v >= ValueType{1024} ? implementation::log_lt(v) : implementation::log_gt(v);
+        if constexpr(is_fixed_point<ValueType>::value)
+            return implementation::log_fixed(ValueType(1) + v);
+        else
+        {
+            using kernel_type = typename implementation::exp_log_kernel_type<ValueType>::type;
+            return static_cast<ValueType>(implementation::log1p_kernel(static_cast<kernel_type>(v)));
+        }
     }
 }
 
@@ -80,5 +111,19 @@ static_assert(cml::is_equal(1.0f, cml::log(cml::exp(1.0f))), "log(ef)");
 static_assert(cml::is_equal(1.0,  cml::log(cml::exp(1.0))), "log(e)");
 static_assert(cml::is_equal(1.0l, cml::log(cml::exp(1.0l))), "log(el)");
 static_assert(cml::is_equal(0.0,  cml::log(1)), "log(1)");
+static_assert(cml::is_equal(3.0,  cml::log2(8.0)), "log2(8.0)");
+static_assert(cml::is_equal(cml::log(1e300), cml::log(1e300, 0.0)), "newton iterations from far away");
+static_assert(cml::log2(1024.0) == 10.0, "log2(1024.0) is exact");
+static_assert(cml::log2(std::numeric_limits<double>::denorm_min()) == -1074.0, "log2 of a subnormal");
+static_assert(cml::log(0.0) == -std::numeric_limits<double>::infinity(), "log(0)");
+static_assert(cml::log(-1.0) != cml::log(-1.0), "log(-1) is NaN");
+static_assert(cml::log1p(1e-10) < 1e-10 && cml::log1p(1e-10) > 0.9999999999e-10, "log1p(1e-10)");
+static_assert(cml::is_equal(0.6931471805599453094l, cml::log1p(1.0l)), "log1p(1.0l)");
+
+static_assert(cml::log2(cml::fixed<int32_t, 16>(8)) == cml::fixed<int32_t, 16>(3), "log2(f1616(8))");
+static_assert(cml::log2(cml::fixed<int32_t, 16>(0.25)) == cml::fixed<int32_t, 16>(-2), "log2(f1616(0.25))");
+static_assert(cml::log(cml::fixed<int32_t, 16>(1)) == cml::fixed<int32_t, 16>(0), "log(f1616(1))");
+static_assert(cml::log(cml::fixed<int32_t, 16>(10)).data == 150902, "log(f1616(10))");
+static_assert(cml::log(cml::fixed<int32_t, 16>(0)).data == std::numeric_limits<int32_t>::min(), "log(0)");
 
 #endif
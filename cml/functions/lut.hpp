@@ -0,0 +1,291 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include "../config.hpp"
+#include "../definitions.hpp"
+#include "../fixed_point.hpp"
+#include "../matrix.hpp"
+#include "../span.hpp"
+#include "../tau.hpp"
+#include "sin.hpp"
+
+#ifdef CML_SIMD_AVX2
+#include <immintrin.h>
+#endif
+
+// Table driven sin / cos: a sine table of Size entries over a full turn (power of two), linearly interpolated. The
+// tables are variables built by the constexpr cml::sin, so they are in the binary and there is nothing to do at startup.
+// cos reads the same table a quarter of a turn further.
+//
+// The interpolation error is at most (2pi / Size)^2 / 8 (the chord of a curve whose second derivative is <= 1), plus one
+// unit of the table type (fixed point entries are truncated, and the interpolation rounds):
+//   Size    interpolation   float table
+//    256    7.5e-5          7.5e-5
+//   1024    4.7e-6          4.8e-6
+//   4096    2.9e-7          4.1e-7
+//  16384    1.8e-8          1.4e-7
+// lut_error_bound<Size, TableType> gives that bound. The angle itself is rounded in its own type when it is converted to
+// table steps: add |v| * epsilon of the angle type for big angles.
+namespace cml
+{
+    namespace implementation
+    {
+        template<size_t Size, typename TableType>
+        constexpr auto make_lut_sin_table() -> std::array<TableType, Size + 1>
+        {
+            std::array<TableType, Size + 1> table{};
+            for (size_t i = 0; i <= Size; ++i)
+            {
+                // angles in [-pi, pi], where the series is the most precise
+                const double turn = (i <= Size / 2 ? double(i) : double(i) - double(Size)) / double(Size);
+                table[i] = static_cast<TableType>(cml::sin(radian<double>(turn * tau<double>)));
+            }
+            return table;
+        }
+
+        /// @brief sin(i * 2pi / Size) for i in [0, Size], the last entry repeats the first one for the interpolation
+        template<size_t Size, typename TableType>
+        inline constexpr std::array<TableType, Size + 1> lut_sin_table = make_lut_sin_table<Size, TableType>();
+
+        /// @brief One unit of the table type around 1
+        template<typename TableType>
+        constexpr double lut_rounding_error() noexcept
+        {
+            if constexpr(is_fixed_point<TableType>::value)
+                return 1.0 / double(std::uint64_t(1) << TableType::fractional_bits);
+            else
+                return double(std::numeric_limits<TableType>::epsilon());
+        }
+
+        /// @brief Position of an angle in the table: the entry before it and the fraction of the step to the next one
+        template<size_t Size, typename ValueType, angle_kind AK>
+        constexpr void lut_position(const ValueType v, size_t& index, ValueType& fraction) noexcept
+        {
+            static_assert(Size >= 4 && (Size & (Size - 1)) == 0, "the table size must be a power of two");
+            static_assert(std::is_floating_point<ValueType>::value, "the trig tables need a floating point angle");
+
+            // table steps per angle unit
+            constexpr ValueType steps = static_cast<ValueType>(static_cast<long double>(Size) * angle_convert_factor<long double, AK, angle_kind::radian>::factor / tau<long double>);
+            const ValueType t = v * steps;
+
+            // floor without a branch, the index wraps to the table by the mask
+            std::int64_t i = static_cast<std::int64_t>(t);
+            i -= t < static_cast<ValueType>(i);
+            fraction = t - static_cast<ValueType>(i);
+            index = static_cast<size_t>(i) & (Size - 1);
+        }
+
+        /// @brief Interpolated table value Offset entries after index (0 for sin, Size / 4 for cos)
+        template<size_t Size, typename TableType, size_t Offset, typename ValueType>
+        constexpr auto lut_interpolate(const size_t index, const ValueType fraction) noexcept -> ValueType
+        {
+            const auto& table = lut_sin_table<Size, TableType>;
+            const size_t i = (index + Offset) & (Size - 1);
+            const ValueType a = static_cast<ValueType>(table[i]);
+            const ValueType b = static_cast<ValueType>(table[i + 1]);
+            return a + fraction * (b - a);
+        }
+
+        /// @brief sin and cos from a single position in the table
+        template<size_t Size, typename TableType, typename ValueType, angle_kind AK>
+        constexpr void lut_sincos_raw(const ValueType v, ValueType& s, ValueType& c) noexcept
+        {
+            size_t index = 0;
+            ValueType fraction = 0;
+            lut_position<Size, ValueType, AK>(v, index, fraction);
+            s = lut_interpolate<Size, TableType, 0>(index, fraction);
+            c = lut_interpolate<Size, TableType, Size / 4>(index, fraction);
+        }
+
+        /// @brief Batched table lookups, Sin / Cos select the outputs. With avx2, float angles and float tables use
+        /// gathers on 8 angles at a time (the results can differ from the scalar ones by the contraction of the
+        /// interpolation into an fma).
+        template<size_t Size, typename TableType, typename ValueType, angle_kind AK, bool Sin, bool Cos>
+        inline void lut_batch(const ValueType* v, ValueType* s, ValueType* c, size_t count) noexcept
+        {
+            size_t i = 0;
+#ifdef CML_SIMD_AVX2
+            if constexpr(std::is_same<ValueType, float>::value && std::is_same<TableType, float>::value)
+            {
+                constexpr float steps = static_cast<float>(static_cast<long double>(Size) * angle_convert_factor<long double, AK, angle_kind::radian>::factor / tau<long double>);
+                const float* table = lut_sin_table<Size, float>.data();
+                const __m256 step = _mm256_set1_ps(steps);
+                const __m256 limit = _mm256_set1_ps(0x1p31f);
+                const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+                const __m256i mask = _mm256_set1_epi32(int(Size - 1));
+                const auto interpolate = [&](__m256i index, __m256 fraction)
+                {
+                    const __m256 a = _mm256_i32gather_ps(table, index, 4);
+                    const __m256 b = _mm256_i32gather_ps(table + 1, index, 4);
+                    return _mm256_add_ps(a, _mm256_mul_ps(fraction, _mm256_sub_ps(b, a)));
+                };
+
+                for (; i + 8 <= count; i += 8)
+                {
+                    const __m256 t = _mm256_mul_ps(_mm256_loadu_ps(v + i), step);
+
+                    // the 32 bit indices need |t| < 2^31, bigger angles are rare: the group goes through the scalar code
+                    if (_mm256_movemask_ps(_mm256_cmp_ps(_mm256_and_ps(t, abs_mask), limit, _CMP_GE_OQ)) != 0)
+                    {
+                        for (size_t j = i; j < i + 8; ++j)
+                        {
+                            ValueType sj = 0;
+                            ValueType cj = 0;
+                            lut_sincos_raw<Size, TableType, ValueType, AK>(v[j], sj, cj);
+                            if constexpr(Sin) s[j] = sj;
+                            if constexpr(Cos) c[j] = cj;
+                        }
+                        continue;
+                    }
+
+                    const __m256 floor = _mm256_floor_ps(t);
+                    const __m256 fraction = _mm256_sub_ps(t, floor);
+                    const __m256i index = _mm256_and_si256(_mm256_cvttps_epi32(floor), mask);
+                    if constexpr(Sin)
+                        _mm256_storeu_ps(s + i, interpolate(index, fraction));
+                    if constexpr(Cos)
+                        _mm256_storeu_ps(c + i, interpolate(_mm256_and_si256(_mm256_add_epi32(index, _mm256_set1_epi32(int(Size / 4))), mask), fraction));
+                }
+            }
+#endif
+            for (; i < count; ++i)
+            {
+                size_t index = 0;
+                ValueType fraction = 0;
+                lut_position<Size, ValueType, AK>(v[i], index, fraction);
+                if constexpr(Sin) s[i] = lut_interpolate<Size, TableType, 0>(index, fraction);
+                if constexpr(Cos) c[i] = lut_interpolate<Size, TableType, Size / 4>(index, fraction);
+            }
+        }
+    }
+
+    /// @brief Maximal error of lut_sin / lut_cos / lut_sincos with a table of Size entries of TableType
+    template<size_t Size, typename TableType = float>
+    inline constexpr double lut_error_bound = (tau<double> / double(Size)) * (tau<double> / double(Size)) / 8 + implementation::lut_rounding_error<TableType>();
+
+    /// @brief Table driven sine, see lut_error_bound for the precision. Size and TableType select the table:
+    /// cml::lut_sin<4096>(a), cml::lut_sin<256, cml::f0824>(a)
+    template<size_t Size = 1024, typename TableType = float, typename ValueType, implementation::angle_kind AK>
+    constexpr auto lut_sin(const implementation::angle<ValueType, AK> v) -> ValueType
+    {
+        size_t index = 0;
+        ValueType fraction = 0;
+        implementation::lut_position<Size, ValueType, AK>(static_cast<ValueType>(v), index, fraction);
+        return implementation::lut_interpolate<Size, TableType, 0>(index, fraction);
+    }
+
+    /// @brief Table driven cosine, see lut_sin
+    template<size_t Size = 1024, typename TableType = float, typename ValueType, implementation::angle_kind AK>
+    constexpr auto lut_cos(const implementation::angle<ValueType, AK> v) -> ValueType
+    {
+        size_t index = 0;
+        ValueType fraction = 0;
+        implementation::lut_position<Size, ValueType, AK>(static_cast<ValueType>(v), index, fraction);
+        return implementation::lut_interpolate<Size, TableType, Size / 4>(index, fraction);
+    }
+
+    /// @brief Table driven sincos, x = lut_sin(v) and y = lut_cos(v)
+    template<size_t Size = 1024, typename TableType = float, typename ValueType, implementation::angle_kind AK>
+    constexpr auto lut_sincos(const implementation::angle<ValueType, AK> v) -> vector<2, ValueType>
+    {
+        ValueType s = 0;
+        ValueType c = 0;
+        implementation::lut_sincos_raw<Size, TableType, ValueType, AK>(static_cast<ValueType>(v), s, c);
+        return vector<2, ValueType>(s, c);
+    }
+
+    /// @brief Batched lut_sin: out[i] = lut_sin(angles[i])
+    template<size_t Size = 1024, typename TableType = float, typename ValueType, implementation::angle_kind AK>
+    void lut_sin(span<const implementation::angle<ValueType, AK>> angles, span<ValueType> out)
+    {
+        if (out.size() < angles.size())
+            throw std::runtime_error("lut_sin output is smaller than the input");
+        using angle_type = implementation::angle<ValueType, AK>;
+        static_assert(sizeof(angle_type) == sizeof(ValueType), "an angle must be layout compatible with its value");
+        implementation::lut_batch<Size, TableType, ValueType, AK, true, false>(reinterpret_cast<const ValueType*>(angles.data()), out.data(), nullptr, angles.size());
+    }
+
+    /// @brief Batched lut_cos: out[i] = lut_cos(angles[i])
+    template<size_t Size = 1024, typename TableType = float, typename ValueType, implementation::angle_kind AK>
+    void lut_cos(span<const implementation::angle<ValueType, AK>> angles, span<ValueType> out)
+    {
+        if (out.size() < angles.size())
+            throw std::runtime_error("lut_cos output is smaller than the input");
+        using angle_type = implementation::angle<ValueType, AK>;
+        static_assert(sizeof(angle_type) == sizeof(ValueType), "an angle must be layout compatible with its value");
+        implementation::lut_batch<Size, TableType, ValueType, AK, false, true>(reinterpret_cast<const ValueType*>(angles.data()), nullptr, out.data(), angles.size());
+    }
+
+    /// @brief Batched lut_sincos: sin_out[i] = lut_sin(angles[i]) and cos_out[i] = lut_cos(angles[i])
+    template<size_t Size = 1024, typename TableType = float, typename ValueType, implementation::angle_kind AK>
+    void lut_sincos(span<const implementation::angle<ValueType, AK>> angles, span<ValueType> sin_out, span<ValueType> cos_out)
+    {
+        if (sin_out.size() < angles.size() || cos_out.size() < angles.size())
+            throw std::runtime_error("lut_sincos output is smaller than the input");
+        using angle_type = implementation::angle<ValueType, AK>;
+        static_assert(sizeof(angle_type) == sizeof(ValueType), "an angle must be layout compatible with its value");
+        implementation::lut_batch<Size, TableType, ValueType, AK, true, true>(reinterpret_cast<const ValueType*>(angles.data()), sin_out.data(), cos_out.data(), angles.size());
+    }
+
+    template<size_t Size = 1024, typename TableType = float, typename ValueType, implementation::angle_kind AK>
+    void lut_sin(span<implementation::angle<ValueType, AK>> angles, span<ValueType> out)
+    {
+        lut_sin<Size, TableType>(span<const implementation::angle<ValueType, AK>>(angles), out);
+    }
+
+    template<size_t Size = 1024, typename TableType = float, typename ValueType, implementation::angle_kind AK>
+    void lut_cos(span<implementation::angle<ValueType, AK>> angles, span<ValueType> out)
+    {
+        lut_cos<Size, TableType>(span<const implementation::angle<ValueType, AK>>(angles), out);
+    }
+
+    template<size_t Size = 1024, typename TableType = float, typename ValueType, implementation::angle_kind AK>
+    void lut_sincos(span<implementation::angle<ValueType, AK>> angles, span<ValueType> sin_out, span<ValueType> cos_out)
+    {
+        lut_sincos<Size, TableType>(span<const implementation::angle<ValueType, AK>>(angles), sin_out, cos_out);
+    }
+}
+
+#ifdef CML_COMPILE_TEST_CASE
+
+#include "../operators.hpp"
+
+// the table entries at the quarters of a turn are exact, and so are the interpolations at the entries
+static_assert(cml::lut_sin<256>(cml::radian<float>(0)) == 0.f, "lut_sin(0)");
+static_assert(cml::lut_cos<256>(cml::radian<float>(0)) == 1.f, "lut_cos(0)");
+static_assert(cml::lut_sin<256>(cml::degree<double>(90)) == 1.0, "lut_sin(90deg)");
+static_assert(cml::lut_cos<256, double>(cml::degree<double>(-180)) == -1.0, "lut_cos(-180deg)");
+static_assert(cml::lut_sin<64, cml::f0824>(cml::degree<double>(270)) == -1.0, "lut_sin(270deg), fixed point table");
+
+// sin(1) == 0.8414709848078965
+static_assert(cml::abs(cml::lut_sin<4096, double>(cml::radian<double>(1)) - 0.8414709848078965) <= cml::lut_error_bound<4096, double>, "lut_sin(1)");
+// cos(1) == 0.5403023058681397
+static_assert(cml::abs(cml::lut_sincos<1024>(cml::radian<float>(1)).components[1] - 0.5403023f) <= float(cml::lut_error_bound<1024>), "lut_sincos(1).y");
+
+#endif
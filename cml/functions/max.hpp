@@ -59,7 +59,12 @@ namespace cml
     template<typename ValueType1, typename ValueType2, typename... Args>
     constexpr auto max(const ValueType1& v1, const ValueType2& v2, Args&&... args) -> auto
     {
-        if constexpr(is_matrix<ValueType1>::value)
+        if constexpr(implementation::any_swizzle<ValueType1, ValueType2>::value)
+        {
+            // swizzles: as vectors
+            return max(implementation::swizzle_operand(v1), implementation::swizzle_operand(v2), std::forward<Args>(args)...);
+        }
+        else if constexpr(is_matrix<ValueType1>::value)
         {
             if constexpr(std::is_same<ValueType1, ValueType2>::value)
                 return implementation::mm_max(std::make_index_sequence<matrix_traits<ValueType1>::components>{}, v1, v2, std::forward<Args>(args)...);
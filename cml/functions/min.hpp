@@ -25,6 +25,7 @@
 #include <type_traits>
 #include <utility>
 
+#include "../swizzle.hpp"
 #include "../traits.hpp"
 
 namespace cml
@@ -60,7 +61,12 @@ namespace cml
     constexpr auto min(const ValueType1& v1, const ValueType2& v2, Args&&... args) -> auto
     {
         // lazy-man SFINAE / function deduction
-        if constexpr(is_matrix<ValueType1>::value)
+        if constexpr(implementation::any_swizzle<ValueType1, ValueType2>::value)
+        {
+            // swizzles: as vectors
+            return min(implementation::swizzle_operand(v1), implementation::swizzle_operand(v2), std::forward<Args>(args)...);
+        }
+        else if constexpr(is_matrix<ValueType1>::value)
         {
             if constexpr(std::is_same<ValueType1, ValueType2>::value)
                 return implementation::mm_min(std::make_index_sequence<matrix_traits<ValueType1>::components>{}, v1, v2, std::forward<Args>(args)...);
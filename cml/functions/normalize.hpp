@@ -22,9 +22,14 @@
 
 #pragma once
 
+#include <algorithm>
+#include <stdexcept>
 #include "../matrix.hpp"
+#include "../span.hpp"
 #include "../traits.hpp"
+#include "dot.hpp"
 #include "length.hpp"
+#include "rsqrt.hpp"
 
 namespace cml
 {
@@ -34,6 +39,55 @@ namespace cml
         static_assert(is_vector<implementation::matrix<DimX, DimY, ValueType, Kind>>::value, "Can only normalize a vector.");
         return v * (ValueType(1) / length(v));
     }
+
+    /// @brief A swizzle is normalized as a vector, its parent is not modified
+    template<typename MatrixType, size_t... Idxs>
+    constexpr auto normalize(const implementation::swizzle<MatrixType, Idxs...>& v)
+    {
+        return normalize(v.eval());
+    }
+
+    /// @brief Approximate normalize, v * rsqrt(dot(v, v)): relative error < 2^-21 for float and double (see rsqrt.hpp)
+    template<size_t DimX, size_t DimY, typename ValueType, implementation::matrix_kind Kind>
+    constexpr implementation::matrix<DimX, DimY, ValueType, Kind> normalize_fast(const implementation::matrix<DimX, DimY, ValueType, Kind>& v)
+    {
+        static_assert(is_vector<implementation::matrix<DimX, DimY, ValueType, Kind>>::value, "Can only normalize a vector.");
+        return v * rsqrt(dot(v, v));
+    }
+
+    template<typename MatrixType, size_t... Idxs>
+    constexpr auto normalize_fast(const implementation::swizzle<MatrixType, Idxs...>& v)
+    {
+        return normalize_fast(v.eval());
+    }
+
+    /// @brief Batched normalize_fast: out[i] = normalize_fast(vectors[i]), the rsqrt of the squared lengths are computed
+    /// a register at a time
+    template<size_t DimX, size_t DimY, typename ValueType, implementation::matrix_kind Kind>
+    void normalize_fast(span<const implementation::matrix<DimX, DimY, ValueType, Kind>> vectors, span<implementation::matrix<DimX, DimY, ValueType, Kind>> out)
+    {
+        static_assert(is_vector<implementation::matrix<DimX, DimY, ValueType, Kind>>::value, "Can only normalize a vector.");
+        if (out.size() < vectors.size())
+            throw std::runtime_error("normalize_fast output is smaller than the input");
+
+        constexpr size_t block_size = 64;
+        ValueType factors[block_size];
+        for (size_t i = 0; i < vectors.size(); i += block_size)
+        {
+            const size_t count = std::min(block_size, vectors.size() - i);
+            for (size_t j = 0; j < count; ++j)
+                factors[j] = dot(vectors[i + j], vectors[i + j]);
+            rsqrt(span<const ValueType>(factors, count), span<ValueType>(factors, count));
+            for (size_t j = 0; j < count; ++j)
+                out[i + j] = vectors[i + j] * factors[j];
+        }
+    }
+
+    template<size_t DimX, size_t DimY, typename ValueType, implementation::matrix_kind Kind>
+    void normalize_fast(span<implementation::matrix<DimX, DimY, ValueType, Kind>> vectors, span<implementation::matrix<DimX, DimY, ValueType, Kind>> out)
+    {
+        normalize_fast(span<const implementation::matrix<DimX, DimY, ValueType, Kind>>(vectors), out);
+    }
 }
 
 #ifdef CML_COMPILE_TEST_CASE
@@ -41,5 +95,7 @@ namespace cml
 #include "../definitions.hpp"
 
 static_assert(cml::is_equal<2>(cml::length(cml::normalize(cml::vec3(1, 2, 3))), 1.0f));
+static_assert(cml::is_equal<2>(cml::length(cml::normalize_fast(cml::vec3(1, 2, 3))), 1.0f));
+static_assert(cml::normalize_fast(cml::f1616vec2(cml::f1616(3), cml::f1616(4))) == cml::f1616vec2(cml::f1616(0.6f), cml::f1616(0.8f)));
 
 #endif
@@ -21,15 +21,161 @@
 //
 
 #pragma once
+
 #include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "../fixed_point.hpp"
+#include "../matrix.hpp"
+#include "exp_log_kernel.hpp"
+#include "fixed_kernel.hpp"
 
 namespace cml
 {
-    template<typename ValueType>
-    constexpr auto pow(const ValueType& value, const std::uint32_t & exp) -> ValueType
+    template<typename ValueType, typename ExponentType>
+    constexpr auto pow(const ValueType& value, const ExponentType& exponent) -> ValueType;
+    template<std::int64_t Exponent, typename ValueType>
+    constexpr auto pow(const ValueType& value) -> ValueType;
+
+    namespace implementation
     {
-        return exp > 0 ? value * pow(value, exp - 1u) : ValueType{1};
+        /// @brief value^n by squaring: log2(n) squarings and as many products
+        template<typename ValueType, typename UnsignedType>
+        constexpr auto pow_unsigned(ValueType value, UnsignedType n) -> ValueType
+        {
+            ValueType ret{1};
+            while (true)
+            {
+                if (n & 1u)
+                    ret = ret * value;
+                n >>= 1;
+                if (n == 0)
+                    return ret;
+                value = value * value;
+            }
+        }
+
+        template<typename ValueType, typename ExponentType>
+        constexpr auto pow_integer(const ValueType& value, const ExponentType exponent) -> ValueType
+        {
+            using unsigned_type = std::make_unsigned_t<ExponentType>;
+            const unsigned_type n = exponent < 0 ? unsigned_type(0) - static_cast<unsigned_type>(exponent) : static_cast<unsigned_type>(exponent);
+            if (exponent >= 0)
+                return pow_unsigned(value, n);
+
+            if constexpr(std::is_floating_point<ValueType>::value)
+            {
+                // the powers of |value| > 1 can overflow before their reciprocal is taken (losing the subnormal
+                // results), the reciprocal is then taken first. The powers of |value| < 1 can underflow to 0 instead.
+                if (value > ValueType{1} || value < ValueType{-1})
+                    return pow_unsigned(ValueType{1} / value, n);
+                const ValueType ret = pow_unsigned(value, n);
+                if (ret == ValueType{0})
+                    return value < ValueType{0} && (n & 1u) ? -std::numeric_limits<ValueType>::infinity() : std::numeric_limits<ValueType>::infinity();
+                return ValueType{1} / ret;
+            }
+            else
+                return ValueType{1} / pow_unsigned(value, n);
+        }
+
+        /// @brief Fixed points exponents that are integers use the exact integer powers
+        template<typename ValueType>
+        constexpr auto pow_fixed_exponent(const ValueType& value, const ValueType& exponent) -> ValueType
+        {
+            constexpr typename ValueType::value_type fraction_mask = (typename ValueType::value_type(1) << ValueType::fractional_bits) - 1;
+            if ((exponent.data & fraction_mask) == 0)
+                return pow_integer(value, static_cast<std::int64_t>(exponent.data >> ValueType::fractional_bits));
+            return pow_fixed(value, exponent);
+        }
+
+        template<typename MatrixType, typename ExponentType, size_t... Idxs>
+        constexpr auto matrix_pow(std::index_sequence<Idxs...>, const MatrixType& value, const ExponentType& exponent) -> MatrixType
+        {
+            return MatrixType{pow(value.components[Idxs], exponent)...};
+        }
+
+        template<std::int64_t Exponent, typename MatrixType, size_t... Idxs>
+        constexpr auto matrix_pow(std::index_sequence<Idxs...>, const MatrixType& value) -> MatrixType
+        {
+            return MatrixType{pow<Exponent>(value.components[Idxs])...};
+        }
+    }
+
+    /// @brief value^exponent, component wise for the matrices and vectors.
+    ///  - integer exponents (signed or not) are computed by squaring, exactly for the integer types. Each squaring
+    ///    doubles the rounding errors of the floating point products before it: the error is below |exponent| ulp,
+    ///  - floating point exponents through e^(exponent log(value)), in a wider type than value (long double for double
+    ///    when it is wider, see exp_log_kernel.hpp). Negative values only have integer powers (NaN otherwise),
+    ///  - fixed point values and exponents use the integer only kernels (0 for value <= 0 and a fractional exponent).
+    template<typename ValueType, typename ExponentType>
+    constexpr auto pow(const ValueType& value, const ExponentType& exponent) -> ValueType
+    {
+        if constexpr(is_matrix<ValueType>::value)
+            return implementation::matrix_pow(std::make_index_sequence<matrix_traits<ValueType>::components>{}, value, exponent);
+        else if constexpr(std::is_integral<ExponentType>::value)
+            return implementation::pow_integer(value, exponent);
+        else if constexpr(is_fixed_point<ValueType>::value)
+            return implementation::pow_fixed_exponent(value, static_cast<ValueType>(exponent));
+        else
+        {
+            using kernel_type = typename implementation::pow_kernel_type<ValueType>::type;
+            return static_cast<ValueType>(implementation::pow_kernel(static_cast<kernel_type>(value), static_cast<kernel_type>(exponent)));
+        }
+    }
+
+    /// @brief value^Exponent, unrolled at compile time: cml::pow<5>(x) is (x^2)^2 * x
+    template<std::int64_t Exponent, typename ValueType>
+    constexpr auto pow(const ValueType& value) -> ValueType
+    {
+        if constexpr(is_matrix<ValueType>::value)
+            return implementation::matrix_pow<Exponent>(std::make_index_sequence<matrix_traits<ValueType>::components>{}, value);
+        else if constexpr(Exponent < 0)
+            return ValueType{1} / pow<-Exponent>(value);
+        else if constexpr(Exponent == 0)
+            return ValueType{1};
+        else if constexpr(Exponent == 1)
+            return value;
+        else
+        {
+            const ValueType half = pow<Exponent / 2>(value);
+            if constexpr(Exponent % 2 == 0)
+                return half * half;
+            else
+                return half * half * value;
+        }
     }
 }
 
+#ifdef CML_COMPILE_TEST_CASE
+
 static_assert(cml::pow(2, 8) == 256);
+static_assert(cml::pow(2, 8u) == 256);
+static_assert(cml::pow(3ll, 39) == 4052555153018976267ll, "no intermediate overflow");
+static_assert(cml::pow(1.0000001, 1000000) > 1.1051 && cml::pow(1.0000001, 1000000) < 1.1052, "log2(n) products");
+static_assert(cml::pow(2.0, -3) == 0.125);
+static_assert(cml::pow(2.0, -1074) == std::numeric_limits<double>::denorm_min(), "subnormal result");
+static_assert(cml::pow(-2.f, 3) == -8.f);
+static_assert(cml::pow<0>(5) == 1);
+static_assert(cml::pow<7>(2) == 128);
+static_assert(cml::pow<-2>(2.0) == 0.25);
+static_assert(cml::pow<1000>(1.0) == 1.0);
+
+static_assert(cml::pow(4.0, 0.5) == 2.0);
+static_assert(cml::pow(2.f, 10.f) == 1024.f);
+static_assert(cml::pow(-8.0, 3.0) == -512.0);
+static_assert(cml::pow(-8.0, 0.5) != cml::pow(-8.0, 0.5), "NaN");
+static_assert(cml::pow(0.0, -1.0) == std::numeric_limits<double>::infinity());
+static_assert(cml::pow(0.5, std::numeric_limits<double>::infinity()) == 0.0);
+static_assert(cml::is_equal(1.4142135623730951, cml::pow(2.0, 0.5)));
+static_assert(cml::is_equal(2.8284271247461900976l, cml::pow(2.0l, 1.5l)));
+
+static_assert(cml::pow(cml::fixed<int32_t, 16>(1.5), 2) == cml::fixed<int32_t, 16>(2.25));
+static_assert(cml::pow(cml::fixed<int32_t, 16>(2), cml::fixed<int32_t, 16>(-2)) == cml::fixed<int32_t, 16>(0.25));
+static_assert(cml::pow(cml::fixed<int32_t, 16>(4), 0.5) == cml::fixed<int32_t, 16>(2));
+
+static_assert(cml::pow(cml::ivec3(1, 2, 3), 2) == cml::ivec3(1, 4, 9));
+static_assert(cml::pow<3>(cml::ivec3(1, 2, 3)) == cml::ivec3(1, 8, 27));
+static_assert(cml::pow(cml::dmat2(1.0, 4.0, 9.0, 16.0), 0.5) == cml::dmat2(1.0, 2.0, 3.0, 4.0));
+
+#endif
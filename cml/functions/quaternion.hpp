@@ -0,0 +1,270 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <type_traits>
+#include "../angle.hpp"
+#include "../config.hpp"
+#include "../matrix.hpp"
+#include "../operators.hpp"
+#include "../simd/quaternion.hpp"
+#include "dot.hpp"
+#include "length.hpp"
+#include "normalize.hpp"
+#include "sincos.hpp"
+#include "sqrt.hpp"
+#include "tan.hpp"
+
+namespace cml
+{
+    // Quaternions are matrix<4, 1, T, matrix_kind::quaternion> stored (x, y, z, w), see cml::quaternion. The rotations
+    // follow the rest of cml: vectors are rows, rotate(q, v) == v * to_mat3(q), and rotate(a * b, v) == rotate(a,
+    // rotate(b, v)), so to_mat3(a * b) == to_mat3(b) * to_mat3(a).
+
+    namespace implementation
+    {
+        template<typename ValueType, matrix_kind Kind>
+        constexpr matrix<3, 1, ValueType, Kind> quaternion_rotate_impl(const matrix<4, 1, ValueType, matrix_kind::quaternion>& q, const matrix<3, 1, ValueType, Kind>& v)
+        {
+            // t = 2 (u x v), v' = v + w t + u x t
+            const auto& u = q.components;
+            const auto& p = v.components;
+            const ValueType tx = ValueType(2) * (u[1] * p[2] - u[2] * p[1]);
+            const ValueType ty = ValueType(2) * (u[2] * p[0] - u[0] * p[2]);
+            const ValueType tz = ValueType(2) * (u[0] * p[1] - u[1] * p[0]);
+            return matrix<3, 1, ValueType, Kind>(
+                p[0] + u[3] * tx + (u[1] * tz - u[2] * ty),
+                p[1] + u[3] * ty + (u[2] * tx - u[0] * tz),
+                p[2] + u[3] * tz + (u[0] * ty - u[1] * tx));
+        }
+
+        template<typename ValueType, matrix_kind Kind>
+        inline matrix<3, 1, ValueType, Kind> quaternion_rotate_simd(const matrix<4, 1, ValueType, matrix_kind::quaternion>& q, const matrix<3, 1, ValueType, Kind>& v)
+        {
+            matrix<3, 1, ValueType, Kind> ret;
+#ifdef CML_SIMD_SSE2
+            simd::quat_rotate(q.components.data(), v.components.data(), ret.components.data());
+#endif
+            return ret;
+        }
+
+        /// @brief Row major rotation matrix of a unit quaternion, for row vectors (the transpose of the usual column
+        /// vector formula). Only the DimxDim top left block is written.
+        template<size_t Dim, typename ValueType>
+        constexpr std::array<ValueType, Dim * Dim> quaternion_rotation(const matrix<4, 1, ValueType, matrix_kind::quaternion>& q)
+        {
+            const ValueType x = q.components[0], y = q.components[1], z = q.components[2], w = q.components[3];
+            const ValueType xx = x * x, yy = y * y, zz = z * z;
+            const ValueType xy = x * y, xz = x * z, yz = y * z;
+            const ValueType wx = w * x, wy = w * y, wz = w * z;
+            constexpr ValueType one = ValueType(1);
+            constexpr ValueType two = ValueType(2);
+
+            std::array<ValueType, Dim * Dim> m{};
+            m[0]           = one - two * (yy + zz); m[1]           = two * (xy + wz);       m[2]               = two * (xz - wy);
+            m[Dim + 0]     = two * (xy - wz);       m[Dim + 1]     = one - two * (xx + zz); m[Dim + 2]         = two * (yz + wx);
+            m[2 * Dim + 0] = two * (xz + wy);       m[2 * Dim + 1] = two * (yz - wx);       m[2 * Dim + 2]     = one - two * (xx + yy);
+            return m;
+        }
+
+        /// @brief atan2(y, x) for 0 <= y <= x, the constexpr series when constant evaluated
+        template<typename ValueType>
+        constexpr ValueType quaternion_half_angle(const ValueType y, const ValueType x)
+        {
+            if constexpr(std::is_floating_point<ValueType>::value)
+            {
+                if (!is_constant_evaluated())
+                    return std::atan2(y, x);
+            }
+            return atan2(x, y);
+        }
+    }
+
+    template<typename ValueType>
+    constexpr quaternion<ValueType> conjugate(const quaternion<ValueType>& q)
+    {
+        return quaternion<ValueType>(-q.components[0], -q.components[1], -q.components[2], q.components[3]);
+    }
+
+    /// @brief conjugate(q) / |q|^2, this is the conjugate for unit quaternions
+    template<typename ValueType>
+    constexpr quaternion<ValueType> inverse(const quaternion<ValueType>& q)
+    {
+        return conjugate(q) * (ValueType(1) / dot(q, q));
+    }
+
+    /// @brief Rotate v by the unit quaternion q (q v q*), using 2 cross products instead of 2 Hamilton products
+    template<typename ValueType, implementation::matrix_kind Kind>
+    constexpr implementation::matrix<3, 1, ValueType, Kind> rotate(const quaternion<ValueType>& q, const implementation::matrix<3, 1, ValueType, Kind>& v)
+    {
+        if constexpr(implementation::has_simd_quaternion<ValueType>::value)
+        {
+            if (!implementation::is_constant_evaluated())
+                return implementation::quaternion_rotate_simd(q, v);
+        }
+        return implementation::quaternion_rotate_impl(q, v);
+    }
+
+    template<typename ValueType, typename MatrixType, size_t... Idxs>
+    constexpr auto rotate(const quaternion<ValueType>& q, const implementation::swizzle<MatrixType, Idxs...>& v)
+    {
+        return rotate(q, v.eval());
+    }
+
+    /// @brief Rotation of angle around the unit vector axis
+    template<typename ValueType, implementation::matrix_kind Kind, implementation::angle_kind AK>
+    constexpr quaternion<ValueType> from_axis_angle(const implementation::matrix<3, 1, ValueType, Kind>& axis, const implementation::angle<ValueType, AK> angle)
+    {
+        const vector<2, ValueType> sc = sincos(implementation::radian<ValueType>(static_cast<ValueType>(implementation::radian<ValueType>{angle}) / ValueType(2)));
+        return quaternion<ValueType>(axis.components[0] * sc.components[0], axis.components[1] * sc.components[0], axis.components[2] * sc.components[0], sc.components[1]);
+    }
+
+    template<typename MatrixType, size_t... Idxs, typename ValueType, implementation::angle_kind AK>
+    constexpr quaternion<ValueType> from_axis_angle(const implementation::swizzle<MatrixType, Idxs...>& axis, const implementation::angle<ValueType, AK> angle)
+    {
+        return from_axis_angle(axis.eval(), angle);
+    }
+
+    /// @brief Rotation matrix of the unit quaternion q, v * to_mat3(q) == rotate(q, v)
+    template<typename ValueType>
+    constexpr matrix<3, 3, ValueType> to_mat3(const quaternion<ValueType>& q)
+    {
+        return matrix<3, 3, ValueType>(implementation::quaternion_rotation<3>(q));
+    }
+
+    /// @brief to_mat3(q) in the top left corner of an identity matrix
+    template<typename ValueType>
+    constexpr matrix<4, 4, ValueType> to_mat4(const quaternion<ValueType>& q)
+    {
+        std::array<ValueType, 16> m = implementation::quaternion_rotation<4>(q);
+        m[15] = ValueType(1);
+        return matrix<4, 4, ValueType>(m);
+    }
+
+    /// @brief Unit quaternion of the rotation matrix m (as returned by to_mat3). Computed from the largest of w, x, y
+    /// and z so the square root and the division stay well conditioned.
+    template<typename ValueType, implementation::matrix_kind Kind>
+    constexpr quaternion<ValueType> from_mat3(const implementation::matrix<3, 3, ValueType, Kind>& m)
+    {
+        // r(i, j) is the column vector convention matrix, the transpose of m
+        const auto r = [&m](size_t i, size_t j) constexpr { return m.components[i + j * 3]; };
+        constexpr ValueType one = ValueType(1);
+        constexpr ValueType quarter = ValueType(0.25);
+
+        const ValueType trace = r(0, 0) + r(1, 1) + r(2, 2);
+        if (trace > ValueType(0))
+        {
+            const ValueType s = sqrt(trace + one) * ValueType(2);
+            return quaternion<ValueType>((r(2, 1) - r(1, 2)) / s, (r(0, 2) - r(2, 0)) / s, (r(1, 0) - r(0, 1)) / s, quarter * s);
+        }
+        else if (r(0, 0) > r(1, 1) && r(0, 0) > r(2, 2))
+        {
+            const ValueType s = sqrt(one + r(0, 0) - r(1, 1) - r(2, 2)) * ValueType(2);
+            return quaternion<ValueType>(quarter * s, (r(0, 1) + r(1, 0)) / s, (r(0, 2) + r(2, 0)) / s, (r(2, 1) - r(1, 2)) / s);
+        }
+        else if (r(1, 1) > r(2, 2))
+        {
+            const ValueType s = sqrt(one + r(1, 1) - r(0, 0) - r(2, 2)) * ValueType(2);
+            return quaternion<ValueType>((r(0, 1) + r(1, 0)) / s, quarter * s, (r(1, 2) + r(2, 1)) / s, (r(0, 2) - r(2, 0)) / s);
+        }
+        else
+        {
+            const ValueType s = sqrt(one + r(2, 2) - r(0, 0) - r(1, 1)) * ValueType(2);
+            return quaternion<ValueType>((r(0, 2) + r(2, 0)) / s, (r(1, 2) + r(2, 1)) / s, quarter * s, (r(1, 0) - r(0, 1)) / s);
+        }
+    }
+
+    /// @brief Normalized linear interpolation along the shortest path (b is negated when dot(a, b) < 0). Not constant
+    /// speed, but close to slerp for small angles and much cheaper.
+    template<typename ValueType>
+    constexpr quaternion<ValueType> nlerp(const quaternion<ValueType>& a, const quaternion<ValueType>& b, const ValueType t)
+    {
+        const quaternion<ValueType> c = dot(a, b) < ValueType(0) ? b * ValueType(-1) : b;
+        return normalize(a + (c - a) * t);
+    }
+
+    /// @brief Spherical linear interpolation along the shortest path, constant angular speed. The angle is
+    /// 2 atan(|a - b| / |a + b|), which stays accurate for close quaternions (unlike acos(dot(a, b))), and nlerp is used
+    /// when a and b are too close for sin(angle) to be a safe divisor.
+    template<typename ValueType>
+    constexpr quaternion<ValueType> slerp(const quaternion<ValueType>& a, const quaternion<ValueType>& b, const ValueType t)
+    {
+        static_assert(std::is_floating_point<ValueType>::value, "slerp needs a floating point quaternion, use nlerp");
+        const quaternion<ValueType> c = dot(a, b) < ValueType(0) ? b * ValueType(-1) : b;
+        // |a - c| = 2 sin(angle / 2) and |a + c| = 2 cos(angle / 2)
+        const ValueType d = length(a - c);
+        const ValueType e = length(a + c);
+        const ValueType angle = ValueType(2) * implementation::quaternion_half_angle(d, e);
+        if (angle < ValueType(1e-3))
+            return nlerp(a, c, t);
+
+        const ValueType inv_s = ValueType(2) / (d * e);
+        const ValueType fa = sin(implementation::radian<ValueType>((ValueType(1) - t) * angle)) * inv_s;
+        const ValueType fc = sin(implementation::radian<ValueType>(t * angle)) * inv_s;
+        return a * fa + c * fc;
+    }
+}
+
+#ifdef CML_COMPILE_TEST_CASE
+
+#include "../definitions.hpp"
+#include "../equality.hpp"
+
+// i * j == k, j * i == -k, i * i == -1
+static_assert(cml::dquat(1, 0, 0, 0) * cml::dquat(0, 1, 0, 0) == cml::dquat(0, 0, 1, 0));
+static_assert(cml::dquat(0, 1, 0, 0) * cml::dquat(1, 0, 0, 0) == cml::dquat(0, 0, -1, 0));
+static_assert(cml::dquat(1, 0, 0, 0) * cml::dquat(1, 0, 0, 0) == cml::dquat(0, 0, 0, -1));
+static_assert(cml::dquat(1, 2, 3, 4) * cml::dquat(5, 6, 7, 8) == cml::dquat(24, 48, 48, -6));
+static_assert(cml::dquat(1, 2, 3, 4) * cml::dquat::identity() == cml::dquat(1, 2, 3, 4));
+static_assert(cml::dquat(1, 2, 3, 4) * 2.0 == cml::dquat(2, 4, 6, 8));
+
+static_assert(cml::conjugate(cml::dquat(1, 2, 3, 4)) == cml::dquat(-1, -2, -3, 4));
+static_assert(cml::inverse(cml::dquat(1, 1, 1, 1)) == cml::dquat(-0.25, -0.25, -0.25, 0.25));
+static_assert(cml::dquat(1, 1, 1, 1) * cml::inverse(cml::dquat(1, 1, 1, 1)) == cml::dquat::identity());
+
+// (0.5, 0.5, 0.5, 0.5) is 120 degrees around (1, 1, 1): x -> y -> z -> x, (0, 0, 1, 0) is 180 degrees around z
+static_assert(cml::rotate(cml::dquat(0.5, 0.5, 0.5, 0.5), cml::dvec3(1, 0, 0)) == cml::dvec3(0, 1, 0));
+static_assert(cml::rotate(cml::dquat(0.5, 0.5, 0.5, 0.5), cml::dvec3(1, 2, 3)) == cml::dvec3(3, 1, 2));
+static_assert(cml::rotate(cml::dquat(0, 0, 1, 0) * cml::dquat(0.5, 0.5, 0.5, 0.5), cml::dvec3(1, 0, 0)) == cml::dvec3(0, -1, 0));
+static_assert(cml::dvec3(1, 2, 3) * cml::to_mat3(cml::dquat(0.5, 0.5, 0.5, 0.5)) == cml::dvec3(3, 1, 2));
+static_assert(cml::to_mat3(cml::dquat(0, 0, 1, 0) * cml::dquat(0.5, 0.5, 0.5, 0.5)) == cml::to_mat3(cml::dquat(0.5, 0.5, 0.5, 0.5)) * cml::to_mat3(cml::dquat(0, 0, 1, 0)));
+static_assert(cml::to_mat4(cml::dquat::identity()) == cml::dmat4::identity());
+static_assert(cml::dvec4(1, 2, 3, 1) * cml::to_mat4(cml::dquat(0.5, 0.5, 0.5, 0.5)) == cml::dvec4(3, 1, 2, 1));
+
+static_assert(cml::from_mat3(cml::dmat3::identity()) == cml::dquat::identity());
+static_assert(cml::from_mat3(cml::to_mat3(cml::dquat(0.5, 0.5, 0.5, 0.5))) == cml::dquat(0.5, 0.5, 0.5, 0.5));
+static_assert(cml::from_mat3(cml::to_mat3(cml::dquat(1, 0, 0, 0))) == cml::dquat(1, 0, 0, 0));
+static_assert(cml::from_mat3(cml::to_mat3(cml::dquat(0, 1, 0, 0))) == cml::dquat(0, 1, 0, 0));
+static_assert(cml::from_mat3(cml::to_mat3(cml::dquat(0, 0, 1, 0))) == cml::dquat(0, 0, 1, 0));
+
+// unit quaternions a and b are the same rotation when dot(a, b) == 1
+static_assert(cml::is_equal(cml::dot(cml::from_axis_angle(cml::dvec3(0, 0, 1), cml::ddeg(180)), cml::dquat(0, 0, 1, 0)), 1.0));
+static_assert(cml::is_equal(cml::dot(cml::from_axis_angle(cml::dvec3(0, 0, 1), cml::ddeg(90)), cml::dquat(0, 0, cml::sqrt(0.5), cml::sqrt(0.5))), 1.0));
+static_assert(cml::is_equal(cml::dot(cml::nlerp(cml::dquat::identity(), cml::dquat(0, 0, 1, 0), 0.5), cml::dquat(0, 0, cml::sqrt(0.5), cml::sqrt(0.5))), 1.0));
+static_assert(cml::nlerp(cml::dquat::identity(), cml::dquat(0, 0, 0, -1), 0.5) == cml::dquat::identity());
+static_assert(cml::is_equal<4>(cml::dot(cml::slerp(cml::dquat::identity(), cml::dquat(0, 0, 1, 0), 0.5), cml::dquat(0, 0, cml::sqrt(0.5), cml::sqrt(0.5))), 1.0));
+static_assert(cml::is_equal<4>(cml::dot(cml::slerp(cml::dquat::identity(), cml::dquat(0, 0, 1, 0), 0.25), cml::from_axis_angle(cml::dvec3(0, 0, 1), cml::ddeg(45))), 1.0));
+static_assert(cml::is_equal<4>(cml::dot(cml::slerp(cml::dquat::identity(), cml::dquat(0, 0, cml::sqrt(0.5), -cml::sqrt(0.5)), 0.5), cml::from_axis_angle(cml::dvec3(0, 0, 1), cml::ddeg(-45))), 1.0));
+
+#endif
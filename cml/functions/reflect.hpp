@@ -32,4 +32,10 @@ namespace cml
     {
         return incident - ValueType(2) * dot(incident, normal) * normal;
     }
+
+    template<typename ValueType1, typename ValueType2, typename = std::enable_if_t<implementation::any_swizzle<ValueType1, ValueType2>::value>>
+    constexpr auto reflect(const ValueType1& incident, const ValueType2& normal)
+    {
+        return reflect(implementation::swizzle_operand(incident), implementation::swizzle_operand(normal));
+    }
 }
@@ -0,0 +1,190 @@
+//
+// Copyright (c) 2017 James Simpson, Timothe Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include "../config.hpp"
+#include "../fixed_point.hpp"
+#include "../simd/pack.hpp"
+#include "../simd/sqrt.hpp"
+#include "../span.hpp"
+#include "sqrt.hpp"
+
+// Approximate reciprocal square root: at runtime float and double use the hardware estimate (rsqrtss / rsqrtps, 12 bits)
+// followed by one Newton-Raphson step. Relative error < 2^-21 (float and double), the constant evaluated version is
+// 1 / sqrt(v) and may differ by that much. Zero, infinities, denormals and values out of the float range are not handled
+// by the estimate and go through 1 / sqrt(v).
+// Fixed point types use an exact integer square root (same result at runtime and at compile time).
+namespace cml
+{
+    namespace implementation
+    {
+        /// @brief One Newton-Raphson step refining y ~= 1 / sqrt(v), also instantiated on simd packs
+        template<typename T>
+        inline T rsqrt_refine(T v, T y) noexcept
+        {
+            return y * (T(1.5) - T(0.5) * v * y * y);
+        }
+
+        /// @brief Whether v can go through the hardware estimate (positive, normal and in the float range)
+        template<typename T>
+        inline auto rsqrt_in_range(T v) noexcept
+        {
+            return (T(std::numeric_limits<float>::min()) <= v) & (v <= T(std::numeric_limits<float>::max()));
+        }
+
+        template<typename ValueType>
+        inline ValueType rsqrt_runtime(ValueType v) noexcept
+        {
+#ifdef CML_SIMD_SSE2
+            if (rsqrt_in_range(v))
+                return rsqrt_refine(v, simd::rsqrt_estimate(v));
+#endif
+            return ValueType(1) / std::sqrt(v);
+        }
+
+        /// @brief out[i] = rsqrt_runtime(v[i]), a register at a time
+        template<typename ValueType>
+        inline void rsqrt_runtime(const ValueType* v, ValueType* out, size_t count) noexcept
+        {
+            size_t i = 0;
+#ifdef CML_SIMD_SSE2
+            using pack = typename simd::pack_of<ValueType>::type;
+            for (; i + pack::size <= count; i += pack::size)
+            {
+                const pack x = pack::load(v + i);
+                if (!simd::all(rsqrt_in_range(x)))
+                {
+                    for (size_t j = i; j < i + pack::size; ++j)
+                        out[j] = rsqrt_runtime(v[j]);
+                    continue;
+                }
+                rsqrt_refine(x, simd::rsqrt_estimate(x)).store(out + i);
+            }
+#endif
+            for (; i < count; ++i)
+                out[i] = rsqrt_runtime(v[i]);
+        }
+
+        /// @brief floor(sqrt(v)), bit by bit
+        template<typename ValueType>
+        constexpr ValueType integer_sqrt(ValueType v) noexcept
+        {
+            ValueType ret = 0;
+            ValueType bit = ValueType(1) << (std::numeric_limits<ValueType>::digits - 1 - (std::numeric_limits<ValueType>::digits - 1) % 2);
+            while (bit > v)
+                bit >>= 2;
+            while (bit != 0)
+            {
+                if (v >= ret + bit)
+                {
+                    v -= ret + bit;
+                    ret = (ret >> 1) + bit;
+                }
+                else
+                {
+                    ret >>= 1;
+                }
+                bit >>= 2;
+            }
+            return ret;
+        }
+
+        /// @brief 1 / sqrt(v) = 2^F / sqrt(data * 2^F) in the raw representation, saturated (0 gives the biggest value)
+        template<typename Type, size_t FB>
+        constexpr fixed<Type, FB> rsqrt_fixed(const fixed<Type, FB> v) noexcept
+        {
+            using fixed_t = fixed<Type, FB>;
+            using upper_type = typename fixed_t::upper_type;
+            static_assert(sizeof(upper_type) > sizeof(Type) && 2 * FB < std::numeric_limits<upper_type>::digits, "rsqrt needs a wider type for the intermediate results");
+
+            if (v.data <= Type(0))
+                return fixed_t{fixed_t::from_fixed, std::numeric_limits<Type>::max()};
+
+            const upper_type root = integer_sqrt(static_cast<upper_type>(v.data) << FB);
+            const upper_type ret = (upper_type(1) << (2 * FB)) / root;
+            if (ret > static_cast<upper_type>(std::numeric_limits<Type>::max()))
+                return fixed_t{fixed_t::from_fixed, std::numeric_limits<Type>::max()};
+            return fixed_t{fixed_t::from_fixed, static_cast<Type>(ret)};
+        }
+    }
+
+    /// @brief Approximate 1 / sqrt(v), see above for the precision
+    template<typename ValueType>
+    constexpr auto rsqrt(ValueType v) -> ValueType
+    {
+        if constexpr(std::is_floating_point<ValueType>::value)
+        {
+            if (!implementation::is_constant_evaluated())
+                return implementation::rsqrt_runtime(v);
+            return ValueType(1) / sqrt(v);
+        }
+        else if constexpr(is_fixed_point<ValueType>::value)
+        {
+            return implementation::rsqrt_fixed(v);
+        }
+        else
+        {
+            return ValueType(1) / sqrt(v);
+        }
+    }
+
+    /// @brief Batched rsqrt: out[i] = rsqrt(values[i]). float and double are evaluated a full register at a time, with
+    /// the same results as the single value version (unless the compiler contracts mul/add pairs into fma).
+    template<typename ValueType>
+    void rsqrt(span<const ValueType> values, span<ValueType> out)
+    {
+        if (out.size() < values.size())
+            throw std::runtime_error("rsqrt output is smaller than the input");
+
+        if constexpr(std::is_same<ValueType, float>::value || std::is_same<ValueType, double>::value)
+        {
+            implementation::rsqrt_runtime(values.data(), out.data(), values.size());
+        }
+        else
+        {
+            for (size_t i = 0; i < values.size(); ++i)
+                out[i] = rsqrt(values[i]);
+        }
+    }
+
+    template<typename ValueType>
+    void rsqrt(span<ValueType> values, span<ValueType> out)
+    {
+        rsqrt(span<const ValueType>(values), out);
+    }
+}
+
+#ifdef CML_COMPILE_TEST_CASE
+
+static_assert(cml::rsqrt(4.0) == 0.5);
+static_assert(cml::rsqrt(0.25f) == 2.f);
+static_assert(cml::rsqrt(cml::f1616(4)) == cml::f1616(0.5f));
+static_assert(cml::rsqrt(cml::f1616(0.25f)) == cml::f1616(2));
+static_assert(cml::rsqrt(cml::f1616(0)).data == std::numeric_limits<int32_t>::max());
+
+#endif
@@ -23,47 +23,115 @@
 #pragma once
 
 #include "../angle.hpp"
+#include "../config.hpp"
 #include "../equality.hpp"
 #include "exp.hpp"
+#include "fixed_kernel.hpp"
 #include "log.hpp"
 #include "sqrt.hpp"
+#include "trig_kernel.hpp"
+
+#include <cstdint>
+#include <type_traits>
 
 namespace cml
 {
     namespace implementation
     {
+        /// @brief Terms the constexpr series sum at most. Their arguments are reduced first (|x| <= pi for sin and cos,
+        /// <= 1/2 for asin, <= 1 for atan) so the series converge before, even for long double.
+        constexpr int series_max_terms = 128;
+
+        /// @brief x - round(x / tau) tau, in [-pi, pi]. Evaluated in long double, angles of 2^62 turns and more are
+        /// returned as they are.
+        template<typename ValueType>
+        constexpr auto trig_reduce_series(const ValueType x) -> ValueType
+        {
+            if constexpr(std::is_floating_point<ValueType>::value)
+            {
+                if (x > pi<ValueType> || x < -pi<ValueType>)
+                {
+                    const long double turns = static_cast<long double>(x) / tau<long double>;
+                    if (turns < 4611686018427387904.l && turns > -4611686018427387904.l)
+                    {
+                        const long double k = static_cast<long double>(static_cast<std::int64_t>(turns < 0 ? turns - 0.5l : turns + 0.5l));
+                        return static_cast<ValueType>(static_cast<long double>(x) - k * tau<long double>);
+                    }
+                }
+            }
+            return x;
+        }
+
+        /// @brief Taylor series of sin / cos: sum + s t / n + ..., with t multiplied by x^2 and n by i (i + 1) at each
+        /// term
         template<typename ValueType>
-        constexpr auto trig_series(const ValueType x, const ValueType sum, const ValueType n, const ValueType i, const ValueType s, const ValueType t) -> ValueType
+        constexpr auto trig_series(const ValueType x, ValueType sum, ValueType n, ValueType i, ValueType s, ValueType t) -> ValueType
         {
-            return is_equal(sum, sum + t*s/n) ? sum : trig_series(x, sum + t*s/n, n*i*(i+1), i+2, -s, t*x*x);
+            for (int k = 0; k < series_max_terms; ++k)
+            {
+                const ValueType next = sum + t * s / n;
+                if (is_equal(sum, next))
+                    break;
+                sum = next;
+                n = n * i * (i + 1);
+                i = i + 2;
+                s = -s;
+                t = t * x * x;
+            }
+            return sum;
         }
 
         template<typename ValueType>
-        constexpr auto sin_impl(const ValueType v) -> ValueType
+        constexpr auto sin_impl(ValueType v) -> ValueType
         {
+            v = trig_reduce_series(v);
             return trig_series(v, v, ValueType{6}, ValueType{4}, ValueType{-1}, v*v*v);
         }
 
+        /// @brief asin(x) = x + x^3 / 6 + 3 x^5 / 40..., the terms are t n / (n + 2)
         template<typename ValueType>
-        constexpr auto asin_series(const ValueType x, const ValueType sum, int n, ValueType t) -> ValueType
+        constexpr auto asin_series(const ValueType x, ValueType sum, int n, ValueType t) -> ValueType
         {
-            return is_equal(sum, sum + t * static_cast<ValueType>(n) / (n + ValueType{2})) ? sum : asin_series(x, sum + t * static_cast<ValueType>(n) / (n + ValueType{2}), n + ValueType{2},
-                t*x*x*static_cast<ValueType>(n) / (n + ValueType{3}));
+            for (int k = 0; k < series_max_terms; ++k)
+            {
+                const ValueType next = sum + t * static_cast<ValueType>(n) / (n + ValueType{2});
+                if (is_equal(sum, next))
+                    break;
+                sum = next;
+                t = t * x * x * static_cast<ValueType>(n) / (n + ValueType{3});
+                n += 2;
+            }
+            return sum;
         }
 
+        /// @brief The series converges slowly close to +-1: above 1/2, asin(x) = pi/2 - 2 asin(sqrt((1 - x) / 2))
         template<typename ValueType>
         constexpr auto asin_impl(const ValueType x) -> ValueType
         {
-            return x == ValueType{-1} ? pi<ValueType> / ValueType{-2} :
-                   x == ValueType{1} ? pi<ValueType> / ValueType{2} :
-                   asin_series(x, x, 1, x*x*x / ValueType{2});
+            if (x > ValueType{1} / ValueType{2} || x < ValueType{-1} / ValueType{2})
+            {
+                const ValueType a = x < ValueType{0} ? -x : x;
+                const ValueType r = pi<ValueType> / ValueType{2} - ValueType{2} * asin_impl(sqrt((ValueType{1} - a) / ValueType{2}));
+                return x < ValueType{0} ? -r : r;
+            }
+            return asin_series(x, x, 1, x*x*x / ValueType{2});
         }
     }
 
+    /// @brief Sine. float and double use a range reduced polynomial at runtime (see trig_kernel.hpp), the series is used
+    /// when constant evaluated. Fixed points always use the integer CORDIC kernel (see fixed_kernel.hpp).
     template<typename ValueType, implementation::angle_kind AK>
     constexpr auto sin(const implementation::angle<ValueType, AK> v) -> ValueType
     {
-        return implementation::sin_impl(static_cast<ValueType>(implementation::radian<ValueType>{v}));
+        const ValueType r = static_cast<ValueType>(implementation::radian<ValueType>{v});
+        if constexpr(is_fixed_point<ValueType>::value)
+            return implementation::sin_fixed(r);
+        else if constexpr(implementation::has_trig_kernel<ValueType>::value)
+        {
+            if (!implementation::is_constant_evaluated())
+                return implementation::sin_runtime(r);
+        }
+        return implementation::sin_impl(r);
     }
 
     template<typename ValueType, implementation::angle_kind AK>
@@ -72,16 +140,25 @@ namespace cml
         return implementation::asin_impl(static_cast<ValueType>(implementation::radian<ValueType>{v}));
     }
 
+    /// @brief (e^v - e^-v) / 2 = (E + E / (E + 1)) / 2 with E = e^|v| - 1: a single exponential, and no cancellation
+    /// around 0
     template<typename ValueType>
     constexpr auto sinh(const ValueType v) -> ValueType
     {
-        return (exp(v) - exp(-v)) / ValueType{2};
+        const ValueType a = v < ValueType{0} ? -v : v;
+        const ValueType e = expm1(a);
+        const ValueType r = (e + ValueType{1} == e ? e : e + e / (e + ValueType{1})) / ValueType{2};
+        return v < ValueType{0} ? -r : r;
     }
 
+    /// @brief log(v + sqrt(v^2 + 1)), through log1p below 2 (fdlibm's asinh)
     template<typename ValueType>
     constexpr auto asinh(const ValueType v) -> ValueType
     {
-        return log(v + sqrt(v * v + ValueType{1}));
+        const ValueType a = v < ValueType{0} ? -v : v;
+        const ValueType r = a > ValueType{2} ? log(ValueType{2} * a + ValueType{1} / (sqrt(a * a + ValueType{1}) + a))
+                                             : log1p(a + a * a / (ValueType{1} + sqrt(ValueType{1} + a * a)));
+        return v < ValueType{0} ? -r : r;
     }
 }
 
@@ -103,6 +180,11 @@ static_assert(cml::is_equal(1.0l, cml::sin(cml::radian<long double>(cml::half_pi
 
 // sin(1) == 0.8414709848078965066525
 static_assert(cml::is_equal(0.8414709848078965, cml::sin(cml::radian<double>(1.0))), "sin(1.0)");
+// sin(100) == -0.5063656411097587936565, the series runs on 100 - 16 tau
+static_assert(cml::is_equal<64>(-0.5063656411097588, cml::sin(cml::radian<double>(100.0))), "sin(100.0)");
+
+// asin(0.999) == 1.526071239626163188471, through pi/2 - 2 asin(sqrt(0.0005))
+static_assert(cml::is_equal<4>(1.5260712396261632, cml::asin(cml::radian<double>(0.999))), "asin(0.999)");
 
 static_assert(cml::is_equal(cml::asin(cml::radian<float>(1.f)), cml::half_pi<float>), "asin(1.f)");
 static_assert(cml::is_equal(cml::asin(cml::radian<double>(1.0)), cml::half_pi<double>), "asin(1.0)");
@@ -112,6 +194,11 @@ static_assert(cml::is_equal(cml::asin(cml::radian<float>(0.5f)), cml::pi<float>
 static_assert(cml::is_equal(cml::asin(cml::radian<double>(0.5f)), cml::pi<double> / 6.f), "asin(0.5f)");
 static_assert(cml::is_equal(cml::asin(cml::radian<long double>(0.5f)), cml::pi<long double> / 6.f), "asin(0.5f)");
 
+// sin(1) == 0.8414709848078965 is 55146.64 in 16.16
+static_assert(cml::sin(cml::radian<cml::f1616>(1)).data == 55147, "sin(f1616(1))");
+static_assert(cml::sin(cml::radian<cml::f1616>(0)).data == 0, "sin(f1616(0))");
+static_assert(cml::sin(cml::radian<cml::f1616>(-100)).data == 33185, "sin(f1616(-100))");
+
 // sinh(1) == 1.1752011936438014568823818505956008151557
 static_assert(cml::is_equal(cml::sinh(1.f), 1.1752011f), "sinh(1.f)");
 static_assert(cml::is_equal(cml::sinh(1.0), 1.1752011936438014), "sinh(1.0)");
@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+#include <stdexcept>
+#include "../definitions.hpp"
+#include "../matrix.hpp"
+#include "../span.hpp"
+#include "cos.hpp"
+#include "sin.hpp"
+
+namespace cml
+{
+    /// @brief Sine and cosine of an angle, x = sin(v) and y = cos(v). At runtime float and double do the range reduction
+    /// only once for both (see trig_kernel.hpp).
+    template<typename ValueType, implementation::angle_kind AK>
+    constexpr auto sincos(const implementation::angle<ValueType, AK> v) -> vector<2, ValueType>
+    {
+        const ValueType r = static_cast<ValueType>(implementation::radian<ValueType>{v});
+        if constexpr(is_fixed_point<ValueType>::value)
+        {
+            ValueType s, c;
+            implementation::sincos_fixed(r, s, c);
+            return vector<2, ValueType>(s, c);
+        }
+        else if constexpr(implementation::has_trig_kernel<ValueType>::value)
+        {
+            if (!implementation::is_constant_evaluated())
+            {
+                ValueType s = 0;
+                ValueType c = 0;
+                implementation::sincos_runtime(r, s, c);
+                return vector<2, ValueType>(s, c);
+            }
+        }
+        return vector<2, ValueType>(implementation::sin_impl(r), implementation::cos_impl(r));
+    }
+
+    /// @brief Batched sincos: sin_out[i] = sin(angles[i]) and cos_out[i] = cos(angles[i]). float and double are
+    /// evaluated a full register at a time, with the same results as the single angle version.
+    template<typename ValueType, implementation::angle_kind AK>
+    void sincos(span<const implementation::angle<ValueType, AK>> angles, span<ValueType> sin_out, span<ValueType> cos_out)
+    {
+        using angle_type = implementation::angle<ValueType, AK>;
+        static_assert(sizeof(angle_type) == sizeof(ValueType), "an angle must be layout compatible with its value");
+        constexpr ValueType factor = implementation::angle_convert_factor<ValueType, AK, implementation::angle_kind::radian>::factor;
+
+        if (sin_out.size() < angles.size() || cos_out.size() < angles.size())
+            throw std::runtime_error("sincos output is smaller than the input");
+
+        if constexpr(implementation::has_trig_kernel<ValueType>::value)
+        {
+            implementation::sincos_runtime(reinterpret_cast<const ValueType*>(angles.data()), factor, sin_out.data(), cos_out.data(), angles.size());
+        }
+        else
+        {
+            for (size_t i = 0; i < angles.size(); ++i)
+            {
+                const vector<2, ValueType> sc = sincos(angles[i]);
+                sin_out[i] = sc.components[0];
+                cos_out[i] = sc.components[1];
+            }
+        }
+    }
+
+    template<typename ValueType, implementation::angle_kind AK>
+    void sincos(span<implementation::angle<ValueType, AK>> angles, span<ValueType> sin_out, span<ValueType> cos_out)
+    {
+        sincos(span<const implementation::angle<ValueType, AK>>(angles), sin_out, cos_out);
+    }
+}
+
+#ifdef CML_COMPILE_TEST_CASE
+
+#include "../operators.hpp"
+
+static_assert(cml::is_close_zero(cml::sincos(cml::radian<float>(0)).components[0]), "sincos(0.f).x");
+static_assert(cml::is_equal(cml::sincos(cml::radian<float>(0)).components[1], 1.f), "sincos(0.f).y");
+static_assert(cml::is_equal(cml::sincos(cml::radian<double>(cml::half_pi<double>)).components[0], 1.0), "sincos(PI/2).x");
+static_assert(cml::is_close_zero(cml::sincos(cml::radian<double>(cml::half_pi<double>)).components[1]), "sincos(PI/2).y");
+static_assert(cml::is_equal(cml::sincos(cml::degree<double>(90)).components[0], 1.0), "sincos(90deg).x");
+
+// sin(1) == 0.8414709848078965, cos(1) == 0.5403023058681397
+static_assert(cml::is_equal(cml::sincos(cml::radian<double>(1)).components[0], 0.8414709848078965), "sincos(1.0).x");
+static_assert(cml::is_equal(cml::sincos(cml::radian<double>(1)).components[1], 0.5403023058681397), "sincos(1.0).y");
+
+#endif
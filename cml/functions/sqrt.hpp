@@ -22,7 +22,12 @@
 
 #pragma once
 
+#include <cmath>
 #include <cstddef>
+#include <limits>
+#include <type_traits>
+#include "../config.hpp"
+#include "../simd/sqrt.hpp"
 #include "../traits.hpp"
 #include "../equality.hpp"
 
@@ -30,17 +35,140 @@ namespace cml
 {
     namespace implementation
     {
+        /// @brief Newton iterations from b >= sqrt(a): they only decrease towards the root, so they stop once they can't
+        /// (the integers end on floor(sqrt(a))). They halve b until it gets close to the root, 128 iterations are
+        /// enough for 64 bit types. 0 for a <= 0.
         template<typename ValueType>
-        constexpr auto sqrt_helper(const ValueType& a, const ValueType& b) -> ValueType
+        constexpr auto sqrt_helper(const ValueType& a, ValueType b) -> ValueType
         {
-            return is_equal(a, b * b) ? b : sqrt_helper(a, (b + a / b) / ValueType{2});
+            if (!(a > ValueType{0}))
+                return ValueType{0};
+            for (int i = 0; i < 128; ++i)
+            {
+                const ValueType next = (b + a / b) / ValueType{2};
+                if (!(next < b))
+                    break;
+                b = next;
+            }
+            return b;
+        }
+
+        /// @brief Sign of a * b - c, computed without rounding error (Dekker's product). a * b must be close to c.
+        template<typename ValueType>
+        constexpr int exact_product_compare(const ValueType a, const ValueType b, const ValueType c)
+        {
+            constexpr ValueType splitter = static_cast<ValueType>((1ull << ((std::numeric_limits<ValueType>::digits + 1) / 2)) + 1);
+            const ValueType ta = splitter * a;
+            const ValueType ah = ta - (ta - a);
+            const ValueType al = a - ah;
+            const ValueType tb = splitter * b;
+            const ValueType bh = tb - (tb - b);
+            const ValueType bl = b - bh;
+
+            const ValueType p = a * b;
+            const ValueType e = ((ah * bh - p) + ah * bl + al * bh) + al * bl; // a * b == p + e
+            const ValueType d = (p - c) + e; // p - c is exact as p and c are within a factor 2
+            return d > ValueType{0} ? 1 : (d < ValueType{0} ? -1 : 0);
+        }
+
+        /// @brief Correctly rounded square root of a floating point value, giving the same result as the hardware instruction
+        template<typename ValueType>
+        constexpr auto sqrt_rounded(ValueType v) -> ValueType
+        {
+            if (v != v || v < ValueType{0})
+                return std::numeric_limits<ValueType>::quiet_NaN();
+            if (v == ValueType{0} || v == std::numeric_limits<ValueType>::infinity())
+                return v;
+
+            // scale v by powers of 4 into [1, 4), sqrt(v * 4^k) == sqrt(v) * 2^k (exact)
+            ValueType scale = ValueType{1};
+            while (v >= ValueType{4294967296.0})
+            {
+                v /= ValueType{4294967296.0};
+                scale *= ValueType{65536.0};
+            }
+            while (v >= ValueType{4})
+            {
+                v /= ValueType{4};
+                scale *= ValueType{2};
+            }
+            while (v < ValueType{1} / ValueType{4294967296.0})
+            {
+                v *= ValueType{4294967296.0};
+                scale /= ValueType{65536.0};
+            }
+            while (v < ValueType{1})
+            {
+                v *= ValueType{4};
+                scale /= ValueType{2};
+            }
+
+            // newton iterations, y ends up in [1, 2]
+            ValueType y = (ValueType{1} + v) / ValueType{2};
+            for (int i = 0; i < 16; ++i)
+            {
+                const ValueType next = (y + v / y) / ValueType{2};
+                if (next == y)
+                    break;
+                y = next;
+            }
+
+            // newton can stop one ulp away: move to the neighbour that is the correctly rounded result (Tuckerman test)
+            constexpr ValueType epsilon = std::numeric_limits<ValueType>::epsilon();
+            for (int i = 0; i < 4; ++i)
+            {
+                const ValueType down = y - (y > ValueType{1} ? epsilon : epsilon / ValueType{2});
+                const ValueType up = y + (y < ValueType{2} ? epsilon : epsilon * ValueType{2});
+                if (exact_product_compare(y, down, v) >= 0)
+                    y = down;
+                else if (exact_product_compare(y, up, v) < 0)
+                    y = up;
+                else
+                    break;
+            }
+            return y * scale;
+        }
+
+        inline float sqrt_runtime(float v) noexcept
+        {
+#ifdef CML_SIMD_SSE2
+            return simd::sqrt(v);
+#else
+            return std::sqrt(v);
+#endif
+        }
+
+        inline double sqrt_runtime(double v) noexcept
+        {
+#ifdef CML_SIMD_SSE2
+            return simd::sqrt(v);
+#else
+            return std::sqrt(v);
+#endif
+        }
+
+        inline long double sqrt_runtime(long double v) noexcept
+        {
+            return std::sqrt(v);
         }
     }
 
+    /// @brief Square root. Floating points use the hardware instruction at runtime and a correctly rounded newton
+    /// iteration when constant evaluated: both give the exact same results.
     template<typename ValueType>
     constexpr auto sqrt(ValueType v) -> ValueType
     {
-        return implementation::sqrt_helper(v, v);
+        if constexpr(std::is_floating_point<ValueType>::value)
+        {
+            if (!implementation::is_constant_evaluated())
+                return implementation::sqrt_runtime(v);
+            return implementation::sqrt_rounded(v);
+        }
+        else
+        {
+            // (v / 2 + 1)^2 > v, and v / 2 + 1 + v / b doesn't overflow
+            return implementation::sqrt_helper(v, v / ValueType{2} + ValueType{1});
+        }
     }
 }
 
@@ -50,5 +178,7 @@ namespace cml
 
 static_assert(cml::is_equal(5.0, cml::sqrt(5.0) * cml::sqrt(5.0)));
 static_assert(5.0f == cml::sqrt(5.0f) * cml::sqrt(5.0f));
+static_assert(cml::sqrt(8) == 2 && cml::sqrt(9) == 3 && cml::sqrt(0) == 0, "floor(sqrt) for the integers");
+static_assert(cml::sqrt(9223372036854775807ll) == 3037000499ll, "no overflow");
 
 #endif
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <stdexcept>
 #include "../tau.hpp"
 #include "sin.hpp"
 #include "cos.hpp"
@@ -43,21 +44,28 @@ namespace cml
             return (ValueType{2} * static_cast<ValueType>(k) * x) / ((ValueType{2} * static_cast<ValueType>(k) + ValueType{1}) * (ValueType{1} + x));
         }
 
-        template <typename ValueType>
-        constexpr ValueType atan_product(ValueType x, std::size_t k)
-        {
-            return k == 1 ? atan_term(x * x, k) : atan_term(x * x, k) * atan_product(x, k - 1);
-        }
-
+        /// @brief Euler's series: atan(x) = x / (1 + x^2) (1 + sum of the products of the atan_term), the products are
+        /// built one term at a time. It converges like (x^2 / (1 + x^2))^k, |x| <= 1 so at least like 2^-k.
         template <typename ValueType>
         constexpr ValueType atan_sum(ValueType x, ValueType sum, std::size_t n)
         {
-            return sum + atan_product(x, n) == sum ? sum : atan_sum(x, sum + atan_product(x, n), n + 1);
+            ValueType product = ValueType{1};
+            for (int k = 0; k < series_max_terms; ++k, ++n)
+            {
+                product = product * atan_term(x * x, n);
+                if (sum + product == sum)
+                    break;
+                sum = sum + product;
+            }
+            return sum;
         }
 
+        /// @brief atan(x) = +-pi/2 - atan(1 / x) for |x| > 1
         template<typename ValueType>
         constexpr auto atan_impl(const ValueType v) -> ValueType
         {
+            if (v > ValueType{1} || v < ValueType{-1})
+                return (v < ValueType{0} ? -pi<ValueType> : pi<ValueType>) / ValueType{2} - atan_impl(ValueType{1} / v);
             return v / (ValueType{1} + v*v) * atan_sum(v, ValueType{1}, 1);
         }
 
@@ -81,25 +89,42 @@ namespace cml
     template<typename ValueType, implementation::angle_kind AK>
     constexpr auto atan(const implementation::angle<ValueType, AK> v) -> ValueType
     {
-        return implementation::atan_impl(static_cast<ValueType>(implementation::radian<ValueType>{v}));
+        if constexpr(is_fixed_point<ValueType>::value)
+            return implementation::atan2_fixed(ValueType(1), static_cast<ValueType>(implementation::radian<ValueType>{v}));
+        else
+            return implementation::atan_impl(static_cast<ValueType>(implementation::radian<ValueType>{v}));
     }
 
+    /// @brief Angle of the point (x, y), atan(y / x) in [-pi, pi]. Fixed points use the integer CORDIC kernel (see
+    /// fixed_kernel.hpp).
     template<typename ValueType>
     constexpr auto atan2(const ValueType x, const ValueType y) -> ValueType
     {
-        return implementation::atan2_impl(x, y);
+        if constexpr(is_fixed_point<ValueType>::value)
+            return implementation::atan2_fixed(x, y);
+        else
+            return implementation::atan2_impl(x, y);
     }
 
+    /// @brief E / (E + 2) with E = e^2|v| - 1: a single exponential, and no cancellation around 0
     template<typename ValueType>
     constexpr auto tanh(const ValueType v) -> ValueType
     {
-        return sinh(v) / cosh(v);
+        const ValueType a = v < ValueType{0} ? -v : v;
+        const ValueType e = expm1(ValueType{2} * a);
+        const ValueType r = e + ValueType{2} == e ? ValueType{1} : e / (e + ValueType{2});
+        return v < ValueType{0} ? -r : r;
     }
 
+    /// @brief log((1 + v) / (1 - v)) / 2, as log1p(2v / (1 - v)) / 2
     template<typename ValueType>
     constexpr auto atanh(const ValueType v) -> ValueType
     {
-        return v > -1 && v < 1 ? (ValueType{1}/ValueType{2}) * log((ValueType{1} + v) / (ValueType{1} - v)) : throw std::runtime_error("atanh value is out of the range of [-1,1]");
+        if (!(v > -1 && v < 1))
+            throw std::runtime_error("atanh value is out of the range of [-1,1]");
+        const ValueType a = v < ValueType{0} ? -v : v;
+        const ValueType r = (ValueType{1} / ValueType{2}) * log1p(ValueType{2} * a / (ValueType{1} - a));
+        return v < ValueType{0} ? -r : r;
     }
 }
 
@@ -121,11 +146,19 @@ static_assert(cml::is_equal(cml::tan(cml::radian<double>(1)), 1.5574077246549022
 static_assert(cml::is_equal(cml::pi<float>/4.f, cml::atan(cml::radian<float>(1))), "atan(1.f)");
 static_assert(cml::is_equal(cml::pi<double>/4.0, cml::atan(cml::radian<double>(1))), "atan(1.f)");
 static_assert(cml::is_equal(cml::pi<long double>/4.l, cml::atan(cml::radian<long double>(1))), "atan(1.f)");
+// atan(1000) == 1.569796327128229752969, as pi/2 - atan(1/1000)
+static_assert(cml::is_equal(1.5697963271282298, cml::atan(cml::radian<double>(1000))), "atan(1000)");
 
 static_assert(cml::is_equal(cml::pi<float>/4.f, cml::atan2(1.f, 1.f)), "atan2(1,1)");
 static_assert(cml::is_equal(cml::pi<double>/4.f, cml::atan2(1.0, 1.0)), "atan2(1,1)");
 static_assert(cml::is_equal(cml::pi<long double>/4.f, cml::atan2(1.l, 1.l)), "atan2(1,1)");
 
+// atan(1) == pi/4 is 51471.85 in 16.16
+static_assert(cml::atan2(cml::f1616(1), cml::f1616(1)).data == 51472, "atan2(f1616(1), f1616(1))");
+static_assert(cml::atan2(cml::f1616(-1), cml::f1616(-1)).data == -154416, "atan2(f1616(-1), f1616(-1))");
+static_assert(cml::atan2(cml::f1616(-1), cml::f1616(0)).data == 205887, "atan2(f1616(-1), 0) == pi");
+static_assert(cml::atan(cml::radian<cml::f1616>(1)).data == 51472, "atan(f1616(1))");
+
 // tanh(1) == 0.761594155955764888119458282604793590412768597257936551596
 static_assert(cml::is_equal(cml::tanh(1.f), 0.7615941f), "tanh(1)");
 static_assert(cml::is_equal(cml::tanh(1.0), 0.7615941559557648), "tanh(1)");
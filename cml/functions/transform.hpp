@@ -0,0 +1,297 @@
+//
+// Copyright (c) 2017 James Simpson, Timothe Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "../config.hpp"
+#include "../matrix.hpp"
+#include "../parallel.hpp"
+#include "../simd/transform.hpp"
+#include "../span.hpp"
+
+// Transform of 3 component points / vectors and 4 component vectors by a 4x4 matrix, applied as rows (v * m, like the
+// rest of cml): points get the translation (w = 1), vectors do not (w = 0), and the projective version divides by the
+// resulting w. The batched versions keep the matrix in registers and, for float, process a full register of vectors at a
+// time (8 with avx, 4 with sse, the vec3 arrays are transposed on the fly). The overloads taking a parallel::thread_pool
+// share the chunks of big arrays between its threads.
+
+namespace cml
+{
+    namespace implementation
+    {
+        template<typename ValueType, matrix_kind Kind, bool Translate, bool Divide>
+        constexpr vector<3, ValueType> transform3_impl(const matrix<4, 4, ValueType, Kind>& m, const vector<3, ValueType>& v)
+        {
+            const auto& a = m.components;
+            const ValueType x = v.components[0], y = v.components[1], z = v.components[2];
+            ValueType rx{}, ry{}, rz{};
+            if constexpr(Translate)
+            {
+                rx = x * a[0] + (y * a[4] + (z * a[8] + a[12]));
+                ry = x * a[1] + (y * a[5] + (z * a[9] + a[13]));
+                rz = x * a[2] + (y * a[6] + (z * a[10] + a[14]));
+            }
+            else
+            {
+                rx = x * a[0] + (y * a[4] + z * a[8]);
+                ry = x * a[1] + (y * a[5] + z * a[9]);
+                rz = x * a[2] + (y * a[6] + z * a[10]);
+            }
+            if constexpr(Divide)
+            {
+                const ValueType w = x * a[3] + (y * a[7] + (z * a[11] + a[15]));
+                return vector<3, ValueType>(rx / w, ry / w, rz / w);
+            }
+            else
+            {
+                return vector<3, ValueType>(rx, ry, rz);
+            }
+        }
+
+        template<typename ValueType, matrix_kind Kind>
+        struct has_simd_transform
+        {
+#ifdef CML_SIMD_SSE2
+            static constexpr bool value = std::is_same<ValueType, float>::value && (Kind == matrix_kind::normal || Kind == matrix_kind::aligned);
+#else
+            static constexpr bool value = false;
+#endif
+        };
+
+        template<bool Translate, bool Divide, typename ValueType, matrix_kind Kind>
+        void transform3_batch(const matrix<4, 4, ValueType, Kind>& m, const vector<3, ValueType>* in, vector<3, ValueType>* out, size_t count)
+        {
+            // empty spans have no data to take the components of
+            if (count == 0)
+                return;
+            size_t done = 0;
+#ifdef CML_SIMD_SSE2
+            if constexpr(has_simd_transform<ValueType, Kind>::value)
+                done = simd::transform3<Translate, Divide>(m.components.data(), in->components.data(), out->components.data(), count);
+#endif
+            for (size_t i = done; i < count; ++i)
+                out[i] = transform3_impl<ValueType, Kind, Translate, Divide>(m, in[i]);
+        }
+
+        template<typename ValueType, matrix_kind Kind>
+        void transform4_batch(const matrix<4, 4, ValueType, Kind>& m, const vector<4, ValueType>* in, vector<4, ValueType>* out, size_t count)
+        {
+            if (count == 0)
+                return;
+            size_t done = 0;
+#ifdef CML_SIMD_SSE2
+            if constexpr(has_simd_transform<ValueType, Kind>::value)
+                done = simd::transform4(m.components.data(), in->components.data(), out->components.data(), count);
+#endif
+            for (size_t i = done; i < count; ++i)
+                out[i] = (in[i].template unsafe_cast<ValueType, Kind>() * m).template unsafe_cast<ValueType, matrix_kind::normal>();
+        }
+    }
+
+    /// @brief (p, 1) * m, the w of the result is dropped
+    template<typename ValueType, implementation::matrix_kind Kind>
+    constexpr vector<3, ValueType> transform_point(const implementation::matrix<4, 4, ValueType, Kind>& m, const vector<3, ValueType>& p)
+    {
+        return implementation::transform3_impl<ValueType, Kind, true, false>(m, p);
+    }
+
+    /// @brief (v, 0) * m: directions are not translated
+    template<typename ValueType, implementation::matrix_kind Kind>
+    constexpr vector<3, ValueType> transform_vector(const implementation::matrix<4, 4, ValueType, Kind>& m, const vector<3, ValueType>& v)
+    {
+        return implementation::transform3_impl<ValueType, Kind, false, false>(m, v);
+    }
+
+    /// @brief (p, 1) * m, divided by its w (projection matrices)
+    template<typename ValueType, implementation::matrix_kind Kind>
+    constexpr vector<3, ValueType> transform_point_projective(const implementation::matrix<4, 4, ValueType, Kind>& m, const vector<3, ValueType>& p)
+    {
+        return implementation::transform3_impl<ValueType, Kind, true, true>(m, p);
+    }
+
+    /// @brief The transforms of swizzles (m, v._<'xyz'>()) transform their vector
+    template<typename ValueType, implementation::matrix_kind Kind, typename MatrixType, size_t... Idxs>
+    constexpr vector<3, ValueType> transform_point(const implementation::matrix<4, 4, ValueType, Kind>& m, const implementation::swizzle<MatrixType, Idxs...>& p)
+    {
+        return transform_point(m, vector<3, ValueType>(p));
+    }
+
+    template<typename ValueType, implementation::matrix_kind Kind, typename MatrixType, size_t... Idxs>
+    constexpr vector<3, ValueType> transform_vector(const implementation::matrix<4, 4, ValueType, Kind>& m, const implementation::swizzle<MatrixType, Idxs...>& v)
+    {
+        return transform_vector(m, vector<3, ValueType>(v));
+    }
+
+    template<typename ValueType, implementation::matrix_kind Kind, typename MatrixType, size_t... Idxs>
+    constexpr vector<3, ValueType> transform_point_projective(const implementation::matrix<4, 4, ValueType, Kind>& m, const implementation::swizzle<MatrixType, Idxs...>& p)
+    {
+        return transform_point_projective(m, vector<3, ValueType>(p));
+    }
+
+    /// @brief Batched transform_point: out[i] = transform_point(m, in[i]). in and out can be the same array.
+    template<typename ValueType, implementation::matrix_kind Kind>
+    void transform_points(const implementation::matrix<4, 4, ValueType, Kind>& m, span<const vector<3, ValueType>> in, span<vector<3, ValueType>> out)
+    {
+        if (out.size() < in.size())
+            throw std::runtime_error("transform_points output is smaller than the input");
+        implementation::transform3_batch<true, false>(m, in.data(), out.data(), in.size());
+    }
+
+    template<typename ValueType, implementation::matrix_kind Kind>
+    void transform_points(const implementation::matrix<4, 4, ValueType, Kind>& m, span<vector<3, ValueType>> in, span<vector<3, ValueType>> out)
+    {
+        transform_points(m, span<const vector<3, ValueType>>(in), out);
+    }
+
+    /// @brief Batched transform_vector: out[i] = transform_vector(m, in[i]). in and out can be the same array.
+    template<typename ValueType, implementation::matrix_kind Kind>
+    void transform_vectors(const implementation::matrix<4, 4, ValueType, Kind>& m, span<const vector<3, ValueType>> in, span<vector<3, ValueType>> out)
+    {
+        if (out.size() < in.size())
+            throw std::runtime_error("transform_vectors output is smaller than the input");
+        implementation::transform3_batch<false, false>(m, in.data(), out.data(), in.size());
+    }
+
+    template<typename ValueType, implementation::matrix_kind Kind>
+    void transform_vectors(const implementation::matrix<4, 4, ValueType, Kind>& m, span<vector<3, ValueType>> in, span<vector<3, ValueType>> out)
+    {
+        transform_vectors(m, span<const vector<3, ValueType>>(in), out);
+    }
+
+    /// @brief Batched transform_point_projective: out[i] = transform_point_projective(m, in[i]). in and out can be the
+    /// same array.
+    template<typename ValueType, implementation::matrix_kind Kind>
+    void transform_points_projective(const implementation::matrix<4, 4, ValueType, Kind>& m, span<const vector<3, ValueType>> in, span<vector<3, ValueType>> out)
+    {
+        if (out.size() < in.size())
+            throw std::runtime_error("transform_points_projective output is smaller than the input");
+        implementation::transform3_batch<true, true>(m, in.data(), out.data(), in.size());
+    }
+
+    template<typename ValueType, implementation::matrix_kind Kind>
+    void transform_points_projective(const implementation::matrix<4, 4, ValueType, Kind>& m, span<vector<3, ValueType>> in, span<vector<3, ValueType>> out)
+    {
+        transform_points_projective(m, span<const vector<3, ValueType>>(in), out);
+    }
+
+    /// @brief Batched v * m on 4 component vectors: out[i] = in[i] * m. in and out can be the same array.
+    template<typename ValueType, implementation::matrix_kind Kind>
+    void transform_points4(const implementation::matrix<4, 4, ValueType, Kind>& m, span<const vector<4, ValueType>> in, span<vector<4, ValueType>> out)
+    {
+        if (out.size() < in.size())
+            throw std::runtime_error("transform_points4 output is smaller than the input");
+        implementation::transform4_batch(m, in.data(), out.data(), in.size());
+    }
+
+    template<typename ValueType, implementation::matrix_kind Kind>
+    void transform_points4(const implementation::matrix<4, 4, ValueType, Kind>& m, span<vector<4, ValueType>> in, span<vector<4, ValueType>> out)
+    {
+        transform_points4(m, span<const vector<4, ValueType>>(in), out);
+    }
+
+    // Multithreaded versions: the arrays are cut in parallel::chunk_size elements chunks shared between the threads of
+    // pool (a single chunk runs on the calling thread). Same results as the single threaded versions.
+
+    template<typename ValueType, implementation::matrix_kind Kind>
+    void transform_points(parallel::thread_pool& pool, const implementation::matrix<4, 4, ValueType, Kind>& m, span<const vector<3, ValueType>> in, span<vector<3, ValueType>> out)
+    {
+        if (out.size() < in.size())
+            throw std::runtime_error("transform_points output is smaller than the input");
+        pool.run(in.size(), parallel::chunk_size<vector<3, ValueType>>(), [&](size_t begin, size_t end)
+        {
+            implementation::transform3_batch<true, false>(m, in.data() + begin, out.data() + begin, end - begin);
+        });
+    }
+
+    template<typename ValueType, implementation::matrix_kind Kind>
+    void transform_points(parallel::thread_pool& pool, const implementation::matrix<4, 4, ValueType, Kind>& m, span<vector<3, ValueType>> in, span<vector<3, ValueType>> out)
+    {
+        transform_points(pool, m, span<const vector<3, ValueType>>(in), out);
+    }
+
+    template<typename ValueType, implementation::matrix_kind Kind>
+    void transform_vectors(parallel::thread_pool& pool, const implementation::matrix<4, 4, ValueType, Kind>& m, span<const vector<3, ValueType>> in, span<vector<3, ValueType>> out)
+    {
+        if (out.size() < in.size())
+            throw std::runtime_error("transform_vectors output is smaller than the input");
+        pool.run(in.size(), parallel::chunk_size<vector<3, ValueType>>(), [&](size_t begin, size_t end)
+        {
+            implementation::transform3_batch<false, false>(m, in.data() + begin, out.data() + begin, end - begin);
+        });
+    }
+
+    template<typename ValueType, implementation::matrix_kind Kind>
+    void transform_vectors(parallel::thread_pool& pool, const implementation::matrix<4, 4, ValueType, Kind>& m, span<vector<3, ValueType>> in, span<vector<3, ValueType>> out)
+    {
+        transform_vectors(pool, m, span<const vector<3, ValueType>>(in), out);
+    }
+
+    template<typename ValueType, implementation::matrix_kind Kind>
+    void transform_points_projective(parallel::thread_pool& pool, const implementation::matrix<4, 4, ValueType, Kind>& m, span<const vector<3, ValueType>> in, span<vector<3, ValueType>> out)
+    {
+        if (out.size() < in.size())
+            throw std::runtime_error("transform_points_projective output is smaller than the input");
+        pool.run(in.size(), parallel::chunk_size<vector<3, ValueType>>(), [&](size_t begin, size_t end)
+        {
+            implementation::transform3_batch<true, true>(m, in.data() + begin, out.data() + begin, end - begin);
+        });
+    }
+
+    template<typename ValueType, implementation::matrix_kind Kind>
+    void transform_points_projective(parallel::thread_pool& pool, const implementation::matrix<4, 4, ValueType, Kind>& m, span<vector<3, ValueType>> in, span<vector<3, ValueType>> out)
+    {
+        transform_points_projective(pool, m, span<const vector<3, ValueType>>(in), out);
+    }
+
+    template<typename ValueType, implementation::matrix_kind Kind>
+    void transform_points4(parallel::thread_pool& pool, const implementation::matrix<4, 4, ValueType, Kind>& m, span<const vector<4, ValueType>> in, span<vector<4, ValueType>> out)
+    {
+        if (out.size() < in.size())
+            throw std::runtime_error("transform_points4 output is smaller than the input");
+        pool.run(in.size(), parallel::chunk_size<vector<4, ValueType>>(), [&](size_t begin, size_t end)
+        {
+            implementation::transform4_batch(m, in.data() + begin, out.data() + begin, end - begin);
+        });
+    }
+
+    template<typename ValueType, implementation::matrix_kind Kind>
+    void transform_points4(parallel::thread_pool& pool, const implementation::matrix<4, 4, ValueType, Kind>& m, span<vector<4, ValueType>> in, span<vector<4, ValueType>> out)
+    {
+        transform_points4(pool, m, span<const vector<4, ValueType>>(in), out);
+    }
+}
+
+#ifdef CML_COMPILE_TEST_CASE
+
+#include "../definitions.hpp"
+
+// rotation of 90 degrees around z, scale by 2 and translation by (1, 2, 3)
+static_assert(cml::transform_point(cml::dmat4(0, 2, 0, 0, -2, 0, 0, 0, 0, 0, 2, 0, 1, 2, 3, 1), cml::dvec3(1, 1, 1)) == cml::dvec3(-1, 4, 5));
+static_assert(cml::transform_vector(cml::dmat4(0, 2, 0, 0, -2, 0, 0, 0, 0, 0, 2, 0, 1, 2, 3, 1), cml::dvec3(1, 1, 1)) == cml::dvec3(-2, 2, 2));
+static_assert(cml::transform_point(cml::mat4::identity(), cml::vec3(1, 2, 3)) == cml::vec3(1, 2, 3));
+// w = z: perspective divide
+static_assert(cml::transform_point_projective(cml::dmat4(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0), cml::dvec3(2, 4, 2)) == cml::dvec3(1, 2, 1));
+static_assert(cml::transform_point_projective(cml::dmat4(2, 0, 0, 0, 0, 2, 0, 0, 0, 0, 2, 0, 0, 0, 0, 2), cml::dvec3(1, 2, 3)) == cml::dvec3(1, 2, 3));
+
+#endif
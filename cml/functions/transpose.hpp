@@ -43,4 +43,11 @@ namespace cml
     {
         return implementation::transpose_impl(std::make_index_sequence<DimX * DimY>{}, m);
     }
+
+    /// @brief Transpose of the vector of a swizzle (a column vector)
+    template<typename MatrixType, size_t... Idxs>
+    constexpr auto transpose(const implementation::swizzle<MatrixType, Idxs...>& v)
+    {
+        return transpose(v.eval());
+    }
 } // namespace cml
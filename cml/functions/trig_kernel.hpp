@@ -0,0 +1,335 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../config.hpp"
+#include "../simd/pack.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Runtime sin/cos kernels. The angle is reduced to r in [-pi/4, pi/4] and a quadrant (Cody-Waite reduction with pi/2
+// split in 33 bit chunks), then fixed degree minimax polynomials (from fdlibm/FreeBSD msun) are evaluated on r.
+//
+// Error bounds, for |x| <= trig_reduce_max (~823550 rad):
+//  - float:  < 0.51 ulp (reduction and polynomials are evaluated in double, max measured 0.501 ulp)
+//  - double: < 1 ulp (max measured 0.78 ulp)
+// Bigger angles fall back to the standard library, which does a full (Payne-Hanek) reduction.
+namespace cml::implementation
+{
+    /// @brief Result of a trigonometric range reduction: x = quadrant * pi/2 + (hi + lo)
+    struct trig_reduction
+    {
+        double hi;
+        double lo;
+        int quadrant;
+    };
+
+    /// @brief Biggest angle that the Cody-Waite reduction handles without loosing precision (2^19 * pi/2)
+    constexpr double trig_reduce_max = 823549.6961762;
+
+    namespace trig_constants
+    {
+        constexpr double inv_pio2 = 6.36619772367581382433e-01;
+        constexpr double pio2_1 = 1.57079632673412561417e+00;  // first 33 bits of pi/2
+        constexpr double pio2_1t = 6.07710050650619224932e-11; // pi/2 - pio2_1
+        constexpr double pio2_2 = 6.07710050630396597660e-11;  // second 33 bits of pi/2
+        constexpr double pio2_2t = 2.02226624879595063154e-21; // pi/2 - (pio2_1 + pio2_2)
+        constexpr double pio2_3 = 2.02226624871116645580e-21;  // third 33 bits of pi/2
+        constexpr double pio2_3t = 8.47842766036889956997e-32; // pi/2 - (pio2_1 + pio2_2 + pio2_3)
+        constexpr double round_magic = 6755399441055744.0;     // 1.5 * 2^52, rounds to the nearest integer when added
+    }
+
+    inline int trig_exponent(double v) noexcept
+    {
+        std::uint64_t bits = 0;
+        std::memcpy(&bits, &v, sizeof(v));
+        return static_cast<int>((bits >> 52) & 0x7ff);
+    }
+
+    /// @brief Cody-Waite reduction of x by pi/2, |x| must be lower than trig_reduce_max
+    inline trig_reduction trig_reduce(double x) noexcept
+    {
+        using namespace trig_constants;
+        const double fn = (x * inv_pio2 + round_magic) - round_magic;
+        double r = x - fn * pio2_1; // exact
+        double w = fn * pio2_1t;
+        double hi = r - w;
+
+        // x is close to a multiple of pi/2: more bits of pi/2 are needed (fdlibm's __ieee754_rem_pio2)
+        const int e = trig_exponent(x);
+        if (e - trig_exponent(hi) > 16)
+        {
+            double t = r;
+            w = fn * pio2_2;
+            r = t - w;
+            w = fn * pio2_2t - ((t - r) - w);
+            hi = r - w;
+            if (e - trig_exponent(hi) > 49)
+            {
+                t = r;
+                w = fn * pio2_3;
+                r = t - w;
+                w = fn * pio2_3t - ((t - r) - w);
+                hi = r - w;
+            }
+        }
+        return {hi, (r - hi) - w, static_cast<int>(static_cast<std::int64_t>(fn)) & 3};
+    }
+
+    // The polynomial kernels are templates so they can also be evaluated on a register of doubles (simd::dpack) by the
+    // batched functions, with exactly the same operations as the scalar code.
+
+    /// @brief sin(hi + lo) for |hi + lo| <= pi/4 (FreeBSD __kernel_sin)
+    template<typename T>
+    inline T sin_kernel(T x, T y) noexcept
+    {
+        constexpr double S1 = -1.66666666666666324348e-01;
+        constexpr double S2 = 8.33333333332248946124e-03;
+        constexpr double S3 = -1.98412698298579493134e-04;
+        constexpr double S4 = 2.75573137070700676789e-06;
+        constexpr double S5 = -2.50507602534068634195e-08;
+        constexpr double S6 = 1.58969099521155010221e-10;
+
+        const T z = x * x;
+        const T w = z * z;
+        const T r = S2 + z * (S3 + z * S4) + z * w * (S5 + z * S6);
+        const T v = z * x;
+        return x - ((z * (0.5 * y - v * r) - y) - v * S1);
+    }
+
+    /// @brief cos(hi + lo) for |hi + lo| <= pi/4 (FreeBSD __kernel_cos)
+    template<typename T>
+    inline T cos_kernel(T x, T y) noexcept
+    {
+        constexpr double C1 = 4.16666666666666019037e-02;
+        constexpr double C2 = -1.38888888888741095749e-03;
+        constexpr double C3 = 2.48015872894767294178e-05;
+        constexpr double C4 = -2.75573143513906633035e-07;
+        constexpr double C5 = 2.08757232129817482790e-09;
+        constexpr double C6 = -1.13596475577881948265e-11;
+
+        const T z = x * x;
+        T w = z * z;
+        const T r = z * (C1 + z * (C2 + z * C3)) + w * w * (C4 + z * (C5 + z * C6));
+        const T hz = 0.5 * z;
+        w = 1.0 - hz;
+        return w + (((1.0 - w) - hz) + (z * r - x * y));
+    }
+
+    /// @brief sin(x) for |x| <= pi/4, float precision (FreeBSD __kernel_sindf)
+    template<typename T>
+    inline T sin_kernel_float(T x) noexcept
+    {
+        constexpr double S1 = -0.166666666416265235595;
+        constexpr double S2 = 0.0083333293858894631756;
+        constexpr double S3 = -0.000198393348360966317347;
+        constexpr double S4 = 0.0000027183114939898219064;
+
+        const T z = x * x;
+        const T w = z * z;
+        const T r = S3 + z * S4;
+        const T s = z * x;
+        return (x + s * (S1 + z * S2)) + s * w * r;
+    }
+
+    /// @brief cos(x) for |x| <= pi/4, float precision (FreeBSD __kernel_cosdf)
+    template<typename T>
+    inline T cos_kernel_float(T x) noexcept
+    {
+        constexpr double C0 = -0.499999997251031003120;
+        constexpr double C1 = 0.0416666233237390631894;
+        constexpr double C2 = -0.00138867637746099294692;
+        constexpr double C3 = 0.0000243904487962774090654;
+
+        const T z = x * x;
+        const T w = z * z;
+        const T r = C2 + z * C3;
+        return ((1.0 + z * C0) + w * C1) + (w * z) * r;
+    }
+
+    inline float sin_runtime(float v) noexcept
+    {
+        if (!(std::fabs(v) <= static_cast<float>(trig_reduce_max)))
+            return std::sin(v);
+        const trig_reduction r = trig_reduce(static_cast<double>(v));
+        const double x = r.hi + r.lo;
+        switch (r.quadrant)
+        {
+            case 0: return static_cast<float>(sin_kernel_float(x));
+            case 1: return static_cast<float>(cos_kernel_float(x));
+            case 2: return static_cast<float>(-sin_kernel_float(x));
+            default: return static_cast<float>(-cos_kernel_float(x));
+        }
+    }
+
+    inline float cos_runtime(float v) noexcept
+    {
+        if (!(std::fabs(v) <= static_cast<float>(trig_reduce_max)))
+            return std::cos(v);
+        const trig_reduction r = trig_reduce(static_cast<double>(v));
+        const double x = r.hi + r.lo;
+        switch (r.quadrant)
+        {
+            case 0: return static_cast<float>(cos_kernel_float(x));
+            case 1: return static_cast<float>(-sin_kernel_float(x));
+            case 2: return static_cast<float>(-cos_kernel_float(x));
+            default: return static_cast<float>(sin_kernel_float(x));
+        }
+    }
+
+    inline double sin_runtime(double v) noexcept
+    {
+        if (!(std::fabs(v) <= trig_reduce_max))
+            return std::sin(v);
+        const trig_reduction r = trig_reduce(v);
+        switch (r.quadrant)
+        {
+            case 0: return sin_kernel(r.hi, r.lo);
+            case 1: return cos_kernel(r.hi, r.lo);
+            case 2: return -sin_kernel(r.hi, r.lo);
+            default: return -cos_kernel(r.hi, r.lo);
+        }
+    }
+
+    inline double cos_runtime(double v) noexcept
+    {
+        if (!(std::fabs(v) <= trig_reduce_max))
+            return std::cos(v);
+        const trig_reduction r = trig_reduce(v);
+        switch (r.quadrant)
+        {
+            case 0: return cos_kernel(r.hi, r.lo);
+            case 1: return -sin_kernel(r.hi, r.lo);
+            case 2: return -cos_kernel(r.hi, r.lo);
+            default: return sin_kernel(r.hi, r.lo);
+        }
+    }
+
+    /// @brief sin and cos of v sharing the range reduction
+    template<typename ValueType>
+    inline void sincos_runtime(ValueType v, ValueType& s, ValueType& c) noexcept
+    {
+        if (!(std::fabs(v) <= static_cast<ValueType>(trig_reduce_max)))
+        {
+            s = std::sin(v);
+            c = std::cos(v);
+            return;
+        }
+
+        const trig_reduction r = trig_reduce(static_cast<double>(v));
+        double ks = 0;
+        double kc = 0;
+        if constexpr(std::is_same<ValueType, float>::value)
+        {
+            ks = sin_kernel_float(r.hi + r.lo);
+            kc = cos_kernel_float(r.hi + r.lo);
+        }
+        else
+        {
+            ks = sin_kernel(r.hi, r.lo);
+            kc = cos_kernel(r.hi, r.lo);
+        }
+
+        switch (r.quadrant)
+        {
+            case 0: s = static_cast<ValueType>(ks); c = static_cast<ValueType>(kc); break;
+            case 1: s = static_cast<ValueType>(kc); c = static_cast<ValueType>(-ks); break;
+            case 2: s = static_cast<ValueType>(-ks); c = static_cast<ValueType>(-kc); break;
+            default: s = static_cast<ValueType>(-kc); c = static_cast<ValueType>(ks); break;
+        }
+    }
+
+    /// @brief s[i], c[i] = sin, cos of v[i] * factor (the factor converts the angles to radian and is applied in ValueType
+    /// precision like the angle conversions). Gives the same results as the scalar sincos_runtime (unless the compiler
+    /// contracts mul/add pairs into fma).
+    template<typename ValueType>
+    inline void sincos_runtime(const ValueType* v, ValueType factor, ValueType* s, ValueType* c, size_t count) noexcept
+    {
+        size_t i = 0;
+#ifdef CML_SIMD_SSE2
+        using namespace trig_constants;
+        using simd::dpack;
+
+        for (; i + dpack::size <= count; i += dpack::size)
+        {
+            dpack x;
+            if constexpr(std::is_same<ValueType, float>::value)
+                x = dpack::load(v + i, factor);
+            else
+                x = dpack::load(v + i) * dpack(factor);
+
+            const dpack fn = (x * inv_pio2 + round_magic) - round_magic;
+            const dpack r = x - fn * pio2_1;
+            const dpack w = fn * pio2_1t;
+            const dpack hi = r - w;
+
+            // Lanes out of range, or close enough to a multiple of pi/2 for trig_reduce to use more bits of pi/2, are
+            // rare: the whole group goes through the scalar code.
+            if (!simd::all((simd::abs(x) <= trig_reduce_max) & (simd::abs(x) * 0x1p-15 <= simd::abs(hi))))
+            {
+                for (size_t j = i; j < i + dpack::size; ++j)
+                    sincos_runtime(static_cast<ValueType>(v[j] * factor), s[j], c[j]);
+                continue;
+            }
+
+            const dpack lo = (r - hi) - w;
+            dpack ks;
+            dpack kc;
+            if constexpr(std::is_same<ValueType, float>::value)
+            {
+                ks = sin_kernel_float(hi + lo);
+                kc = cos_kernel_float(hi + lo);
+            }
+            else
+            {
+                ks = sin_kernel(hi, lo);
+                kc = cos_kernel(hi, lo);
+            }
+
+            // quadrant = fn mod 4 (round((fn - 1.5) / 4) is floor(fn / 4) for integers)
+            const dpack k = ((fn - 1.5) * 0.25 + round_magic) - round_magic;
+            const dpack q = fn - k * 4.0;
+            const dpack swap = (q == 1.0) | (q == 3.0);
+            const dpack sign = -0.0;
+            const dpack neg_s = dpack(2.0) <= q;
+            const dpack neg_c = (q == 1.0) | (q == 2.0);
+            (simd::select(swap, kc, ks) ^ (neg_s & sign)).store(s + i);
+            (simd::select(swap, ks, kc) ^ (neg_c & sign)).store(c + i);
+        }
+#endif
+        for (; i < count; ++i)
+            sincos_runtime(static_cast<ValueType>(v[i] * factor), s[i], c[i]);
+    }
+
+    /// @brief Whether a runtime kernel exists for the type
+    template<typename ValueType>
+    struct has_trig_kernel
+    {
+        static constexpr bool value = std::is_same<ValueType, float>::value || std::is_same<ValueType, double>::value;
+    };
+} // namespace cml::implementation
@@ -0,0 +1,293 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "fixed_point.hpp"
+#include "matrix.hpp"
+#include "reference.hpp"
+#include "traits.hpp"
+
+// Opt-in lazy evaluation. cml::lazy(m) wraps a matrix in an expression, the operators on expressions build a tree
+// instead of computing intermediate matrices, and the tree is evaluated in one pass, component per component, when it
+// is converted to (or assigned to) a matrix:
+//
+//      cml::vec3 r = cml::lazy(a) + cml::lazy(b) * s - c * t;      // no temporary vec3
+//
+// Only the component wise operations are lazy: + and - (with expressions, matrices or scalars) and * / by a scalar.
+// The left most operand must be an expression. Everything is constexpr, and the values are computed with the same
+// operations as the eager operators. Expressions keep references to the lvalues they are built from: evaluate them
+// before those go out of scope (soa_array.hpp also makes soa_arrays usable as leaves, the sizes of the soa_arrays of an
+// expression must be the same).
+namespace cml::implementation
+{
+    template<typename Target> struct lazy_evaluate;
+
+    /// @brief Base of every lazy expression, Derived has a result_type and an at<Lane>(component, index) method
+    template<typename Derived>
+    struct lazy_expression
+    {
+        /// @brief Evaluate the expression
+        constexpr auto eval() const
+        {
+            return lazy_evaluate<typename Derived::result_type>::evaluate(static_cast<const Derived&>(*this));
+        }
+
+        template<typename Target, typename D = Derived, typename = std::enable_if_t<std::is_same<Target, typename D::result_type>::value>>
+        constexpr operator Target() const
+        {
+            return eval();
+        }
+    };
+
+    template<typename T>
+    struct is_lazy_expression
+    {
+        static constexpr bool value = std::is_base_of<lazy_expression<std::remove_cv_t<std::remove_reference_t<T>>>, std::remove_cv_t<std::remove_reference_t<T>>>::value;
+    };
+
+    /// @brief Evaluation of an expression into a Target, specialized by soa_array
+    template<typename Target>
+    struct lazy_evaluate
+    {
+        template<typename Expr>
+        static constexpr Target evaluate(const Expr& e)
+        {
+            return evaluate(std::make_index_sequence<matrix_traits<Target>::components>{}, e);
+        }
+
+    private:
+        template<typename Expr, size_t... Idxs>
+        static constexpr Target evaluate(std::index_sequence<Idxs...>, const Expr& e)
+        {
+            using value_type = typename matrix_traits<Target>::type;
+            return Target(std::array<value_type, sizeof...(Idxs)>{{e.template at<value_type>(Idxs, 0)...}});
+        }
+    };
+
+    /// @brief Leaf holding a matrix (by reference for lvalues, by value for rvalues)
+    template<typename MType>
+    struct lazy_matrix : public lazy_expression<lazy_matrix<MType>>
+    {
+        using result_type = remove_matrix_reference_t<std::remove_cv_t<std::remove_reference_t<MType>>>;
+
+        constexpr lazy_matrix(MType m) noexcept : m(static_cast<MType>(m)) {}
+
+        /// @brief Matrices are broadcast over the elements of soa_arrays
+        constexpr size_t size() const noexcept { return 0; }
+
+        template<typename Lane>
+        constexpr Lane at(size_t component, size_t) const
+        {
+            return Lane(static_cast<typename matrix_traits<result_type>::type>(m.components[component]));
+        }
+
+        MType m;
+    };
+
+    /// @brief Leaf holding a scalar
+    template<typename SType>
+    struct lazy_scalar
+    {
+        using result_type = void;
+
+        constexpr size_t size() const noexcept { return 0; }
+
+        template<typename Lane>
+        constexpr Lane at(size_t, size_t) const
+        {
+            return Lane(s);
+        }
+
+        SType s;
+    };
+
+    /// @brief Results evaluated element per element (soa_array), the matrices are broadcast over their elements
+    template<typename T> struct is_lazy_array : public std::false_type {};
+
+    template<typename L, typename R>
+    constexpr bool lazy_same_size()
+    {
+        if constexpr(is_matrix<L>::value && is_matrix<R>::value)
+            return matrix_traits<L>::components == matrix_traits<R>::components;
+        else
+            return true;
+    }
+
+    /// @brief Result of an operation between two expressions (void for scalars)
+    template<typename L, typename R>
+    struct lazy_result
+    {
+        using type = std::conditional_t<is_lazy_array<R>::value && !is_lazy_array<L>::value, R, L>;
+        static_assert(lazy_same_size<L, R>(), "lazy operations need matrices of the same size");
+    };
+    template<typename L> struct lazy_result<L, void> { using type = L; };
+    template<typename R> struct lazy_result<void, R> { using type = R; };
+
+    struct lazy_add { template<typename A, typename B> static constexpr auto apply(const A& a, const B& b) { return a + b; } };
+    struct lazy_sub { template<typename A, typename B> static constexpr auto apply(const A& a, const B& b) { return a - b; } };
+    struct lazy_mul { template<typename A, typename B> static constexpr auto apply(const A& a, const B& b) { return a * b; } };
+    struct lazy_div { template<typename A, typename B> static constexpr auto apply(const A& a, const B& b) { return a / b; } };
+
+    template<typename Op, typename L, typename R>
+    struct lazy_binary : public lazy_expression<lazy_binary<Op, L, R>>
+    {
+        using result_type = typename lazy_result<typename L::result_type, typename R::result_type>::type;
+
+        constexpr lazy_binary(L l, R r) noexcept : l(l), r(r) {}
+
+        /// @brief Size of the soa_array leaves (0 without any), they must all have the same
+        constexpr size_t size() const
+        {
+            const size_t lsize = l.size();
+            const size_t rsize = r.size();
+            if (lsize != 0 && rsize != 0 && lsize != rsize)
+                throw std::runtime_error("soa_array sizes differ");
+            return lsize != 0 ? lsize : rsize;
+        }
+
+        template<typename Lane>
+        constexpr Lane at(size_t component, size_t index) const
+        {
+            return Lane(Op::apply(l.template at<Lane>(component, index), r.template at<Lane>(component, index)));
+        }
+
+        L l;
+        R r;
+    };
+
+    template<typename E>
+    struct lazy_negate : public lazy_expression<lazy_negate<E>>
+    {
+        using result_type = typename E::result_type;
+
+        constexpr lazy_negate(E e) noexcept : e(e) {}
+
+        constexpr size_t size() const { return e.size(); }
+
+        template<typename Lane>
+        constexpr Lane at(size_t component, size_t index) const
+        {
+            return Lane(-e.template at<Lane>(component, index));
+        }
+
+        E e;
+    };
+
+    template<typename T>
+    struct is_lazy_scalar
+    {
+        using type = std::remove_cv_t<std::remove_reference_t<T>>;
+        static constexpr bool value = std::is_arithmetic<type>::value || is_fixed_point<type>::value;
+    };
+} // namespace cml::implementation
+
+namespace cml
+{
+    /// @brief Start a lazy expression from a matrix
+    template<size_t DimX, size_t DimY, typename ValueType, implementation::matrix_kind Kind>
+    constexpr auto lazy(const implementation::matrix<DimX, DimY, ValueType, Kind>& m) noexcept
+    {
+        return implementation::lazy_matrix<const implementation::matrix<DimX, DimY, ValueType, Kind>&>(m);
+    }
+
+    template<size_t DimX, size_t DimY, typename ValueType, implementation::matrix_kind Kind>
+    constexpr auto lazy(implementation::matrix<DimX, DimY, ValueType, Kind>&& m) noexcept
+    {
+        return implementation::lazy_matrix<implementation::matrix<DimX, DimY, ValueType, Kind>>(std::move(m));
+    }
+} // namespace cml
+
+namespace cml::implementation
+{
+    /// @brief Wrap an operand of a lazy operator: expressions are kept as is, scalars and matrices become leaves
+    template<typename T>
+    constexpr auto lazy_operand(T&& v)
+    {
+        if constexpr(is_lazy_expression<T>::value)
+            return std::remove_cv_t<std::remove_reference_t<T>>(v);
+        else if constexpr(is_lazy_scalar<T>::value)
+            return lazy_scalar<typename is_lazy_scalar<T>::type>{v};
+        else
+            return lazy(std::forward<T>(v)); // cml::lazy, or one found by ADL
+    }
+
+    template<typename T>
+    using lazy_operand_t = decltype(lazy_operand(std::declval<T>()));
+
+    template<typename L, typename R, typename = std::enable_if_t<is_lazy_expression<L>::value>>
+    constexpr auto operator + (const L& l, R&& r)
+    {
+        return lazy_binary<lazy_add, L, lazy_operand_t<R>>(l, lazy_operand(std::forward<R>(r)));
+    }
+
+    template<typename L, typename R, typename = std::enable_if_t<is_lazy_expression<L>::value>>
+    constexpr auto operator - (const L& l, R&& r)
+    {
+        return lazy_binary<lazy_sub, L, lazy_operand_t<R>>(l, lazy_operand(std::forward<R>(r)));
+    }
+
+    template<typename L, typename S, typename = std::enable_if_t<is_lazy_expression<L>::value && is_lazy_scalar<S>::value>>
+    constexpr auto operator * (const L& l, S s)
+    {
+        return lazy_binary<lazy_mul, L, lazy_scalar<S>>(l, lazy_scalar<S>{s});
+    }
+
+    template<typename S, typename R, typename = std::enable_if_t<is_lazy_expression<R>::value && is_lazy_scalar<S>::value>>
+    constexpr auto operator * (S s, const R& r)
+    {
+        return lazy_binary<lazy_mul, lazy_scalar<S>, R>(lazy_scalar<S>{s}, r);
+    }
+
+    template<typename L, typename S, typename = std::enable_if_t<is_lazy_expression<L>::value && is_lazy_scalar<S>::value>>
+    constexpr auto operator / (const L& l, S s)
+    {
+        return lazy_binary<lazy_div, L, lazy_scalar<S>>(l, lazy_scalar<S>{s});
+    }
+
+    template<typename E, typename = std::enable_if_t<is_lazy_expression<E>::value>>
+    constexpr auto operator - (const E& e)
+    {
+        return lazy_negate<E>(e);
+    }
+} // namespace cml::implementation
+
+#ifdef CML_COMPILE_TEST_CASE
+
+#include "definitions.hpp"
+#include "operators.hpp"
+
+static_assert((cml::lazy(cml::vec3(1, 2, 3)) + cml::vec3(1, 1, 1) * 2.f).eval() == cml::vec3(3, 4, 5));
+static_assert((cml::lazy(cml::vec3(1, 2, 3)) * 2.f - cml::lazy(cml::vec3(1, 1, 1)) / 2.f).eval() == cml::vec3(1.5f, 3.5f, 5.5f));
+static_assert((-cml::lazy(cml::ivec2(1, 2)) + 1).eval() == cml::ivec2(0, -1));
+static_assert(cml::vec3(cml::lazy(cml::vec3(1, 2, 3)) * 2.f) == cml::vec3(2, 4, 6));
+static_assert((cml::lazy(cml::f88vec3(cml::f88(1), cml::f88(2), cml::f88(3))) * cml::f88(2) + cml::f88vec3(cml::f88(0.5f))).eval()
+              == cml::f88vec3(cml::f88(2.5f), cml::f88(4.5f), cml::f88(6.5f)));
+
+#endif
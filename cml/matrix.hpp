@@ -29,7 +29,7 @@
 #include "matrix_components.hpp"
 #include "matrix_kind.hpp"
 #include "vector_component_table.hpp"
-#include "reference.hpp"
+#include "swizzle.hpp"
 
 #ifdef _MSC_VER
 #pragma warning( push )
@@ -40,13 +40,9 @@ namespace cml::implementation
 {
     template<size_t DimX, size_t DimY, typename ValueType, matrix_kind Kind> class matrix;
 
-    template<typename ValueType, size_t DimX, size_t DimY, matrix_kind Kind, bool IsConst> struct matrix_at_return_type { using type = matrix<DimX, DimY, ValueType, Kind>; };
-    template<typename ValueType, size_t DimX, size_t DimY, matrix_kind Kind> struct matrix_at_return_type<ValueType, DimX, DimY, Kind, true> { using type = matrix<DimX, DimY, ValueType, Kind>; };
-    template<typename ValueType, size_t DimX, size_t DimY, matrix_kind Kind> struct matrix_at_return_type<ValueType, DimX, DimY, Kind, false> { using type = matrix<DimX, DimY, reference<ValueType>, Kind>; };
-    template<typename ValueType, size_t DimX, size_t DimY, matrix_kind Kind> struct matrix_at_return_type<reference<ValueType>, DimX, DimY, Kind, false> { using type = matrix<DimX, DimY, reference<ValueType>, Kind>; };
-    template<typename ValueType, matrix_kind Kind> struct matrix_at_return_type<ValueType, 1, 1, Kind, true> { using type = const ValueType &; };
-    template<typename ValueType, matrix_kind Kind> struct matrix_at_return_type<ValueType, 1, 1, Kind, false> { using type = ValueType &; };
-    template<typename ValueType, bool IC, matrix_kind Kind> struct matrix_at_return_type<ValueType, 0, 1, Kind, IC> { using type = void; };
+    template<typename ValueType, size_t DimX, size_t DimY, matrix_kind Kind> struct matrix_at_return_type { using type = matrix<DimX, DimY, ValueType, Kind>; };
+    template<typename ValueType, matrix_kind Kind> struct matrix_at_return_type<ValueType, 1, 1, Kind> { using type = const ValueType &; };
+    template<typename ValueType, matrix_kind Kind> struct matrix_at_return_type<ValueType, 0, 1, Kind> { using type = void; };
 
     /// @brief Generic matrix class. Can hold multiple values of *any* type
     /// @tparam DimX The number of component this matrix have on X
@@ -101,10 +97,18 @@ namespace cml::implementation
         {
         }
 
+        /// @brief Identity matrix, or the (0, 0, 0, 1) quaternion for matrix_kind::quaternion
         static constexpr matrix<DimX, DimY, ValueType, Kind> identity()
         {
-            static_assert(DimX == DimY, "Only square matrices can be identity matrices");
-            return make_identity(std::make_index_sequence<DimX>{});
+            if constexpr(Kind == matrix_kind::quaternion && DimX == 4 && DimY == 1)
+            {
+                return matrix(ValueType(0), ValueType(0), ValueType(0), ValueType(1));
+            }
+            else
+            {
+                static_assert(DimX == DimY, "Only square matrices can be identity matrices");
+                return make_identity(std::make_index_sequence<DimX>{});
+            }
         }
 
         /// @brief Cast the matrix to any integral type that has the same size (or bigger)
@@ -138,9 +142,10 @@ namespace cml::implementation
             return convert_to_matrix<Type, OKind>(std::make_index_sequence<DimX * DimY>{});
         }
 
-        /// @brief Multi component access using large char at<'xyy'>() will return a three component matrix
+        /// @brief Multi component access using large char at<'xyy'>() will return a three component swizzle (a view
+        /// writing to this matrix, see swizzle.hpp)
         template<unsigned int Components>
-        constexpr auto _() -> typename matrix_at_return_type<ValueType, (Components > 0x000000FFu ? 2 : (Components > 0 ? 1 : 0)), 1, Kind, false>::type
+        constexpr decltype(auto) _()
         {
             if constexpr (Components == 0)
                 return; // void
@@ -156,7 +161,7 @@ namespace cml::implementation
 
         /// @brief Multi component access using large char at<'xyy'>() will return a three component matrix
         template<unsigned int Components>
-        constexpr auto _() const -> typename matrix_at_return_type<ValueType, (Components > 0x000000FFu ? 2 : (Components > 0 ? 1 : 0)), 1, Kind, true>::type
+        constexpr auto _() const -> typename matrix_at_return_type<ValueType, (Components > 0x000000FFu ? 2 : (Components > 0 ? 1 : 0)), 1, Kind>::type
         {
             if constexpr (Components == 0)
                 return; // void
@@ -172,19 +177,19 @@ namespace cml::implementation
 
         /// @brief Component Access (at<'x'>() will be the X component, at<'x', 'y'>() will return a matrix of the two component X and Y
         template<char... Components>
-        constexpr auto at_separate() -> typename matrix_at_return_type<ValueType, sizeof...(Components), 1, Kind, false>::type
+        constexpr decltype(auto) at_separate()
         {
             if constexpr (sizeof...(Components) == 0)
                 return; // void
             else if constexpr (sizeof...(Components) == 1)
                 return this->components[component_index_t<Components..., DimX * DimY>::index];
             else
-                return matrix<sizeof...(Components), 1, reference<ValueType>, Kind>(reference<ValueType>(&this->components[component_index_t<Components, DimX * DimY>::index])...);
+                return swizzle<matrix, component_index_t<Components, DimX * DimY>::index...>(*this);
         }
 
         /// @brief Component Access (at<'x'>() will be the X component, at<'x', 'y'>() will return a matrix of the two component X and Y
         template<char... Components>
-        constexpr auto at_separate() const -> typename matrix_at_return_type<ValueType, sizeof...(Components), 1, Kind, true>::type
+        constexpr auto at_separate() const -> typename matrix_at_return_type<ValueType, sizeof...(Components), 1, Kind>::type
         {
             if constexpr (sizeof...(Components) == 0)
                 return; // void
@@ -55,14 +55,19 @@ namespace cml::implementation
         private: \
             template<size_t... Idxs, typename... Args> \
             constexpr matrix_components(std::index_sequence<Idxs...>, Args &&... args) noexcept \
-            : components {{static_cast<ValueType>(get_nth_component<Idxs>(std::forward<Args>(args)...))...}} \
+            : matrix_components(std::index_sequence<Idxs...>{}, argument_pack<Args...>(std::forward<Args>(args)...)) \
+            {} \
+\
+            template<size_t... Idxs, typename... Args> \
+            constexpr matrix_components(std::index_sequence<Idxs...>, argument_pack<Args...>&& args) noexcept \
+            : components {{static_cast<ValueType>(get_component_at(get_argument<component_locations_table<Args...>.argument[Idxs]>(args), component_locations_table<Args...>.offset[Idxs]))...}} \
             {} \
 \
         public:
 
     // scalar:
     template<typename ValueType, matrix_kind Kind>
-    class matrix_components<matrix<1, 1, ValueType, Kind>>
+    class alignas(matrix_alignment<ValueType, 1, Kind>::value) matrix_components<matrix<1, 1, ValueType, Kind>>
     {
         private:
             using matrix_t = matrix<1, 1, ValueType, Kind>;
@@ -79,7 +84,7 @@ namespace cml::implementation
     // vectors:
 
     template<typename ValueType, matrix_kind Kind>
-    class matrix_components<matrix<2, 1, ValueType, Kind>>
+    class alignas(matrix_alignment<ValueType, 2, Kind>::value) matrix_components<matrix<2, 1, ValueType, Kind>>
     {
         private:
             using matrix_t = matrix<2, 1, ValueType, Kind>;
@@ -97,7 +102,7 @@ namespace cml::implementation
             };
     };
     template<typename ValueType, matrix_kind Kind>
-    class matrix_components<matrix<1, 2, ValueType, Kind>>
+    class alignas(matrix_alignment<ValueType, 2, Kind>::value) matrix_components<matrix<1, 2, ValueType, Kind>>
     {
         private:
             using matrix_t = matrix<1, 2, ValueType, Kind>;
@@ -116,7 +121,7 @@ namespace cml::implementation
     };
 
     template<typename ValueType, matrix_kind Kind>
-    class matrix_components<matrix<3, 1, ValueType, Kind>>
+    class alignas(matrix_alignment<ValueType, 3, Kind>::value) matrix_components<matrix<3, 1, ValueType, Kind>>
     {
         private:
             using matrix_t = matrix<3, 1, ValueType, Kind>;
@@ -135,7 +140,7 @@ namespace cml::implementation
             };
     };
     template<typename ValueType, matrix_kind Kind>
-    class matrix_components<matrix<1, 3, ValueType, Kind>>
+    class alignas(matrix_alignment<ValueType, 3, Kind>::value) matrix_components<matrix<1, 3, ValueType, Kind>>
     {
         private:
             using matrix_t = matrix<1, 3, ValueType, Kind>;
@@ -155,7 +160,7 @@ namespace cml::implementation
     };
 
     template<typename ValueType, matrix_kind Kind>
-    class matrix_components<matrix<4, 1, ValueType, Kind>>
+    class alignas(matrix_alignment<ValueType, 4, Kind>::value) matrix_components<matrix<4, 1, ValueType, Kind>>
     {
         private:
             using matrix_t = matrix<4, 1, ValueType, Kind>;
@@ -176,7 +181,7 @@ namespace cml::implementation
     };
 
     template<typename ValueType, matrix_kind Kind>
-    class matrix_components<matrix<1, 4, ValueType, Kind>>
+    class alignas(matrix_alignment<ValueType, 4, Kind>::value) matrix_components<matrix<1, 4, ValueType, Kind>>
     {
         private:
             using matrix_t = matrix<1, 4, ValueType, Kind>;
@@ -197,7 +202,7 @@ namespace cml::implementation
     };
 
     template<size_t DimX, typename ValueType, matrix_kind Kind>
-    class matrix_components<matrix<DimX, 1, ValueType, Kind>>
+    class alignas(matrix_alignment<ValueType, DimX, Kind>::value) matrix_components<matrix<DimX, 1, ValueType, Kind>>
     {
         private:
             using matrix_t = matrix<DimX, 1, ValueType, Kind>;
@@ -218,7 +223,7 @@ namespace cml::implementation
     };
 
     template<size_t DimY, typename ValueType, matrix_kind Kind>
-    class matrix_components<matrix<1, DimY, ValueType, Kind>>
+    class alignas(matrix_alignment<ValueType, DimY, Kind>::value) matrix_components<matrix<1, DimY, ValueType, Kind>>
     {
         private:
             using matrix_t = matrix<1, DimY, ValueType, Kind>;
@@ -240,7 +245,7 @@ namespace cml::implementation
 
     // matrices (somewhat generic)
     template<size_t DimX, size_t DimY, typename ValueType, matrix_kind Kind>
-    class matrix_components<matrix<DimY, DimX, ValueType, Kind>>
+    class alignas(matrix_alignment<ValueType, DimY * DimX, Kind>::value) matrix_components<matrix<DimY, DimX, ValueType, Kind>>
     {
         private:
             static_assert(DimY > 1);
@@ -252,7 +257,7 @@ namespace cml::implementation
             union
             {
                 std::array<ValueType, DimX * DimY> components = {{ ValueType() }};
-                std::array<matrix<DimX, 1, ValueType, Kind>, DimY> rows;
+                std::array<matrix<DimX, 1, ValueType, matrix_row_kind<ValueType, DimX, Kind>::value>, DimY> rows;
             };
     };
 #undef CML_MATRIX_COMPONENTS_BODY
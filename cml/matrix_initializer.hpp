@@ -23,6 +23,8 @@
 #pragma once
 
 #include <cstddef>
+#include <utility>
+#include <type_traits>
 
 #include "definitions.hpp"
 #include "matrix_kind.hpp"
@@ -31,6 +33,7 @@ namespace cml::implementation
 {
     template<size_t DimX, size_t DimY, typename ValueType, matrix_kind Kind> class matrix;
     template<typename ValueType> struct reference;
+    template<typename MatrixType, size_t... Idxs> class swizzle;
 
     /// @brief Return the component count of a given type
     template<typename ValueType>
@@ -43,70 +46,110 @@ namespace cml::implementation
     {
         static constexpr size_t count = DimX * DimY;
     };
+    template<typename MatrixType, size_t... Idxs>
+    struct get_component_count<swizzle<MatrixType, Idxs...>>
+    {
+        static constexpr size_t count = sizeof...(Idxs);
+    };
 
     /// @brief Count the number of components that are provided in the args
     template<typename... Args>
     struct count_components_from_args
     {
-        static constexpr size_t count = 0;
+        static constexpr size_t count = (size_t(0) + ... + get_component_count<std::decay_t<Args>>::count);
     };
-    template<typename ValueType, typename... Args>
-    struct count_components_from_args<ValueType, Args...>
+
+    /// @brief For every component provided by the args, the index of the argument it comes from and its index in
+    ///        that argument
+    template<typename... Args>
+    struct component_locations
     {
-        static constexpr size_t count = get_component_count<typename std::remove_reference<typename std::remove_cv<ValueType>::type>::type>::count + count_components_from_args<Args...>::count;
+        static constexpr size_t count = count_components_from_args<Args...>::count;
+
+        size_t argument[count > 0 ? count : 1] = {};
+        size_t offset[count > 0 ? count : 1] = {};
     };
 
-    /// @brief Return the nth component
-    template<size_t Index>
-    static constexpr auto get_nth_component() -> auto
+    /// @brief Fill the table with a loop instead of recursing through the args: building a matrix from N components
+    ///        stays O(N) instantiations
+    template<typename... Args>
+    constexpr component_locations<Args...> make_component_locations() noexcept
     {
-        static_assert(Index >= 0, "out of range access");
-        return; // will cause a compilation error (out of range ?)
+        constexpr size_t counts[] = {get_component_count<std::decay_t<Args>>::count..., 0};
+
+        component_locations<Args...> ret;
+        size_t index = 0;
+        for (size_t arg = 0; arg < sizeof...(Args); ++arg)
+        {
+            for (size_t offset = 0; offset < counts[arg]; ++offset, ++index)
+            {
+                ret.argument[index] = arg;
+                ret.offset[index] = offset;
+            }
+        }
+        return ret;
     }
 
-    template<size_t Index, typename ValueType, typename... Args>
-    static constexpr auto get_nth_component([[maybe_unused]]ValueType&& m, Args&&... args) -> auto;
+    template<typename... Args>
+    inline constexpr component_locations<Args...> component_locations_table = make_component_locations<Args...>();
 
-    template<size_t Index, size_t DimX, size_t DimY, typename ValueType, matrix_kind Kind, typename... Args>
-    static constexpr auto get_nth_component_obj([[maybe_unused]]const matrix<DimX, DimY, ValueType, Kind>& m, Args &&... args) -> auto
+    /// @brief Return the component at offset in a single argument
+    template<size_t DimX, size_t DimY, typename ValueType, matrix_kind Kind>
+    constexpr auto get_component_at(const matrix<DimX, DimY, ValueType, Kind>& m, size_t offset) -> auto
     {
-        if constexpr(Index < DimX * DimY)
-            return m.components[Index];
-        else
-            return get_nth_component<Index - (DimX * DimY)>(std::forward<Args>(args)...);
+        return m.components[offset];
     }
 
-    template<size_t Index, size_t FB, typename ValueType, typename... Args>
-    static constexpr auto get_nth_component_obj([[maybe_unused]]const fixed<ValueType, FB>& m, Args &&... args) -> auto
+    template<typename ValueType, size_t FB>
+    constexpr auto get_component_at(const fixed<ValueType, FB>& m, size_t) -> auto
     {
-        if constexpr(Index == 0)
-            return m;
-        else
-            return get_nth_component<Index - 1>(std::forward<Args>(args)...);
+        return m;
     }
 
-    template<size_t Index, typename ValueType, typename... Args>
-    static constexpr auto get_nth_component_obj([[maybe_unused]]const reference<ValueType>& m, Args &&... args) -> auto
+    template<typename MatrixType, size_t... Idxs>
+    constexpr auto get_component_at(const swizzle<MatrixType, Idxs...>& m, size_t offset) -> auto
     {
-        if constexpr(Index == 0)
-            return m;
-        else
-            return get_nth_component<Index - 1>(std::forward<Args>(args)...);
+        return m[offset];
     }
 
-    template<size_t Index, typename ValueType, typename... Args>
-    static constexpr auto get_nth_component([[maybe_unused]]ValueType&& m, Args&&... args) -> auto
+    template<typename ValueType>
+    constexpr auto get_component_at(const reference<ValueType>& m, size_t) -> auto
     {
-        if constexpr (std::is_arithmetic<typename std::remove_reference<typename std::remove_cv<ValueType>::type>::type>::value || std::is_pointer<ValueType>::value)
-        {
-            if constexpr(Index == 0)
-                return m;
-            else
-                return get_nth_component<Index - 1>(std::forward<Args>(args)...);
-        }
-        else
-        {
-            return get_nth_component_obj<Index>(std::forward<ValueType>(m), std::forward<Args>(args)...);
-        }
+        return m;
+    }
+
+    template<typename ValueType, typename = std::enable_if_t<std::is_arithmetic<ValueType>::value || std::is_pointer<ValueType>::value>>
+    constexpr auto get_component_at(ValueType m, size_t) -> auto
+    {
+        return m;
+    }
+
+    /// @brief Reference to a single argument, an argument_pack inherits one per argument
+    template<size_t Index, typename ValueType>
+    struct argument_leaf
+    {
+        ValueType&& value;
+    };
+
+    template<typename Indexes, typename... Args> struct argument_leaves;
+    template<size_t... Idxs, typename... Args>
+    struct argument_leaves<std::index_sequence<Idxs...>, Args...> : argument_leaf<Idxs, Args>...
+    {
+        constexpr argument_leaves(Args&&... args) noexcept : argument_leaf<Idxs, Args>{std::forward<Args>(args)}... {}
+    };
+
+    /// @brief Flat (non recursive) pack of the constructor args
+    template<typename... Args>
+    struct argument_pack : argument_leaves<std::index_sequence_for<Args...>, Args...>
+    {
+        constexpr argument_pack(Args&&... args) noexcept : argument_leaves<std::index_sequence_for<Args...>, Args...>(std::forward<Args>(args)...) {}
+    };
+
+    /// @brief Return the nth argument of a pack, the leaf is found by a derived to base conversion instead of a
+    ///        recursion through the args
+    template<size_t Index, typename ValueType>
+    constexpr auto get_argument(const argument_leaf<Index, ValueType>& leaf) -> const std::remove_reference_t<ValueType>&
+    {
+        return leaf.value;
     }
 } // namespace cml::implementation
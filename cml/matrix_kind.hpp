@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 namespace cml::implementation
 {
     /// \brief What kind of matrix is being used (yep, quaternions are treated as matrices...)
@@ -30,5 +32,42 @@ namespace cml::implementation
         normal,
         quaternion,
         other,
+        /// \brief A normal matrix whose storage is over-aligned for SIMD loads: up to 16 bytes to the size rounded up to a
+        /// power of two (3 component float vectors are padded to 16 bytes), then 32 bytes when the size is a multiple of
+        /// 32 (mat4, dvec4, dmat4) and 16 otherwise.
+        aligned,
+    };
+
+    /// \brief Alignment of the storage of a matrix of Count components
+    template<typename ValueType, size_t Count, matrix_kind Kind>
+    struct matrix_alignment
+    {
+        static constexpr size_t value = alignof(ValueType);
+    };
+
+    template<typename ValueType, size_t Count>
+    struct matrix_alignment<ValueType, Count, matrix_kind::aligned>
+    {
+    private:
+        static constexpr size_t size = sizeof(ValueType) * Count;
+        static constexpr size_t ceil_pow2(size_t v, size_t p = 1) { return p >= v ? p : ceil_pow2(v, p * 2); }
+        static constexpr size_t aligned = size <= 16 ? ceil_pow2(size) : (size % 32 == 0 ? 32 : 16);
+
+    public:
+        static constexpr size_t value = aligned > alignof(ValueType) ? aligned : alignof(ValueType);
+    };
+
+    /// \brief Kind of the rows of a matrix: the rows of an aligned matrix are only aligned when that does not pad them
+    /// (the rows of an aligned mat4 are aligned vec4, the ones of an aligned mat3 are normal vec3)
+    template<typename ValueType, size_t DimX, matrix_kind Kind>
+    struct matrix_row_kind
+    {
+        static constexpr matrix_kind value = Kind;
+    };
+
+    template<typename ValueType, size_t DimX>
+    struct matrix_row_kind<ValueType, DimX, matrix_kind::aligned>
+    {
+        static constexpr matrix_kind value = (sizeof(ValueType) * DimX) % matrix_alignment<ValueType, DimX, matrix_kind::aligned>::value == 0 ? matrix_kind::aligned : matrix_kind::normal;
     };
 } // namespace cml::implementation
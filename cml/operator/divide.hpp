@@ -33,7 +33,8 @@ namespace cml::implementation
     template<typename VType, size_t DimX, size_t DimY, matrix_kind Kind, typename SType>
     constexpr auto operator / (const matrix<DimX, DimY, VType, Kind>& v1, SType&& v2) -> auto
     {
-        if constexpr(std::is_arithmetic<SType>::value || is_fixed_point<SType>::value || is_reference<SType>::value || std::is_same<SType, VType>::value)
+        using S = std::decay_t<SType>;
+        if constexpr(std::is_arithmetic<S>::value || is_fixed_point<S>::value || is_reference<S>::value || std::is_same<S, VType>::value)
             return matrix_ms_div(std::make_index_sequence<DimX * DimY>{}, v1, v2);
         else
             return matrix_mm_div(std::make_index_sequence<DimX * DimY>{}, v1, v2);
@@ -48,7 +49,8 @@ namespace cml::implementation
     template<typename VType, size_t DimX, size_t DimY, matrix_kind Kind, typename SType>
     constexpr matrix<DimX, DimY, VType, Kind>& operator /= (matrix<DimX, DimY, VType, Kind>& v1, SType&& v2)
     {
-        if constexpr(std::is_arithmetic<SType>::value || is_fixed_point<SType>::value || is_reference<SType>::value || std::is_same<SType, VType>::value)
+        using S = std::decay_t<SType>;
+        if constexpr(std::is_arithmetic<S>::value || is_fixed_point<S>::value || is_reference<S>::value || std::is_same<S, VType>::value)
             return matrix_sms_div(std::make_index_sequence<DimX * DimY>{}, v1, v2);
         else
             return matrix_smm_div(std::make_index_sequence<DimX * DimY>{}, v1, v2);
@@ -57,7 +59,8 @@ namespace cml::implementation
     template<typename VType, size_t DimX, size_t DimY, matrix_kind Kind, typename SType>
     constexpr matrix<DimX, DimY, VType, Kind>&& operator /= (matrix<DimX, DimY, VType, Kind>&& v1, SType&& v2)
     {
-        if constexpr(std::is_arithmetic<SType>::value || is_fixed_point<SType>::value || is_reference<SType>::value || std::is_same<SType, VType>::value)
+        using S = std::decay_t<SType>;
+        if constexpr(std::is_arithmetic<S>::value || is_fixed_point<S>::value || is_reference<S>::value || std::is_same<S, VType>::value)
             return static_cast<matrix<DimX, DimY, VType, Kind>&&>(matrix_sms_div(std::make_index_sequence<DimX * DimY>{}, v1, v2));
         else
             return static_cast<matrix<DimX, DimY, VType, Kind>&&>(matrix_smm_div(std::make_index_sequence<DimX * DimY>{}, v1, v2));
@@ -0,0 +1,112 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#pragma once
+
+#include <array>
+
+#include "../config.hpp"
+#include "../fixed_point.hpp"
+#include "../simd/fixed.hpp"
+#include "../traits.hpp"
+
+namespace cml::implementation
+{
+    /// @brief Whether the integer kernels of simd/fixed.hpp handle Count components of VType: signed 16 bit fixed points
+    /// (sse2) and signed 32 bit ones (sse4.1), when there is at least a full 128 bit register to process: on less, the
+    /// partial loads and stores cost more than the scalar code
+    template<typename VType, size_t Count>
+    struct has_simd_fixed
+    {
+        static constexpr bool value = false;
+    };
+
+#ifdef CML_SIMD_SSE2
+    template<typename Type, size_t FB, size_t Count>
+    struct has_simd_fixed<fixed<Type, FB>, Count>
+    {
+        static constexpr bool value = simd::has_fixed_pack<Type, FB>::value && Count * sizeof(Type) >= 16;
+    };
+#endif
+
+    /// @brief Whether the integer kernels handle a fixed point matrix product: a row of the second matrix must fit in
+    /// 128 bits, and fill at least half of them
+    template<typename VType, size_t DimX1, size_t DimY1, size_t DimX2, size_t DimY2, matrix_kind Kind>
+    struct has_simd_fixed_mm_mul
+    {
+        static constexpr bool value = false;
+    };
+
+#ifdef CML_SIMD_SSE2
+    template<typename Type, size_t FB, size_t DimX1, size_t DimY1, size_t DimX2, size_t DimY2, matrix_kind Kind>
+    struct has_simd_fixed_mm_mul<fixed<Type, FB>, DimX1, DimY1, DimX2, DimY2, Kind>
+    {
+        static constexpr bool value = simd::has_fixed_pack<Type, FB>::value && DimX2 * sizeof(Type) >= 8 && DimX2 * sizeof(Type) <= 16
+                                   && (Kind == matrix_kind::normal || Kind == matrix_kind::aligned);
+    };
+#endif
+
+    /// @brief The raw values of fixed points, the kernels work on those
+    template<typename Type, size_t FB>
+    inline const Type* fixed_raw(const fixed<Type, FB>* p) noexcept { return reinterpret_cast<const Type*>(p); }
+    template<typename Type, size_t FB>
+    inline Type* fixed_raw(fixed<Type, FB>* p) noexcept { return reinterpret_cast<Type*>(p); }
+
+    template<typename VType, size_t DimX, size_t DimY, matrix_kind Kind, typename Op>
+    inline matrix<DimX, DimY, VType, Kind> fixed_mm_componentwise_simd(const matrix<DimX, DimY, VType, Kind>& v1, const matrix<DimX, DimY, VType, Kind>& v2, Op op)
+    {
+        matrix<DimX, DimY, VType, Kind> ret;
+#ifdef CML_SIMD_SSE2
+        simd::fixed_componentwise<typename VType::value_type, VType::fractional_bits, DimX * DimY>(fixed_raw(v1.components.data()), fixed_raw(v2.components.data()), fixed_raw(ret.components.data()), op);
+#endif
+        return ret;
+    }
+
+    template<typename VType, size_t DimX, size_t DimY, matrix_kind Kind>
+    inline matrix<DimX, DimY, VType, Kind> fixed_ms_mul_simd(const matrix<DimX, DimY, VType, Kind>& v1, const VType& v2)
+    {
+        matrix<DimX, DimY, VType, Kind> ret;
+#ifdef CML_SIMD_SSE2
+        simd::fixed_mul_scalar<typename VType::value_type, VType::fractional_bits, DimX * DimY>(fixed_raw(v1.components.data()), v2.data, fixed_raw(ret.components.data()));
+#endif
+        return ret;
+    }
+
+    template<typename VType, size_t DimX1, size_t DimY1, size_t DimX2, size_t DimY2, matrix_kind Kind>
+    inline matrix<DimX2, DimY1, VType, Kind> fixed_mm_mul_simd(const matrix<DimX1, DimY1, VType, Kind>& v1, const matrix<DimX2, DimY2, VType, Kind>& v2)
+    {
+        matrix<DimX2, DimY1, VType, Kind> ret;
+#ifdef CML_SIMD_SSE2
+        simd::fixed_mm_mul<typename VType::value_type, VType::fractional_bits, DimX1, DimY1, DimX2>(fixed_raw(v1.components.data()), fixed_raw(v2.components.data()), fixed_raw(ret.components.data()));
+#endif
+        return ret;
+    }
+
+    template<typename VType, size_t Count>
+    inline VType fixed_dot_simd(const std::array<VType, Count>& v1, const std::array<VType, Count>& v2)
+    {
+#ifdef CML_SIMD_SSE2
+        return {VType::from_fixed, simd::fixed_dot<typename VType::value_type, VType::fractional_bits, Count>(fixed_raw(v1.data()), fixed_raw(v2.data()))};
+#else
+        return VType(0);
+#endif
+    }
+}
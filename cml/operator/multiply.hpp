@@ -33,8 +33,13 @@ namespace cml::implementation
     template<typename VType, size_t DimX, size_t DimY, matrix_kind Kind, typename SType>
     constexpr auto operator * (const matrix<DimX, DimY, VType, Kind>& v1, SType&& v2) -> auto
     {
-        if constexpr(std::is_arithmetic<SType>::value || is_fixed_point<SType>::value || is_reference<SType>::value || std::is_same<SType, VType>::value)
+        using S = std::decay_t<SType>;
+        if constexpr(std::is_same<S, VType>::value && has_simd_fixed<VType, DimX * DimY>::value)
+            return matrix_ms_mul(v1, v2);
+        else if constexpr(std::is_arithmetic<S>::value || is_fixed_point<S>::value || is_reference<S>::value || std::is_same<S, VType>::value)
             return matrix_ms_mul(std::make_index_sequence<DimX * DimY>{}, v1, v2);
+        else if constexpr(std::is_same<S, matrix<4, 1, VType, matrix_kind::quaternion>>::value && Kind == matrix_kind::quaternion)
+            return quaternion_mul(v1, v2);
         else
             return matrix_mm_mul(v1, v2);
     }
@@ -42,22 +47,33 @@ namespace cml::implementation
     template<typename VType, size_t DimX, size_t DimY, matrix_kind Kind>
     constexpr auto operator * (VType v1, const matrix<DimX, DimY, VType, Kind>& v2) -> auto
     {
-        return matrix_sm_mul(std::make_index_sequence<DimX * DimY>{}, v1, v2);
+        if constexpr(has_simd_fixed<VType, DimX * DimY>::value)
+            return matrix_ms_mul(v2, v1);
+        else
+            return matrix_sm_mul(std::make_index_sequence<DimX * DimY>{}, v1, v2);
     }
 
     template<typename VType, size_t DimX, size_t DimY, matrix_kind Kind, typename SType>
     constexpr matrix<DimX, DimY, VType, Kind>& operator *= (matrix<DimX, DimY, VType, Kind>& v1, SType&& v2)
     {
-        if constexpr(std::is_arithmetic<SType>::value || is_fixed_point<SType>::value || is_reference<SType>::value || std::is_same<SType, VType>::value)
+        using S = std::decay_t<SType>;
+        if constexpr(std::is_same<S, VType>::value && has_simd_fixed<VType, DimX * DimY>::value)
+            return (v1 = matrix_ms_mul(v1, v2));
+        else if constexpr(std::is_arithmetic<S>::value || is_fixed_point<S>::value || is_reference<S>::value || std::is_same<S, VType>::value)
             return matrix_sms_mul(std::make_index_sequence<DimX * DimY>{}, v1, v2);
+        else if constexpr(std::is_same<S, matrix<4, 1, VType, matrix_kind::quaternion>>::value && Kind == matrix_kind::quaternion)
+            return (v1 = quaternion_mul(v1, v2));
         else
             return matrix_smm_mul(v1, v2);
     }
     template<typename VType, size_t DimX, size_t DimY, matrix_kind Kind, typename SType>
     constexpr matrix<DimX, DimY, VType, Kind>&& operator *= (matrix<DimX, DimY, VType, Kind>&& v1, SType&& v2)
     {
-        if constexpr(std::is_arithmetic<SType>::value || is_fixed_point<SType>::value || is_reference<SType>::value || std::is_same<SType, VType>::value)
+        using S = std::decay_t<SType>;
+        if constexpr(std::is_arithmetic<S>::value || is_fixed_point<S>::value || is_reference<S>::value || std::is_same<S, VType>::value)
             return static_cast<matrix<DimX, DimY, VType, Kind>&&>(matrix_sms_mul(std::make_index_sequence<DimX * DimY>{}, v1, v2));
+        else if constexpr(std::is_same<S, matrix<4, 1, VType, matrix_kind::quaternion>>::value && Kind == matrix_kind::quaternion)
+            return static_cast<matrix<DimX, DimY, VType, Kind>&&>(v1 = quaternion_mul(v1, v2));
         else
             return static_cast<matrix<DimX, DimY, VType, Kind>&&>(matrix_smm_mul(v1, v2));
     }
@@ -22,6 +22,13 @@
 
 #pragma once
 
+#include <array>
+
+#include "../config.hpp"
+#include "../simd/gemm.hpp"
+#include "../simd/mat4.hpp"
+#include "../simd/quaternion.hpp"
+#include "fixed_impl.hpp"
 #include "../traits.hpp"
 
 namespace cml::implementation
@@ -48,11 +55,220 @@ namespace cml::implementation
         return {matrix_mm_mul_dot<Idxs>(std::make_index_sequence<DimY2>{}, v1, v2)...};
     }
 
+    /// @brief Above that many multiply-adds (DimX2 * DimY1 * DimY2) the products use the loops of matrix_mm_mul_blocked
+    /// instead of one fold expression per component: the folds instantiate a function per component and the optimizer
+    /// gives up on them long before 64x64
+    constexpr size_t mm_mul_blocked_threshold = 512;
+
+    /// @brief Tiling of matrix_mm_mul_blocked: a mr x nr tile of the result stays in registers (nr values fill two 128 bit
+    /// registers) while it accumulates a kc long slice of the common dimension, mc rows at a time, so the mc x kc block of
+    /// the first matrix and the kc x nr panel of the second one stay in L1
+    template<typename VType>
+    struct mm_mul_blocking
+    {
+        static constexpr size_t mr = 4;
+        static constexpr size_t nr = sizeof(VType) >= 32 ? 1 : 32 / sizeof(VType);
+        static constexpr size_t kc = 128;
+        static constexpr size_t mc = 32;
+    };
+
+    /// @brief Whether the product goes through matrix_mm_mul_blocked
+    template<typename VType, size_t DimX1, size_t DimY1, size_t DimX2, size_t DimY2, matrix_kind Kind>
+    struct use_blocked_mm_mul
+    {
+        static constexpr bool value = std::is_same<VType, typename remove_reference<VType>::type>::value && DimX2 * DimY1 * DimY2 > mm_mul_blocked_threshold;
+    };
+
+    /// @brief Whether simd::mm_mul_tile computes the full tiles at runtime (float and double)
+    template<typename VType>
+    struct has_simd_mm_mul_tile
+    {
+#ifdef CML_SIMD_SSE2
+        static constexpr bool value = std::is_same<VType, float>::value || std::is_same<VType, double>::value;
+#else
+        static constexpr bool value = false;
+#endif
+    };
+
+    /// @brief c[i + r][j + s] += sum of a[i + r][k] * b[k][j + s] for k in [k0, k1), on a full Rows x Cols tile whose
+    /// accumulators stay in registers (a is M x K, b is K x N and c is M x N, all row major)
+    template<size_t Rows, size_t Cols, typename VType>
+    constexpr void mm_mul_tile(const VType* a, const VType* b, VType* c, size_t n, size_t k, size_t i, size_t j, size_t k0, size_t k1)
+    {
+        if constexpr(has_simd_mm_mul_tile<VType>::value)
+        {
+            if (!is_constant_evaluated())
+            {
+#ifdef CML_SIMD_SSE2
+                simd::mm_mul_tile(a + i * k, b + j, c + i * n + j, n, k, k0, k1);
+#endif
+                return;
+            }
+        }
+        VType acc[Rows][Cols] = {};
+        for (size_t r = 0; r < Rows; ++r)
+            for (size_t s = 0; s < Cols; ++s)
+                acc[r][s] = c[(i + r) * n + j + s];
+        for (size_t l = k0; l < k1; ++l)
+        {
+            for (size_t r = 0; r < Rows; ++r)
+            {
+                const VType arl = a[(i + r) * k + l];
+                for (size_t s = 0; s < Cols; ++s)
+                    acc[r][s] += arl * b[l * n + j + s];
+            }
+        }
+        for (size_t r = 0; r < Rows; ++r)
+            for (size_t s = 0; s < Cols; ++s)
+                c[(i + r) * n + j + s] = acc[r][s];
+    }
+
+    /// @brief Same as mm_mul_tile for the partial tiles of the last rows and columns (the sums are in the same order, a
+    /// row of b at a time)
+    template<typename VType>
+    constexpr void mm_mul_edge(const VType* a, const VType* b, VType* c, size_t n, size_t k, size_t i, size_t j, size_t rows, size_t cols, size_t k0, size_t k1)
+    {
+        for (size_t r = 0; r < rows; ++r)
+        {
+            VType* cr = c + (i + r) * n + j;
+            for (size_t l = k0; l < k1; ++l)
+            {
+                const VType arl = a[(i + r) * k + l];
+                for (size_t s = 0; s < cols; ++s)
+                    cr[s] += arl * b[l * n + j + s];
+            }
+        }
+    }
+
+    /// @brief c += a * b on the rows [row_begin, row_end) of c, blocked for the caches and tiled for the registers. a has
+    /// k columns, b k rows of n columns and c n columns, all row major. The same loops run at compile time, the runtime
+    /// tiles of float and double use simd::mm_mul_tile.
+    template<typename VType>
+    constexpr void mm_mul_blocked(const VType* a, const VType* b, VType* c, size_t n, size_t k, size_t row_begin, size_t row_end)
+    {
+        using blocking = mm_mul_blocking<VType>;
+        for (size_t k0 = 0; k0 < k; k0 += blocking::kc)
+        {
+            const size_t k1 = k0 + blocking::kc < k ? k0 + blocking::kc : k;
+            for (size_t i0 = row_begin; i0 < row_end; i0 += blocking::mc)
+            {
+                const size_t i1 = i0 + blocking::mc < row_end ? i0 + blocking::mc : row_end;
+                for (size_t j = 0; j < n; j += blocking::nr)
+                {
+                    const size_t cols = j + blocking::nr < n ? blocking::nr : n - j;
+                    for (size_t i = i0; i < i1; i += blocking::mr)
+                    {
+                        const size_t rows = i + blocking::mr < i1 ? blocking::mr : i1 - i;
+                        if (rows == blocking::mr && cols == blocking::nr)
+                            mm_mul_tile<blocking::mr, blocking::nr>(a, b, c, n, k, i, j, k0, k1);
+                        else
+                            mm_mul_edge(a, b, c, n, k, i, j, rows, cols, k0, k1);
+                    }
+                }
+            }
+        }
+    }
+
+    /// @brief Loop based product of big matrices (v1 has DimY1 rows of DimX1 components, v2 DimY2 rows of DimX2), see
+    /// mm_mul_blocked
+    template<typename VType, size_t DimX1, size_t DimY1, size_t DimX2, size_t DimY2, matrix_kind Kind>
+    constexpr matrix<DimX2, DimY1, VType, Kind> matrix_mm_mul_blocked(const matrix<DimX1, DimY1, VType, Kind>& v1, const matrix<DimX2, DimY2, VType, Kind>& v2)
+    {
+        std::array<VType, DimX2 * DimY1> ret = {};
+        mm_mul_blocked(v1.components.data(), v2.components.data(), ret.data(), DimX2, DimX1, 0, DimY1);
+        return matrix<DimX2, DimY1, VType, Kind>(ret);
+    }
+
+    /// @brief Whether a runtime SIMD kernel exists for this multiplication (float mat4 * mat4 and vec4 * mat4, normal or
+    /// aligned: the aligned kind uses aligned loads and stores)
+    template<typename VType, size_t DimX1, size_t DimY1, size_t DimX2, size_t DimY2, matrix_kind Kind>
+    struct has_simd_mm_mul
+    {
+#ifdef CML_SIMD_SSE2
+        static constexpr bool value = std::is_same<VType, float>::value && (Kind == matrix_kind::normal || Kind == matrix_kind::aligned)
+                                   && DimX1 == 4 && DimX2 == 4 && DimY2 == 4 && (DimY1 == 4 || DimY1 == 1);
+#else
+        static constexpr bool value = false;
+#endif
+    };
+
+    template<typename VType, size_t DimX1, size_t DimY1, size_t DimX2, size_t DimY2, matrix_kind Kind>
+    inline matrix<DimX2, DimY1, VType, Kind> matrix_mm_mul_simd(const matrix<DimX1, DimY1, VType, Kind>& v1, const matrix<DimX2, DimY2, VType, Kind>& v2)
+    {
+        constexpr bool aligned = Kind == matrix_kind::aligned;
+        alignas(matrix_alignment<VType, DimX2 * DimY1, Kind>::value) std::array<VType, DimX2 * DimY1> ret; // left uninitialized, the kernels write every component
+#ifdef CML_SIMD_SSE2
+        if constexpr(DimY1 == 4)
+            simd::mat4_mul<aligned>(v1.components.data(), v2.components.data(), ret.data());
+        else
+            simd::vec4_mat4_mul<aligned>(v1.components.data(), v2.components.data(), ret.data());
+#endif
+        return matrix<DimX2, DimY1, VType, Kind>(ret);
+    }
+
     template<typename VType, size_t DimX1, size_t DimY1, size_t DimX2, size_t DimY2, matrix_kind Kind>
     constexpr auto matrix_mm_mul(const matrix<DimX1, DimY1, VType, Kind>& v1, const matrix<DimX2, DimY2, VType, Kind>& v2) -> auto
     {
         static_assert(DimX1 == DimY2, "Cannot multiply matrices when the number of columns of the first matrix is different from the number of rows of the second matrix");
-        return matrix_mm_mul(std::make_index_sequence<DimX2 * DimY1>{}, v1, v2);
+        if constexpr(has_simd_mm_mul<VType, DimX1, DimY1, DimX2, DimY2, Kind>::value)
+        {
+            if (!is_constant_evaluated())
+                return matrix_mm_mul_simd(v1, v2);
+        }
+        else if constexpr(has_simd_fixed_mm_mul<VType, DimX1, DimY1, DimX2, DimY2, Kind>::value)
+        {
+            if (!is_constant_evaluated())
+                return fixed_mm_mul_simd(v1, v2);
+        }
+        if constexpr(use_blocked_mm_mul<VType, DimX1, DimY1, DimX2, DimY2, Kind>::value)
+            return matrix_mm_mul_blocked(v1, v2);
+        else
+            return matrix_mm_mul(std::make_index_sequence<DimX2 * DimY1>{}, v1, v2);
+    }
+
+    /// @brief Hamilton product, quaternions are stored (x, y, z, w)
+    template<typename VType>
+    constexpr matrix<4, 1, VType, matrix_kind::quaternion> quaternion_mul_impl(const matrix<4, 1, VType, matrix_kind::quaternion>& a, const matrix<4, 1, VType, matrix_kind::quaternion>& b)
+    {
+        const auto& p = a.components;
+        const auto& q = b.components;
+        return matrix<4, 1, VType, matrix_kind::quaternion>(
+            p[3] * q[0] + p[0] * q[3] + p[1] * q[2] - p[2] * q[1],
+            p[3] * q[1] - p[0] * q[2] + p[1] * q[3] + p[2] * q[0],
+            p[3] * q[2] + p[0] * q[1] - p[1] * q[0] + p[2] * q[3],
+            p[3] * q[3] - p[0] * q[0] - p[1] * q[1] - p[2] * q[2]);
+    }
+
+    /// @brief Whether the quaternion functions (product, rotation) have a runtime SIMD kernel (float)
+    template<typename VType>
+    struct has_simd_quaternion
+    {
+#ifdef CML_SIMD_SSE2
+        static constexpr bool value = std::is_same<VType, float>::value;
+#else
+        static constexpr bool value = false;
+#endif
+    };
+
+    template<typename VType>
+    inline matrix<4, 1, VType, matrix_kind::quaternion> quaternion_mul_simd(const matrix<4, 1, VType, matrix_kind::quaternion>& a, const matrix<4, 1, VType, matrix_kind::quaternion>& b)
+    {
+        std::array<VType, 4> ret; // left uninitialized, the kernel writes every component
+#ifdef CML_SIMD_SSE2
+        simd::quat_mul(a.components.data(), b.components.data(), ret.data());
+#endif
+        return matrix<4, 1, VType, matrix_kind::quaternion>(ret);
+    }
+
+    template<typename VType>
+    constexpr matrix<4, 1, VType, matrix_kind::quaternion> quaternion_mul(const matrix<4, 1, VType, matrix_kind::quaternion>& a, const matrix<4, 1, VType, matrix_kind::quaternion>& b)
+    {
+        if constexpr(has_simd_quaternion<VType>::value)
+        {
+            if (!is_constant_evaluated())
+                return quaternion_mul_simd(a, b);
+        }
+        return quaternion_mul_impl(a, b);
     }
 
     template<typename MType, typename SType, size_t... Idxs>
@@ -67,6 +283,18 @@ namespace cml::implementation
         return {v1 * v2.components[Idxs]...};
     }
 
+    /// @brief matrix * scalar and scalar * matrix (the product commutes) for a scalar of the type of the components
+    template<typename VType, size_t DimX, size_t DimY, matrix_kind Kind>
+    constexpr matrix<DimX, DimY, VType, Kind> matrix_ms_mul(const matrix<DimX, DimY, VType, Kind>& v1, const VType& v2)
+    {
+        if constexpr(has_simd_fixed<VType, DimX * DimY>::value)
+        {
+            if (!is_constant_evaluated())
+                return fixed_ms_mul_simd(v1, v2);
+        }
+        return matrix_ms_mul(std::make_index_sequence<DimX * DimY>{}, v1, v2);
+    }
+
     template<typename M1, typename M2>
     constexpr M1& matrix_smm_mul(M1& v1, const M2& v2)
     {
@@ -33,9 +33,10 @@ namespace cml::implementation
     template<typename VType, size_t DimX, size_t DimY, matrix_kind Kind, typename SType>
     constexpr bool operator != (const matrix<DimX, DimY, VType, Kind>& v1, SType&& v2)
     {
-        if constexpr(std::is_arithmetic<SType>::value || is_fixed_point<SType>::value || is_reference<SType>::value || std::is_same<SType, VType>::value)
+        using S = std::decay_t<SType>;
+        if constexpr(std::is_arithmetic<S>::value || is_fixed_point<S>::value || is_reference<S>::value || std::is_same<S, VType>::value)
             return matrix_ms_neq(std::make_index_sequence<DimX * DimY>{}, v1, v2);
-        else if constexpr (std::is_same<matrix<DimX, DimY, VType, Kind>, SType>::value)
+        else if constexpr (std::is_same<matrix<DimX, DimY, VType, Kind>, S>::value)
             return matrix_mm_neq(std::make_index_sequence<DimX * DimY>{}, v1, v2);
         else
             return false;
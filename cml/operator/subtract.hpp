@@ -33,10 +33,11 @@ namespace cml::implementation
     template<typename VType, size_t DimX, size_t DimY, matrix_kind Kind, typename SType>
     constexpr auto operator - (const matrix<DimX, DimY, VType, Kind>& v1, SType&& v2) -> auto
     {
-        if constexpr(std::is_arithmetic<SType>::value || is_fixed_point<SType>::value || is_reference<SType>::value || std::is_same<SType, VType>::value)
+        using S = std::decay_t<SType>;
+        if constexpr(std::is_arithmetic<S>::value || is_fixed_point<S>::value || is_reference<S>::value || std::is_same<S, VType>::value)
             return matrix_ms_sub(std::make_index_sequence<DimX * DimY>{}, v1, v2);
         else
-            return matrix_mm_sub(std::make_index_sequence<DimX * DimY>{}, v1, v2);
+            return matrix_mm_sub(v1, v2);
     }
 
     template<typename VType, size_t DimX, size_t DimY, matrix_kind Kind>
@@ -48,18 +49,20 @@ namespace cml::implementation
     template<typename VType, size_t DimX, size_t DimY, matrix_kind Kind, typename SType>
     constexpr matrix<DimX, DimY, VType, Kind>& operator -= (matrix<DimX, DimY, VType, Kind>& v1, SType&& v2)
     {
-        if constexpr(std::is_arithmetic<SType>::value || is_fixed_point<SType>::value || is_reference<SType>::value || std::is_same<SType, VType>::value)
+        using S = std::decay_t<SType>;
+        if constexpr(std::is_arithmetic<S>::value || is_fixed_point<S>::value || is_reference<S>::value || std::is_same<S, VType>::value)
             return matrix_sms_sub(std::make_index_sequence<DimX * DimY>{}, v1, v2);
         else
-            return matrix_smm_sub(std::make_index_sequence<DimX * DimY>{}, v1, v2);
+            return matrix_smm_sub(v1, v2);
     }
 
     template<typename VType, size_t DimX, size_t DimY, matrix_kind Kind, typename SType>
     constexpr matrix<DimX, DimY, VType, Kind>&& operator -= (matrix<DimX, DimY, VType, Kind>&& v1, SType&& v2)
     {
-        if constexpr(std::is_arithmetic<SType>::value || is_fixed_point<SType>::value || is_reference<SType>::value || std::is_same<SType, VType>::value)
+        using S = std::decay_t<SType>;
+        if constexpr(std::is_arithmetic<S>::value || is_fixed_point<S>::value || is_reference<S>::value || std::is_same<S, VType>::value)
             return static_cast<matrix<DimX, DimY, VType, Kind>&&>(matrix_sms_sub(std::make_index_sequence<DimX * DimY>{}, v1, v2));
         else
-            return static_cast<matrix<DimX, DimY, VType, Kind>&&>(matrix_smm_sub(std::make_index_sequence<DimX * DimY>{}, v1, v2));
+            return static_cast<matrix<DimX, DimY, VType, Kind>&&>(matrix_smm_sub(v1, v2));
     }
 }
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "fixed_impl.hpp"
 #include "../traits.hpp"
 
 namespace cml::implementation
@@ -32,6 +33,17 @@ namespace cml::implementation
         return {v1.components[Idxs] - v2.components[Idxs]...};
     }
 
+    template<typename VType, size_t DimX, size_t DimY, matrix_kind Kind>
+    constexpr matrix<DimX, DimY, VType, Kind> matrix_mm_sub(const matrix<DimX, DimY, VType, Kind>& v1, const matrix<DimX, DimY, VType, Kind>& v2)
+    {
+        if constexpr(has_simd_fixed<VType, DimX * DimY>::value)
+        {
+            if (!is_constant_evaluated())
+                return fixed_mm_componentwise_simd(v1, v2, [](auto a, auto b) { return a - b; });
+        }
+        return matrix_mm_sub(std::make_index_sequence<DimX * DimY>{}, v1, v2);
+    }
+
     template<typename MType, typename SType, size_t... Idxs>
     static constexpr remove_matrix_reference_t<MType> matrix_ms_sub(std::index_sequence<Idxs...>, const MType& v1, SType&& v2)
     {
@@ -56,6 +68,17 @@ namespace cml::implementation
         return v1;
     }
 
+    template<typename VType, size_t DimX, size_t DimY, matrix_kind Kind>
+    constexpr matrix<DimX, DimY, VType, Kind>& matrix_smm_sub(matrix<DimX, DimY, VType, Kind>& v1, const matrix<DimX, DimY, VType, Kind>& v2)
+    {
+        if constexpr(has_simd_fixed<VType, DimX * DimY>::value)
+        {
+            if (!is_constant_evaluated())
+                return (v1 = fixed_mm_componentwise_simd(v1, v2, [](auto a, auto b) { return a - b; }));
+        }
+        return matrix_smm_sub(std::make_index_sequence<DimX * DimY>{}, v1, v2);
+    }
+
     template<typename MType, typename SType, size_t... Idxs>
     static constexpr MType& matrix_sms_sub(std::index_sequence<Idxs...>, MType& v1, SType&& v2)
     {
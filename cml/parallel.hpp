@@ -0,0 +1,452 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifdef CML_PARALLEL_STD_EXECUTION
+#include <execution>
+#include <numeric>
+#endif
+
+#include "span.hpp"
+
+// Batched algorithms on whole arrays, split between threads: cml::parallel::transform, for_each, reduce and
+// transform_reduce. The arrays are cut in chunks of whole cache lines (chunk_size) that are spread over the threads of
+// a work stealing thread_pool: each thread starts on its own contiguous share of the chunks, and takes half of the
+// remaining chunks of another one when it runs out.
+//
+// Every algorithm has an overload taking the thread_pool to use, the others use thread_pool::global() (one thread per
+// hardware thread), or the standard parallel algorithms when CML_PARALLEL_STD_EXECUTION is defined (c++17
+// <execution>, gcc needs TBB to actually run them in parallel).
+namespace cml::parallel
+{
+    /// @brief Size of the cache lines, chunks never share one (as long as the arrays are aligned on them)
+    constexpr size_t cache_line_size = 64;
+
+    /// @brief Minimal size in bytes of the chunks: smaller ones cost more in scheduling than they save
+    constexpr size_t chunk_bytes = 16384;
+
+    namespace implementation
+    {
+        constexpr size_t gcd(size_t a, size_t b) noexcept
+        {
+            while (b != 0)
+            {
+                const size_t t = a % b;
+                a = b;
+                b = t;
+            }
+            return a;
+        }
+    }
+
+    /// @brief Number of elements per chunk for arrays of Type: a whole number of cache lines, at least chunk_bytes
+    template<typename Type>
+    constexpr size_t chunk_size() noexcept
+    {
+        constexpr size_t line_elements = cache_line_size / implementation::gcd(sizeof(Type), cache_line_size);
+        constexpr size_t elements = chunk_bytes / sizeof(Type) > 0 ? chunk_bytes / sizeof(Type) : 1;
+        return (elements + line_elements - 1) / line_elements * line_elements;
+    }
+
+    /// @brief Fork / join thread pool with work stealing. The thread calling run() works too: a pool of thread_count
+    /// threads starts thread_count - 1 workers.
+    class thread_pool
+    {
+    public:
+        /// @brief thread_count threads including the caller (0 for one per hardware thread)
+        explicit thread_pool(size_t thread_count = 0)
+        {
+            if (thread_count == 0)
+                thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+            m_ranges.reset(new range[thread_count]);
+            m_workers.reserve(thread_count - 1);
+            try
+            {
+                for (size_t i = 1; i < thread_count; ++i)
+                    m_workers.emplace_back([this, i] { work(i); });
+            }
+            catch (...)
+            {
+                // the workers already started must be joined before their std::thread is destroyed
+                stop();
+                throw;
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator = (const thread_pool&) = delete;
+
+        ~thread_pool()
+        {
+            stop();
+        }
+
+        /// @brief Number of threads, the caller included
+        size_t size() const noexcept { return m_workers.size() + 1; }
+
+        /// @brief Pool shared by the overloads that don't take one, one thread per hardware thread
+        static thread_pool& global()
+        {
+            static thread_pool pool;
+            return pool;
+        }
+
+        /// @brief Call function(begin, end) on the chunks of chunk elements of [0, count), and return when they are all
+        /// done. The first exception thrown by function is rethrown here. Calls made from inside a task, or on a pool
+        /// of one thread, run on the calling thread; concurrent calls from other threads wait for their turn.
+        template<typename Function>
+        void run(size_t count, size_t chunk, Function&& function)
+        {
+            chunk = std::max<size_t>(chunk, 1);
+            // the ranges pack two 32 bit chunk indexes
+            chunk = std::max<size_t>(chunk, count / 0xFFFFFFFFu + 1);
+            const size_t chunks = (count + chunk - 1) / chunk;
+            if (chunks <= 1 || m_workers.empty() || in_task())
+            {
+                // same chunks as the threaded path, the reductions give the same results
+                for (size_t begin = 0; begin < count; begin += chunk)
+                    function(begin, std::min(count, begin + chunk));
+                return;
+            }
+
+            std::lock_guard<std::mutex> submit(m_submit);
+            auto call = [&function, chunk, count](size_t index)
+            {
+                const size_t begin = index * chunk;
+                function(begin, std::min(count, begin + chunk));
+            };
+            job j;
+            j.call = [](void* context, size_t index) { (*static_cast<decltype(call)*>(context))(index); };
+            j.context = &call;
+            j.participants = std::min(size(), chunks);
+            j.remaining.store(chunks, std::memory_order_relaxed);
+            j.active.store(j.participants - 1, std::memory_order_relaxed);
+            for (size_t i = 0; i < j.participants; ++i)
+                m_ranges[i].value.store(pack(chunks * i / j.participants, chunks * (i + 1) / j.participants), std::memory_order_relaxed);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_job = &j;
+                m_participants = j.participants;
+                ++m_generation;
+            }
+            m_wake.notify_all();
+
+            in_task() = true;
+            execute(j, 0);
+            in_task() = false;
+
+            // the workers may still be on their last chunks, and must be done with the job before it goes away
+            while (j.remaining.load(std::memory_order_acquire) != 0 || j.active.load(std::memory_order_acquire) != 0)
+                std::this_thread::yield();
+            if (j.error)
+                std::rethrow_exception(j.error);
+        }
+
+    private:
+        struct job
+        {
+            void (*call)(void*, size_t) = nullptr;
+            void* context = nullptr;
+            size_t participants = 0;
+            std::atomic<size_t> remaining{0};
+            std::atomic<size_t> active{0};
+            std::atomic<bool> failed{false};
+            std::exception_ptr error;
+        };
+
+        /// @brief [begin, end) chunk indexes left to a thread, one per cache line
+        struct alignas(cache_line_size) range
+        {
+            std::atomic<uint64_t> value{0};
+        };
+
+        static constexpr uint64_t pack(size_t begin, size_t end) noexcept { return (uint64_t(end) << 32) | uint64_t(begin); }
+        static constexpr size_t begin_of(uint64_t r) noexcept { return size_t(r & 0xFFFFFFFFu); }
+        static constexpr size_t end_of(uint64_t r) noexcept { return size_t(r >> 32); }
+
+        static bool& in_task() noexcept
+        {
+            static thread_local bool value = false;
+            return value;
+        }
+
+        /// @brief Take the first chunk of a range
+        bool pop(size_t self, size_t& index) noexcept
+        {
+            uint64_t r = m_ranges[self].value.load(std::memory_order_relaxed);
+            while (begin_of(r) < end_of(r))
+            {
+                if (m_ranges[self].value.compare_exchange_weak(r, pack(begin_of(r) + 1, end_of(r)), std::memory_order_relaxed))
+                {
+                    index = begin_of(r);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /// @brief Move the second half of the range of another thread to the (empty) range of self
+        bool steal(const job& j, size_t self) noexcept
+        {
+            for (size_t i = 1; i < j.participants; ++i)
+            {
+                range& victim = m_ranges[(self + i) % j.participants];
+                uint64_t r = victim.value.load(std::memory_order_relaxed);
+                while (begin_of(r) < end_of(r))
+                {
+                    const size_t middle = end_of(r) - (end_of(r) - begin_of(r) + 1) / 2;
+                    if (victim.value.compare_exchange_weak(r, pack(begin_of(r), middle), std::memory_order_relaxed))
+                    {
+                        // only the owner writes its empty range, and thieves skip empty ranges
+                        m_ranges[self].value.store(pack(middle, end_of(r)), std::memory_order_relaxed);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        void execute(job& j, size_t self)
+        {
+            for (;;)
+            {
+                size_t index;
+                if (!pop(self, index))
+                {
+                    if (!steal(j, self))
+                        return;
+                    continue;
+                }
+                if (!j.failed.load(std::memory_order_relaxed))
+                {
+                    try
+                    {
+                        j.call(j.context, index);
+                    }
+                    catch (...)
+                    {
+                        if (!j.failed.exchange(true))
+                            j.error = std::current_exception();
+                    }
+                }
+                j.remaining.fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        void work(size_t self)
+        {
+            in_task() = true;
+            size_t generation = 0;
+            for (;;)
+            {
+                job* j = nullptr;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_wake.wait(lock, [&] { return m_stop || m_generation != generation; });
+                    if (m_stop)
+                        return;
+                    generation = m_generation;
+                    if (self < m_participants)
+                        j = m_job;
+                }
+                if (j != nullptr)
+                {
+                    execute(*j, self);
+                    j->active.fetch_sub(1, std::memory_order_release);
+                }
+            }
+        }
+
+        /// @brief Wake the workers up to return, and join them
+        void stop() noexcept
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_wake.notify_all();
+            for (std::thread& worker : m_workers)
+                worker.join();
+        }
+
+    private:
+        std::vector<std::thread> m_workers;
+        std::unique_ptr<range[]> m_ranges;
+
+        std::mutex m_submit;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        job* m_job = nullptr;
+        size_t m_participants = 0;
+        size_t m_generation = 0;
+        bool m_stop = false;
+    };
+
+    /// @brief out[i] = function(in[i]). in and out can be the same array.
+    template<typename InType, typename OutType, typename Function>
+    void transform(thread_pool& pool, span<InType> in, span<OutType> out, Function function)
+    {
+        if (out.size() < in.size())
+            throw std::runtime_error("parallel::transform output is smaller than the input");
+        pool.run(in.size(), chunk_size<OutType>(), [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                out[i] = function(in[i]);
+        });
+    }
+
+    /// @brief out[i] = function(a[i], b[i])
+    template<typename InType1, typename InType2, typename OutType, typename Function>
+    void transform(thread_pool& pool, span<InType1> a, span<InType2> b, span<OutType> out, Function function)
+    {
+        if (b.size() < a.size() || out.size() < a.size())
+            throw std::runtime_error("parallel::transform second input or output is smaller than the first input");
+        pool.run(a.size(), chunk_size<OutType>(), [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                out[i] = function(a[i], b[i]);
+        });
+    }
+
+    /// @brief function(values[i]) for every value, values can be modified in place
+    template<typename Type, typename Function>
+    void for_each(thread_pool& pool, span<Type> values, Function function)
+    {
+        pool.run(values.size(), chunk_size<Type>(), [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                function(values[i]);
+        });
+    }
+
+    /// @brief init reduced with transform(values[i]) for every value. reduce must be associative: every chunk is reduced
+    /// on its own, then the chunks are reduced in order, so the result doesn't depend on the thread count (or on the
+    /// pool), only on chunk_size<Type>().
+    template<typename Type, typename ValueType, typename Reduce, typename Transform>
+    ValueType transform_reduce(thread_pool& pool, span<Type> values, ValueType init, Reduce reduce, Transform transform)
+    {
+        const size_t chunk = chunk_size<Type>();
+        std::vector<ValueType> partials((values.size() + chunk - 1) / chunk);
+        pool.run(values.size(), chunk, [&](size_t begin, size_t end)
+        {
+            ValueType partial = transform(values[begin]);
+            for (size_t i = begin + 1; i < end; ++i)
+                partial = reduce(partial, transform(values[i]));
+            partials[begin / chunk] = partial;
+        });
+        for (const ValueType& partial : partials)
+            init = reduce(init, partial);
+        return init;
+    }
+
+    /// @brief init reduced with every value, see transform_reduce
+    template<typename Type, typename ValueType, typename Reduce>
+    ValueType reduce(thread_pool& pool, span<Type> values, ValueType init, Reduce reduce)
+    {
+        return transform_reduce(pool, values, init, reduce, [](const auto& v) -> const auto& { return v; });
+    }
+
+    /// @brief Sum of init and of every value
+    template<typename Type, typename ValueType>
+    ValueType reduce(thread_pool& pool, span<Type> values, ValueType init)
+    {
+        return reduce(pool, values, init, [](const ValueType& a, const ValueType& b) { return a + b; });
+    }
+
+    // Overloads on the global pool, or on the standard parallel algorithms
+
+    template<typename InType, typename OutType, typename Function>
+    void transform(span<InType> in, span<OutType> out, Function function)
+    {
+#ifdef CML_PARALLEL_STD_EXECUTION
+        if (out.size() < in.size())
+            throw std::runtime_error("parallel::transform output is smaller than the input");
+        std::transform(std::execution::par_unseq, in.begin(), in.end(), out.begin(), function);
+#else
+        transform(thread_pool::global(), in, out, function);
+#endif
+    }
+
+    template<typename InType1, typename InType2, typename OutType, typename Function>
+    void transform(span<InType1> a, span<InType2> b, span<OutType> out, Function function)
+    {
+#ifdef CML_PARALLEL_STD_EXECUTION
+        if (b.size() < a.size() || out.size() < a.size())
+            throw std::runtime_error("parallel::transform second input or output is smaller than the first input");
+        std::transform(std::execution::par_unseq, a.begin(), a.end(), b.begin(), out.begin(), function);
+#else
+        transform(thread_pool::global(), a, b, out, function);
+#endif
+    }
+
+    template<typename Type, typename Function>
+    void for_each(span<Type> values, Function function)
+    {
+#ifdef CML_PARALLEL_STD_EXECUTION
+        std::for_each(std::execution::par_unseq, values.begin(), values.end(), function);
+#else
+        for_each(thread_pool::global(), values, function);
+#endif
+    }
+
+    /// @brief With CML_PARALLEL_STD_EXECUTION the order of the reductions is unspecified (reduce must also be
+    /// commutative) and can change from one run to the other
+    template<typename Type, typename ValueType, typename Reduce, typename Transform>
+    ValueType transform_reduce(span<Type> values, ValueType init, Reduce reduce, Transform transform)
+    {
+#ifdef CML_PARALLEL_STD_EXECUTION
+        return std::transform_reduce(std::execution::par_unseq, values.begin(), values.end(), init, reduce, transform);
+#else
+        return transform_reduce(thread_pool::global(), values, init, reduce, transform);
+#endif
+    }
+
+    template<typename Type, typename ValueType, typename Reduce>
+    ValueType reduce(span<Type> values, ValueType init, Reduce reduce)
+    {
+#ifdef CML_PARALLEL_STD_EXECUTION
+        return std::reduce(std::execution::par_unseq, values.begin(), values.end(), init, reduce);
+#else
+        return parallel::reduce(thread_pool::global(), values, init, reduce);
+#endif
+    }
+
+    template<typename Type, typename ValueType>
+    ValueType reduce(span<Type> values, ValueType init)
+    {
+        return parallel::reduce(values, init, [](const ValueType& a, const ValueType& b) { return a + b; });
+    }
+} // namespace cml::parallel
@@ -0,0 +1,93 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../config.hpp"
+
+#ifdef CML_SIMD_SSE2
+#include <immintrin.h>
+
+namespace cml::implementation::simd
+{
+    // 3 x 3 float block kernels of the block sparse products (bsr_matrix). A block is 9 row major floats, its rows are
+    // read with 4 float loads that stay inside the block (the last one at offset 5, shifted down), the vectors with 3
+    // float loads so the ends of the arrays are never overrun. The 4th lanes carry garbage that never reaches y.
+
+    inline __m128 load_vec3(const float* p) noexcept
+    {
+        // __m64 may alias floats (unlike the double of _mm_load_sd / _mm_store_sd)
+        return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(p)), _mm_load_ss(p + 2));
+    }
+
+    inline void store_vec3(float* p, __m128 v) noexcept
+    {
+        _mm_storel_pi(reinterpret_cast<__m64*>(p), v);
+        _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+    }
+
+    inline __m128 load_block_row2(const float* block) noexcept
+    {
+        const __m128 r = _mm_loadu_ps(block + 5);
+        return _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 2, 1));
+    }
+
+    /// @brief y = sum of blocks[k] x[columns[k]] for k in [0, count): the rows of a block dotted with the vector. Each
+    /// row keeps its per column products in a register, they are only summed horizontally once the row is done.
+    inline void bsr3_row(const float* blocks, const std::uint32_t* columns, size_t count, const float* x, float* y) noexcept
+    {
+        __m128 r0 = _mm_setzero_ps();
+        __m128 r1 = _mm_setzero_ps();
+        __m128 r2 = _mm_setzero_ps();
+        for (size_t k = 0; k < count; ++k)
+        {
+            const float* b = blocks + k * 9;
+            const __m128 v = load_vec3(x + size_t(columns[k]) * 3);
+            r0 = _mm_add_ps(r0, _mm_mul_ps(_mm_loadu_ps(b), v));
+            r1 = _mm_add_ps(r1, _mm_mul_ps(_mm_loadu_ps(b + 3), v));
+            r2 = _mm_add_ps(r2, _mm_mul_ps(load_block_row2(b), v));
+        }
+        __m128 r3 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        store_vec3(y, _mm_add_ps(_mm_add_ps(r0, r1), r2));
+    }
+
+    /// @brief y = sum of x[rows[k]] blocks[indices[k]] for k in [0, count): the vector times the blocks (v * m), a
+    /// column of the transposed product gathered through the column index of the matrix.
+    inline void bsr3_column(const float* blocks, const std::uint32_t* indices, const std::uint32_t* rows, size_t count, const float* x, float* y) noexcept
+    {
+        __m128 r = _mm_setzero_ps();
+        for (size_t k = 0; k < count; ++k)
+        {
+            const float* b = blocks + size_t(indices[k]) * 9;
+            const float* v = x + size_t(rows[k]) * 3;
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[0]), _mm_loadu_ps(b)));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[1]), _mm_loadu_ps(b + 3)));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[2]), load_block_row2(b)));
+        }
+        store_vec3(y, r);
+    }
+} // namespace cml::implementation::simd
+
+#endif // CML_SIMD_SSE2
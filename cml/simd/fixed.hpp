@@ -0,0 +1,371 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#pragma once
+
+#include "../config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#ifdef CML_SIMD_SSE2
+#include <immintrin.h>
+
+namespace cml::implementation::simd
+{
+    // Integer kernels for fixed points, working on the raw values. They give the same bits as the scalar fixed
+    // operators: + and - wrap, a * b is the double width product shifted right by the fractional bits and truncated
+    // (floor, not rounded: pmulhrsw would round), and sums of products add the truncated products.
+
+    /// @brief Whether there are kernels for fixed<Type, FB>: signed 16 bit (sse2) and signed 32 bit (the multiplication
+    /// needs pmuldq, sse4.1)
+    template<typename Type, size_t FB>
+    struct has_fixed_pack
+    {
+        static constexpr bool value = (std::is_same<Type, int16_t>::value && FB < 16)
+#if defined(CML_SIMD_SSE4_1) || defined(CML_SIMD_AVX2)
+                                   || (std::is_same<Type, int32_t>::value && FB < 32)
+#endif
+                                   ;
+    };
+
+    /// @brief Load the first Bytes bytes (a multiple of 2), the other lanes are 0. The value is assembled from 64, 32 and
+    /// 16 bit loads: copying it to a stack buffer first would stall on the store forwarding.
+    template<size_t Bytes>
+    inline __m128i load_bytes_128(const void* p) noexcept
+    {
+        static_assert(Bytes <= 16 && Bytes % 2 == 0);
+        const char* c = static_cast<const char*>(p);
+        if constexpr(Bytes == 16)
+        {
+            return _mm_loadu_si128(static_cast<const __m128i*>(p));
+        }
+        else if constexpr(Bytes >= 8)
+        {
+            return _mm_unpacklo_epi64(_mm_loadl_epi64(static_cast<const __m128i*>(p)), load_bytes_128<Bytes - 8>(c + 8));
+        }
+        else if constexpr(Bytes >= 4)
+        {
+            int32_t v;
+            std::memcpy(&v, c, 4);
+            __m128i r = _mm_cvtsi32_si128(v);
+            if constexpr(Bytes == 6)
+            {
+                int16_t w;
+                std::memcpy(&w, c + 4, 2);
+                r = _mm_insert_epi16(r, w, 2);
+            }
+            return r;
+        }
+        else if constexpr(Bytes == 2)
+        {
+            int16_t w;
+            std::memcpy(&w, c, 2);
+            return _mm_cvtsi32_si128(static_cast<uint16_t>(w));
+        }
+        else
+        {
+            return _mm_setzero_si128();
+        }
+    }
+
+    template<size_t Bytes>
+    inline void store_bytes_128(void* p, __m128i v) noexcept
+    {
+        static_assert(Bytes <= 16 && Bytes % 2 == 0);
+        char* c = static_cast<char*>(p);
+        if constexpr(Bytes == 16)
+        {
+            _mm_storeu_si128(static_cast<__m128i*>(p), v);
+        }
+        else if constexpr(Bytes >= 8)
+        {
+            _mm_storel_epi64(static_cast<__m128i*>(p), v);
+            store_bytes_128<Bytes - 8>(c + 8, _mm_unpackhi_epi64(v, v));
+        }
+        else if constexpr(Bytes >= 4)
+        {
+            const int32_t w = _mm_cvtsi128_si32(v);
+            std::memcpy(c, &w, 4);
+            if constexpr(Bytes == 6)
+            {
+                const int16_t h = static_cast<int16_t>(_mm_extract_epi16(v, 2));
+                std::memcpy(c + 4, &h, 2);
+            }
+        }
+        else if constexpr(Bytes == 2)
+        {
+            const int16_t h = static_cast<int16_t>(_mm_cvtsi128_si32(v));
+            std::memcpy(c, &h, 2);
+        }
+    }
+
+    template<typename Register, size_t Bytes>
+    inline Register load_bytes(const void* p) noexcept
+    {
+#ifdef CML_SIMD_AVX2
+        if constexpr(sizeof(Register) == 32)
+        {
+            if constexpr(Bytes == 32)
+                return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+            else if constexpr(Bytes > 16)
+                return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(static_cast<const __m128i*>(p))), load_bytes_128<Bytes - 16>(static_cast<const char*>(p) + 16), 1);
+            else
+                return _mm256_inserti128_si256(_mm256_setzero_si256(), load_bytes_128<Bytes>(p), 0);
+        }
+        else
+#endif
+        {
+            return load_bytes_128<Bytes>(p);
+        }
+    }
+
+    template<size_t Bytes, typename Register>
+    inline void store_bytes(void* p, Register v) noexcept
+    {
+#ifdef CML_SIMD_AVX2
+        if constexpr(sizeof(Register) == 32)
+        {
+            if constexpr(Bytes == 32)
+            {
+                _mm256_storeu_si256(static_cast<__m256i*>(p), v);
+            }
+            else if constexpr(Bytes > 16)
+            {
+                _mm_storeu_si128(static_cast<__m128i*>(p), _mm256_castsi256_si128(v));
+                store_bytes_128<Bytes - 16>(static_cast<char*>(p) + 16, _mm256_extracti128_si256(v, 1));
+            }
+            else
+            {
+                store_bytes_128<Bytes>(p, _mm256_castsi256_si128(v));
+            }
+        }
+        else
+#endif
+        {
+            store_bytes_128<Bytes>(p, v);
+        }
+    }
+
+    // 16 bit lanes: the product keeps bits FB to FB + 15 of the 32 bit products, the top of the low half and the bottom
+    // of the high half
+    inline __m128i fixed_add(int16_t, __m128i a, __m128i b) noexcept { return _mm_add_epi16(a, b); }
+    inline __m128i fixed_sub(int16_t, __m128i a, __m128i b) noexcept { return _mm_sub_epi16(a, b); }
+    inline __m128i fixed_broadcast(int16_t v, __m128i) noexcept { return _mm_set1_epi16(v); }
+    template<size_t FB>
+    inline __m128i fixed_mul(int16_t, __m128i a, __m128i b) noexcept
+    {
+        const __m128i lo = _mm_mullo_epi16(a, b);
+        const __m128i hi = _mm_mulhi_epi16(a, b);
+        return _mm_or_si128(_mm_srli_epi16(lo, FB), _mm_slli_epi16(hi, 16 - FB));
+    }
+    inline int16_t fixed_hsum(int16_t, __m128i v) noexcept
+    {
+        v = _mm_add_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+        v = _mm_add_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+        v = _mm_add_epi16(v, _mm_srli_epi32(v, 16));
+        return static_cast<int16_t>(_mm_cvtsi128_si32(v));
+    }
+
+    // 32 bit lanes: pmuldq multiplies the even lanes into 64 bits, the odd lanes are moved down first. Bits FB to
+    // FB + 31 of the products are brought down by a 64 bit shift and the two halves blended back.
+    inline __m128i fixed_add(int32_t, __m128i a, __m128i b) noexcept { return _mm_add_epi32(a, b); }
+    inline __m128i fixed_sub(int32_t, __m128i a, __m128i b) noexcept { return _mm_sub_epi32(a, b); }
+    inline __m128i fixed_broadcast(int32_t v, __m128i) noexcept { return _mm_set1_epi32(v); }
+#if defined(CML_SIMD_SSE4_1) || defined(CML_SIMD_AVX2)
+    template<size_t FB>
+    inline __m128i fixed_mul(int32_t, __m128i a, __m128i b) noexcept
+    {
+        const __m128i even = _mm_srli_epi64(_mm_mul_epi32(a, b), FB);
+        const __m128i odd = _mm_srli_epi64(_mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)), FB);
+        return _mm_blend_epi16(even, _mm_slli_epi64(odd, 32), 0xcc);
+    }
+#endif
+    inline int32_t fixed_hsum(int32_t, __m128i v) noexcept
+    {
+        v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+        v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(v);
+    }
+
+#ifdef CML_SIMD_AVX2
+    inline __m256i fixed_add(int16_t, __m256i a, __m256i b) noexcept { return _mm256_add_epi16(a, b); }
+    inline __m256i fixed_sub(int16_t, __m256i a, __m256i b) noexcept { return _mm256_sub_epi16(a, b); }
+    inline __m256i fixed_broadcast(int16_t v, __m256i) noexcept { return _mm256_set1_epi16(v); }
+    template<size_t FB>
+    inline __m256i fixed_mul(int16_t, __m256i a, __m256i b) noexcept
+    {
+        const __m256i lo = _mm256_mullo_epi16(a, b);
+        const __m256i hi = _mm256_mulhi_epi16(a, b);
+        return _mm256_or_si256(_mm256_srli_epi16(lo, FB), _mm256_slli_epi16(hi, 16 - FB));
+    }
+
+    inline __m256i fixed_add(int32_t, __m256i a, __m256i b) noexcept { return _mm256_add_epi32(a, b); }
+    inline __m256i fixed_sub(int32_t, __m256i a, __m256i b) noexcept { return _mm256_sub_epi32(a, b); }
+    inline __m256i fixed_broadcast(int32_t v, __m256i) noexcept { return _mm256_set1_epi32(v); }
+    template<size_t FB>
+    inline __m256i fixed_mul(int32_t, __m256i a, __m256i b) noexcept
+    {
+        const __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(a, b), FB);
+        const __m256i odd = _mm256_srli_epi64(_mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32)), FB);
+        return _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xaa);
+    }
+
+    template<typename Type>
+    inline Type fixed_hsum(Type t, __m256i v) noexcept
+    {
+        return fixed_hsum(t, fixed_add(t, _mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+    }
+#endif
+
+    /// @brief The integer register for Bytes bytes of data: 256 bits with avx2 when there are that many, 128 otherwise
+    template<size_t Bytes, bool Wide = (Bytes >= 32)>
+    struct integer_register
+    {
+        using type = __m128i;
+    };
+
+#ifdef CML_SIMD_AVX2
+    template<size_t Bytes>
+    struct integer_register<Bytes, true>
+    {
+        using type = __m256i;
+    };
+#endif
+
+    /// @brief fixed<Type, FB> values in a register, sized for Count values
+    template<typename Type, size_t FB, size_t Count>
+    struct fixed_pack
+    {
+        using register_type = typename integer_register<Count * sizeof(Type)>::type;
+        static constexpr size_t size = sizeof(register_type) / sizeof(Type);
+        register_type v;
+
+        template<size_t N = size>
+        static fixed_pack load(const Type* p) noexcept { return {load_bytes<register_type, N * sizeof(Type)>(p)}; }
+        template<size_t N = size>
+        void store(Type* p) const noexcept { store_bytes<N * sizeof(Type)>(p, v); }
+        static fixed_pack broadcast(Type value) noexcept { return {fixed_broadcast(value, register_type{})}; }
+        Type sum() const noexcept { return fixed_hsum(Type{}, v); }
+
+        friend fixed_pack operator + (fixed_pack a, fixed_pack b) noexcept { return {fixed_add(Type{}, a.v, b.v)}; }
+        friend fixed_pack operator - (fixed_pack a, fixed_pack b) noexcept { return {fixed_sub(Type{}, a.v, b.v)}; }
+        friend fixed_pack operator * (fixed_pack a, fixed_pack b) noexcept { return {fixed_mul<FB>(Type{}, a.v, b.v)}; }
+    };
+
+    /// @brief out[i] = op(a[i], b[i]) on Count values, a register at a time
+    template<typename Type, size_t FB, size_t Count, typename Op>
+    inline void fixed_componentwise(const Type* a, const Type* b, Type* out, Op op) noexcept
+    {
+        using pack = fixed_pack<Type, FB, Count>;
+        constexpr size_t full = Count - Count % pack::size;
+        for (size_t i = 0; i < full; i += pack::size)
+            op(pack::load(a + i), pack::load(b + i)).store(out + i);
+        if constexpr(full != Count)
+            op(pack::template load<Count - full>(a + full), pack::template load<Count - full>(b + full)).template store<Count - full>(out + full);
+    }
+
+    /// @brief out[i] = a[i] * s on Count values
+    template<typename Type, size_t FB, size_t Count>
+    inline void fixed_mul_scalar(const Type* a, Type s, Type* out) noexcept
+    {
+        using pack = fixed_pack<Type, FB, Count>;
+        const pack vs = pack::broadcast(s);
+        constexpr size_t full = Count - Count % pack::size;
+        for (size_t i = 0; i < full; i += pack::size)
+            (pack::load(a + i) * vs).store(out + i);
+        if constexpr(full != Count)
+            (pack::template load<Count - full>(a + full) * vs).template store<Count - full>(out + full);
+    }
+
+    /// @brief sum of a[i] * b[i] on Count values. The additions wrap, so their order does not change the result.
+    template<typename Type, size_t FB, size_t Count>
+    inline Type fixed_dot(const Type* a, const Type* b) noexcept
+    {
+        using pack = fixed_pack<Type, FB, Count>;
+        constexpr size_t full = Count - Count % pack::size;
+        pack acc = pack::broadcast(0);
+        for (size_t i = 0; i < full; i += pack::size)
+            acc = acc + pack::load(a + i) * pack::load(b + i);
+        if constexpr(full != Count)
+            acc = acc + pack::template load<Count - full>(a + full) * pack::template load<Count - full>(b + full);
+        return acc.sum();
+    }
+
+    template<typename Type, size_t FB, size_t DimX1, size_t DimY1, size_t DimX2, size_t... Ks>
+    inline void fixed_mm_mul(std::index_sequence<Ks...>, const Type* a, const Type* b, Type* out) noexcept
+    {
+        if constexpr(std::is_same<Type, int16_t>::value)
+        {
+            const __m128i rows[] = {load_bytes_128<DimX2 * 2>(b + Ks * DimX2)...};
+            for (size_t y = 0; y < DimY1; ++y)
+            {
+                const Type* ay = a + y * DimX1;
+                __m128i acc = _mm_setzero_si128();
+                ((acc = _mm_add_epi16(acc, fixed_mul<FB>(Type{}, _mm_set1_epi16(ay[Ks]), rows[Ks]))), ...);
+                store_bytes_128<DimX2 * 2>(out + y * DimX2, acc);
+            }
+        }
+        else
+        {
+            // the products are accumulated on 64 bits (each one shifted on its own, so it is truncated as the scalar
+            // one) and only their low halves are kept: the additions wrap the same way
+#ifdef CML_SIMD_AVX2
+            const __m256i rows[] = {_mm256_cvtepi32_epi64(load_bytes_128<DimX2 * 4>(b + Ks * DimX2))...};
+            const __m256i low_halves = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+            for (size_t y = 0; y < DimY1; ++y)
+            {
+                const Type* ay = a + y * DimX1;
+                __m256i acc = _mm256_setzero_si256();
+                ((acc = _mm256_add_epi64(acc, _mm256_srli_epi64(_mm256_mul_epi32(_mm256_set1_epi32(ay[Ks]), rows[Ks]), FB))), ...);
+                store_bytes_128<DimX2 * 4>(out + y * DimX2, _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(acc, low_halves)));
+            }
+#else
+            // pmuldq reads the even lanes: the odd lanes of the rows are moved down once, the broadcast components
+            // are the same in every lane
+            const __m128i even[] = {load_bytes_128<DimX2 * 4>(b + Ks * DimX2)...};
+            const __m128i odd[] = {_mm_srli_epi64(even[Ks], 32)...};
+            for (size_t y = 0; y < DimY1; ++y)
+            {
+                const Type* ay = a + y * DimX1;
+                __m128i acc_even = _mm_setzero_si128();
+                __m128i acc_odd = _mm_setzero_si128();
+                ((acc_even = _mm_add_epi64(acc_even, _mm_srli_epi64(_mm_mul_epi32(_mm_set1_epi32(ay[Ks]), even[Ks]), FB))), ...);
+                ((acc_odd = _mm_add_epi64(acc_odd, _mm_srli_epi64(_mm_mul_epi32(_mm_set1_epi32(ay[Ks]), odd[Ks]), FB))), ...);
+                store_bytes_128<DimX2 * 4>(out + y * DimX2, _mm_blend_epi16(acc_even, _mm_slli_epi64(acc_odd, 32), 0xcc));
+            }
+#endif
+        }
+    }
+
+    /// @brief out = a * b for row major matrices (a is DimX1 x DimY1, b is DimX2 x DimX1, a row of b must fit in 128
+    /// bits): each row of out is the sum of the rows of b multiplied by the components of the row of a
+    template<typename Type, size_t FB, size_t DimX1, size_t DimY1, size_t DimX2>
+    inline void fixed_mm_mul(const Type* a, const Type* b, Type* out) noexcept
+    {
+        static_assert(DimX2 * sizeof(Type) <= 16, "a row of the second matrix must fit in 128 bits");
+        fixed_mm_mul<Type, FB, DimX1, DimY1, DimX2>(std::make_index_sequence<DimX1>{}, a, b, out);
+    }
+} // namespace cml::implementation::simd
+
+#endif // CML_SIMD_SSE2
@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "../config.hpp"
+
+#ifdef CML_SIMD_SSE2
+#include <immintrin.h>
+
+namespace cml::implementation::simd
+{
+    // Register tiles of the blocked matrix products (mm_mul_blocked): a 4 x 8 float or 4 x 4 double tile of c
+    // (32 bytes per row) accumulates a[r][l] * b[l][s] for l in [k0, k1). The products are added in l order with
+    // separate mul and add, as the constexpr loops do, so both give the same bits (unless the compiler is allowed to
+    // contract the mul/add pairs into fma).
+    // a points at the first row of the tile (rows of k values), b at its first column and c at its first component
+    // (rows of n values).
+
+    inline void mm_mul_tile(const float* a, const float* b, float* c, size_t n, size_t k, size_t k0, size_t k1) noexcept
+    {
+#ifdef CML_SIMD_AVX
+        __m256 c0 = _mm256_loadu_ps(c + 0 * n);
+        __m256 c1 = _mm256_loadu_ps(c + 1 * n);
+        __m256 c2 = _mm256_loadu_ps(c + 2 * n);
+        __m256 c3 = _mm256_loadu_ps(c + 3 * n);
+        for (size_t l = k0; l < k1; ++l)
+        {
+            const __m256 bk = _mm256_loadu_ps(b + l * n);
+            c0 = _mm256_add_ps(c0, _mm256_mul_ps(_mm256_broadcast_ss(a + 0 * k + l), bk));
+            c1 = _mm256_add_ps(c1, _mm256_mul_ps(_mm256_broadcast_ss(a + 1 * k + l), bk));
+            c2 = _mm256_add_ps(c2, _mm256_mul_ps(_mm256_broadcast_ss(a + 2 * k + l), bk));
+            c3 = _mm256_add_ps(c3, _mm256_mul_ps(_mm256_broadcast_ss(a + 3 * k + l), bk));
+        }
+        _mm256_storeu_ps(c + 0 * n, c0);
+        _mm256_storeu_ps(c + 1 * n, c1);
+        _mm256_storeu_ps(c + 2 * n, c2);
+        _mm256_storeu_ps(c + 3 * n, c3);
+#else
+        __m128 c0l = _mm_loadu_ps(c + 0 * n), c0h = _mm_loadu_ps(c + 0 * n + 4);
+        __m128 c1l = _mm_loadu_ps(c + 1 * n), c1h = _mm_loadu_ps(c + 1 * n + 4);
+        __m128 c2l = _mm_loadu_ps(c + 2 * n), c2h = _mm_loadu_ps(c + 2 * n + 4);
+        __m128 c3l = _mm_loadu_ps(c + 3 * n), c3h = _mm_loadu_ps(c + 3 * n + 4);
+        for (size_t l = k0; l < k1; ++l)
+        {
+            const __m128 bl = _mm_loadu_ps(b + l * n);
+            const __m128 bh = _mm_loadu_ps(b + l * n + 4);
+            const __m128 a0 = _mm_set1_ps(a[0 * k + l]);
+            const __m128 a1 = _mm_set1_ps(a[1 * k + l]);
+            const __m128 a2 = _mm_set1_ps(a[2 * k + l]);
+            const __m128 a3 = _mm_set1_ps(a[3 * k + l]);
+            c0l = _mm_add_ps(c0l, _mm_mul_ps(a0, bl));
+            c0h = _mm_add_ps(c0h, _mm_mul_ps(a0, bh));
+            c1l = _mm_add_ps(c1l, _mm_mul_ps(a1, bl));
+            c1h = _mm_add_ps(c1h, _mm_mul_ps(a1, bh));
+            c2l = _mm_add_ps(c2l, _mm_mul_ps(a2, bl));
+            c2h = _mm_add_ps(c2h, _mm_mul_ps(a2, bh));
+            c3l = _mm_add_ps(c3l, _mm_mul_ps(a3, bl));
+            c3h = _mm_add_ps(c3h, _mm_mul_ps(a3, bh));
+        }
+        _mm_storeu_ps(c + 0 * n, c0l);
+        _mm_storeu_ps(c + 0 * n + 4, c0h);
+        _mm_storeu_ps(c + 1 * n, c1l);
+        _mm_storeu_ps(c + 1 * n + 4, c1h);
+        _mm_storeu_ps(c + 2 * n, c2l);
+        _mm_storeu_ps(c + 2 * n + 4, c2h);
+        _mm_storeu_ps(c + 3 * n, c3l);
+        _mm_storeu_ps(c + 3 * n + 4, c3h);
+#endif
+    }
+
+    inline void mm_mul_tile(const double* a, const double* b, double* c, size_t n, size_t k, size_t k0, size_t k1) noexcept
+    {
+#ifdef CML_SIMD_AVX
+        __m256d c0 = _mm256_loadu_pd(c + 0 * n);
+        __m256d c1 = _mm256_loadu_pd(c + 1 * n);
+        __m256d c2 = _mm256_loadu_pd(c + 2 * n);
+        __m256d c3 = _mm256_loadu_pd(c + 3 * n);
+        for (size_t l = k0; l < k1; ++l)
+        {
+            const __m256d bk = _mm256_loadu_pd(b + l * n);
+            c0 = _mm256_add_pd(c0, _mm256_mul_pd(_mm256_broadcast_sd(a + 0 * k + l), bk));
+            c1 = _mm256_add_pd(c1, _mm256_mul_pd(_mm256_broadcast_sd(a + 1 * k + l), bk));
+            c2 = _mm256_add_pd(c2, _mm256_mul_pd(_mm256_broadcast_sd(a + 2 * k + l), bk));
+            c3 = _mm256_add_pd(c3, _mm256_mul_pd(_mm256_broadcast_sd(a + 3 * k + l), bk));
+        }
+        _mm256_storeu_pd(c + 0 * n, c0);
+        _mm256_storeu_pd(c + 1 * n, c1);
+        _mm256_storeu_pd(c + 2 * n, c2);
+        _mm256_storeu_pd(c + 3 * n, c3);
+#else
+        __m128d c0l = _mm_loadu_pd(c + 0 * n), c0h = _mm_loadu_pd(c + 0 * n + 2);
+        __m128d c1l = _mm_loadu_pd(c + 1 * n), c1h = _mm_loadu_pd(c + 1 * n + 2);
+        __m128d c2l = _mm_loadu_pd(c + 2 * n), c2h = _mm_loadu_pd(c + 2 * n + 2);
+        __m128d c3l = _mm_loadu_pd(c + 3 * n), c3h = _mm_loadu_pd(c + 3 * n + 2);
+        for (size_t l = k0; l < k1; ++l)
+        {
+            const __m128d bl = _mm_loadu_pd(b + l * n);
+            const __m128d bh = _mm_loadu_pd(b + l * n + 2);
+            const __m128d a0 = _mm_set1_pd(a[0 * k + l]);
+            const __m128d a1 = _mm_set1_pd(a[1 * k + l]);
+            const __m128d a2 = _mm_set1_pd(a[2 * k + l]);
+            const __m128d a3 = _mm_set1_pd(a[3 * k + l]);
+            c0l = _mm_add_pd(c0l, _mm_mul_pd(a0, bl));
+            c0h = _mm_add_pd(c0h, _mm_mul_pd(a0, bh));
+            c1l = _mm_add_pd(c1l, _mm_mul_pd(a1, bl));
+            c1h = _mm_add_pd(c1h, _mm_mul_pd(a1, bh));
+            c2l = _mm_add_pd(c2l, _mm_mul_pd(a2, bl));
+            c2h = _mm_add_pd(c2h, _mm_mul_pd(a2, bh));
+            c3l = _mm_add_pd(c3l, _mm_mul_pd(a3, bl));
+            c3h = _mm_add_pd(c3h, _mm_mul_pd(a3, bh));
+        }
+        _mm_storeu_pd(c + 0 * n, c0l);
+        _mm_storeu_pd(c + 0 * n + 2, c0h);
+        _mm_storeu_pd(c + 1 * n, c1l);
+        _mm_storeu_pd(c + 1 * n + 2, c1h);
+        _mm_storeu_pd(c + 2 * n, c2l);
+        _mm_storeu_pd(c + 2 * n + 2, c2h);
+        _mm_storeu_pd(c + 3 * n, c3l);
+        _mm_storeu_pd(c + 3 * n + 2, c3h);
+#endif
+    }
+} // namespace cml::implementation::simd
+
+#endif // CML_SIMD_SSE2
@@ -0,0 +1,189 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../config.hpp"
+
+#ifdef CML_SIMD_SSE2
+#include <immintrin.h>
+
+namespace cml::implementation::simd
+{
+    // All the kernels work on row major float arrays (the cml layout) and accumulate the products in the same order
+    // as the fold expressions of matrix_mm_mul_dot: v0 * r0 + (v1 * r1 + (v2 * r2 + v3 * r3)), so they give the same
+    // results as the constexpr path (unless the compiler is allowed to contract the mul/add pairs into fma).
+
+    /// @brief Multiply a row (4 floats, already in a register) by a 4x4 matrix given as its four rows
+    inline __m128 row_mat4_mul(__m128 row, __m128 r0, __m128 r1, __m128 r2, __m128 r3) noexcept
+    {
+        __m128 acc = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), r3);
+        acc = _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), r2), acc);
+        acc = _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), r1), acc);
+        return _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), r0), acc);
+    }
+
+    /// @brief _mm_load_ps when the data is known to be 16 bytes aligned (matrix_kind::aligned), _mm_loadu_ps otherwise
+    template<bool Aligned>
+    inline __m128 load4(const float* p) noexcept
+    {
+        if constexpr(Aligned)
+            return _mm_load_ps(p);
+        else
+            return _mm_loadu_ps(p);
+    }
+
+    template<bool Aligned>
+    inline void store4(float* p, __m128 v) noexcept
+    {
+        if constexpr(Aligned)
+            _mm_store_ps(p, v);
+        else
+            _mm_storeu_ps(p, v);
+    }
+
+    /// @brief out = v * m, where v is a 4 component vector and m a 4x4 matrix
+    template<bool Aligned = false>
+    inline void vec4_mat4_mul(const float* v, const float* m, float* out) noexcept
+    {
+        const __m128 r = row_mat4_mul(load4<Aligned>(v), load4<Aligned>(m + 0), load4<Aligned>(m + 4), load4<Aligned>(m + 8), load4<Aligned>(m + 12));
+        store4<Aligned>(out, r);
+    }
+
+    /// @brief out = a * b, where a and b are 4x4 matrices. out must not alias a or b.
+    /// When Aligned, a, b and out must be 32 bytes aligned (16 without avx).
+    template<bool Aligned = false>
+    inline void mat4_mul(const float* a, const float* b, float* out) noexcept
+    {
+#ifdef CML_SIMD_AVX
+        // two rows of a per iteration, the rows of b are duplicated in both 128 bit lanes
+        const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 0));
+        const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 4));
+        const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 8));
+        const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 12));
+        for (int i = 0; i < 16; i += 8)
+        {
+            const __m256 rows = Aligned ? _mm256_load_ps(a + i) : _mm256_loadu_ps(a + i);
+            __m256 acc = _mm256_mul_ps(_mm256_permute_ps(rows, _MM_SHUFFLE(3, 3, 3, 3)), b3);
+            acc = _mm256_add_ps(_mm256_mul_ps(_mm256_permute_ps(rows, _MM_SHUFFLE(2, 2, 2, 2)), b2), acc);
+            acc = _mm256_add_ps(_mm256_mul_ps(_mm256_permute_ps(rows, _MM_SHUFFLE(1, 1, 1, 1)), b1), acc);
+            acc = _mm256_add_ps(_mm256_mul_ps(_mm256_permute_ps(rows, _MM_SHUFFLE(0, 0, 0, 0)), b0), acc);
+            if constexpr(Aligned)
+                _mm256_store_ps(out + i, acc);
+            else
+                _mm256_storeu_ps(out + i, acc);
+        }
+#else
+        const __m128 b0 = load4<Aligned>(b + 0);
+        const __m128 b1 = load4<Aligned>(b + 4);
+        const __m128 b2 = load4<Aligned>(b + 8);
+        const __m128 b3 = load4<Aligned>(b + 12);
+        store4<Aligned>(out + 0, row_mat4_mul(load4<Aligned>(a + 0), b0, b1, b2, b3));
+        store4<Aligned>(out + 4, row_mat4_mul(load4<Aligned>(a + 4), b0, b1, b2, b3));
+        store4<Aligned>(out + 8, row_mat4_mul(load4<Aligned>(a + 8), b0, b1, b2, b3));
+        store4<Aligned>(out + 12, row_mat4_mul(load4<Aligned>(a + 12), b0, b1, b2, b3));
+#endif
+    }
+
+    // 2x2 matrices packed in a register as (x, y, z, w) = | x  y |
+    //                                                      | z  w |
+    template<int X, int Y, int Z, int W>
+    inline __m128 swizzle(__m128 v) noexcept
+    {
+        return _mm_shuffle_ps(v, v, _MM_SHUFFLE(W, Z, Y, X));
+    }
+
+    /// @brief a * b
+    inline __m128 mat2_mul(__m128 a, __m128 b) noexcept
+    {
+        return _mm_add_ps(_mm_mul_ps(a, swizzle<0, 3, 0, 3>(b)), _mm_mul_ps(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+    }
+
+    /// @brief adjugate(a) * b
+    inline __m128 mat2_adj_mul(__m128 a, __m128 b) noexcept
+    {
+        return _mm_sub_ps(_mm_mul_ps(swizzle<3, 3, 0, 0>(a), b), _mm_mul_ps(swizzle<1, 1, 2, 2>(a), swizzle<2, 3, 0, 1>(b)));
+    }
+
+    /// @brief a * adjugate(b)
+    inline __m128 mat2_mul_adj(__m128 a, __m128 b) noexcept
+    {
+        return _mm_sub_ps(_mm_mul_ps(a, swizzle<3, 0, 3, 0>(b)), _mm_mul_ps(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+    }
+
+    /// @brief out = inverse(m) of a 4x4 matrix, returns the determinant of m (out is not finite when it is 0). out may
+    /// alias m. The matrix is split in four 2x2 blocks | A  B | and inverted blockwise with their adjugates:
+    ///                                                 | C  D |
+    /// |M| = |A||D| + |B||C| - tr(adj(A) B adj(D) C), the constexpr path expands the 2x2 minors instead so the results
+    /// can differ by a few ulps.
+    template<bool Aligned = false>
+    inline float mat4_inverse(const float* m, float* out) noexcept
+    {
+        const __m128 r0 = load4<Aligned>(m + 0);
+        const __m128 r1 = load4<Aligned>(m + 4);
+        const __m128 r2 = load4<Aligned>(m + 8);
+        const __m128 r3 = load4<Aligned>(m + 12);
+
+        const __m128 a = _mm_movelh_ps(r0, r1);
+        const __m128 b = _mm_movehl_ps(r1, r0);
+        const __m128 c = _mm_movelh_ps(r2, r3);
+        const __m128 d = _mm_movehl_ps(r3, r2);
+
+        // (|A|, |B|, |C|, |D|)
+        const __m128 dets = _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 1, 3, 1))),
+                                       _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 0, 2, 0))));
+        const __m128 det_a = swizzle<0, 0, 0, 0>(dets);
+        const __m128 det_b = swizzle<1, 1, 1, 1>(dets);
+        const __m128 det_c = swizzle<2, 2, 2, 2>(dets);
+        const __m128 det_d = swizzle<3, 3, 3, 3>(dets);
+
+        const __m128 d_c = mat2_adj_mul(d, c);
+        const __m128 a_b = mat2_adj_mul(a, b);
+        // adjugates of the blocks of the inverse (times |M|)
+        __m128 x = _mm_sub_ps(_mm_mul_ps(det_d, a), mat2_mul(b, d_c));
+        __m128 w = _mm_sub_ps(_mm_mul_ps(det_a, d), mat2_mul(c, a_b));
+        __m128 y = _mm_sub_ps(_mm_mul_ps(det_b, c), mat2_mul_adj(d, a_b));
+        __m128 z = _mm_sub_ps(_mm_mul_ps(det_c, b), mat2_mul_adj(a, d_c));
+
+        __m128 tr = _mm_mul_ps(a_b, swizzle<0, 2, 1, 3>(d_c));
+        tr = _mm_add_ps(tr, swizzle<1, 0, 3, 2>(tr));
+        tr = _mm_add_ps(tr, swizzle<2, 3, 0, 1>(tr));
+        const __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c)), tr);
+
+        // (1, -1, -1, 1) / |M|, the signs of the adjugate of a 2x2 matrix
+        const __m128 rdet = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), det);
+        x = _mm_mul_ps(x, rdet);
+        y = _mm_mul_ps(y, rdet);
+        z = _mm_mul_ps(z, rdet);
+        w = _mm_mul_ps(w, rdet);
+
+        // the shuffles both take the adjugates and put the blocks back in rows
+        store4<Aligned>(out + 0, _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+        store4<Aligned>(out + 4, _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+        store4<Aligned>(out + 8, _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+        store4<Aligned>(out + 12, _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+        return _mm_cvtss_f32(det);
+    }
+} // namespace cml::implementation::simd
+
+#endif // CML_SIMD_SSE2
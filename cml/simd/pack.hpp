@@ -0,0 +1,207 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../config.hpp"
+
+#include <cstddef>
+
+#ifdef CML_SIMD_SSE2
+#include <immintrin.h>
+
+namespace cml::implementation::simd
+{
+    // Widest registers of doubles (dpack) and floats (fpack) available: 4 doubles / 8 floats with avx, 2 / 4 with sse2.
+    // The arithmetic operators let scalar code be instantiated on a full register (see functions/trig_kernel.hpp or
+    // soa_array.hpp), the comparisons return masks as packs (all bits set in the lanes where the comparison holds).
+#ifdef CML_SIMD_AVX
+    struct dpack
+    {
+        static constexpr size_t size = 4;
+
+        dpack() = default;
+        dpack(__m256d v) noexcept : v(v) {}
+        dpack(double d) noexcept : v(_mm256_set1_pd(d)) {}
+
+        static dpack load(const double* p) noexcept { return _mm256_loadu_pd(p); }
+        static dpack load(const float* p) noexcept { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+        /// @brief Load floats and multiply them by factor in float precision before the conversion
+        static dpack load(const float* p, float factor) noexcept { return _mm256_cvtps_pd(_mm_mul_ps(_mm_loadu_ps(p), _mm_set1_ps(factor))); }
+        void store(double* p) const noexcept { _mm256_storeu_pd(p, v); }
+        void store(float* p) const noexcept { _mm_storeu_ps(p, _mm256_cvtpd_ps(v)); }
+
+        __m256d v;
+    };
+
+    inline dpack operator + (dpack a, dpack b) noexcept { return _mm256_add_pd(a.v, b.v); }
+    inline dpack operator - (dpack a, dpack b) noexcept { return _mm256_sub_pd(a.v, b.v); }
+    inline dpack operator * (dpack a, dpack b) noexcept { return _mm256_mul_pd(a.v, b.v); }
+    inline dpack operator / (dpack a, dpack b) noexcept { return _mm256_div_pd(a.v, b.v); }
+    inline dpack operator - (dpack a) noexcept { return _mm256_xor_pd(a.v, _mm256_set1_pd(-0.0)); }
+    inline dpack operator & (dpack a, dpack b) noexcept { return _mm256_and_pd(a.v, b.v); }
+    inline dpack operator | (dpack a, dpack b) noexcept { return _mm256_or_pd(a.v, b.v); }
+    inline dpack operator ^ (dpack a, dpack b) noexcept { return _mm256_xor_pd(a.v, b.v); }
+    inline dpack operator == (dpack a, dpack b) noexcept { return _mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ); }
+    inline dpack operator < (dpack a, dpack b) noexcept { return _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ); }
+    inline dpack operator <= (dpack a, dpack b) noexcept { return _mm256_cmp_pd(a.v, b.v, _CMP_LE_OQ); }
+
+    inline dpack abs(dpack a) noexcept { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v); }
+    inline dpack sqrt(dpack a) noexcept { return _mm256_sqrt_pd(a.v); }
+    /// @brief rsqrtps on the values converted to float (they must be in the float range)
+    inline dpack rsqrt_estimate(dpack a) noexcept { return _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(a.v))); }
+    /// @brief mask ? a : b
+    inline dpack select(dpack mask, dpack a, dpack b) noexcept { return _mm256_blendv_pd(b.v, a.v, mask.v); }
+    inline bool any(dpack mask) noexcept { return _mm256_movemask_pd(mask.v) != 0; }
+    inline bool all(dpack mask) noexcept { return _mm256_movemask_pd(mask.v) == 0xf; }
+
+    struct fpack
+    {
+        static constexpr size_t size = 8;
+
+        fpack() = default;
+        fpack(__m256 v) noexcept : v(v) {}
+        fpack(float f) noexcept : v(_mm256_set1_ps(f)) {}
+
+        static fpack load(const float* p) noexcept { return _mm256_loadu_ps(p); }
+        void store(float* p) const noexcept { _mm256_storeu_ps(p, v); }
+
+        __m256 v;
+    };
+
+    inline fpack operator + (fpack a, fpack b) noexcept { return _mm256_add_ps(a.v, b.v); }
+    inline fpack operator - (fpack a, fpack b) noexcept { return _mm256_sub_ps(a.v, b.v); }
+    inline fpack operator * (fpack a, fpack b) noexcept { return _mm256_mul_ps(a.v, b.v); }
+    inline fpack operator / (fpack a, fpack b) noexcept { return _mm256_div_ps(a.v, b.v); }
+    inline fpack operator - (fpack a) noexcept { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.f)); }
+    inline fpack operator & (fpack a, fpack b) noexcept { return _mm256_and_ps(a.v, b.v); }
+    inline fpack operator | (fpack a, fpack b) noexcept { return _mm256_or_ps(a.v, b.v); }
+    inline fpack operator ^ (fpack a, fpack b) noexcept { return _mm256_xor_ps(a.v, b.v); }
+    inline fpack operator == (fpack a, fpack b) noexcept { return _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ); }
+    inline fpack operator < (fpack a, fpack b) noexcept { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+    inline fpack operator <= (fpack a, fpack b) noexcept { return _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ); }
+
+    inline fpack abs(fpack a) noexcept { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a.v); }
+    inline fpack sqrt(fpack a) noexcept { return _mm256_sqrt_ps(a.v); }
+    inline fpack rsqrt_estimate(fpack a) noexcept { return _mm256_rsqrt_ps(a.v); }
+    inline fpack select(fpack mask, fpack a, fpack b) noexcept { return _mm256_blendv_ps(b.v, a.v, mask.v); }
+    inline bool any(fpack mask) noexcept { return _mm256_movemask_ps(mask.v) != 0; }
+    inline bool all(fpack mask) noexcept { return _mm256_movemask_ps(mask.v) == 0xff; }
+#else
+    struct dpack
+    {
+        static constexpr size_t size = 2;
+
+        dpack() = default;
+        dpack(__m128d v) noexcept : v(v) {}
+        dpack(double d) noexcept : v(_mm_set1_pd(d)) {}
+
+        static dpack load(const double* p) noexcept { return _mm_loadu_pd(p); }
+        static dpack load(const float* p) noexcept { return _mm_cvtps_pd(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(p))); }
+        static dpack load(const float* p, float factor) noexcept
+        {
+            return _mm_cvtps_pd(_mm_mul_ps(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(p)), _mm_set1_ps(factor)));
+        }
+        void store(double* p) const noexcept { _mm_storeu_pd(p, v); }
+        // through __m64, which may alias floats (a double load / store would not)
+        void store(float* p) const noexcept { _mm_storel_pi(reinterpret_cast<__m64*>(p), _mm_cvtpd_ps(v)); }
+
+        __m128d v;
+    };
+
+    inline dpack operator + (dpack a, dpack b) noexcept { return _mm_add_pd(a.v, b.v); }
+    inline dpack operator - (dpack a, dpack b) noexcept { return _mm_sub_pd(a.v, b.v); }
+    inline dpack operator * (dpack a, dpack b) noexcept { return _mm_mul_pd(a.v, b.v); }
+    inline dpack operator / (dpack a, dpack b) noexcept { return _mm_div_pd(a.v, b.v); }
+    inline dpack operator - (dpack a) noexcept { return _mm_xor_pd(a.v, _mm_set1_pd(-0.0)); }
+    inline dpack operator & (dpack a, dpack b) noexcept { return _mm_and_pd(a.v, b.v); }
+    inline dpack operator | (dpack a, dpack b) noexcept { return _mm_or_pd(a.v, b.v); }
+    inline dpack operator ^ (dpack a, dpack b) noexcept { return _mm_xor_pd(a.v, b.v); }
+    inline dpack operator == (dpack a, dpack b) noexcept { return _mm_cmpeq_pd(a.v, b.v); }
+    inline dpack operator < (dpack a, dpack b) noexcept { return _mm_cmplt_pd(a.v, b.v); }
+    inline dpack operator <= (dpack a, dpack b) noexcept { return _mm_cmple_pd(a.v, b.v); }
+
+    inline dpack abs(dpack a) noexcept { return _mm_andnot_pd(_mm_set1_pd(-0.0), a.v); }
+    inline dpack sqrt(dpack a) noexcept { return _mm_sqrt_pd(a.v); }
+    /// @brief rsqrtps on the values converted to float (they must be in the float range)
+    inline dpack rsqrt_estimate(dpack a) noexcept { return _mm_cvtps_pd(_mm_rsqrt_ps(_mm_cvtpd_ps(a.v))); }
+    /// @brief mask ? a : b
+    inline dpack select(dpack mask, dpack a, dpack b) noexcept
+    {
+#ifdef CML_SIMD_SSE4_1
+        return _mm_blendv_pd(b.v, a.v, mask.v);
+#else
+        return _mm_or_pd(_mm_and_pd(mask.v, a.v), _mm_andnot_pd(mask.v, b.v));
+#endif
+    }
+    inline bool any(dpack mask) noexcept { return _mm_movemask_pd(mask.v) != 0; }
+    inline bool all(dpack mask) noexcept { return _mm_movemask_pd(mask.v) == 0x3; }
+
+    struct fpack
+    {
+        static constexpr size_t size = 4;
+
+        fpack() = default;
+        fpack(__m128 v) noexcept : v(v) {}
+        fpack(float f) noexcept : v(_mm_set1_ps(f)) {}
+
+        static fpack load(const float* p) noexcept { return _mm_loadu_ps(p); }
+        void store(float* p) const noexcept { _mm_storeu_ps(p, v); }
+
+        __m128 v;
+    };
+
+    inline fpack operator + (fpack a, fpack b) noexcept { return _mm_add_ps(a.v, b.v); }
+    inline fpack operator - (fpack a, fpack b) noexcept { return _mm_sub_ps(a.v, b.v); }
+    inline fpack operator * (fpack a, fpack b) noexcept { return _mm_mul_ps(a.v, b.v); }
+    inline fpack operator / (fpack a, fpack b) noexcept { return _mm_div_ps(a.v, b.v); }
+    inline fpack operator - (fpack a) noexcept { return _mm_xor_ps(a.v, _mm_set1_ps(-0.f)); }
+    inline fpack operator & (fpack a, fpack b) noexcept { return _mm_and_ps(a.v, b.v); }
+    inline fpack operator | (fpack a, fpack b) noexcept { return _mm_or_ps(a.v, b.v); }
+    inline fpack operator ^ (fpack a, fpack b) noexcept { return _mm_xor_ps(a.v, b.v); }
+    inline fpack operator == (fpack a, fpack b) noexcept { return _mm_cmpeq_ps(a.v, b.v); }
+    inline fpack operator < (fpack a, fpack b) noexcept { return _mm_cmplt_ps(a.v, b.v); }
+    inline fpack operator <= (fpack a, fpack b) noexcept { return _mm_cmple_ps(a.v, b.v); }
+
+    inline fpack abs(fpack a) noexcept { return _mm_andnot_ps(_mm_set1_ps(-0.f), a.v); }
+    inline fpack sqrt(fpack a) noexcept { return _mm_sqrt_ps(a.v); }
+    inline fpack rsqrt_estimate(fpack a) noexcept { return _mm_rsqrt_ps(a.v); }
+    inline fpack select(fpack mask, fpack a, fpack b) noexcept
+    {
+#ifdef CML_SIMD_SSE4_1
+        return _mm_blendv_ps(b.v, a.v, mask.v);
+#else
+        return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+#endif
+    }
+    inline bool any(fpack mask) noexcept { return _mm_movemask_ps(mask.v) != 0; }
+    inline bool all(fpack mask) noexcept { return _mm_movemask_ps(mask.v) == 0xf; }
+#endif
+
+    /// @brief Register type holding several ValueType (void if there is none)
+    template<typename ValueType> struct pack_of { using type = void; };
+    template<> struct pack_of<float> { using type = fpack; };
+    template<> struct pack_of<double> { using type = dpack; };
+} // namespace cml::implementation::simd
+
+#endif // CML_SIMD_SSE2
@@ -0,0 +1,77 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#pragma once
+
+#include "../config.hpp"
+
+#ifdef CML_SIMD_SSE2
+#include <immintrin.h>
+
+namespace cml::implementation::simd
+{
+    // Quaternions are stored (x, y, z, w): the vector part first, then the scalar part.
+
+    /// @brief out = a * b (Hamilton product). Each lane is aw * b + ax * (bw, -bz, by, -bx) + ay * (bz, bw, -bx, -by) +
+    /// az * (-by, bx, bw, -bz), the sign flips are xors.
+    inline void quat_mul(const float* a, const float* b, float* out) noexcept
+    {
+        const __m128 qa = _mm_loadu_ps(a);
+        const __m128 qb = _mm_loadu_ps(b);
+
+        const __m128 sign_x = _mm_set_ps(-0.f, 0.f, -0.f, 0.f);
+        const __m128 sign_y = _mm_set_ps(-0.f, -0.f, 0.f, 0.f);
+        const __m128 sign_z = _mm_set_ps(-0.f, 0.f, 0.f, -0.f);
+
+        __m128 r = _mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(3, 3, 3, 3)), qb);
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(0, 0, 0, 0)), _mm_xor_ps(_mm_shuffle_ps(qb, qb, _MM_SHUFFLE(0, 1, 2, 3)), sign_x)));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(1, 1, 1, 1)), _mm_xor_ps(_mm_shuffle_ps(qb, qb, _MM_SHUFFLE(1, 0, 3, 2)), sign_y)));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(2, 2, 2, 2)), _mm_xor_ps(_mm_shuffle_ps(qb, qb, _MM_SHUFFLE(2, 3, 0, 1)), sign_z)));
+        _mm_storeu_ps(out, r);
+    }
+
+    /// @brief a x b on the first three lanes, the last lane is 0 when it is 0 in a and b
+    inline __m128 cross3(__m128 a, __m128 b) noexcept
+    {
+        const __m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+        const __m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+        const __m128 c = _mm_sub_ps(_mm_mul_ps(a, b_yzx), _mm_mul_ps(a_yzx, b));
+        return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+    }
+
+    /// @brief out = q v q*, with t = 2 (u x v) and v + w t + u x t (u the vector part of q). v and out are 3 floats.
+    inline void quat_rotate(const float* q, const float* v, float* out) noexcept
+    {
+        const __m128 qv = _mm_loadu_ps(q);
+        const __m128 u = _mm_and_ps(qv, _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)));
+        const __m128 w = _mm_shuffle_ps(qv, qv, _MM_SHUFFLE(3, 3, 3, 3));
+        // __m64 may alias floats (unlike the double of _mm_load_sd / _mm_store_sd)
+        const __m128 p = _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(v)), _mm_load_ss(v + 2));
+
+        __m128 t = cross3(u, p);
+        t = _mm_add_ps(t, t);
+        const __m128 r = _mm_add_ps(_mm_add_ps(p, _mm_mul_ps(w, t)), cross3(u, t));
+        _mm_storel_pi(reinterpret_cast<__m64*>(out), r);
+        _mm_store_ss(out + 2, _mm_movehl_ps(r, r));
+    }
+} // namespace cml::implementation::simd
+
+#endif // CML_SIMD_SSE2
@@ -0,0 +1,58 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+#include "../config.hpp"
+
+#ifdef CML_SIMD_SSE2
+#include <immintrin.h>
+
+namespace cml::implementation::simd
+{
+    /// @brief sqrtss, correctly rounded
+    inline float sqrt(float v) noexcept
+    {
+        return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(v)));
+    }
+
+    /// @brief sqrtsd, correctly rounded
+    inline double sqrt(double v) noexcept
+    {
+        return _mm_cvtsd_f64(_mm_sqrt_sd(_mm_setzero_pd(), _mm_set_sd(v)));
+    }
+
+    /// @brief rsqrtss, 1 / sqrt(v) with a relative error < 1.5 * 2^-12
+    inline float rsqrt_estimate(float v) noexcept
+    {
+        return _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(v)));
+    }
+
+    /// @brief There is no double estimate (before avx512): rsqrtss on v converted to float, v must be in the float range
+    inline double rsqrt_estimate(double v) noexcept
+    {
+        return static_cast<double>(rsqrt_estimate(static_cast<float>(v)));
+    }
+} // namespace cml::implementation::simd
+
+#endif // CML_SIMD_SSE2
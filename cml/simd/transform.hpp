@@ -0,0 +1,176 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#pragma once
+
+#include "../config.hpp"
+#include "mat4.hpp"
+#include "pack.hpp"
+
+#ifdef CML_SIMD_SSE2
+#include <immintrin.h>
+
+namespace cml::implementation::simd
+{
+    // Batched v * m kernels for float arrays. They return how many elements were processed (a multiple of the
+    // register width), the caller handles the tail.
+
+    template<int Imm> inline __m128 shuffle(__m128 a, __m128 b) noexcept { return _mm_shuffle_ps(a, b, Imm); }
+#ifdef CML_SIMD_AVX
+    template<int Imm> inline __m256 shuffle(__m256 a, __m256 b) noexcept { return _mm256_shuffle_ps(a, b, Imm); }
+#endif
+
+    /// @brief (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3) -> (x0 x1 x2 x3) (y0 y1 y2 y3) (z0 z1 z2 z3), in each 128 bit lane
+    template<typename Reg>
+    inline void deinterleave3(Reg a, Reg b, Reg c, Reg& x, Reg& y, Reg& z) noexcept
+    {
+        const Reg t = shuffle<_MM_SHUFFLE(2, 1, 3, 2)>(b, c); // b2 b3 c1 c2
+        const Reg u = shuffle<_MM_SHUFFLE(1, 0, 2, 1)>(a, b); // a1 a2 b0 b1
+        x = shuffle<_MM_SHUFFLE(2, 0, 3, 0)>(a, t);
+        y = shuffle<_MM_SHUFFLE(3, 1, 2, 0)>(u, t);
+        z = shuffle<_MM_SHUFFLE(3, 0, 3, 1)>(u, c);
+    }
+
+    /// @brief Inverse of deinterleave3
+    template<typename Reg>
+    inline void interleave3(Reg x, Reg y, Reg z, Reg& a, Reg& b, Reg& c) noexcept
+    {
+        const Reg xy01 = shuffle<_MM_SHUFFLE(1, 0, 1, 0)>(x, y); // x0 x1 y0 y1
+        const Reg zx01 = shuffle<_MM_SHUFFLE(1, 1, 0, 0)>(z, x); // z0 z0 x1 x1
+        const Reg yz1 = shuffle<_MM_SHUFFLE(1, 1, 1, 1)>(y, z);  // y1 y1 z1 z1
+        const Reg xy2 = shuffle<_MM_SHUFFLE(2, 2, 2, 2)>(x, y);  // x2 x2 y2 y2
+        const Reg zx23 = shuffle<_MM_SHUFFLE(3, 3, 2, 2)>(z, x); // z2 z2 x3 x3
+        const Reg yz3 = shuffle<_MM_SHUFFLE(3, 3, 3, 3)>(y, z);  // y3 y3 z3 z3
+        a = shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(xy01, zx01);
+        b = shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(yz1, xy2);
+        c = shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(zx23, yz3);
+    }
+
+    /// @brief Load fpack::size 3 component vectors (3 * fpack::size floats) as one register per component
+    inline void load3(const float* p, fpack& x, fpack& y, fpack& z) noexcept
+    {
+#ifdef CML_SIMD_AVX
+        // lane 0 holds the vectors 0 to 3, lane 1 the vectors 4 to 7
+        const __m256 a = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 0)), _mm_loadu_ps(p + 12), 1);
+        const __m256 b = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 4)), _mm_loadu_ps(p + 16), 1);
+        const __m256 c = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 8)), _mm_loadu_ps(p + 20), 1);
+#else
+        const __m128 a = _mm_loadu_ps(p + 0);
+        const __m128 b = _mm_loadu_ps(p + 4);
+        const __m128 c = _mm_loadu_ps(p + 8);
+#endif
+        deinterleave3(a, b, c, x.v, y.v, z.v);
+    }
+
+    inline void store3(float* p, fpack x, fpack y, fpack z) noexcept
+    {
+#ifdef CML_SIMD_AVX
+        __m256 a, b, c;
+        interleave3(x.v, y.v, z.v, a, b, c);
+        _mm_storeu_ps(p + 0, _mm256_castps256_ps128(a));
+        _mm_storeu_ps(p + 4, _mm256_castps256_ps128(b));
+        _mm_storeu_ps(p + 8, _mm256_castps256_ps128(c));
+        _mm_storeu_ps(p + 12, _mm256_extractf128_ps(a, 1));
+        _mm_storeu_ps(p + 16, _mm256_extractf128_ps(b, 1));
+        _mm_storeu_ps(p + 20, _mm256_extractf128_ps(c, 1));
+#else
+        __m128 a, b, c;
+        interleave3(x.v, y.v, z.v, a, b, c);
+        _mm_storeu_ps(p + 0, a);
+        _mm_storeu_ps(p + 4, b);
+        _mm_storeu_ps(p + 8, c);
+#endif
+    }
+
+    /// @brief out[i] = (in[i], Translate ? 1 : 0) * m, divided by its w when Divide. m is a row major 4x4 matrix, in
+    /// and out are 3 component vectors (they can be the same array). The sums are in the order of the constexpr path:
+    /// x m0 + (y m1 + (z m2 + m3)).
+    template<bool Translate, bool Divide>
+    inline size_t transform3(const float* m, const float* in, float* out, size_t count) noexcept
+    {
+        const fpack m00(m[0]), m01(m[1]), m02(m[2]), m03(m[3]);
+        const fpack m10(m[4]), m11(m[5]), m12(m[6]), m13(m[7]);
+        const fpack m20(m[8]), m21(m[9]), m22(m[10]), m23(m[11]);
+        const fpack m30(m[12]), m31(m[13]), m32(m[14]), m33(m[15]);
+
+        const size_t simd_count = count - count % fpack::size;
+        for (size_t i = 0; i < simd_count; i += fpack::size)
+        {
+            fpack x, y, z;
+            load3(in + i * 3, x, y, z);
+            fpack rx, ry, rz;
+            if constexpr(Translate)
+            {
+                rx = x * m00 + (y * m10 + (z * m20 + m30));
+                ry = x * m01 + (y * m11 + (z * m21 + m31));
+                rz = x * m02 + (y * m12 + (z * m22 + m32));
+            }
+            else
+            {
+                rx = x * m00 + (y * m10 + z * m20);
+                ry = x * m01 + (y * m11 + z * m21);
+                rz = x * m02 + (y * m12 + z * m22);
+            }
+            if constexpr(Divide)
+            {
+                const fpack w = x * m03 + (y * m13 + (z * m23 + m33));
+                rx = rx / w;
+                ry = ry / w;
+                rz = rz / w;
+            }
+            store3(out + i * 3, rx, ry, rz);
+        }
+        return simd_count;
+    }
+
+    /// @brief out[i] = in[i] * m, in and out are 4 component vectors (they can be the same array)
+    inline size_t transform4(const float* m, const float* in, float* out, size_t count) noexcept
+    {
+#ifdef CML_SIMD_AVX
+        // two vectors per register, the rows of m are duplicated in both lanes
+        const __m256 r0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 0));
+        const __m256 r1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 4));
+        const __m256 r2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 8));
+        const __m256 r3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 12));
+        const size_t simd_count = count - count % 2;
+        for (size_t i = 0; i < simd_count; i += 2)
+        {
+            const __m256 v = _mm256_loadu_ps(in + i * 4);
+            __m256 acc = _mm256_mul_ps(_mm256_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3)), r3);
+            acc = _mm256_add_ps(_mm256_mul_ps(_mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), r2), acc);
+            acc = _mm256_add_ps(_mm256_mul_ps(_mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), r1), acc);
+            acc = _mm256_add_ps(_mm256_mul_ps(_mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)), r0), acc);
+            _mm256_storeu_ps(out + i * 4, acc);
+        }
+        return simd_count;
+#else
+        const __m128 r0 = _mm_loadu_ps(m + 0);
+        const __m128 r1 = _mm_loadu_ps(m + 4);
+        const __m128 r2 = _mm_loadu_ps(m + 8);
+        const __m128 r3 = _mm_loadu_ps(m + 12);
+        for (size_t i = 0; i < count; ++i)
+            _mm_storeu_ps(out + i * 4, row_mat4_mul(_mm_loadu_ps(in + i * 4), r0, r1, r2, r3));
+        return count;
+#endif
+    }
+} // namespace cml::implementation::simd
+
+#endif // CML_SIMD_SSE2
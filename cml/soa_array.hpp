@@ -0,0 +1,468 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "fixed_point.hpp"
+#include "lazy.hpp"
+#include "matrix.hpp"
+#include "reference.hpp"
+#include "simd/pack.hpp"
+#include "span.hpp"
+#include "traits.hpp"
+#include "functions/sqrt.hpp"
+
+namespace cml
+{
+    namespace implementation
+    {
+        /// @brief Lane tag given to the soa_loop bodies
+        template<typename Lane>
+        struct soa_lane
+        {
+            using type = Lane;
+        };
+
+        /// @brief Call body(soa_lane<L>, i) for every index of a stream. L is a register of ValueType (simd::fpack,
+        /// simd::dpack) for the bulk of the stream and ValueType for the remaining elements (and for the other types).
+        template<typename ValueType, typename Body>
+        inline void soa_loop(size_t count, Body&& body)
+        {
+            size_t i = 0;
+#ifdef CML_SIMD_SSE2
+            using pack = typename simd::pack_of<ValueType>::type;
+            if constexpr(!std::is_void<pack>::value)
+            {
+                for (; i + pack::size <= count; i += pack::size)
+                    body(soa_lane<pack>{}, i);
+            }
+#endif
+            for (; i < count; ++i)
+                body(soa_lane<ValueType>{}, i);
+        }
+
+        template<typename Lane, typename ValueType>
+        inline Lane soa_load(const ValueType* p) noexcept
+        {
+            if constexpr(std::is_same<Lane, ValueType>::value)
+                return *p;
+            else
+                return Lane::load(p);
+        }
+
+        template<typename Lane, typename ValueType>
+        inline void soa_store(ValueType* p, const Lane& v) noexcept
+        {
+            if constexpr(std::is_same<Lane, ValueType>::value)
+                *p = v;
+            else
+                v.store(p);
+        }
+
+        template<typename Lane>
+        inline Lane soa_sqrt(const Lane& v) noexcept
+        {
+            if constexpr(std::is_arithmetic<Lane>::value || is_fixed_point<Lane>::value)
+                return cml::sqrt(v);
+            else
+                return sqrt(v); // simd::sqrt, found by ADL
+        }
+    } // namespace implementation
+
+    /// @brief Array of vectors stored as a structure of arrays: every component has its own contiguous stream
+    /// (x0 x1 x2 ... / y0 y1 y2 ... / ...). The operators and functions below work on whole arrays, a full register of
+    /// floats or doubles at a time, and give the same results as the vector operators applied element by element.
+    template<typename VecType, typename Allocator = std::allocator<typename matrix_traits<VecType>::type>>
+    class soa_array
+    {
+        static_assert(is_vector<VecType>::value, "soa_array can only hold vectors");
+
+    public:
+        using vector_type = VecType;
+        using value_type = typename matrix_traits<VecType>::type;
+        using allocator_type = Allocator;
+        using stream_type = std::vector<value_type, Allocator>;
+        static constexpr size_t dim = matrix_traits<VecType>::components;
+
+        /// @brief Proxy returned by operator[]: a vector of references on the components of an element
+        using reference = implementation::matrix<matrix_traits<VecType>::dimx, matrix_traits<VecType>::dimy, implementation::reference<value_type>, matrix_traits<VecType>::kind>;
+
+    public:
+        soa_array() = default;
+        soa_array(const soa_array&) = default;
+        soa_array(soa_array&&) noexcept = default;
+        soa_array& operator = (const soa_array&) = default;
+        soa_array& operator = (soa_array&&) noexcept = default;
+
+        explicit soa_array(const Allocator& allocator)
+        : m_streams(make_streams(std::make_index_sequence<dim>{}, allocator))
+        {
+        }
+
+        explicit soa_array(size_t count, const VecType& value = VecType(), const Allocator& allocator = Allocator())
+        : soa_array(allocator)
+        {
+            resize(count, value);
+        }
+
+        soa_array(std::initializer_list<VecType> values, const Allocator& allocator = Allocator())
+        : soa_array(allocator)
+        {
+            reserve(values.size());
+            for (const VecType& v : values)
+                push_back(v);
+        }
+
+        size_t size() const noexcept { return m_streams[0].size(); }
+        bool empty() const noexcept { return m_streams[0].empty(); }
+
+        void reserve(size_t count)
+        {
+            for (stream_type& s : m_streams)
+                s.reserve(count);
+        }
+
+        void resize(size_t count, const VecType& value = VecType())
+        {
+            for (size_t c = 0; c < dim; ++c)
+                m_streams[c].resize(count, value.components[c]);
+        }
+
+        void clear() noexcept
+        {
+            for (stream_type& s : m_streams)
+                s.clear();
+        }
+
+        void push_back(const VecType& value)
+        {
+            for (size_t c = 0; c < dim; ++c)
+                m_streams[c].push_back(value.components[c]);
+        }
+
+        reference operator [] (size_t index) noexcept
+        {
+            return make_reference(std::make_index_sequence<dim>{}, index);
+        }
+
+        VecType operator [] (size_t index) const noexcept
+        {
+            return make_vector(std::make_index_sequence<dim>{}, index);
+        }
+
+        /// @brief The contiguous stream of a component (0 for x, 1 for y, ...)
+        value_type* data(size_t component) noexcept { return m_streams[component].data(); }
+        const value_type* data(size_t component) const noexcept { return m_streams[component].data(); }
+
+        span<value_type> stream(size_t component) noexcept { return span<value_type>(data(component), size()); }
+        span<const value_type> stream(size_t component) const noexcept { return span<const value_type>(data(component), size()); }
+
+        soa_array& operator += (const soa_array& o) { return apply(o, [](auto a, auto b) { return a + b; }); }
+        soa_array& operator -= (const soa_array& o) { return apply(o, [](auto a, auto b) { return a - b; }); }
+        soa_array& operator += (const VecType& v) { return apply(v, [](auto a, auto b) { return a + b; }); }
+        soa_array& operator -= (const VecType& v) { return apply(v, [](auto a, auto b) { return a - b; }); }
+        soa_array& operator *= (value_type s) { return apply(VecType(s), [](auto a, auto b) { return a * b; }); }
+        soa_array& operator /= (value_type s) { return apply(VecType(s), [](auto a, auto b) { return a / b; }); }
+
+        /// @brief Evaluate a lazy expression (see lazy.hpp) in one pass over the streams, without temporary arrays
+        template<typename Expr, typename = std::enable_if_t<implementation::is_lazy_expression<Expr>::value>>
+        soa_array& operator = (const Expr& e)
+        {
+            resize(e.size());
+            return apply_expression(e, [](auto, auto b) { return b; });
+        }
+
+        template<typename Expr, typename = std::enable_if_t<implementation::is_lazy_expression<Expr>::value>>
+        soa_array& operator += (const Expr& e)
+        {
+            if (e.size() != size())
+                throw std::runtime_error("soa_array sizes differ");
+            return apply_expression(e, [](auto a, auto b) { return a + b; });
+        }
+
+        template<typename Expr, typename = std::enable_if_t<implementation::is_lazy_expression<Expr>::value>>
+        soa_array& operator -= (const Expr& e)
+        {
+            if (e.size() != size())
+                throw std::runtime_error("soa_array sizes differ");
+            return apply_expression(e, [](auto a, auto b) { return a - b; });
+        }
+
+    private:
+        template<size_t... Idxs>
+        static std::array<stream_type, dim> make_streams(std::index_sequence<Idxs...>, const Allocator& allocator)
+        {
+            return {{((void)Idxs, stream_type(allocator))...}};
+        }
+
+        template<size_t... Idxs>
+        reference make_reference(std::index_sequence<Idxs...>, size_t index) noexcept
+        {
+            return reference(implementation::reference<value_type>(m_streams[Idxs].data() + index)...);
+        }
+
+        template<size_t... Idxs>
+        VecType make_vector(std::index_sequence<Idxs...>, size_t index) const noexcept
+        {
+            return VecType(m_streams[Idxs][index]...);
+        }
+
+        template<typename Op>
+        soa_array& apply(const soa_array& o, Op op)
+        {
+            if (o.size() != size())
+                throw std::runtime_error("soa_array sizes differ");
+            for (size_t c = 0; c < dim; ++c)
+            {
+                value_type* out = data(c);
+                const value_type* in = o.data(c);
+                implementation::soa_loop<value_type>(size(), [&](auto lane, size_t i)
+                {
+                    using L = typename decltype(lane)::type;
+                    implementation::soa_store(out + i, L(op(implementation::soa_load<L>(out + i), implementation::soa_load<L>(in + i))));
+                });
+            }
+            return *this;
+        }
+
+        template<typename Op>
+        soa_array& apply(const VecType& v, Op op)
+        {
+            for (size_t c = 0; c < dim; ++c)
+            {
+                value_type* out = data(c);
+                const value_type vc = v.components[c];
+                implementation::soa_loop<value_type>(size(), [&](auto lane, size_t i)
+                {
+                    using L = typename decltype(lane)::type;
+                    implementation::soa_store(out + i, L(op(implementation::soa_load<L>(out + i), L(vc))));
+                });
+            }
+            return *this;
+        }
+
+        template<typename Expr, typename Op>
+        soa_array& apply_expression(const Expr& e, Op op)
+        {
+            for (size_t c = 0; c < dim; ++c)
+            {
+                value_type* out = data(c);
+                implementation::soa_loop<value_type>(size(), [&](auto lane, size_t i)
+                {
+                    using L = typename decltype(lane)::type;
+                    implementation::soa_store(out + i, L(op(implementation::soa_load<L>(out + i), e.template at<L>(c, i))));
+                });
+            }
+            return *this;
+        }
+
+    private:
+        std::array<stream_type, dim> m_streams;
+    };
+
+    namespace implementation
+    {
+        template<typename VecType, typename Allocator>
+        struct is_lazy_array<soa_array<VecType, Allocator>> : public std::true_type {};
+
+        /// @brief Leaf of a lazy expression reading an soa_array
+        template<typename VecType, typename Allocator>
+        struct lazy_soa : public lazy_expression<lazy_soa<VecType, Allocator>>
+        {
+            using result_type = soa_array<VecType, Allocator>;
+
+            lazy_soa(const result_type& a) noexcept : a(&a) {}
+
+            size_t size() const noexcept { return a->size(); }
+
+            template<typename Lane>
+            Lane at(size_t component, size_t index) const noexcept
+            {
+                return soa_load<Lane>(a->data(component) + index);
+            }
+
+            const result_type* a;
+        };
+
+        template<typename VecType, typename Allocator>
+        struct lazy_evaluate<soa_array<VecType, Allocator>>
+        {
+            template<typename Expr>
+            static soa_array<VecType, Allocator> evaluate(const Expr& e)
+            {
+                soa_array<VecType, Allocator> ret;
+                ret = e;
+                return ret;
+            }
+        };
+    } // namespace implementation
+
+    /// @brief Start a lazy expression from an soa_array: the whole expression is then evaluated a register at a time
+    template<typename VecType, typename Allocator>
+    implementation::lazy_soa<VecType, Allocator> lazy(const soa_array<VecType, Allocator>& a) noexcept
+    {
+        return implementation::lazy_soa<VecType, Allocator>(a);
+    }
+
+    /// @brief The leaves only point to their soa_array: a temporary would be gone before the expression is evaluated
+    template<typename VecType, typename Allocator>
+    void lazy(soa_array<VecType, Allocator>&& a) = delete;
+
+    template<typename VecType, typename Allocator>
+    soa_array<VecType, Allocator> operator + (soa_array<VecType, Allocator> a, const soa_array<VecType, Allocator>& b) { return a += b; }
+    template<typename VecType, typename Allocator>
+    soa_array<VecType, Allocator> operator - (soa_array<VecType, Allocator> a, const soa_array<VecType, Allocator>& b) { return a -= b; }
+    template<typename VecType, typename Allocator>
+    soa_array<VecType, Allocator> operator + (soa_array<VecType, Allocator> a, const VecType& v) { return a += v; }
+    template<typename VecType, typename Allocator>
+    soa_array<VecType, Allocator> operator - (soa_array<VecType, Allocator> a, const VecType& v) { return a -= v; }
+    template<typename VecType, typename Allocator>
+    soa_array<VecType, Allocator> operator * (soa_array<VecType, Allocator> a, typename soa_array<VecType, Allocator>::value_type s) { return a *= s; }
+    template<typename VecType, typename Allocator>
+    soa_array<VecType, Allocator> operator * (typename soa_array<VecType, Allocator>::value_type s, soa_array<VecType, Allocator> a) { return a *= s; }
+    template<typename VecType, typename Allocator>
+    soa_array<VecType, Allocator> operator / (soa_array<VecType, Allocator> a, typename soa_array<VecType, Allocator>::value_type s) { return a /= s; }
+
+    /// @brief out[i] = dot(a[i], b[i])
+    template<typename VecType, typename Allocator>
+    void dot(const soa_array<VecType, Allocator>& a, const soa_array<VecType, Allocator>& b, span<typename soa_array<VecType, Allocator>::value_type> out)
+    {
+        using value_type = typename soa_array<VecType, Allocator>::value_type;
+        constexpr size_t dim = soa_array<VecType, Allocator>::dim;
+        if (b.size() != a.size() || out.size() < a.size())
+            throw std::runtime_error("soa_array sizes differ");
+
+        value_type* o = out.data();
+        implementation::soa_loop<value_type>(a.size(), [&](auto lane, size_t i)
+        {
+            using L = typename decltype(lane)::type;
+            // same order as the fold expression of dot_impl: a0*b0 + (a1*b1 + (a2*b2 + ...))
+            L acc = implementation::soa_load<L>(a.data(dim - 1) + i) * implementation::soa_load<L>(b.data(dim - 1) + i);
+            for (size_t c = dim - 1; c-- > 0;)
+                acc = L(implementation::soa_load<L>(a.data(c) + i) * implementation::soa_load<L>(b.data(c) + i) + acc);
+            implementation::soa_store(o + i, acc);
+        });
+    }
+
+    template<typename VecType, typename Allocator>
+    std::vector<typename soa_array<VecType, Allocator>::value_type, Allocator> dot(const soa_array<VecType, Allocator>& a, const soa_array<VecType, Allocator>& b)
+    {
+        std::vector<typename soa_array<VecType, Allocator>::value_type, Allocator> ret(a.size());
+        dot(a, b, span<typename soa_array<VecType, Allocator>::value_type>(ret));
+        return ret;
+    }
+
+    /// @brief out[i] = length(a[i])
+    template<typename VecType, typename Allocator>
+    void length(const soa_array<VecType, Allocator>& a, span<typename soa_array<VecType, Allocator>::value_type> out)
+    {
+        using value_type = typename soa_array<VecType, Allocator>::value_type;
+        if (out.size() < a.size())
+            throw std::runtime_error("soa_array sizes differ");
+
+        dot(a, a, out);
+        value_type* o = out.data();
+        implementation::soa_loop<value_type>(a.size(), [&](auto lane, size_t i)
+        {
+            using L = typename decltype(lane)::type;
+            implementation::soa_store(o + i, implementation::soa_sqrt(implementation::soa_load<L>(o + i)));
+        });
+    }
+
+    template<typename VecType, typename Allocator>
+    std::vector<typename soa_array<VecType, Allocator>::value_type, Allocator> length(const soa_array<VecType, Allocator>& a)
+    {
+        std::vector<typename soa_array<VecType, Allocator>::value_type, Allocator> ret(a.size());
+        length(a, span<typename soa_array<VecType, Allocator>::value_type>(ret));
+        return ret;
+    }
+
+    /// @brief Normalize every vector of the array in place
+    template<typename VecType, typename Allocator>
+    void normalize_in_place(soa_array<VecType, Allocator>& a)
+    {
+        using value_type = typename soa_array<VecType, Allocator>::value_type;
+        constexpr size_t dim = soa_array<VecType, Allocator>::dim;
+
+        const std::vector<value_type, Allocator> len = length(a);
+        const value_type* l = len.data();
+        implementation::soa_loop<value_type>(a.size(), [&](auto lane, size_t i)
+        {
+            using L = typename decltype(lane)::type;
+            // same as normalize: v * (1 / length(v))
+            const L s = L(L(value_type(1)) / implementation::soa_load<L>(l + i));
+            for (size_t c = 0; c < dim; ++c)
+                implementation::soa_store(a.data(c) + i, L(implementation::soa_load<L>(a.data(c) + i) * s));
+        });
+    }
+
+    template<typename VecType, typename Allocator>
+    soa_array<VecType, Allocator> normalize(soa_array<VecType, Allocator> a)
+    {
+        normalize_in_place(a);
+        return a;
+    }
+
+    /// @brief out[i] = cross(a[i], b[i]), out can be a or b
+    template<typename VecType, typename Allocator>
+    void cross(const soa_array<VecType, Allocator>& a, const soa_array<VecType, Allocator>& b, soa_array<VecType, Allocator>& out)
+    {
+        using value_type = typename soa_array<VecType, Allocator>::value_type;
+        static_assert(soa_array<VecType, Allocator>::dim == 3, "can only cross 3 component vectors");
+        if (b.size() != a.size())
+            throw std::runtime_error("soa_array sizes differ");
+        out.resize(a.size());
+
+        implementation::soa_loop<value_type>(a.size(), [&](auto lane, size_t i)
+        {
+            using L = typename decltype(lane)::type;
+            const L ax = implementation::soa_load<L>(a.data(0) + i);
+            const L ay = implementation::soa_load<L>(a.data(1) + i);
+            const L az = implementation::soa_load<L>(a.data(2) + i);
+            const L bx = implementation::soa_load<L>(b.data(0) + i);
+            const L by = implementation::soa_load<L>(b.data(1) + i);
+            const L bz = implementation::soa_load<L>(b.data(2) + i);
+            implementation::soa_store(out.data(0) + i, L(ay * bz - az * by));
+            implementation::soa_store(out.data(1) + i, L(az * bx - ax * bz));
+            implementation::soa_store(out.data(2) + i, L(ax * by - ay * bx));
+        });
+    }
+
+    template<typename VecType, typename Allocator>
+    soa_array<VecType, Allocator> cross(const soa_array<VecType, Allocator>& a, const soa_array<VecType, Allocator>& b)
+    {
+        soa_array<VecType, Allocator> ret(a.size());
+        cross(a, b, ret);
+        return ret;
+    }
+} // namespace cml
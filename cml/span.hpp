@@ -0,0 +1,91 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace cml
+{
+    /// @brief Non owning view over contiguous values (std::span is c++20). Used by the batched functions.
+    template<typename ValueType>
+    class span
+    {
+    public:
+        using element_type = ValueType;
+        using value_type = std::remove_cv_t<ValueType>;
+        using size_type = std::size_t;
+        using pointer = ValueType*;
+        using reference = ValueType&;
+        using iterator = ValueType*;
+
+        constexpr span() noexcept = default;
+        constexpr span(const span&) noexcept = default;
+        constexpr span& operator = (const span&) noexcept = default;
+
+        constexpr span(pointer data, size_type size) noexcept
+        : m_data(data), m_size(size)
+        {
+        }
+
+        template<size_t Size>
+        constexpr span(ValueType (&array)[Size]) noexcept
+        : m_data(array), m_size(Size)
+        {
+        }
+
+        /// @brief Any contiguous container (std::vector, std::array, ...)
+        template<typename Container, typename = std::enable_if_t<
+            !std::is_same<std::remove_cv_t<Container>, span>::value &&
+            std::is_convertible<decltype(std::data(std::declval<Container&>())), pointer>::value>>
+        constexpr span(Container& container) noexcept
+        : m_data(std::data(container)), m_size(std::size(container))
+        {
+        }
+
+        /// @brief span<T> -> span<const T>
+        template<typename Other, typename = std::enable_if_t<std::is_convertible<Other(*)[], ValueType(*)[]>::value>>
+        constexpr span(const span<Other>& o) noexcept
+        : m_data(o.data()), m_size(o.size())
+        {
+        }
+
+        constexpr pointer data() const noexcept { return m_data; }
+        constexpr size_type size() const noexcept { return m_size; }
+        constexpr bool empty() const noexcept { return m_size == 0; }
+
+        constexpr reference operator [] (size_type index) const noexcept { return m_data[index]; }
+
+        constexpr iterator begin() const noexcept { return m_data; }
+        constexpr iterator end() const noexcept { return m_data + m_size; }
+
+        constexpr span subspan(size_type offset, size_type count) const noexcept { return span(m_data + offset, count); }
+        constexpr span subspan(size_type offset) const noexcept { return span(m_data + offset, m_size - offset); }
+
+    private:
+        pointer m_data = nullptr;
+        size_type m_size = 0;
+    };
+} // namespace cml
@@ -0,0 +1,400 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "config.hpp"
+#include "matrix_kind.hpp"
+#include "simd/swizzle.hpp"
+#include "traits.hpp"
+#include "vector_component_table.hpp"
+
+namespace cml::implementation
+{
+    template<size_t DimX, size_t DimY, typename ValueType, matrix_kind Kind> class matrix;
+    template<typename MatrixType, size_t... Idxs> class swizzle;
+
+    // traits
+    template<typename T> struct is_swizzle : public std::false_type {};
+    template<typename MatrixType, size_t... Idxs> struct is_swizzle<swizzle<MatrixType, Idxs...>> : public std::true_type {};
+
+    /// @brief Whether no component appears twice in Idxs
+    template<size_t... Idxs>
+    constexpr bool swizzle_is_distinct() noexcept
+    {
+        constexpr size_t idxs[] = {Idxs...};
+        for (size_t i = 0; i < sizeof...(Idxs); ++i)
+        {
+            for (size_t j = i + 1; j < sizeof...(Idxs); ++j)
+            {
+                if (idxs[i] == idxs[j])
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    /// @brief Position of Index in Idxs (the inverse permutation)
+    template<size_t Index, size_t... Idxs>
+    constexpr size_t swizzle_position() noexcept
+    {
+        constexpr size_t idxs[] = {Idxs...};
+        for (size_t i = 0; i < sizeof...(Idxs); ++i)
+        {
+            if (idxs[i] == Index)
+                return i;
+        }
+        return ~size_t(0);
+    }
+
+    /// @brief Whether reading the swizzle is a single shuffle (simd/swizzle.hpp): the four components of a four float
+    /// matrix. Writing also needs distinct components.
+    template<typename MatrixType, size_t... Idxs>
+    struct has_simd_swizzle
+    {
+#ifdef CML_SIMD_SSE2
+        static constexpr bool value = std::is_same<typename matrix_traits<MatrixType>::type, float>::value && matrix_traits<MatrixType>::components == 4 && sizeof...(Idxs) == 4;
+#else
+        static constexpr bool value = false;
+#endif
+    };
+
+    /// @brief Swizzles are evaluated before being used as operands
+    template<typename Type>
+    constexpr decltype(auto) swizzle_operand(Type&& o)
+    {
+        if constexpr(is_swizzle<std::decay_t<Type>>::value)
+            return o.eval();
+        else
+            return std::forward<Type>(o);
+    }
+
+    /// @brief Whether one of Types is a swizzle: the vector functions have overloads evaluating those (swizzle_operand)
+    /// before calling their matrix versions
+    template<typename... Types>
+    struct any_swizzle : public std::disjunction<is_swizzle<std::decay_t<Types>>...> {};
+
+    /// @brief Parent pointer of a swizzle, first member of the union of its named components
+    template<typename MatrixType>
+    struct swizzle_parent
+    {
+        MatrixType* pointer;
+    };
+
+    /// @brief Named component of a swizzle (v._<'zy'>().x is v.z), behaves like a reference to the component Index of
+    /// the parent matrix. Its only member is the parent pointer, so the names of a swizzle are all in a union with it
+    /// and the swizzle stays a single pointer. Like the named components of matrices, they are not usable in constant
+    /// expressions.
+    template<typename MatrixType, size_t Index>
+    struct swizzle_component
+    {
+        using value_type = typename matrix_traits<MatrixType>::type;
+
+        MatrixType* pointer;
+
+        /// @brief Assign the component (a swizzle component is never re-seated)
+        constexpr swizzle_component& operator = (const swizzle_component& o) noexcept { pointer->components[Index] = o.pointer->components[Index]; return *this; }
+        constexpr swizzle_component& operator = (const value_type& o) noexcept { pointer->components[Index] = o; return *this; }
+
+        constexpr operator value_type& () const noexcept { return pointer->components[Index]; }
+        template<typename Type>
+        explicit constexpr operator Type () const noexcept { return static_cast<Type>(pointer->components[Index]); }
+
+        constexpr swizzle_component& operator += (const value_type& o) noexcept { pointer->components[Index] += o; return *this; }
+        constexpr swizzle_component& operator -= (const value_type& o) noexcept { pointer->components[Index] -= o; return *this; }
+        constexpr swizzle_component& operator *= (const value_type& o) noexcept { pointer->components[Index] *= o; return *this; }
+        constexpr swizzle_component& operator /= (const value_type& o) noexcept { pointer->components[Index] /= o; return *this; }
+    };
+
+    /// @brief Storage of a swizzle: the parent pointer, and the names of the components for 2 to 4 of them (same names as
+    /// matrix_components)
+    template<typename MatrixType, size_t... Idxs>
+    class swizzle_components
+    {
+    public:
+        union
+        {
+            swizzle_parent<MatrixType> parent;
+        };
+
+    protected:
+        explicit constexpr swizzle_components(MatrixType& m) noexcept : parent{&m} {}
+    };
+
+    template<typename MatrixType, size_t I0, size_t I1>
+    class swizzle_components<MatrixType, I0, I1>
+    {
+    public:
+        union
+        {
+            swizzle_parent<MatrixType> parent;
+            swizzle_component<MatrixType, I0> x, r, s;
+            swizzle_component<MatrixType, I1> y, g, t;
+        };
+
+    protected:
+        explicit constexpr swizzle_components(MatrixType& m) noexcept : parent{&m} {}
+    };
+
+    template<typename MatrixType, size_t I0, size_t I1, size_t I2>
+    class swizzle_components<MatrixType, I0, I1, I2>
+    {
+    public:
+        union
+        {
+            swizzle_parent<MatrixType> parent;
+            swizzle_component<MatrixType, I0> x, r, s;
+            swizzle_component<MatrixType, I1> y, g, t;
+            swizzle_component<MatrixType, I2> z, b, u;
+        };
+
+    protected:
+        explicit constexpr swizzle_components(MatrixType& m) noexcept : parent{&m} {}
+    };
+
+    template<typename MatrixType, size_t I0, size_t I1, size_t I2, size_t I3>
+    class swizzle_components<MatrixType, I0, I1, I2, I3>
+    {
+    public:
+        union
+        {
+            swizzle_parent<MatrixType> parent;
+            swizzle_component<MatrixType, I0> x, r, s;
+            swizzle_component<MatrixType, I1> y, g, t;
+            swizzle_component<MatrixType, I2> z, b, u;
+            swizzle_component<MatrixType, I3> w, a, v;
+        };
+
+    protected:
+        explicit constexpr swizzle_components(MatrixType& m) noexcept : parent{&m} {}
+    };
+
+    /// @brief View on some components of a matrix, returned by the non const matrix::_<'zyx'>(). The component indexes
+    /// are template parameters, so the view only holds a pointer to the parent matrix. Its components have the names of
+    /// the vector ones: v._<'zyx'>().x is v.z.
+    /// It converts to a vector, and the assignments and compound operators write through to the parent one component
+    /// after the other (v._<'xx'>() *= 2 multiplies x by 4). The right hand side is read before anything is written:
+    /// v._<'yx'>() = v._<'xy'>() swaps x and y. For four components of a float vec4 the reads and writes are a single
+    /// shuffle at runtime.
+    template<typename MatrixType, size_t... Idxs>
+    class swizzle : public swizzle_components<MatrixType, Idxs...>
+    {
+    public:
+        using matrix_type = MatrixType;
+        using value_type = typename matrix_traits<MatrixType>::type;
+        using vector_type = matrix<sizeof...(Idxs), 1, value_type, matrix_traits<MatrixType>::kind>;
+
+        static constexpr size_t count = sizeof...(Idxs);
+
+        /// @brief Indexes of the components in the parent matrix
+        static constexpr size_t indexes[] = {Idxs...};
+
+    public:
+        explicit constexpr swizzle(MatrixType& m) noexcept : swizzle_components<MatrixType, Idxs...>(m) {}
+        constexpr swizzle(const swizzle&) noexcept = default;
+
+        /// @brief Assign the components (a swizzle is never re-seated)
+        constexpr swizzle& operator = (const swizzle& o) noexcept
+        {
+            return *this = o.eval();
+        }
+
+        /// @brief Assign a vector with the same component count, another swizzle or a scalar (to every component)
+        template<typename Type>
+        constexpr swizzle& operator = (Type&& o) noexcept
+        {
+            using T = std::decay_t<Type>;
+            if constexpr(is_swizzle<T>::value)
+            {
+                return *this = o.eval();
+            }
+            else
+            {
+#ifdef CML_SIMD_SSE2
+                if constexpr(has_simd_swizzle<MatrixType, Idxs...>::value && swizzle_is_distinct<Idxs...>() && is_matrix<T>::value)
+                {
+                    if constexpr(std::is_same<typename matrix_traits<T>::type, float>::value)
+                    {
+                        if (!is_constant_evaluated())
+                        {
+                            simd::shuffle4<swizzle_position<0, Idxs...>(), swizzle_position<1, Idxs...>(), swizzle_position<2, Idxs...>(), swizzle_position<3, Idxs...>()>(o.components.data(), this->parent.pointer->components.data());
+                            return *this;
+                        }
+                    }
+                }
+#endif
+                apply(std::make_index_sequence<count>{}, o, [](value_type& a, const value_type& b) { a = b; });
+                return *this;
+            }
+        }
+
+        template<typename Type> constexpr swizzle& operator += (const Type& o) noexcept { return compound(o, [](value_type& a, const value_type& b) { a += b; }); }
+        template<typename Type> constexpr swizzle& operator -= (const Type& o) noexcept { return compound(o, [](value_type& a, const value_type& b) { a -= b; }); }
+        template<typename Type> constexpr swizzle& operator *= (const Type& o) noexcept { return compound(o, [](value_type& a, const value_type& b) { a *= b; }); }
+        template<typename Type> constexpr swizzle& operator /= (const Type& o) noexcept { return compound(o, [](value_type& a, const value_type& b) { a /= b; }); }
+
+        /// @brief The components, as a vector
+        constexpr vector_type eval() const noexcept
+        {
+#ifdef CML_SIMD_SSE2
+            if constexpr(has_simd_swizzle<MatrixType, Idxs...>::value)
+            {
+                if (!is_constant_evaluated())
+                {
+                    vector_type ret;
+                    simd::shuffle4<Idxs...>(this->parent.pointer->components.data(), ret.components.data());
+                    return ret;
+                }
+            }
+#endif
+            return vector_type(this->parent.pointer->components[Idxs]...);
+        }
+
+        /// @brief Convert to a vector (to another value type only if no precision is lost, like matrices)
+        template<typename Type, matrix_kind OKind>
+        constexpr operator matrix<sizeof...(Idxs), 1, Type, OKind>() const
+        {
+            return eval();
+        }
+
+        template<typename Type, matrix_kind OKind = matrix_traits<MatrixType>::kind>
+        constexpr matrix<sizeof...(Idxs), 1, Type, OKind> unsafe_cast() const
+        {
+            return eval().template unsafe_cast<Type, OKind>();
+        }
+
+        /// @brief Component of the parent matrix
+        constexpr value_type& operator [] (size_t index) const noexcept
+        {
+            return this->parent.pointer->components[indexes[index]];
+        }
+
+        /// @brief Component access, a swizzle of a swizzle is a swizzle of the parent matrix
+        template<unsigned int Components>
+        constexpr decltype(auto) _() const noexcept
+        {
+            if constexpr (Components == 0)
+                return; // void
+            else if constexpr (Components <= 0xFFu)
+                return at_separate<static_cast<char>(Components)>();
+            else if constexpr (Components <= 0xFFFFu)
+                return at_separate<static_cast<char>((Components >> 8) & 0xFF), static_cast<char>((Components >> 0) & 0xFF)>();
+            else if constexpr (Components <= 0xFFFFFFu)
+                return at_separate<static_cast<char>((Components >> 16) & 0xFF), static_cast<char>((Components >> 8) & 0xFF), static_cast<char>((Components >> 0) & 0xFF)>();
+            else
+                return at_separate<static_cast<char>((Components >> 24) & 0xFF), static_cast<char>((Components >> 16) & 0xFF), static_cast<char>((Components >> 8) & 0xFF), static_cast<char>((Components >> 0) & 0xFF)>();
+        }
+
+        template<char... Components>
+        constexpr decltype(auto) at_separate() const noexcept
+        {
+            if constexpr (sizeof...(Components) == 1)
+                return (*this)[component_index_t<Components..., count>::index];
+            else
+                return swizzle<MatrixType, indexes[component_index_t<Components, count>::index]...>(*this->parent.pointer);
+        }
+
+    public: // operators: the swizzle is evaluated and the matrix operators do the rest
+#define CML_SWIZZLE_OPERATOR(op) \
+        template<typename Type> \
+        friend constexpr auto operator op (swizzle a, Type&& b) { return a.eval() op swizzle_operand(std::forward<Type>(b)); } \
+        template<typename Type, typename = std::enable_if_t<std::is_convertible<Type, value_type>::value>> \
+        friend constexpr auto operator op (Type&& a, swizzle b) { return value_type(std::forward<Type>(a)) op b.eval(); } \
+        friend constexpr auto operator op (const vector_type& a, swizzle b) { return a op b.eval(); }
+
+        CML_SWIZZLE_OPERATOR(+)
+        CML_SWIZZLE_OPERATOR(-)
+        CML_SWIZZLE_OPERATOR(*)
+        CML_SWIZZLE_OPERATOR(/)
+#undef CML_SWIZZLE_OPERATOR
+
+        template<typename Type>
+        friend constexpr bool operator == (swizzle a, Type&& b) { return a.eval() == swizzle_operand(std::forward<Type>(b)); }
+        friend constexpr bool operator == (const vector_type& a, swizzle b) { return a == b.eval(); }
+        template<typename Type>
+        friend constexpr bool operator != (swizzle a, Type&& b) { return a.eval() != swizzle_operand(std::forward<Type>(b)); }
+        friend constexpr bool operator != (const vector_type& a, swizzle b) { return a != b.eval(); }
+
+        friend constexpr vector_type& operator += (vector_type& a, swizzle b) { return a += b.eval(); }
+        friend constexpr vector_type& operator -= (vector_type& a, swizzle b) { return a -= b.eval(); }
+        friend constexpr vector_type& operator *= (vector_type& a, swizzle b) { return a *= b.eval(); }
+        friend constexpr vector_type& operator /= (vector_type& a, swizzle b) { return a /= b.eval(); }
+
+    private:
+        /// @brief o as a value_type, or its component index if it is a matrix
+        template<typename Operand>
+        static constexpr value_type operand_at(const Operand& o, size_t index)
+        {
+            if constexpr(is_matrix<Operand>::value)
+            {
+                static_assert(matrix_traits<Operand>::components == sizeof...(Idxs), "cml::swizzle: the operand must have as many components as the swizzle");
+                return value_type(o.components[index]);
+            }
+            else
+            {
+                return value_type(o);
+            }
+        }
+
+        /// @brief operation(parent component, operand component) for every component, in order. The operand is a copy:
+        /// it may be the parent matrix itself.
+        template<typename Operand, typename Operation, size_t... Is>
+        constexpr void apply(std::index_sequence<Is...>, const Operand o, Operation operation)
+        {
+#ifndef _MSC_VER
+            (operation(this->parent.pointer->components[Idxs], operand_at(o, Is)), ...);
+#else
+            using ar_t = int[];
+            (void)(ar_t{(operation(this->parent.pointer->components[Idxs], operand_at(o, Is)), 0)...});
+#endif
+        }
+
+        template<typename Operand, typename Operation>
+        constexpr swizzle& compound(const Operand& o, Operation operation)
+        {
+            if constexpr(is_swizzle<Operand>::value)
+            {
+                return compound(o.eval(), operation);
+            }
+            else
+            {
+                if constexpr(has_simd_swizzle<MatrixType, Idxs...>::value && swizzle_is_distinct<Idxs...>())
+                {
+                    // every component is written once: shuffle, compute on the vector, shuffle back
+                    if (!is_constant_evaluated())
+                    {
+                        vector_type values = eval();
+                        for (size_t i = 0; i < count; ++i)
+                            operation(values.components[i], operand_at(o, i));
+                        return *this = values;
+                    }
+                }
+                apply(std::make_index_sequence<count>{}, o, operation);
+                return *this;
+            }
+        }
+    };
+} // namespace cml::implementation
@@ -0,0 +1,131 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "bench.hpp"
+#include <cml/cml.hpp>
+#include <cstring>
+#include <vector>
+
+// Batched transforms with the normal and the aligned storage. std::vector<vec4> is only as aligned as the allocator
+// makes it, vec4 packed in bigger structures can sit at any 4 byte offset (the "packed" benchmarks), avec4 / amat4 are
+// always 16 / 32 bytes aligned and use aligned loads.
+namespace
+{
+    constexpr size_t transform_count = 4096;
+
+    template<typename VecType>
+    std::vector<VecType> make_points()
+    {
+        std::vector<VecType> ret(transform_count);
+        for (size_t i = 0; i < ret.size(); ++i)
+            ret[i] = VecType(float(i), float(i) * 0.5f, 1.f - float(i), 1.f);
+        return ret;
+    }
+
+    template<typename MatType>
+    MatType make_transform()
+    {
+        return MatType(0.5f, 0.f, 0.1f, 0.f, 0.f, 1.f, 0.f, 0.f, -0.1f, 0.f, 0.5f, 0.f, 10.f, 20.f, 30.f, 1.f);
+    }
+
+    /// @brief vec4 at a 4 byte offset inside their buffer
+    struct packed_points
+    {
+        packed_points()
+        : storage(transform_count * sizeof(cml::vec4) + sizeof(float))
+        {
+            const std::vector<cml::vec4> points = make_points<cml::vec4>();
+            std::memcpy(storage.data() + sizeof(float), points.data(), points.size() * sizeof(cml::vec4));
+        }
+
+        cml::vec4* data() { return reinterpret_cast<cml::vec4*>(storage.data() + sizeof(float)); }
+
+        std::vector<unsigned char> storage;
+    };
+}
+
+CML_BENCHMARK(transform_vec4_4096)
+{
+    std::vector<cml::vec4> points = make_points<cml::vec4>();
+    cml::mat4 m = make_transform<cml::mat4>();
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(m);
+        for (cml::vec4& p : points)
+            p = p * m;
+        bench::do_not_optimize(points);
+    }
+}
+
+CML_BENCHMARK(transform_vec4_packed_4096)
+{
+    packed_points points;
+    cml::mat4 m = make_transform<cml::mat4>();
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(m);
+        cml::vec4* p = points.data();
+        for (size_t i = 0; i < transform_count; ++i)
+            p[i] = p[i] * m;
+        bench::do_not_optimize(points.storage);
+    }
+}
+
+CML_BENCHMARK(transform_avec4_4096)
+{
+    std::vector<cml::avec4> points = make_points<cml::avec4>();
+    cml::amat4 m = make_transform<cml::amat4>();
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(m);
+        for (cml::avec4& p : points)
+            p = p * m;
+        bench::do_not_optimize(points);
+    }
+}
+
+CML_BENCHMARK(concat_mat4_4096)
+{
+    std::vector<cml::mat4> transforms(transform_count, make_transform<cml::mat4>());
+    cml::mat4 m = make_transform<cml::mat4>();
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(m);
+        for (cml::mat4& t : transforms)
+            t = t * m;
+        bench::do_not_optimize(transforms);
+    }
+}
+
+CML_BENCHMARK(concat_amat4_4096)
+{
+    std::vector<cml::amat4> transforms(transform_count, make_transform<cml::amat4>());
+    cml::amat4 m = make_transform<cml::amat4>();
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(m);
+        for (cml::amat4& t : transforms)
+            t = t * m;
+        bench::do_not_optimize(transforms);
+    }
+}
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Minimal benchmark harness, loosely modeled after google benchmark:
+//
+//  CML_BENCHMARK(my_benchmark)
+//  {
+//      setup();
+//      while (state.keep_running())
+//          bench::do_not_optimize(work());
+//  }
+//
+// Families of benchmarks can also be registered at runtime with bench::latency and bench::throughput (see below).
+namespace bench
+{
+    using clock = std::chrono::steady_clock;
+
+    /// @brief Force the compiler to consider the value as used (and its memory as possibly modified)
+    template<typename T>
+    inline void do_not_optimize(T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : "+m"(value) : : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    template<typename T>
+    inline void do_not_optimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    /// @brief Hide the value of an operand from the optimizer without flushing everything else to memory.
+    /// Used on the constant side of a dependency chain so `v = v + w` can't be folded into `v + n*w`.
+    template<typename T>
+    inline void opaque(T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : "+m"(value));
+#else
+        do_not_optimize(value);
+#endif
+    }
+
+    class state
+    {
+    public:
+        explicit state(std::size_t iterations) noexcept
+        : m_iterations(iterations), m_remaining(iterations)
+        {
+        }
+
+        /// @brief Return true while the benchmark has to run another iteration. The timer starts on the first call.
+        bool keep_running() noexcept
+        {
+            if (!m_started)
+            {
+                m_started = true;
+                m_start = clock::now();
+            }
+            if (m_remaining == 0)
+            {
+                m_end = clock::now();
+                return false;
+            }
+            --m_remaining;
+            return true;
+        }
+
+        /// @brief Number of operations done by one iteration, used to report the time per item
+        void set_items_per_iteration(std::size_t items) noexcept { m_items = items; }
+
+        std::size_t iterations() const noexcept { return m_iterations; }
+        std::size_t items_per_iteration() const noexcept { return m_items; }
+        double elapsed_ns() const noexcept { return std::chrono::duration<double, std::nano>(m_end - m_start).count(); }
+
+    private:
+        std::size_t m_iterations;
+        std::size_t m_remaining;
+        std::size_t m_items = 1;
+        bool m_started = false;
+        clock::time_point m_start;
+        clock::time_point m_end;
+    };
+
+    using function = std::function<void(state&)>;
+
+    struct benchmark
+    {
+        std::string name;
+        function run;
+    };
+
+    inline std::vector<benchmark>& registry()
+    {
+        static std::vector<benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    inline bool register_benchmark(std::string name, function run)
+    {
+        registry().push_back({std::move(name), std::move(run)});
+        return true;
+    }
+
+    /// @brief Length of the dependency chain run by one latency iteration
+    constexpr std::size_t latency_chain = 64;
+
+    /// @brief Number of independent inputs processed by one throughput iteration (small enough to stay in L1/L2)
+    constexpr std::size_t throughput_batch = 256;
+
+    /// @brief Return seed, through a load whose address depends on previous: the chain of the next latency iteration
+    /// can't start before the previous one is done, while still restarting from seed.
+    template<typename T>
+    inline T chain_after(const T& seed, const T& previous)
+    {
+        unsigned char byte;
+        std::memcpy(&byte, &previous, 1);
+        std::size_t zero = 0;
+        opaque(zero);
+        return (&seed)[byte & zero];
+    }
+
+    /// @brief Register `<name>/latency`: every call consumes the result of the previous one, so the time per item is
+    /// the latency of op. The chain restarts from seed on every iteration so it can't drift to inf, nan or denormals.
+    template<typename T, typename Op>
+    bool latency(const std::string& name, T seed, Op op)
+    {
+        return register_benchmark(name + "/latency", [seed, op](state& s)
+        {
+            s.set_items_per_iteration(latency_chain);
+            T value = seed;
+            while (s.keep_running())
+            {
+                value = chain_after(seed, value);
+                for (std::size_t i = 0; i < latency_chain; ++i)
+                    value = op(value);
+                do_not_optimize(value);
+            }
+        });
+    }
+
+    /// @brief Same as above for a binary op(value, operand), the operand is hidden from the optimizer at every step
+    template<typename T, typename U, typename Op>
+    bool latency(const std::string& name, T seed, U operand, Op op)
+    {
+        return register_benchmark(name + "/latency", [seed, operand, op](state& s)
+        {
+            s.set_items_per_iteration(latency_chain);
+            U w = operand;
+            T value = seed;
+            while (s.keep_running())
+            {
+                value = chain_after(seed, value);
+                for (std::size_t i = 0; i < latency_chain; ++i)
+                {
+                    opaque(w);
+                    value = op(value, w);
+                }
+                do_not_optimize(value);
+            }
+        });
+    }
+
+    /// @brief Register `<name>/throughput`: op is applied to throughput_batch independent inputs built by make(i), the
+    /// time per item is the reciprocal throughput of op.
+    template<typename Make, typename Op>
+    bool throughput(const std::string& name, Make make, Op op)
+    {
+        using input_type = decltype(make(std::size_t{}));
+        using result_type = decltype(op(std::declval<const input_type&>()));
+        // avoid the std::vector<bool> bitset
+        using output_type = std::conditional_t<std::is_same<result_type, bool>::value, unsigned char, result_type>;
+
+        return register_benchmark(name + "/throughput", [make, op](state& s)
+        {
+            std::vector<input_type> in;
+            in.reserve(throughput_batch);
+            for (std::size_t i = 0; i < throughput_batch; ++i)
+                in.push_back(make(i));
+            std::vector<output_type> out(throughput_batch);
+
+            s.set_items_per_iteration(throughput_batch);
+            while (s.keep_running())
+            {
+                do_not_optimize(in);
+                for (std::size_t i = 0; i < throughput_batch; ++i)
+                    out[i] = op(in[i]);
+                do_not_optimize(out);
+            }
+        });
+    }
+} // namespace bench
+
+#define CML_BENCHMARK(NAME) \
+    static void NAME(::bench::state& state); \
+    static const bool NAME##_registered = ::bench::register_benchmark(#NAME, NAME); \
+    static void NAME(::bench::state& state)
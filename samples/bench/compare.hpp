@@ -0,0 +1,226 @@
+#pragma once
+
+#include "bench.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+
+#include <cml/cml.hpp>
+
+// Helpers registering a cml operation next to a reference implementation (the std:: function or a hand written
+// struct of plain scalars) as `<op>/<type>/<impl>/<latency|throughput>`.
+namespace bench
+{
+    namespace naive
+    {
+        template<std::size_t N, typename V>
+        struct vec
+        {
+            V v[N];
+        };
+
+        template<typename V>
+        struct mat4
+        {
+            V m[16];
+        };
+
+        template<typename T>
+        inline T from(const T& value)
+        {
+            return value;
+        }
+
+        template<std::size_t N, typename V, cml::implementation::matrix_kind K>
+        inline vec<N, V> from(const cml::implementation::matrix<N, 1, V, K>& value)
+        {
+            vec<N, V> r;
+            for (std::size_t i = 0; i < N; ++i)
+                r.v[i] = value.components[i];
+            return r;
+        }
+
+        template<typename V, cml::implementation::matrix_kind K>
+        inline mat4<V> from(const cml::implementation::matrix<4, 4, V, K>& value)
+        {
+            mat4<V> r;
+            for (std::size_t i = 0; i < 16; ++i)
+                r.m[i] = value.components[i];
+            return r;
+        }
+
+        template<std::size_t N, typename V>
+        inline vec<N, V> operator+(const vec<N, V>& a, const vec<N, V>& b)
+        {
+            vec<N, V> r;
+            for (std::size_t i = 0; i < N; ++i)
+                r.v[i] = a.v[i] + b.v[i];
+            return r;
+        }
+
+        template<std::size_t N, typename V>
+        inline vec<N, V> operator-(const vec<N, V>& a, const vec<N, V>& b)
+        {
+            vec<N, V> r;
+            for (std::size_t i = 0; i < N; ++i)
+                r.v[i] = a.v[i] - b.v[i];
+            return r;
+        }
+
+        template<std::size_t N, typename V>
+        inline vec<N, V> operator*(const vec<N, V>& a, const V& s)
+        {
+            vec<N, V> r;
+            for (std::size_t i = 0; i < N; ++i)
+                r.v[i] = a.v[i] * s;
+            return r;
+        }
+
+        template<std::size_t N, typename V>
+        inline vec<N, V> operator/(const vec<N, V>& a, const V& s)
+        {
+            vec<N, V> r;
+            for (std::size_t i = 0; i < N; ++i)
+                r.v[i] = a.v[i] / s;
+            return r;
+        }
+
+        template<std::size_t N, typename V>
+        inline bool operator==(const vec<N, V>& a, const vec<N, V>& b)
+        {
+            for (std::size_t i = 0; i < N; ++i)
+                if (!(a.v[i] == b.v[i]))
+                    return false;
+            return true;
+        }
+
+        template<typename V>
+        inline vec<4, V> operator*(const vec<4, V>& a, const mat4<V>& b)
+        {
+            vec<4, V> r;
+            for (std::size_t x = 0; x < 4; ++x)
+            {
+                V sum = a.v[0] * b.m[x];
+                for (std::size_t k = 1; k < 4; ++k)
+                    sum = sum + a.v[k] * b.m[x + k * 4];
+                r.v[x] = sum;
+            }
+            return r;
+        }
+
+        template<typename V>
+        inline mat4<V> operator*(const mat4<V>& a, const mat4<V>& b)
+        {
+            mat4<V> r;
+            for (std::size_t y = 0; y < 4; ++y)
+                for (std::size_t x = 0; x < 4; ++x)
+                {
+                    V sum = a.m[y * 4] * b.m[x];
+                    for (std::size_t k = 1; k < 4; ++k)
+                        sum = sum + a.m[k + y * 4] * b.m[x + k * 4];
+                    r.m[x + y * 4] = sum;
+                }
+            return r;
+        }
+
+        template<typename V>
+        inline mat4<V> transpose(const mat4<V>& a)
+        {
+            mat4<V> r;
+            for (std::size_t y = 0; y < 4; ++y)
+                for (std::size_t x = 0; x < 4; ++x)
+                    r.m[x + y * 4] = a.m[y + x * 4];
+            return r;
+        }
+
+        template<std::size_t N, typename V>
+        inline V dot(const vec<N, V>& a, const vec<N, V>& b)
+        {
+            V sum = a.v[0] * b.v[0];
+            for (std::size_t i = 1; i < N; ++i)
+                sum = sum + a.v[i] * b.v[i];
+            return sum;
+        }
+
+        template<typename V>
+        inline vec<3, V> cross(const vec<3, V>& a, const vec<3, V>& b)
+        {
+            return {{a.v[1] * b.v[2] - a.v[2] * b.v[1], a.v[2] * b.v[0] - a.v[0] * b.v[2], a.v[0] * b.v[1] - a.v[1] * b.v[0]}};
+        }
+
+        template<std::size_t N, typename V>
+        inline V length(const vec<N, V>& a)
+        {
+            return std::sqrt(dot(a, a));
+        }
+
+        template<std::size_t N, typename V>
+        inline vec<N, V> normalize(const vec<N, V>& a)
+        {
+            return a / length(a);
+        }
+    }
+
+    template<typename T>
+    struct scalar_of
+    {
+        using type = T;
+    };
+
+    template<std::size_t X, std::size_t Y, typename V, cml::implementation::matrix_kind K>
+    struct scalar_of<cml::implementation::matrix<X, Y, V, K>>
+    {
+        using type = V;
+    };
+
+    /// @brief i-th throughput input: seed slightly shifted so the inputs are not all the same
+    template<typename T>
+    inline T vary(const T& seed, std::size_t index)
+    {
+        using S = typename scalar_of<T>::type;
+        return seed + S(static_cast<float>(index % 64) * (1.f / 1024.f));
+    }
+
+    constexpr unsigned latency_mode = 1;
+    constexpr unsigned throughput_mode = 2;
+    constexpr unsigned both_modes = latency_mode | throughput_mode;
+
+    /// @brief Register cml_op(value) as `<name>/cml` and reference_op(naive::from(value)) as `<name>/<reference>`, in the
+    /// latency and/or throughput Modes
+    template<unsigned Modes = both_modes, typename T, typename CmlOp, typename RefOp>
+    void compare(const std::string& name, const T& seed, CmlOp cml_op, const char* reference, RefOp reference_op)
+    {
+        const auto naive_seed = naive::from(seed);
+        if constexpr((Modes & latency_mode) != 0)
+        {
+            latency(name + "/cml", seed, cml_op);
+            latency(name + "/" + reference, naive_seed, reference_op);
+        }
+        if constexpr((Modes & throughput_mode) != 0)
+        {
+            throughput(name + "/cml", [seed](std::size_t i) { return vary(seed, i); }, cml_op);
+            throughput(name + "/" + reference, [seed](std::size_t i) { return naive::from(vary(seed, i)); }, reference_op);
+        }
+    }
+
+    /// @brief Same as above for binary operations, the second operand stays the same for the whole run
+    template<unsigned Modes = both_modes, typename T, typename U, typename CmlOp, typename RefOp>
+    void compare(const std::string& name, const T& seed, const U& operand, CmlOp cml_op, const char* reference, RefOp reference_op)
+    {
+        const auto naive_seed = naive::from(seed);
+        const auto naive_operand = naive::from(operand);
+        if constexpr((Modes & latency_mode) != 0)
+        {
+            latency(name + "/cml", seed, operand, cml_op);
+            latency(name + "/" + reference, naive_seed, naive_operand, reference_op);
+        }
+        if constexpr((Modes & throughput_mode) != 0)
+        {
+            throughput(name + "/cml", [seed](std::size_t i) { return vary(seed, i); },
+                [cml_op, operand](const T& value) { return cml_op(value, operand); });
+            throughput(name + "/" + reference, [seed](std::size_t i) { return naive::from(vary(seed, i)); },
+                [reference_op, naive_operand](const decltype(naive_seed)& value) { return reference_op(value, naive_operand); });
+        }
+    }
+} // namespace bench
@@ -0,0 +1,143 @@
+#include "bench.hpp"
+#include <cml/cml.hpp>
+#include <numeric>
+#include <vector>
+
+// cml::dynamic_matrix kernels (simd, split between the threads of the global pool for the big ones) against the same
+// loops written by hand on a std::vector
+namespace
+{
+    constexpr size_t vector_size = size_t(1) << 20;
+    constexpr size_t matrix_size = 256;
+    constexpr size_t transpose_size = 2048;
+
+    template<typename Container>
+    void fill(Container& c, size_t count, float scale)
+    {
+        for (size_t i = 0; i < count; ++i)
+            c[i] = float(int(i % 29) - 14) * scale;
+    }
+
+    struct data
+    {
+        data()
+        : a(vector_size), b(vector_size), ma(matrix_size, matrix_size), mb(matrix_size, matrix_size), big(transpose_size, transpose_size),
+          na(vector_size), nb(vector_size), nma(matrix_size * matrix_size), nmb(matrix_size * matrix_size), nbig(transpose_size * transpose_size)
+        {
+            fill(a, vector_size, 0.125f);
+            fill(b, vector_size, 0.25f);
+            fill(ma, ma.size(), 0.125f);
+            fill(mb, mb.size(), 0.25f);
+            fill(big, big.size(), 0.5f);
+            fill(na, vector_size, 0.125f);
+            fill(nb, vector_size, 0.25f);
+            fill(nma, nma.size(), 0.125f);
+            fill(nmb, nmb.size(), 0.25f);
+            fill(nbig, nbig.size(), 0.5f);
+        }
+
+        cml::dynamic_vector<float> a, b;
+        cml::dynamic_matrix<float> ma, mb, big;
+        std::vector<float> na, nb, nma, nmb, nbig;
+    };
+
+    data& shared_data()
+    {
+        static data d;
+        return d;
+    }
+}
+
+CML_BENCHMARK(dynamic_add_1M)
+{
+    data& d = shared_data();
+    while (state.keep_running())
+    {
+        d.a += d.b;
+        bench::do_not_optimize(d.a);
+    }
+}
+
+CML_BENCHMARK(dynamic_add_1M_naive)
+{
+    data& d = shared_data();
+    while (state.keep_running())
+    {
+        for (size_t i = 0; i < vector_size; ++i)
+            d.na[i] += d.nb[i];
+        bench::do_not_optimize(d.na);
+    }
+}
+
+CML_BENCHMARK(dynamic_dot_1M)
+{
+    data& d = shared_data();
+    while (state.keep_running())
+    {
+        float r = cml::dot(d.a, d.b);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(dynamic_dot_1M_naive)
+{
+    data& d = shared_data();
+    while (state.keep_running())
+    {
+        float r = std::inner_product(d.na.begin(), d.na.end(), d.nb.begin(), 0.f);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(dynamic_mul_256)
+{
+    data& d = shared_data();
+    while (state.keep_running())
+    {
+        cml::dynamic_matrix<float> r = d.ma * d.mb;
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(dynamic_mul_256_naive)
+{
+    data& d = shared_data();
+    std::vector<float> r(matrix_size * matrix_size);
+    while (state.keep_running())
+    {
+        for (size_t i = 0; i < matrix_size; ++i)
+        {
+            for (size_t j = 0; j < matrix_size; ++j)
+            {
+                float sum = 0.f;
+                for (size_t k = 0; k < matrix_size; ++k)
+                    sum += d.nma[i * matrix_size + k] * d.nmb[k * matrix_size + j];
+                r[i * matrix_size + j] = sum;
+            }
+        }
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(dynamic_transpose_2048)
+{
+    data& d = shared_data();
+    while (state.keep_running())
+    {
+        cml::dynamic_matrix<float> r = cml::transpose(d.big);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(dynamic_transpose_2048_naive)
+{
+    data& d = shared_data();
+    std::vector<float> r(transpose_size * transpose_size);
+    while (state.keep_running())
+    {
+        for (size_t y = 0; y < transpose_size; ++y)
+            for (size_t x = 0; x < transpose_size; ++x)
+                r[y + x * transpose_size] = d.nbig[x + y * transpose_size];
+        bench::do_not_optimize(r);
+    }
+}
@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "bench.hpp"
+#include <cml/cml.hpp>
+#include <cmath>
+#include <vector>
+
+// sin, cos, atan2, exp and log on 1024 values: the integer only fixed point kernels against cml on float
+namespace
+{
+    template<typename T>
+    std::vector<T> make_values(float scale, float offset)
+    {
+        std::vector<T> values(1024);
+        for (size_t i = 0; i < values.size(); ++i)
+            values[i] = T(static_cast<float>(i) * scale + offset);
+        return values;
+    }
+
+    template<typename T>
+    void run_sincos(bench::state& state)
+    {
+        const std::vector<cml::implementation::radian<T>> angles = make_values<cml::implementation::radian<T>>(0.37f, -150.f);
+        std::vector<T> s(angles.size());
+        std::vector<T> c(angles.size());
+        while (state.keep_running())
+        {
+            for (size_t i = 0; i < angles.size(); ++i)
+            {
+                const cml::vector<2, T> sc = cml::sincos(angles[i]);
+                s[i] = sc.x;
+                c[i] = sc.y;
+            }
+            bench::do_not_optimize(s);
+            bench::do_not_optimize(c);
+        }
+    }
+
+    template<typename T>
+    void run_atan2(bench::state& state)
+    {
+        const std::vector<T> x = make_values<T>(0.011f, -5.f);
+        const std::vector<T> y = make_values<T>(-0.007f, 3.f);
+        std::vector<T> r(x.size());
+        while (state.keep_running())
+        {
+            for (size_t i = 0; i < x.size(); ++i)
+                r[i] = cml::atan2(x[i], y[i]);
+            bench::do_not_optimize(r);
+        }
+    }
+
+    template<typename T>
+    void run_exp(bench::state& state)
+    {
+        const std::vector<T> v = make_values<T>(0.0078f, -4.f);
+        std::vector<T> r(v.size());
+        while (state.keep_running())
+        {
+            for (size_t i = 0; i < v.size(); ++i)
+                r[i] = cml::exp(v[i]);
+            bench::do_not_optimize(r);
+        }
+    }
+
+    template<typename T>
+    void run_log(bench::state& state)
+    {
+        const std::vector<T> v = make_values<T>(0.97f, 0.01f);
+        std::vector<T> r(v.size());
+        while (state.keep_running())
+        {
+            for (size_t i = 0; i < v.size(); ++i)
+                r[i] = cml::log(v[i]);
+            bench::do_not_optimize(r);
+        }
+    }
+}
+
+CML_BENCHMARK(sincos_f1616_1024) { run_sincos<cml::f1616>(state); }
+CML_BENCHMARK(atan2_f1616_1024) { run_atan2<cml::f1616>(state); }
+CML_BENCHMARK(atan2_float_1024) { run_atan2<float>(state); }
+CML_BENCHMARK(exp_f1616_1024) { run_exp<cml::f1616>(state); }
+CML_BENCHMARK(exp_float_1024) { run_exp<float>(state); }
+CML_BENCHMARK(log_f1616_1024) { run_log<cml::f1616>(state); }
+CML_BENCHMARK(log_float_1024) { run_log<float>(state); }
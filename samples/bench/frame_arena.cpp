@@ -0,0 +1,81 @@
+#include "bench.hpp"
+#include <cml/cml.hpp>
+#include <vector>
+
+// Per frame scratch buffers (positions, matrices, rotations and a dynamic matrix) taken from std::vector / the heap
+// against the same buffers taken from a cml::frame_arena that is rewound at the end of the frame
+namespace
+{
+    constexpr size_t point_count = 4096;
+    constexpr size_t bone_count = 256;
+
+    const cml::mat4 world(0.5f, 0.f, 0.1f, 0.f, 0.f, 1.f, 0.f, 0.f, -0.1f, 0.f, 0.5f, 0.f, 10.f, 20.f, 30.f, 1.f);
+
+    template<typename Points, typename Matrices, typename Rotations>
+    float frame(Points& points, Matrices& bones, Rotations& rotations)
+    {
+        for (size_t i = 0; i < points.size(); ++i)
+            points[i] = cml::vec3(float(i % 13), float(i % 7), 1.f);
+        for (size_t i = 0; i < bones.size(); ++i)
+        {
+            rotations[i] = cml::quat(0.f, 0.f, 0.f, 1.f);
+            bones[i] = world;
+        }
+        cml::transform_points(world, cml::span<cml::vec3>(points.data(), points.size()), cml::span<cml::vec3>(points.data(), points.size()));
+        return points[points.size() - 1].x + bones[bones.size() - 1].components[12] + rotations[0].w;
+    }
+}
+
+CML_BENCHMARK(frame_scratch_heap)
+{
+    while (state.keep_running())
+    {
+        std::vector<cml::vec3> points(point_count);
+        std::vector<cml::mat4> bones(bone_count);
+        std::vector<cml::quat> rotations(bone_count);
+        cml::dynamic_matrix<float> jacobian(64, 64);
+        float r = frame(points, bones, rotations) + jacobian[0];
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(frame_scratch_arena)
+{
+    cml::frame_arena& arena = cml::frame_arena::local();
+    while (state.keep_running())
+    {
+        cml::frame_arena::scope scope(arena);
+        cml::span<cml::vec3> points = arena.allocate_span<cml::vec3>(point_count);
+        cml::span<cml::mat4> bones = arena.allocate_span<cml::mat4>(bone_count);
+        cml::span<cml::quat> rotations = arena.allocate_span<cml::quat>(bone_count);
+        cml::dynamic_matrix<float, cml::arena_allocator<float>> jacobian(64, 64);
+        float r = frame(points, bones, rotations) + jacobian[0];
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(frame_allocations_heap)
+{
+    while (state.keep_running())
+    {
+        for (size_t i = 0; i < 64; ++i)
+        {
+            std::vector<cml::vec4> scratch(16);
+            bench::do_not_optimize(scratch);
+        }
+    }
+}
+
+CML_BENCHMARK(frame_allocations_arena)
+{
+    cml::frame_arena& arena = cml::frame_arena::local();
+    while (state.keep_running())
+    {
+        cml::frame_arena::scope scope(arena);
+        for (size_t i = 0; i < 64; ++i)
+        {
+            std::vector<cml::vec4, cml::arena_allocator<cml::vec4>> scratch(16);
+            bench::do_not_optimize(scratch);
+        }
+    }
+}
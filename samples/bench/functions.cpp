@@ -0,0 +1,51 @@
+#include "compare.hpp"
+
+// dot, cross, length, normalize and transpose, against the same functions written by hand on plain structs
+namespace
+{
+    template<typename V>
+    bool register_vector_functions(const std::string& type)
+    {
+        using vec3 = cml::vector<3, V>;
+        using mat4 = cml::matrix<4, 4, V>;
+        using nvec3 = bench::naive::vec<3, V>;
+        using nmat4 = bench::naive::mat4<V>;
+
+        const vec3 a{V(1.25f), V(-0.5f), V(2.f)};
+        // unit length and not colinear with a: chained cross products rotate around it without growing
+        const vec3 axis{V(0.f), V(0.6f), V(0.8f)};
+        mat4 m;
+        for (std::size_t i = 0; i < 16; ++i)
+            m.components[i] = V(static_cast<float>(i) * 0.25f);
+
+        // dot and length return a scalar, there is no chain to measure a latency on
+        bench::compare<bench::throughput_mode>("dot/vec3/" + type, a, axis,
+            [](const vec3& x, const vec3& y) { return cml::dot(x, y); },
+            "naive", [](const nvec3& x, const nvec3& y) { return bench::naive::dot(x, y); });
+        bench::compare("cross/vec3/" + type, a, axis,
+            [](const vec3& x, const vec3& y) { return cml::cross(x, y); },
+            "naive", [](const nvec3& x, const nvec3& y) { return bench::naive::cross(x, y); });
+        // transpose(transpose(m)) folds away, only the throughput is meaningful
+        bench::compare<bench::throughput_mode>("transpose/mat4/" + type, m,
+            [](const mat4& x) { return cml::transpose(x); },
+            "naive", [](const nmat4& x) { return bench::naive::transpose(x); });
+
+        // cml::sqrt does not converge on fixed point types yet
+        if constexpr(std::is_floating_point<V>::value)
+        {
+            bench::compare<bench::throughput_mode>("length/vec3/" + type, a,
+                [](const vec3& x) { return cml::length(x); },
+                "naive", [](const nvec3& x) { return bench::naive::length(x); });
+            bench::compare("normalize/vec3/" + type, a,
+                [](const vec3& x) { return cml::normalize(x); },
+                "naive", [](const nvec3& x) { return bench::naive::normalize(x); });
+            bench::compare("normalize_fast/vec3/" + type, a,
+                [](const vec3& x) { return cml::normalize_fast(x); },
+                "naive", [](const nvec3& x) { return bench::naive::normalize(x); });
+        }
+        return true;
+    }
+
+    const bool registered = register_vector_functions<float>("float") && register_vector_functions<double>("double") && register_vector_functions<cml::f1616>("f1616")
+                         && register_vector_functions<cml::f88>("f88") && register_vector_functions<cml::f0824>("f0824");
+}
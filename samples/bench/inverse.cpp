@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "bench.hpp"
+#include <cml/cml.hpp>
+
+namespace
+{
+    constexpr cml::mat4 bench_mat{0.5f, 1.25f, 3.f, 4.1f, 5.3f, 6.7f, 7.f, 0.1f, 9.9f, 10.5f, 1.3f, 2.2f, 13.f, 0.7f, 1.5f, 16.25f};
+    constexpr cml::mat4 bench_affine{0.f, 2.f, 0.f, 0.f, -2.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.5f, 0.f, 3.f, -4.f, 5.f, 1.f};
+}
+
+CML_BENCHMARK(mat4_determinant)
+{
+    cml::mat4 m = bench_mat;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(m);
+        float r = cml::determinant(m);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(mat4_inverse_cofactor)
+{
+    cml::mat4 m = bench_mat;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(m);
+        auto r = cml::implementation::inverse_mat4(m);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(mat4_inverse)
+{
+    cml::mat4 m = bench_mat;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(m);
+        auto r = cml::inverse(m);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(amat4_inverse)
+{
+    cml::amat4 m = bench_mat.unsafe_cast<float, cml::implementation::matrix_kind::aligned>();
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(m);
+        auto r = cml::inverse(m);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(mat4_inverse_affine)
+{
+    cml::mat4 m = bench_affine;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(m);
+        auto r = cml::inverse_affine(m);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(dmat4_inverse)
+{
+    cml::dmat4 m = bench_mat.unsafe_cast<double>();
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(m);
+        auto r = cml::inverse(m);
+        bench::do_not_optimize(r);
+    }
+}
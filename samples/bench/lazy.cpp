@@ -0,0 +1,117 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "bench.hpp"
+#include <cml/cml.hpp>
+#include <vector>
+
+// a + b * s - c * t, eager (one temporary per operator) against lazy (one fused pass)
+namespace
+{
+    template<typename VecType>
+    VecType make_vector(float offset)
+    {
+        VecType ret;
+        for (size_t i = 0; i < ret.components.size(); ++i)
+            ret.components[i] = typename VecType::value_type(float(i % 16) * 0.25f + offset);
+        return ret;
+    }
+
+    using vec64 = cml::vector<64, float>;
+    using f1616vec16 = cml::vector<16, cml::f1616>;
+}
+
+CML_BENCHMARK(eager_vec64_chain)
+{
+    const vec64 a = make_vector<vec64>(1.f);
+    const vec64 b = make_vector<vec64>(2.f);
+    const vec64 c = make_vector<vec64>(3.f);
+    float s = 0.5f;
+    float t = 0.25f;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(s);
+        bench::do_not_optimize(t);
+        vec64 r = a + b * float(s) - c * float(t);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(lazy_vec64_chain)
+{
+    const vec64 a = make_vector<vec64>(1.f);
+    const vec64 b = make_vector<vec64>(2.f);
+    const vec64 c = make_vector<vec64>(3.f);
+    float s = 0.5f;
+    float t = 0.25f;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(s);
+        bench::do_not_optimize(t);
+        vec64 r = cml::lazy(a) + cml::lazy(b) * s - cml::lazy(c) * t;
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(eager_f1616vec16_chain)
+{
+    const f1616vec16 a = make_vector<f1616vec16>(1.f);
+    const f1616vec16 b = make_vector<f1616vec16>(2.f);
+    const f1616vec16 c = make_vector<f1616vec16>(3.f);
+    cml::f1616 s(0.5f);
+    cml::f1616 t(0.25f);
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(s);
+        bench::do_not_optimize(t);
+        f1616vec16 r = a + b * cml::f1616(s) - c * cml::f1616(t);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(lazy_f1616vec16_chain)
+{
+    const f1616vec16 a = make_vector<f1616vec16>(1.f);
+    const f1616vec16 b = make_vector<f1616vec16>(2.f);
+    const f1616vec16 c = make_vector<f1616vec16>(3.f);
+    cml::f1616 s(0.5f);
+    cml::f1616 t(0.25f);
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(s);
+        bench::do_not_optimize(t);
+        f1616vec16 r = cml::lazy(a) + cml::lazy(b) * s - cml::lazy(c) * t;
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(lazy_soa_vec3_add_scaled_100k)
+{
+    cml::soa_array<cml::vec3> p(100000, cml::vec3(1, 2, 3));
+    const cml::soa_array<cml::vec3> v(100000, cml::vec3(0.5f, -1, 2));
+    while (state.keep_running())
+    {
+        p += cml::lazy(v) * 0.016f;
+        bench::do_not_optimize(p);
+    }
+}
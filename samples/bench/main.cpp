@@ -0,0 +1,121 @@
+#include "bench.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    enum class format
+    {
+        console,
+        csv,
+        json,
+    };
+
+    struct result
+    {
+        const bench::benchmark* benchmark;
+        std::size_t iterations;
+        double ns_per_iteration;
+        double ns_per_item;
+    };
+
+    result run(const bench::benchmark& b, double min_time_ns)
+    {
+        // grow the iteration count until the run is long enough to be meaningful
+        std::size_t iterations = 1;
+        for (;;)
+        {
+            bench::state state(iterations);
+            b.run(state);
+            if (state.elapsed_ns() >= min_time_ns || iterations >= (std::size_t(1) << 40))
+            {
+                const double ns_per_iteration = state.elapsed_ns() / static_cast<double>(iterations);
+                return {&b, iterations, ns_per_iteration, ns_per_iteration / static_cast<double>(state.items_per_iteration())};
+            }
+            const double ratio = state.elapsed_ns() > 0.0 ? min_time_ns * 1.2 / state.elapsed_ns() : 100.0;
+            iterations = static_cast<std::size_t>(static_cast<double>(iterations) * (ratio > 100.0 ? 100.0 : (ratio < 2.0 ? 2.0 : ratio)));
+        }
+    }
+
+    void print_header(format f)
+    {
+        switch (f)
+        {
+        case format::console: std::printf("%-48s %14s %14s %14s\n", "benchmark", "iterations", "ns/iter", "ns/item"); break;
+        case format::csv: std::printf("name,iterations,ns_per_iteration,ns_per_item,items_per_second\n"); break;
+        case format::json: std::printf("{\n  \"benchmarks\": ["); break;
+        }
+    }
+
+    void print_result(format f, const result& r, bool first)
+    {
+        const char* name = r.benchmark->name.c_str();
+        const double items_per_second = r.ns_per_item > 0.0 ? 1e9 / r.ns_per_item : 0.0;
+        switch (f)
+        {
+        case format::console:
+            std::printf("%-48s %14zu %14.3f %14.3f\n", name, r.iterations, r.ns_per_iteration, r.ns_per_item);
+            break;
+        case format::csv:
+            std::printf("%s,%zu,%.4f,%.4f,%.1f\n", name, r.iterations, r.ns_per_iteration, r.ns_per_item, items_per_second);
+            break;
+        case format::json:
+            std::printf("%s\n    {\"name\": \"%s\", \"iterations\": %zu, \"ns_per_iteration\": %.4f, \"ns_per_item\": %.4f, \"items_per_second\": %.1f}",
+                first ? "" : ",", name, r.iterations, r.ns_per_iteration, r.ns_per_item, items_per_second);
+            break;
+        }
+        std::fflush(stdout);
+    }
+
+    void print_footer(format f)
+    {
+        if (f == format::json)
+            std::printf("\n  ]\n}\n");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // usage: cml-bench [--format=console|csv|json] [--min-time=<ms>] [filter]
+    // only the benchmarks whose name contains filter are run
+    const char* filter = "";
+    format output = format::console;
+    double min_time_ns = 2e8;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], "--format=", 9) == 0)
+        {
+            const char* value = argv[i] + 9;
+            if (std::strcmp(value, "json") == 0)
+                output = format::json;
+            else if (std::strcmp(value, "csv") == 0)
+                output = format::csv;
+            else if (std::strcmp(value, "console") == 0)
+                output = format::console;
+            else
+            {
+                std::fprintf(stderr, "unknown format '%s'\n", value);
+                return 1;
+            }
+        }
+        else if (std::strncmp(argv[i], "--min-time=", 11) == 0)
+            min_time_ns = std::atof(argv[i] + 11) * 1e6;
+        else
+            filter = argv[i];
+    }
+
+    print_header(output);
+    bool first = true;
+    for (const bench::benchmark& b : bench::registry())
+    {
+        if (b.name.find(filter) == std::string::npos)
+            continue;
+        print_result(output, run(b, min_time_ns), first);
+        first = false;
+    }
+    print_footer(output);
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "compare.hpp"
+
+// Scalar functions against their std:: counterpart. Latency chains that would diverge (exp, log) carry one extra
+// cheap operation, the same on both sides.
+namespace
+{
+    template<typename V>
+    bool register_math(const std::string& type)
+    {
+        bench::compare("sin/" + type, V(0.5),
+            [](V x) { return cml::sin(cml::radian<V>(x)); },
+            "std", [](V x) { return std::sin(x); });
+        bench::compare("cos/" + type, V(0.5),
+            [](V x) { return cml::cos(cml::radian<V>(x)); },
+            "std", [](V x) { return std::cos(x); });
+        bench::compare("tan/" + type, V(0.5),
+            [](V x) { return cml::tan(cml::radian<V>(x)); },
+            "std", [](V x) { return std::tan(x); });
+        bench::compare("exp/" + type, V(0.5),
+            [](V x) { return cml::exp(-x); },
+            "std", [](V x) { return std::exp(-x); });
+        bench::compare("log/" + type, V(3),
+            [](V x) { return cml::log(x) + V(2); },
+            "std", [](V x) { return std::log(x) + V(2); });
+        bench::compare("exp2/" + type, V(0.5),
+            [](V x) { return cml::exp2(-x); },
+            "std", [](V x) { return std::exp2(-x); });
+        bench::compare("expm1/" + type, V(0.5),
+            [](V x) { return cml::expm1(-x); },
+            "std", [](V x) { return std::expm1(-x); });
+        bench::compare("log2/" + type, V(3),
+            [](V x) { return cml::log2(x) + V(2); },
+            "std", [](V x) { return std::log2(x) + V(2); });
+        bench::compare("log1p/" + type, V(3),
+            [](V x) { return cml::log1p(x) + V(1); },
+            "std", [](V x) { return std::log1p(x) + V(1); });
+        bench::compare("tanh/" + type, V(0.5),
+            [](V x) { return cml::tanh(x); },
+            "std", [](V x) { return std::tanh(x); });
+        bench::compare("sqrt/" + type, V(2),
+            [](V x) { return cml::sqrt(x); },
+            "std", [](V x) { return std::sqrt(x); });
+        bench::compare("rsqrt/" + type, V(2),
+            [](V x) { return cml::rsqrt(x); },
+            "std", [](V x) { return V(1) / std::sqrt(x); });
+        // 1^3 stays 1, which the optimizer can't know
+        bench::compare("pow/" + type, V(1),
+            [](V x) { return cml::pow(x, 3u); },
+            "std", [](V x) { return std::pow(x, V(3)); });
+        bench::compare("pow_unrolled/" + type, V(1),
+            [](V x) { return cml::pow<3>(x); },
+            "std", [](V x) { return std::pow(x, V(3)); });
+        bench::compare("pow_int/" + type, V(1),
+            [](V x) { return cml::pow(x, 1000); },
+            "std", [](V x) { return std::pow(x, 1000); });
+        // x^0.75 converges to 1
+        bench::compare("pow_real/" + type, V(1.5),
+            [](V x) { return cml::pow(x, V(0.75)); },
+            "std", [](V x) { return std::pow(x, V(0.75)); });
+        return true;
+    }
+
+    // fixed point pow and rsqrt, compared against the std functions going through float (the fixed point trigonometry,
+    // exp and log are measured in fixed_functions.cpp)
+    bool register_fixed_math()
+    {
+        using V = cml::f1616;
+        bench::compare("pow/f1616", V(1.f),
+            [](V x) { return cml::pow(x, 3u); },
+            "std_float", [](V x) { return V(std::pow(static_cast<float>(x), 3.f)); });
+        bench::compare("pow_real/f1616", V(1.5f),
+            [](V x) { return cml::pow(x, V(0.75f)); },
+            "std_float", [](V x) { return V(std::pow(static_cast<float>(x), 0.75f)); });
+        bench::compare("rsqrt/f1616", V(2),
+            [](V x) { return cml::rsqrt(x); },
+            "std_float", [](V x) { return V(1.f / std::sqrt(static_cast<float>(x))); });
+        return true;
+    }
+
+    const bool registered = register_math<float>("float") && register_math<double>("double") && register_fixed_math();
+}
@@ -0,0 +1,189 @@
+#include "bench.hpp"
+
+#include <cml/cml.hpp>
+
+#include <array>
+#include <utility>
+
+namespace
+{
+    constexpr cml::mat4 bench_mat_a{0.5f, 1.25f, 3.f, 4.1f, 5.3f, 6.7f, 7.f, 0.1f, 9.9f, 10.5f, 1.3f, 2.2f, 13.f, 0.7f, 1.5f, 16.25f};
+    constexpr cml::mat4 bench_mat_b{1.1f, 2.f, 0.3f, 4.f, 0.25f, 6.f, 7.5f, 8.f, 3.3f, 1.f, 11.f, 12.1f, 0.7f, 14.f, 2.5f, 1.6f};
+
+    // the scalar fold expression path, as used by constexpr evaluation
+    template<typename M1, typename M2>
+    auto fold_mul(const M1& a, const M2& b)
+    {
+        using namespace cml::implementation;
+        return matrix_mm_mul(std::make_index_sequence<cml::matrix_traits<M2>::dimx * cml::matrix_traits<M1>::dimy>{}, a, b);
+    }
+
+    std::array<cml::vec4, 1024> make_vectors()
+    {
+        std::array<cml::vec4, 1024> ret;
+        for (size_t i = 0; i < ret.size(); ++i)
+            ret[i] = cml::vec4(float(i), float(i) * 0.5f, 1.f - float(i), 1.f);
+        return ret;
+    }
+}
+
+CML_BENCHMARK(mat4_mul_fold)
+{
+    cml::mat4 a = bench_mat_a;
+    cml::mat4 b = bench_mat_b;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(a);
+        bench::do_not_optimize(b);
+        auto r = fold_mul(a, b);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(mat4_mul)
+{
+    cml::mat4 a = bench_mat_a;
+    cml::mat4 b = bench_mat_b;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(a);
+        bench::do_not_optimize(b);
+        auto r = a * b;
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(vec4_mat4_mul_fold)
+{
+    cml::vec4 v{1.5f, 2.25f, 3.1f, 0.4f};
+    cml::mat4 m = bench_mat_b;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(v);
+        bench::do_not_optimize(m);
+        auto r = fold_mul(v, m);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(vec4_mat4_mul)
+{
+    cml::vec4 v{1.5f, 2.25f, 3.1f, 0.4f};
+    cml::mat4 m = bench_mat_b;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(v);
+        bench::do_not_optimize(m);
+        auto r = v * m;
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(vec4_mat4_mul_fold_1024)
+{
+    const auto in = make_vectors();
+    std::array<cml::vec4, 1024> out;
+    cml::mat4 m = bench_mat_b;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(m);
+        for (size_t i = 0; i < in.size(); ++i)
+            out[i] = fold_mul(in[i], m);
+        bench::do_not_optimize(out);
+    }
+}
+
+CML_BENCHMARK(vec4_mat4_mul_1024)
+{
+    const auto in = make_vectors();
+    std::array<cml::vec4, 1024> out;
+    cml::mat4 m = bench_mat_b;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(m);
+        for (size_t i = 0; i < in.size(); ++i)
+            out[i] = in[i] * m;
+        bench::do_not_optimize(out);
+    }
+}
+
+// Products of big matrices: the cache blocked loops of matrix_mm_mul_blocked against the folds (16x16, the folds take
+// minutes to compile at 64x64) and against the plain i, j, k loops
+namespace
+{
+    template<typename MType>
+    MType make_big_matrix(float scale)
+    {
+        MType ret;
+        for (size_t i = 0; i < ret.components.size(); ++i)
+            ret.components[i] = float(int(i % 29) - 14) * scale;
+        return ret;
+    }
+
+    template<size_t DimX1, size_t DimY1, size_t DimX2>
+    cml::matrix<DimX2, DimY1, float> naive_mul(const cml::matrix<DimX1, DimY1, float>& a, const cml::matrix<DimX2, DimX1, float>& b)
+    {
+        cml::matrix<DimX2, DimY1, float> ret;
+        for (size_t i = 0; i < DimY1; ++i)
+        {
+            for (size_t j = 0; j < DimX2; ++j)
+            {
+                float sum = 0.f;
+                for (size_t k = 0; k < DimX1; ++k)
+                    sum += a.components[i * DimX1 + k] * b.components[k * DimX2 + j];
+                ret.components[i * DimX2 + j] = sum;
+            }
+        }
+        return ret;
+    }
+
+    template<typename M1, typename M2, typename Mul>
+    void run_big_mul(bench::state& state, Mul mul)
+    {
+        static M1 a = make_big_matrix<M1>(0.125f);
+        static M2 b = make_big_matrix<M2>(0.25f);
+        static cml::matrix<cml::matrix_traits<M2>::dimx, cml::matrix_traits<M1>::dimy, float> r;
+        while (state.keep_running())
+        {
+            bench::do_not_optimize(a);
+            bench::do_not_optimize(b);
+            r = mul(a, b);
+            bench::do_not_optimize(r);
+        }
+    }
+
+    using mat16x16 = cml::matrix<16, 16, float>;
+    using mat64x64 = cml::matrix<64, 64, float>;
+    using mat32x128 = cml::matrix<32, 128, float>;
+    using mat128x32 = cml::matrix<128, 32, float>;
+}
+
+CML_BENCHMARK(mat16x16_mul_fold)
+{
+    run_big_mul<mat16x16, mat16x16>(state, [](const mat16x16& a, const mat16x16& b) { return fold_mul(a, b); });
+}
+
+CML_BENCHMARK(mat16x16_mul)
+{
+    run_big_mul<mat16x16, mat16x16>(state, [](const mat16x16& a, const mat16x16& b) { return a * b; });
+}
+
+CML_BENCHMARK(mat64x64_mul_naive)
+{
+    run_big_mul<mat64x64, mat64x64>(state, [](const mat64x64& a, const mat64x64& b) { return naive_mul(a, b); });
+}
+
+CML_BENCHMARK(mat64x64_mul)
+{
+    run_big_mul<mat64x64, mat64x64>(state, [](const mat64x64& a, const mat64x64& b) { return a * b; });
+}
+
+CML_BENCHMARK(mat32x128_mat128x32_mul_naive)
+{
+    run_big_mul<mat32x128, mat128x32>(state, [](const mat32x128& a, const mat128x32& b) { return naive_mul(a, b); });
+}
+
+CML_BENCHMARK(mat32x128_mat128x32_mul)
+{
+    run_big_mul<mat32x128, mat128x32>(state, [](const mat32x128& a, const mat128x32& b) { return a * b; });
+}
@@ -0,0 +1,58 @@
+#include "compare.hpp"
+
+// + - * / and == on vectors and matrices, against the same operations written by hand on plain structs
+namespace
+{
+    template<typename V>
+    cml::matrix<4, 4, V> make_mat4(float scale)
+    {
+        // close to identity so chained products stay in range
+        cml::matrix<4, 4, V> m;
+        for (std::size_t i = 0; i < 16; ++i)
+            m.components[i] = V((i % 5 == 0 ? 1.f : 0.f) + scale * static_cast<float>(i % 7) / 7.f);
+        return m;
+    }
+
+    template<typename V>
+    bool register_operators(const std::string& type)
+    {
+        using vec3 = cml::vector<3, V>;
+        using vec4 = cml::vector<4, V>;
+        using mat4 = cml::matrix<4, 4, V>;
+        using nvec3 = bench::naive::vec<3, V>;
+        using nvec4 = bench::naive::vec<4, V>;
+        using nmat4 = bench::naive::mat4<V>;
+
+        const vec3 a{V(1.25f), V(-0.5f), V(2.f)};
+        const vec3 b{V(0.125f), V(0.25f), V(-0.375f)};
+        const vec4 c{V(1.f), V(0.5f), V(-0.25f), V(1.f)};
+        const V s = V(1.0625f);
+
+        bench::compare("add/vec3/" + type, a, b,
+            [](const vec3& x, const vec3& y) { return x + y; },
+            "naive", [](const nvec3& x, const nvec3& y) { return x + y; });
+        bench::compare("sub/vec3/" + type, a, b,
+            [](const vec3& x, const vec3& y) { return x - y; },
+            "naive", [](const nvec3& x, const nvec3& y) { return x - y; });
+        bench::compare("mul/vec3_scalar/" + type, a, s,
+            [](const vec3& x, const V& y) { return x * V(y); },
+            "naive", [](const nvec3& x, const V& y) { return x * y; });
+        bench::compare("div/vec3_scalar/" + type, a, s,
+            [](const vec3& x, const V& y) { return x / V(y); },
+            "naive", [](const nvec3& x, const V& y) { return x / y; });
+        bench::compare("mul/vec4_mat4/" + type, c, make_mat4<V>(0.0625f),
+            [](const vec4& x, const mat4& y) { return x * y; },
+            "naive", [](const nvec4& x, const nmat4& y) { return x * y; });
+        bench::compare("mul/mat4_mat4/" + type, make_mat4<V>(0.125f), make_mat4<V>(0.0625f),
+            [](const mat4& x, const mat4& y) { return x * y; },
+            "naive", [](const nmat4& x, const nmat4& y) { return x * y; });
+        // the result is a bool, so there is no chain to measure a latency on
+        bench::compare<bench::throughput_mode>("eq/vec3/" + type, a, a,
+            [](const vec3& x, const vec3& y) { return x == y; },
+            "naive", [](const nvec3& x, const nvec3& y) { return x == y; });
+        return true;
+    }
+
+    const bool registered = register_operators<float>("float") && register_operators<double>("double") && register_operators<cml::f1616>("f1616")
+                         && register_operators<cml::f88>("f88") && register_operators<cml::f0824>("f0824");
+}
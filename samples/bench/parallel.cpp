@@ -0,0 +1,169 @@
+#include "bench.hpp"
+#include <cml/cml.hpp>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// cml::parallel scaling: the same batches on thread pools of 1 to hardware_concurrency threads, next to a plain loop
+// (`parallel/<op>/serial`) and to the standard parallel algorithms when CML_PARALLEL_STD_EXECUTION is defined.
+namespace
+{
+    constexpr size_t vector_count = size_t(1) << 20;
+    constexpr size_t matrix_count = size_t(1) << 16;
+
+    struct data
+    {
+        data()
+        : normals(vector_count), normalized(vector_count), locals(matrix_count), worlds(matrix_count)
+        {
+            for (size_t i = 0; i < vector_count; ++i)
+                normals[i] = cml::vec3(float(i % 101) - 50.5f, float(i % 7) + 1.f, float(i % 13) * 0.5f);
+            for (size_t i = 0; i < matrix_count; ++i)
+                locals[i] = cml::mat4(1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, float(i % 17), float(i % 5), 1.f, 1.f);
+        }
+
+        std::vector<cml::vec3> normals;
+        std::vector<cml::vec3> normalized;
+        std::vector<cml::mat4> locals;
+        std::vector<cml::mat4> worlds;
+        const cml::mat4 parent = cml::mat4(0.5f, 0.f, 0.1f, 0.f, 0.f, 1.f, 0.f, 0.f, -0.1f, 0.f, 0.5f, 0.f, 10.f, 20.f, 30.f, 1.f);
+    };
+
+    data& shared_data()
+    {
+        static data d;
+        return d;
+    }
+
+    /// @brief Thread pool started when its benchmarks run, not when they are registered
+    struct lazy_pool
+    {
+        explicit lazy_pool(size_t threads) : threads(threads) {}
+
+        cml::parallel::thread_pool& get()
+        {
+            if (!pool)
+                pool = std::make_unique<cml::parallel::thread_pool>(threads);
+            return *pool;
+        }
+
+        size_t threads;
+        std::unique_ptr<cml::parallel::thread_pool> pool;
+    };
+
+    /// @brief Register the three batches (run(0, d) normalizes, run(1, d) composes, run(2, d) sums) under
+    /// parallel/<batch>/<suffix>
+    template<typename Run>
+    void register_batches(const std::string& suffix, Run run)
+    {
+        bench::register_benchmark("parallel/normalize_vec3_1M/" + suffix, [run](bench::state& state)
+        {
+            data& d = shared_data();
+            state.set_items_per_iteration(vector_count);
+            while (state.keep_running())
+            {
+                run(0, d);
+                bench::do_not_optimize(d.normalized);
+            }
+        });
+        bench::register_benchmark("parallel/compose_mat4_64K/" + suffix, [run](bench::state& state)
+        {
+            data& d = shared_data();
+            state.set_items_per_iteration(matrix_count);
+            while (state.keep_running())
+            {
+                run(1, d);
+                bench::do_not_optimize(d.worlds);
+            }
+        });
+        bench::register_benchmark("parallel/sum_length_vec3_1M/" + suffix, [run](bench::state& state)
+        {
+            data& d = shared_data();
+            state.set_items_per_iteration(vector_count);
+            while (state.keep_running())
+                run(2, d);
+        });
+    }
+
+    const auto normalize_op = [](const cml::vec3& v) { return cml::normalize(v); };
+    const auto add_op = [](float a, float b) { return a + b; };
+    const auto length_op = [](const cml::vec3& v) { return cml::length(v); };
+
+    bool register_parallel()
+    {
+        register_batches("serial", [](int op, data& d)
+        {
+            if (op == 0)
+            {
+                for (size_t i = 0; i < vector_count; ++i)
+                    d.normalized[i] = normalize_op(d.normals[i]);
+            }
+            else if (op == 1)
+            {
+                for (size_t i = 0; i < matrix_count; ++i)
+                    d.worlds[i] = d.locals[i] * d.parent;
+            }
+            else
+            {
+                float sum = 0.f;
+                for (size_t i = 0; i < vector_count; ++i)
+                    sum += length_op(d.normals[i]);
+                bench::do_not_optimize(sum);
+            }
+        });
+
+        // 1, 2, 4, ... threads, and all of them
+        const size_t max_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        std::vector<size_t> thread_counts;
+        for (size_t threads = 1; threads < max_threads; threads *= 2)
+            thread_counts.push_back(threads);
+        thread_counts.push_back(max_threads);
+
+        for (size_t threads : thread_counts)
+        {
+            const auto pool = std::make_shared<lazy_pool>(threads);
+            register_batches("threads_" + std::to_string(threads), [pool](int op, data& d)
+            {
+                if (op == 0)
+                {
+                    cml::parallel::transform(pool->get(), cml::span<const cml::vec3>(d.normals), cml::span<cml::vec3>(d.normalized), normalize_op);
+                }
+                else if (op == 1)
+                {
+                    const cml::mat4 parent = d.parent;
+                    cml::parallel::transform(pool->get(), cml::span<const cml::mat4>(d.locals), cml::span<cml::mat4>(d.worlds), [parent](const cml::mat4& m) { return m * parent; });
+                }
+                else
+                {
+                    float sum = cml::parallel::transform_reduce(pool->get(), cml::span<const cml::vec3>(d.normals), 0.f, add_op, length_op);
+                    bench::do_not_optimize(sum);
+                }
+            });
+        }
+
+#ifdef CML_PARALLEL_STD_EXECUTION
+        register_batches("std_execution", [](int op, data& d)
+        {
+            if (op == 0)
+            {
+                cml::parallel::transform(cml::span<const cml::vec3>(d.normals), cml::span<cml::vec3>(d.normalized), normalize_op);
+            }
+            else if (op == 1)
+            {
+                const cml::mat4 parent = d.parent;
+                cml::parallel::transform(cml::span<const cml::mat4>(d.locals), cml::span<cml::mat4>(d.worlds), [parent](const cml::mat4& m) { return m * parent; });
+            }
+            else
+            {
+                float sum = cml::parallel::transform_reduce(cml::span<const cml::vec3>(d.normals), 0.f, add_op, length_op);
+                bench::do_not_optimize(sum);
+            }
+        });
+#endif
+        return true;
+    }
+
+    const bool registered = register_parallel();
+}
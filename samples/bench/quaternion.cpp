@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "bench.hpp"
+#include <cml/cml.hpp>
+
+namespace
+{
+    constexpr cml::quat bench_qa = cml::normalize(cml::quat(0.3f, -0.5f, 0.7f, 0.4f));
+    constexpr cml::quat bench_qb = cml::normalize(cml::quat(-0.1f, 0.8f, 0.2f, 0.55f));
+    constexpr cml::vec3 bench_v{1.5f, -2.f, 0.25f};
+}
+
+CML_BENCHMARK(quat_mul_scalar)
+{
+    cml::quat a = bench_qa;
+    cml::quat b = bench_qb;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(a);
+        bench::do_not_optimize(b);
+        auto r = cml::implementation::quaternion_mul_impl(a, b);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(quat_mul)
+{
+    cml::quat a = bench_qa;
+    cml::quat b = bench_qb;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(a);
+        bench::do_not_optimize(b);
+        auto r = a * b;
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(quat_rotate_scalar)
+{
+    cml::quat q = bench_qa;
+    cml::vec3 v = bench_v;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(q);
+        bench::do_not_optimize(v);
+        auto r = cml::implementation::quaternion_rotate_impl(q, v);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(quat_rotate)
+{
+    cml::quat q = bench_qa;
+    cml::vec3 v = bench_v;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(q);
+        bench::do_not_optimize(v);
+        auto r = cml::rotate(q, v);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(quat_sandwich)
+{
+    cml::quat q = bench_qa;
+    cml::vec3 v = bench_v;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(q);
+        bench::do_not_optimize(v);
+        const cml::quat r = q * cml::quat(v.x, v.y, v.z, 0.f) * cml::conjugate(q);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(quat_to_mat3_mul)
+{
+    cml::quat q = bench_qa;
+    cml::vec3 v = bench_v;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(q);
+        bench::do_not_optimize(v);
+        auto r = v * cml::to_mat3(q);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(quat_from_mat3)
+{
+    cml::mat3 m = cml::to_mat3(bench_qa);
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(m);
+        auto r = cml::from_mat3(m);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(quat_nlerp)
+{
+    cml::quat a = bench_qa;
+    cml::quat b = bench_qb;
+    float t = 0.3f;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(a);
+        bench::do_not_optimize(t);
+        auto r = cml::nlerp(a, b, t);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(quat_slerp)
+{
+    cml::quat a = bench_qa;
+    cml::quat b = bench_qb;
+    float t = 0.3f;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(a);
+        bench::do_not_optimize(t);
+        auto r = cml::slerp(a, b, t);
+        bench::do_not_optimize(r);
+    }
+}
@@ -0,0 +1,149 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "bench.hpp"
+#include <cml/cml.hpp>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    std::vector<cml::rad> make_angles()
+    {
+        std::vector<cml::rad> angles(1024);
+        for (size_t i = 0; i < angles.size(); ++i)
+            angles[i] = cml::rad(static_cast<float>(i) * 0.37f - 150.f);
+        return angles;
+    }
+}
+
+CML_BENCHMARK(sin_cos_float_1024)
+{
+    const std::vector<cml::rad> angles = make_angles();
+    std::vector<float> s(angles.size());
+    std::vector<float> c(angles.size());
+    while (state.keep_running())
+    {
+        for (size_t i = 0; i < angles.size(); ++i)
+        {
+            s[i] = cml::sin(angles[i]);
+            c[i] = cml::cos(angles[i]);
+        }
+        bench::do_not_optimize(s);
+        bench::do_not_optimize(c);
+    }
+}
+
+CML_BENCHMARK(sincos_float_1024)
+{
+    const std::vector<cml::rad> angles = make_angles();
+    std::vector<float> s(angles.size());
+    std::vector<float> c(angles.size());
+    while (state.keep_running())
+    {
+        for (size_t i = 0; i < angles.size(); ++i)
+        {
+            const cml::vec2 sc = cml::sincos(angles[i]);
+            s[i] = sc.components[0];
+            c[i] = sc.components[1];
+        }
+        bench::do_not_optimize(s);
+        bench::do_not_optimize(c);
+    }
+}
+
+CML_BENCHMARK(sincos_float_1024_batched)
+{
+    const std::vector<cml::rad> angles = make_angles();
+    std::vector<float> s(angles.size());
+    std::vector<float> c(angles.size());
+    while (state.keep_running())
+    {
+        cml::sincos(cml::span<const cml::rad>(angles), cml::span<float>(s), cml::span<float>(c));
+        bench::do_not_optimize(s);
+        bench::do_not_optimize(c);
+    }
+}
+
+CML_BENCHMARK(std_sin_cos_float_1024)
+{
+    const std::vector<cml::rad> angles = make_angles();
+    std::vector<float> s(angles.size());
+    std::vector<float> c(angles.size());
+    while (state.keep_running())
+    {
+        for (size_t i = 0; i < angles.size(); ++i)
+        {
+            s[i] = std::sin(static_cast<float>(angles[i]));
+            c[i] = std::cos(static_cast<float>(angles[i]));
+        }
+        bench::do_not_optimize(s);
+        bench::do_not_optimize(c);
+    }
+}
+
+CML_BENCHMARK(sincos_double_1024_batched)
+{
+    std::vector<cml::drad> angles(1024);
+    for (size_t i = 0; i < angles.size(); ++i)
+        angles[i] = cml::drad(static_cast<double>(i) * 0.37 - 150.0);
+    std::vector<double> s(angles.size());
+    std::vector<double> c(angles.size());
+    while (state.keep_running())
+    {
+        cml::sincos(cml::span<const cml::drad>(angles), cml::span<double>(s), cml::span<double>(c));
+        bench::do_not_optimize(s);
+        bench::do_not_optimize(c);
+    }
+}
+
+CML_BENCHMARK(lut_sincos_float_1024)
+{
+    const std::vector<cml::rad> angles = make_angles();
+    std::vector<float> s(angles.size());
+    std::vector<float> c(angles.size());
+    while (state.keep_running())
+    {
+        for (size_t i = 0; i < angles.size(); ++i)
+        {
+            const cml::vec2 sc = cml::lut_sincos<4096>(angles[i]);
+            s[i] = sc.components[0];
+            c[i] = sc.components[1];
+        }
+        bench::do_not_optimize(s);
+        bench::do_not_optimize(c);
+    }
+}
+
+CML_BENCHMARK(lut_sincos_float_1024_batched)
+{
+    const std::vector<cml::rad> angles = make_angles();
+    std::vector<float> s(angles.size());
+    std::vector<float> c(angles.size());
+    while (state.keep_running())
+    {
+        cml::lut_sincos<4096>(cml::span<const cml::rad>(angles), cml::span<float>(s), cml::span<float>(c));
+        bench::do_not_optimize(s);
+        bench::do_not_optimize(c);
+    }
+}
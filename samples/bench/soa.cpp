@@ -0,0 +1,142 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "bench.hpp"
+#include <cml/cml.hpp>
+#include <vector>
+
+// 100k vec3, array of structs (std::vector<vec3>) against structure of arrays (cml::soa_array<vec3>)
+namespace
+{
+    constexpr size_t particle_count = 100000;
+
+    std::vector<cml::vec3> make_aos(float offset)
+    {
+        std::vector<cml::vec3> ret(particle_count);
+        for (size_t i = 0; i < ret.size(); ++i)
+            ret[i] = cml::vec3(float(i) * 0.01f + offset, 1.f - float(i) * 0.02f, offset + 3.f);
+        return ret;
+    }
+
+    cml::soa_array<cml::vec3> make_soa(float offset)
+    {
+        cml::soa_array<cml::vec3> ret;
+        for (const cml::vec3& v : make_aos(offset))
+            ret.push_back(v);
+        return ret;
+    }
+}
+
+CML_BENCHMARK(aos_vec3_add_scaled_100k)
+{
+    std::vector<cml::vec3> p = make_aos(1.f);
+    const std::vector<cml::vec3> v = make_aos(2.f);
+    while (state.keep_running())
+    {
+        for (size_t i = 0; i < p.size(); ++i)
+            p[i] += v[i] * 0.016f;
+        bench::do_not_optimize(p);
+    }
+}
+
+CML_BENCHMARK(soa_vec3_add_scaled_100k)
+{
+    cml::soa_array<cml::vec3> p = make_soa(1.f);
+    const cml::soa_array<cml::vec3> v = make_soa(2.f);
+    while (state.keep_running())
+    {
+        p += v * 0.016f;
+        bench::do_not_optimize(p);
+    }
+}
+
+CML_BENCHMARK(aos_vec3_dot_100k)
+{
+    const std::vector<cml::vec3> a = make_aos(1.f);
+    const std::vector<cml::vec3> b = make_aos(2.f);
+    std::vector<float> out(a.size());
+    while (state.keep_running())
+    {
+        for (size_t i = 0; i < a.size(); ++i)
+            out[i] = cml::dot(a[i], b[i]);
+        bench::do_not_optimize(out);
+    }
+}
+
+CML_BENCHMARK(soa_vec3_dot_100k)
+{
+    const cml::soa_array<cml::vec3> a = make_soa(1.f);
+    const cml::soa_array<cml::vec3> b = make_soa(2.f);
+    std::vector<float> out(a.size());
+    while (state.keep_running())
+    {
+        cml::dot(a, b, cml::span<float>(out));
+        bench::do_not_optimize(out);
+    }
+}
+
+CML_BENCHMARK(aos_vec3_normalize_100k)
+{
+    std::vector<cml::vec3> a = make_aos(1.f);
+    while (state.keep_running())
+    {
+        for (size_t i = 0; i < a.size(); ++i)
+            a[i] = cml::normalize(a[i]);
+        bench::do_not_optimize(a);
+    }
+}
+
+CML_BENCHMARK(soa_vec3_normalize_100k)
+{
+    cml::soa_array<cml::vec3> a = make_soa(1.f);
+    while (state.keep_running())
+    {
+        cml::normalize_in_place(a);
+        bench::do_not_optimize(a);
+    }
+}
+
+CML_BENCHMARK(aos_vec3_cross_100k)
+{
+    const std::vector<cml::vec3> a = make_aos(1.f);
+    const std::vector<cml::vec3> b = make_aos(2.f);
+    std::vector<cml::vec3> out(a.size());
+    while (state.keep_running())
+    {
+        for (size_t i = 0; i < a.size(); ++i)
+            out[i] = cml::cross(a[i], b[i]);
+        bench::do_not_optimize(out);
+    }
+}
+
+CML_BENCHMARK(soa_vec3_cross_100k)
+{
+    const cml::soa_array<cml::vec3> a = make_soa(1.f);
+    const cml::soa_array<cml::vec3> b = make_soa(2.f);
+    cml::soa_array<cml::vec3> out(a.size());
+    while (state.keep_running())
+    {
+        cml::cross(a, b, out);
+        bench::do_not_optimize(out);
+    }
+}
@@ -0,0 +1,146 @@
+#include "bench.hpp"
+#include <cml/cml.hpp>
+#include <cmath>
+#include <vector>
+
+// cml::bsr_mat3 products on the stiffness matrix of a cloth grid (structural, shear and bend springs: 13 blocks per
+// row inside the grid), against a scalar CSR product of the same matrix written by hand
+namespace
+{
+    constexpr size_t grid_size = 256;
+    constexpr size_t nodes = grid_size * grid_size;
+
+    std::vector<cml::bsr_triplet<float>> cloth_triplets()
+    {
+        std::vector<cml::vec3> positions(nodes);
+        for (size_t y = 0; y < grid_size; ++y)
+            for (size_t x = 0; x < grid_size; ++x)
+                positions[y * grid_size + x] = cml::vec3(float(x), float(y), 0.25f * std::sin(float(x + 2 * y) * 0.1f));
+
+        // spring (a, b): k d d^T on the diagonal blocks, -k d d^T on the off diagonal ones (d the unit direction)
+        std::vector<cml::bsr_triplet<float>> triplets;
+        const int offsets[6][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}, {2, 0}, {0, 2}};
+        for (size_t y = 0; y < grid_size; ++y)
+        {
+            for (size_t x = 0; x < grid_size; ++x)
+            {
+                for (const auto& o : offsets)
+                {
+                    const size_t bx = x + size_t(o[0]), by = y + size_t(o[1]);
+                    if (bx >= grid_size || by >= grid_size)
+                        continue;
+                    const size_t a = y * grid_size + x, b = by * grid_size + bx;
+                    const cml::vec3 d = cml::normalize(positions[b] - positions[a]);
+                    cml::mat3 k;
+                    for (size_t r = 0; r < 3; ++r)
+                        for (size_t c = 0; c < 3; ++c)
+                            k.components[r * 3 + c] = 100.f * d.components[r] * d.components[c];
+                    triplets.push_back({a, a, k});
+                    triplets.push_back({b, b, k});
+                    triplets.push_back({a, b, k * -1.f});
+                    triplets.push_back({b, a, k * -1.f});
+                }
+            }
+        }
+        return triplets;
+    }
+
+    struct data
+    {
+        data()
+        : triplets(cloth_triplets()), a(nodes, nodes, triplets), x(nodes), y(nodes), pool1(1)
+        {
+            for (size_t i = 0; i < nodes; ++i)
+                x[i] = cml::vec3(float(int(i % 17) - 8) / 8, float(int(i % 13) - 6) / 6, 0.5f);
+
+            // the same matrix as scalar CSR: 9 components and 9 column indexes per block
+            row_offsets.push_back(0);
+            for (size_t i = 0; i < nodes; ++i)
+            {
+                for (size_t r = 0; r < 3; ++r)
+                {
+                    for (size_t k = a.row_offsets()[i]; k < a.row_offsets()[i + 1]; ++k)
+                    {
+                        for (size_t c = 0; c < 3; ++c)
+                        {
+                            values.push_back(a.blocks()[k].components[r * 3 + c]);
+                            columns.push_back(a.column_indices()[k] * 3 + uint32_t(c));
+                        }
+                    }
+                    row_offsets.push_back(uint32_t(values.size()));
+                }
+            }
+        }
+
+        std::vector<cml::bsr_triplet<float>> triplets;
+        cml::bsr_mat3 a;
+        std::vector<cml::vec3> x, y;
+        std::vector<float> values;
+        std::vector<uint32_t> columns, row_offsets;
+        cml::parallel::thread_pool pool1;
+    };
+
+    data& shared_data()
+    {
+        static data d;
+        return d;
+    }
+}
+
+CML_BENCHMARK(bsr_spmv_cloth_256)
+{
+    data& d = shared_data();
+    while (state.keep_running())
+    {
+        d.a.multiply(d.x, d.y);
+        bench::do_not_optimize(d.y);
+    }
+}
+
+CML_BENCHMARK(bsr_spmv_cloth_256_serial)
+{
+    data& d = shared_data();
+    while (state.keep_running())
+    {
+        d.a.multiply(d.pool1, d.x, d.y);
+        bench::do_not_optimize(d.y);
+    }
+}
+
+CML_BENCHMARK(bsr_spmv_transposed_cloth_256)
+{
+    data& d = shared_data();
+    while (state.keep_running())
+    {
+        d.a.multiply_transposed(d.x, d.y);
+        bench::do_not_optimize(d.y);
+    }
+}
+
+CML_BENCHMARK(bsr_spmv_cloth_256_naive)
+{
+    data& d = shared_data();
+    const float* x = d.x.data()->components.data();
+    float* y = d.y.data()->components.data();
+    while (state.keep_running())
+    {
+        for (size_t row = 0; row < nodes * 3; ++row)
+        {
+            float sum = 0.f;
+            for (size_t k = d.row_offsets[row]; k < d.row_offsets[row + 1]; ++k)
+                sum += d.values[k] * x[d.columns[k]];
+            y[row] = sum;
+        }
+        bench::do_not_optimize(d.y);
+    }
+}
+
+CML_BENCHMARK(bsr_build_cloth_256)
+{
+    data& d = shared_data();
+    while (state.keep_running())
+    {
+        cml::bsr_mat3 a(nodes, nodes, d.triplets);
+        bench::do_not_optimize(a);
+    }
+}
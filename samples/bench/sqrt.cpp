@@ -0,0 +1,86 @@
+#include "bench.hpp"
+
+#include <cml/cml.hpp>
+#include <vector>
+
+CML_BENCHMARK(sqrt_newton_float)
+{
+    float v = 12345.678f;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(v);
+        float r = cml::implementation::sqrt_helper(v, v);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(sqrt_float)
+{
+    float v = 12345.678f;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(v);
+        float r = cml::sqrt(v);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(sqrt_newton_double)
+{
+    double v = 12345.678;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(v);
+        double r = cml::implementation::sqrt_helper(v, v);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(sqrt_double)
+{
+    double v = 12345.678;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(v);
+        double r = cml::sqrt(v);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(normalize_vec3)
+{
+    cml::vec3 v{1.f, 2.f, 3.f};
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(v);
+        cml::vec3 r = cml::normalize(v);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(normalize_vec3_1024)
+{
+    std::vector<cml::vec3> in;
+    for (int i = 0; i < 1024; ++i)
+        in.push_back(cml::vec3(float(i) - 512.f, 1.5f, float(i % 17)));
+    std::vector<cml::vec3> out(in.size());
+    while (state.keep_running())
+    {
+        for (size_t i = 0; i < in.size(); ++i)
+            out[i] = cml::normalize(in[i]);
+        bench::do_not_optimize(out);
+    }
+}
+
+CML_BENCHMARK(normalize_fast_vec3_1024_batched)
+{
+    std::vector<cml::vec3> in;
+    for (int i = 0; i < 1024; ++i)
+        in.push_back(cml::vec3(float(i) - 512.f, 1.5f, float(i % 17)));
+    std::vector<cml::vec3> out(in.size());
+    while (state.keep_running())
+    {
+        cml::normalize_fast(cml::span<const cml::vec3>(in), cml::span<cml::vec3>(out));
+        bench::do_not_optimize(out);
+    }
+}
@@ -0,0 +1,29 @@
+#include "compare.hpp"
+
+// Swizzles of float vec4 (single shuffles at runtime) against the same component moves written by hand
+namespace
+{
+    using nvec4 = bench::naive::vec<4, float>;
+
+    bool register_swizzles()
+    {
+        const cml::vec4 a{1.25f, -0.5f, 2.f, 0.75f};
+        const cml::vec4 b{0.125f, 0.25f, -0.375f, 0.5f};
+
+        bench::compare("swizzle/read_zxwy/float", a,
+            [](cml::vec4 x) { return cml::vec4(x._<'zxwy'>()); },
+            "naive", [](const nvec4& x) { return nvec4{{x.v[2], x.v[0], x.v[3], x.v[1]}}; });
+        bench::compare("swizzle/write_ywxz/float", a, b,
+            [](cml::vec4 x, const cml::vec4& y) { x._<'ywxz'>() = y + x; return x; },
+            "naive", [](nvec4 x, const nvec4& y) { const nvec4 s = y + x; x.v[1] = s.v[0]; x.v[3] = s.v[1]; x.v[0] = s.v[2]; x.v[2] = s.v[3]; return x; });
+        bench::compare("swizzle/add_wzyx/float", a, b,
+            [](cml::vec4 x, const cml::vec4& y) { x._<'wzyx'>() += y; return x; },
+            "naive", [](nvec4 x, const nvec4& y) { x.v[3] += y.v[0]; x.v[2] += y.v[1]; x.v[1] += y.v[2]; x.v[0] += y.v[3]; return x; });
+        bench::compare("swizzle/mul_yxwz/float", a, b,
+            [](cml::vec4 x, const cml::vec4& y) { x._<'yxwz'>() *= y; return x; },
+            "naive", [](nvec4 x, const nvec4& y) { x.v[1] *= y.v[0]; x.v[0] *= y.v[1]; x.v[3] *= y.v[2]; x.v[2] *= y.v[3]; return x; });
+        return true;
+    }
+
+    const bool registered = register_swizzles();
+}
@@ -0,0 +1,150 @@
+//
+// Copyright (c) 2017 James Simpson, Timothée Feuillet
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "bench.hpp"
+#include <cml/cml.hpp>
+#include <vector>
+
+namespace
+{
+    constexpr cml::mat4 bench_mat{0.5f, 1.25f, 3.f, 0.f, 5.3f, 6.7f, 7.f, 0.f, 9.9f, 10.5f, 1.3f, 0.f, 13.f, 0.7f, 1.5f, 1.f};
+
+    std::vector<cml::vec3> make_points(size_t count)
+    {
+        std::vector<cml::vec3> points;
+        for (size_t i = 0; i < count; ++i)
+            points.push_back(cml::vec3(float(i % 1024) - 512.f, 1.5f, float(i % 17)));
+        return points;
+    }
+}
+
+CML_BENCHMARK(transform_points_4096_loop)
+{
+    const cml::mat4 m = bench_mat;
+    const std::vector<cml::vec3> in = make_points(4096);
+    std::vector<cml::vec3> out(in.size());
+    state.set_items_per_iteration(in.size());
+    while (state.keep_running())
+    {
+        for (size_t i = 0; i < in.size(); ++i)
+        {
+            const cml::vec4 r = cml::vec4(in[i].x, in[i].y, in[i].z, 1.f) * m;
+            out[i] = cml::vec3(r.x, r.y, r.z);
+        }
+        bench::do_not_optimize(out);
+    }
+}
+
+CML_BENCHMARK(transform_points_4096)
+{
+    const cml::mat4 m = bench_mat;
+    const std::vector<cml::vec3> in = make_points(4096);
+    std::vector<cml::vec3> out(in.size());
+    state.set_items_per_iteration(in.size());
+    while (state.keep_running())
+    {
+        cml::transform_points(m, cml::span<const cml::vec3>(in), cml::span<cml::vec3>(out));
+        bench::do_not_optimize(out);
+    }
+}
+
+CML_BENCHMARK(transform_vectors_4096)
+{
+    const cml::mat4 m = bench_mat;
+    const std::vector<cml::vec3> in = make_points(4096);
+    std::vector<cml::vec3> out(in.size());
+    state.set_items_per_iteration(in.size());
+    while (state.keep_running())
+    {
+        cml::transform_vectors(m, cml::span<const cml::vec3>(in), cml::span<cml::vec3>(out));
+        bench::do_not_optimize(out);
+    }
+}
+
+CML_BENCHMARK(transform_points_projective_4096)
+{
+    const cml::mat4 m = bench_mat;
+    const std::vector<cml::vec3> in = make_points(4096);
+    std::vector<cml::vec3> out(in.size());
+    state.set_items_per_iteration(in.size());
+    while (state.keep_running())
+    {
+        cml::transform_points_projective(m, cml::span<const cml::vec3>(in), cml::span<cml::vec3>(out));
+        bench::do_not_optimize(out);
+    }
+}
+
+CML_BENCHMARK(transform_points4_4096_loop)
+{
+    const cml::mat4 m = bench_mat;
+    std::vector<cml::vec4> in;
+    for (const cml::vec3& p : make_points(4096))
+        in.push_back(cml::vec4(p.x, p.y, p.z, 1.f));
+    std::vector<cml::vec4> out(in.size());
+    state.set_items_per_iteration(in.size());
+    while (state.keep_running())
+    {
+        for (size_t i = 0; i < in.size(); ++i)
+            out[i] = in[i] * m;
+        bench::do_not_optimize(out);
+    }
+}
+
+CML_BENCHMARK(transform_points4_4096)
+{
+    const cml::mat4 m = bench_mat;
+    std::vector<cml::vec4> in;
+    for (const cml::vec3& p : make_points(4096))
+        in.push_back(cml::vec4(p.x, p.y, p.z, 1.f));
+    std::vector<cml::vec4> out(in.size());
+    state.set_items_per_iteration(in.size());
+    while (state.keep_running())
+    {
+        cml::transform_points4(m, cml::span<const cml::vec4>(in), cml::span<cml::vec4>(out));
+        bench::do_not_optimize(out);
+    }
+}
+
+CML_BENCHMARK(transform_points_4m)
+{
+    const cml::mat4 m = bench_mat;
+    const std::vector<cml::vec3> in = make_points(1 << 22);
+    std::vector<cml::vec3> out(in.size());
+    state.set_items_per_iteration(in.size());
+    while (state.keep_running())
+    {
+        cml::transform_points(m, cml::span<const cml::vec3>(in), cml::span<cml::vec3>(out));
+        bench::do_not_optimize(out);
+    }
+}
+
+CML_BENCHMARK(transform_points_4m_threads)
+{
+    const cml::mat4 m = bench_mat;
+    const std::vector<cml::vec3> in = make_points(1 << 22);
+    std::vector<cml::vec3> out(in.size());
+    state.set_items_per_iteration(in.size());
+    while (state.keep_running())
+    {
+        cml::transform_points(cml::parallel::thread_pool::global(), m, cml::span<const cml::vec3>(in), cml::span<cml::vec3>(out));
+        bench::do_not_optimize(out);
+    }
+}
@@ -0,0 +1,71 @@
+#include "bench.hpp"
+
+#include <cml/cml.hpp>
+
+#include <cmath>
+
+CML_BENCHMARK(sin_series_double)
+{
+    double v = 1.234;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(v);
+        double r = cml::implementation::sin_impl(v);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(sin_series_double_100rad)
+{
+    double v = 100.0;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(v);
+        double r = cml::implementation::sin_impl(v);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(sin_double)
+{
+    cml::drad v{1.234};
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(v);
+        double r = cml::sin(v);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(sin_double_100rad)
+{
+    cml::drad v{100.0};
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(v);
+        double r = cml::sin(v);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(cos_float)
+{
+    cml::rad v{1.234f};
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(v);
+        float r = cml::cos(v);
+        bench::do_not_optimize(r);
+    }
+}
+
+CML_BENCHMARK(std_sin_double)
+{
+    double v = 1.234;
+    while (state.keep_running())
+    {
+        bench::do_not_optimize(v);
+        double r = std::sin(v);
+        bench::do_not_optimize(r);
+    }
+}
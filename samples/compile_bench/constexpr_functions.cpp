@@ -0,0 +1,54 @@
+// Build time benchmark of the constexpr functions: this translation unit evaluates a few thousand calls of the series
+// and iterative functions at compile time, time its compilation (`cmake --build . --target cml-compile-bench`).
+#include <cml/cml.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace
+{
+    constexpr size_t count = 500;
+
+    /// @brief Sum of function(x) for count values of x evenly spread over [lo, hi)
+    template<typename ValueType, typename Function>
+    constexpr ValueType sum(Function function, const ValueType lo, const ValueType hi)
+    {
+        ValueType ret{0};
+        for (size_t i = 0; i < count; ++i)
+            ret = ret + function(lo + (hi - lo) * ValueType(static_cast<int>(i)) / ValueType(static_cast<int>(count)));
+        return ret;
+    }
+
+    template<typename ValueType>
+    ValueType build()
+    {
+        using rad = cml::radian<ValueType>;
+        constexpr ValueType s = sum<ValueType>([](ValueType x) { return cml::sin(rad(x)) + cml::cos(rad(x)); }, ValueType(-20), ValueType(20));
+        constexpr ValueType a = sum<ValueType>([](ValueType x) { return cml::asin(rad(x)) + cml::acos(rad(x)) + cml::atan(rad(x * ValueType(30))); }, ValueType(-1), ValueType(1));
+        constexpr ValueType t = sum<ValueType>([](ValueType x) { return cml::atan2(x, ValueType(1) - x) + cml::tan(rad(x)); }, ValueType(-1), ValueType(1));
+        constexpr ValueType e = sum<ValueType>([](ValueType x) { return cml::exp(x) + cml::expm1(x) + cml::sinh(x) + cml::tanh(x); }, ValueType(-50), ValueType(50));
+        constexpr ValueType l = sum<ValueType>([](ValueType x) { return cml::log(x) + cml::log2(x) + cml::log1p(x) + cml::sqrt(x); }, ValueType(0.001), ValueType(1000));
+        constexpr ValueType n = sum<ValueType>([](ValueType x) { return cml::log(x, ValueType(0)); }, ValueType(0.1), ValueType(100));
+        constexpr ValueType p = sum<ValueType>([](ValueType x) { return cml::pow(x, ValueType(2.5)) + cml::pow(x, 25) + cml::pow<-7>(x); }, ValueType(0.5), ValueType(2));
+        return s + a + t + e + l + n + p;
+    }
+
+    std::int64_t build_integers()
+    {
+        constexpr std::int64_t r = sum<std::int64_t>([](std::int64_t x) { return cml::sqrt(x * x * 1000 + 7) + cml::pow(x % 7, 20); }, 0, 1000000);
+        return r;
+    }
+
+    cml::f1616 build_fixed()
+    {
+        using rad = cml::radian<cml::f1616>;
+        constexpr cml::f1616 r = sum<cml::f1616>([](cml::f1616 x) { return cml::sin(rad(x)) + cml::atan2(x, cml::f1616(1)) + cml::exp(x) + cml::log(x + cml::f1616(6)) + cml::sqrt(x + cml::f1616(6)) + cml::pow(x + cml::f1616(6), cml::f1616(0.5)); }, cml::f1616(-5), cml::f1616(5));
+        return r;
+    }
+}
+
+float compile_bench_functions_float() { return build<float>(); }
+double compile_bench_functions_double() { return build<double>(); }
+long double compile_bench_functions_long_double() { return build<long double>(); }
+std::int64_t compile_bench_functions_int() { return build_integers(); }
+cml::f1616 compile_bench_functions_f1616() { return build_fixed(); }
@@ -0,0 +1,47 @@
+// Build time benchmark of the matrix constructors: this translation unit only instantiates large matrices built
+// from many arguments, time its compilation (`cmake --build . --target cml-compile-bench`).
+#include <cml/cml.hpp>
+
+#include <utility>
+
+namespace
+{
+    template<typename MType, typename ValueType, size_t... Idxs>
+    constexpr MType from_scalars(std::index_sequence<Idxs...>)
+    {
+        return MType(static_cast<ValueType>(Idxs % 7)...);
+    }
+
+    template<typename MType, typename PartType, size_t... Idxs>
+    constexpr MType from_parts(const PartType& part, std::index_sequence<Idxs...>)
+    {
+        return MType(((void)Idxs, part)...);
+    }
+
+    template<typename ValueType>
+    ValueType build()
+    {
+        using mat16 = cml::matrix<16, 16, ValueType>;
+        using vec64 = cml::vector<64, ValueType>;
+        using vec16 = cml::vector<16, ValueType>;
+        using vec8 = cml::vector<8, ValueType>;
+
+        // one scalar per component
+        constexpr mat16 m = from_scalars<mat16, ValueType>(std::make_index_sequence<256>{});
+        constexpr vec64 v = from_scalars<vec64, ValueType>(std::make_index_sequence<64>{});
+        constexpr vec16 r = from_scalars<vec16, ValueType>(std::make_index_sequence<16>{});
+
+        // built from smaller vectors, then mixed with scalars
+        const mat16 rows = from_parts<mat16>(r, std::make_index_sequence<16>{});
+        const vec64 parts = from_parts<vec64>(vec8(r.components[0]), std::make_index_sequence<8>{});
+        const vec64 mixed(vec16(r), ValueType(1), vec8(ValueType(2)), ValueType(3), vec16(r), ValueType(4), vec8(ValueType(5)), vec8(ValueType(6)), ValueType(7), ValueType(8), ValueType(9), ValueType(10), ValueType(11));
+        const mat16 blocks(v, v, v, v);
+
+        return m.components[255] + v.components[63] + rows.components[17] + parts.components[9] + mixed.components[40] + blocks.components[200];
+    }
+}
+
+float compile_bench_float() { return build<float>(); }
+double compile_bench_double() { return build<double>(); }
+int compile_bench_int() { return build<int>(); }
+cml::f1616 compile_bench_f1616() { return build<cml::f1616>(); }
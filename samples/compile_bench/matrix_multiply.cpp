@@ -0,0 +1,41 @@
+// Build time benchmark of the products of big matrices (64x64, 32x128 by 128x32, 16x16 at compile time): with the
+// fold expressions a single 64x64 product took minutes, time the compilation of this translation unit
+// (`cmake --build . --target cml-compile-bench`).
+#include <cml/cml.hpp>
+
+namespace
+{
+    template<typename MType>
+    constexpr MType ramp(int seed)
+    {
+        MType ret;
+        for (size_t i = 0; i < ret.components.size(); ++i)
+            ret.components[i] = typename MType::value_type(static_cast<int>((i * 31 + seed) % 17) - 8);
+        return ret;
+    }
+
+    template<typename ValueType>
+    ValueType build()
+    {
+        using mat16 = cml::matrix<16, 16, ValueType>;
+        using mat64 = cml::matrix<64, 64, ValueType>;
+        using mat32x128 = cml::matrix<32, 128, ValueType>;
+        using mat128x32 = cml::matrix<128, 32, ValueType>;
+
+        constexpr mat16 m16 = ramp<mat16>(1) * ramp<mat16>(2) * ramp<mat16>(3);
+
+        static mat64 a64 = ramp<mat64>(4), b64 = ramp<mat64>(5);
+        static mat32x128 a128 = ramp<mat32x128>(6);
+        static mat128x32 b128 = ramp<mat128x32>(7);
+        const mat64 c64 = a64 * b64;
+        const auto c128 = a128 * b128;
+        const auto c32 = b128 * a128;
+        const auto v64 = cml::vector<64, ValueType>(ValueType(1)) * a64;
+
+        return m16.components[17] + c64.components[100] + c128.components[1000] + c32.components[33] + v64.components[5];
+    }
+}
+
+float compile_bench_multiply_float() { return build<float>(); }
+double compile_bench_multiply_double() { return build<double>(); }
+int compile_bench_multiply_int() { return build<int>(); }
@@ -1,9 +1,12 @@
 
 #define CML_COMPILE_TEST_CASE 1
 #include <cml/cml.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <iostream>
 #include <iomanip>
+#include <vector>
 
 #define STRING(STR) #STR
 #define CHECK(expr) if (!(expr)) {printf("Check failed: %s\n", STRING(expr));}
@@ -33,9 +36,47 @@ void print(T t, A... a)
 
 }
 
+/// @brief Allocator with a state (an id), not propagated on move assignments: the containers must copy between two of them
+template<typename T>
+struct tagged_allocator
+{
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::false_type;
+
+    explicit tagged_allocator(int id = 0) noexcept : id(id) {}
+    template<typename U>
+    tagged_allocator(const tagged_allocator<U>& o) noexcept : id(o.id) {}
+
+    T* allocate(size_t count) { return std::allocator<T>().allocate(count); }
+    void deallocate(T* p, size_t count) noexcept { std::allocator<T>().deallocate(p, count); }
+
+    bool operator == (const tagged_allocator& o) const noexcept { return id == o.id; }
+    bool operator != (const tagged_allocator& o) const noexcept { return id != o.id; }
+
+    int id;
+};
+
+/// @brief Value whose copies throw once copies_left reaches 0, counting the live instances
+struct throwing_copy
+{
+    static inline int live = 0;
+    static inline int copies_left = 0;
+
+    throwing_copy() noexcept { ++live; }
+    throwing_copy(const throwing_copy&)
+    {
+        if (copies_left-- == 0)
+            throw std::runtime_error("copy");
+        ++live;
+    }
+    ~throwing_copy() noexcept { --live; }
+};
+
 int main()
 {
     static_assert(cml::ivec4(cml::ivec3(1, 6, 1), 6) == cml::ivec4(1, 6, 1, 6));
+    static_assert(cml::ivec4(5, 6, static_cast<const cml::ivec2&>(cml::ivec2(1, 2))) == cml::ivec4(5, 6, 1, 2));
+    static_assert(cml::matrix<4, 4, int>(cml::ivec4(1), 2, cml::ivec3(3), cml::ivec4(4), cml::ivec4(5)).components[7] == 3);
 
     static_assert(static_cast<cml::ivec4>(cml::cvec4(4, 3, 2, 1))._<'x'>() == 4);
     static_assert(static_cast<cml::ivec4>(cml::cvec4(4, 3, 2, 1)).components[0] == 4);
@@ -50,6 +91,39 @@ int main()
 
     static_assert(static_cast<uint32_t>(cml::cvec4(4, 3, 2, 1)) == 0x01020304); // only OK on little endians
 
+    // swizzles: a single pointer to the parent, written one component after the other, the right hand side read first
+    static_assert(sizeof(decltype(std::declval<cml::vec4&>()._<'wzyx'>())) == sizeof(cml::vec4*));
+    static_assert([] { cml::ivec4 v(1, 2, 3, 4); v._<'wzyx'>() = v; return v; }() == cml::ivec4(4, 3, 2, 1));
+    static_assert([] { cml::ivec4 v(1, 2, 3, 4); v._<'yx'>() = v._<'xy'>(); return v; }() == cml::ivec4(2, 1, 3, 4));
+    static_assert([] { cml::ivec4 v(1, 2, 3, 4); v._<'yy'>() *= 5; v._<'zw'>() += cml::ivec2(10, 20); return v; }() == cml::ivec4(1, 50, 13, 24));
+    static_assert([] { cml::ivec4 v(1, 2, 3, 4); v._<'wzy'>()._<'zx'>() = 7; return v; }() == cml::ivec4(1, 7, 3, 7));
+    static_assert([] { cml::ivec4 v(1, 2, 3, 4); return cml::ivec4(v._<'zw'>(), v._<'xy'>()); }() == cml::ivec4(3, 4, 1, 2));
+    static_assert([] { cml::ivec4 v(1, 2, 3, 4); return v._<'xy'>() + v._<'zw'>() * 2 - 1; }() == cml::ivec2(6, 9));
+    static_assert([] { cml::ivec4 v(1, 2, 3, 4); return cml::ivec2(1, 1) + 2 * v._<'wx'>(); }() == cml::ivec2(9, 3));
+    static_assert([] { cml::ivec4 v(1, 2, 3, 4); return v._<'wx'>() == cml::ivec2(4, 1) && cml::ivec2(3, 2) != v._<'wx'>(); }());
+    static_assert(sizeof(decltype(std::declval<cml::vec4&>()._<'zy'>())) == sizeof(cml::vec4*));
+    static_assert([] { cml::vec3 v(1, 2, 3); return cml::transpose(v._<'xy'>()); }() == cml::transpose(cml::vec2(1, 2)));
+    static_assert([] { cml::vec3 v(3, 4, 1); return cml::dot(v._<'xy'>(), cml::vec2(1, 2)) == 11.f && cml::dot(v._<'xy'>(), v._<'yx'>()) == 24.f; }());
+    static_assert([] { cml::vec3 v(3, -3, 1); return cml::cross(v, v._<'zyx'>()) == cml::cross(v, cml::vec3(1, -3, 3)) && cml::cross(v._<'xyz'>(), v._<'xyz'>()) == cml::vec3(); }());
+    static_assert([] { cml::ivec4 v(1, 5, 3, 4); return cml::max(v._<'xy'>(), v._<'zw'>()) == cml::ivec2(3, 5) && cml::min(v._<'xyz'>(), 2) == cml::ivec3(1, 2, 2); }());
+    {
+        // named components of a swizzle are the parent ones
+        cml::vec4 v(1.f, 2.f, 3.f, 4.f);
+        auto zyx = v._<'zyx'>();
+        CHECK(zyx.x == 3.f && zyx.y == 2.f && zyx.z == 1.f && zyx.r == 3.f && zyx.b == 1.f);
+        zyx.x = 30.f;
+        zyx.z += 9.f;
+        v._<'wzyx'>().w *= 2.f;
+        v._<'yx'>().x = v._<'yx'>().y / 2.f;
+        CHECK(v == cml::vec4(20.f, 10.f, 30.f, 4.f));
+        CHECK(int(v._<'wz'>().x) == 4);
+        CHECK(cml::is_equal<2>(cml::length(v._<'yx'>()), cml::length(cml::vec2(10.f, 20.f))));
+        CHECK(cml::is_equal<2>(cml::distance(v._<'xy'>(), cml::vec2(23.f, 14.f)), 5.f));
+        CHECK(cml::normalize(v._<'zw'>()) == cml::normalize(cml::vec2(30.f, 4.f)));
+        const cml::mat4 translate(1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 1.f, 1.f, 1.f, 1.f);
+        CHECK(cml::transform_point(translate, v._<'xyz'>()) == cml::vec3(21.f, 11.f, 31.f) && cml::transform_vector(translate, v._<'zyx'>()) == cml::vec3(30.f, 10.f, 20.f));
+    }
+
 
     // eq / neq operators
     static_assert(cml::ivec4(4, 3, 2, 1) == cml::ivec4(4, 3, 2, 1));
@@ -58,6 +132,15 @@ int main()
     static_assert((5 != cml::ivec4(4, 3, 2, 1)));
     static_assert(!(0 == cml::ivec4(4, 3, 2, 1)));
     static_assert(!(cml::ivec4(4, 3, 2, 1) == 1));
+    {
+        constexpr cml::ivec4 lhs(4, 3, 2, 1);
+        constexpr cml::ivec4 rhs(4, 3, 2, 1);
+        static_assert(lhs == rhs);
+        static_assert(!(lhs != rhs));
+        cml::vec3 a, b = a;
+        CHECK(a == b);
+        CHECK(!(a != b));
+    }
 
     // + -
     static_assert(cml::ivec4(1) + 1 == 2);
@@ -68,6 +151,25 @@ int main()
     static_assert(1 - cml::ivec4(1) == 0);
     static_assert(cml::ivec4(1) - 1 == cml::ivec4(0));
     static_assert(1 - cml::ivec4(1) == cml::ivec4(0));
+    {
+        // lvalue scalars
+        const float s = 2.f;
+        float t = 4.f;
+        const cml::vec3 v(1.f, 2.f, 4.f);
+        CHECK(v + s == cml::vec3(3.f, 4.f, 6.f) && v + t == cml::vec3(5.f, 6.f, 8.f));
+        CHECK(v - s == cml::vec3(-1.f, 0.f, 2.f) && v - t == cml::vec3(-3.f, -2.f, 0.f));
+        CHECK(v * s == cml::vec3(2.f, 4.f, 8.f) && v * t == cml::vec3(4.f, 8.f, 16.f));
+        CHECK(v / s == cml::vec3(0.5f, 1.f, 2.f) && v / t == cml::vec3(0.25f, 0.5f, 1.f));
+        cml::vec3 w = v;
+        w += s;
+        CHECK(w == cml::vec3(3.f, 4.f, 6.f));
+        w -= t;
+        CHECK(w == cml::vec3(-1.f, 0.f, 2.f));
+        w *= s;
+        CHECK(w == cml::vec3(-2.f, 0.f, 4.f));
+        w /= t;
+        CHECK(w == cml::vec3(-0.5f, 0.f, 1.f));
+    }
 
 
     static_assert(cml::mat3::identity() == cml::mat3(cml::vec3(1, 0, 0),
@@ -86,6 +188,8 @@ int main()
     static_assert(cml::mat<3, 2>{} * cml::mat<2, 3>{} == cml::mat<2, 2>{});
     static_assert(cml::mat<3, 2>{} * cml::mat<2, 3>{} == 0.0f);
     static_assert(cml::mat3::identity() * cml::mat3::identity() == cml::mat3::identity());
+    static_assert(cml::matrix<16, 16, int>::identity() * cml::matrix<16, 16, int>(7) == cml::matrix<16, 16, int>(7));
+    static_assert((cml::matrix<33, 5, int>(2) * cml::matrix<3, 33, int>(3)).components[14] == 198);
 
     static_assert(cml::ivec3{4, -5, -3} * cml::imat3::identity() == cml::ivec3{4, -5, -3});
     static_assert(cml::ivec3{4, -5, -3} * (2 * cml::imat3::identity()) == 2 * cml::ivec3{4, -5, -3});
@@ -150,18 +254,1042 @@ int main()
 
     printf("iv.x %i, v.x %i (must be 175 both)\n", int(iv._<'yx'>().x), cml::ivec2(v._<'yx'>().unsafe_cast<int32_t>()).x);
 
+    // runtime (simd) matrix products must match the constexpr folds (up to fma contraction when enabled)
+    constexpr cml::mat4 ma{0.5f, 1.25f, 3.f, 4.1f, 5.3f, 6.7f, 7.f, 0.1f, 9.9f, 10.5f, 1.3f, 2.2f, 13.f, 0.7f, 1.5f, 16.25f};
+    constexpr cml::mat4 mb{1.1f, 2.f, 0.3f, 4.f, 0.25f, 6.f, 7.5f, 8.f, 3.3f, 1.f, 11.f, 12.1f, 0.7f, 14.f, 2.5f, 1.6f};
+    constexpr cml::vec4 va{1.5f, 2.25f, 3.1f, 0.4f};
+    constexpr cml::mat4 mab = ma * mb;
+    constexpr cml::vec4 vab = va * mb;
+    cml::mat4 mc = ma;
+    mc *= mb;
+    for (size_t i = 0; i < 16; ++i)
+    {
+        CHECK(cml::is_equal<2>((ma * mb).components[i], mab.components[i]));
+        CHECK(cml::is_equal<2>(mc.components[i], mab.components[i]));
+    }
+    for (size_t i = 0; i < 4; ++i)
+        CHECK(cml::is_equal<2>((va * mb).components[i], vab.components[i]));
+
+    // aligned kind: over-aligned storage (aligned loads in the kernels), same values
+    static_assert(alignof(cml::amat4) == 32 && alignof(cml::admat4) == 32 && alignof(cml::avec4) == 16 && alignof(cml::advec4) == 32);
+    static_assert(sizeof(cml::avec3) == 16 && sizeof(cml::amat4) == sizeof(cml::mat4) && sizeof(cml::aligned_matrix<3, 3, float>) == 48);
+    static_assert(std::is_same<decltype(cml::amat4().rows[0]), cml::avec4&>::value);
+    const cml::amat4 ama = ma.unsafe_cast<float, cml::implementation::matrix_kind::aligned>();
+    const cml::amat4 amb = mb.unsafe_cast<float, cml::implementation::matrix_kind::aligned>();
+    const cml::avec4 ava = va.unsafe_cast<float, cml::implementation::matrix_kind::aligned>();
+    for (size_t i = 0; i < 16; ++i)
+        CHECK(cml::is_equal<2>((ama * amb).components[i], mab.components[i]));
+    for (size_t i = 0; i < 4; ++i)
+        CHECK(cml::is_equal<2>((ava * amb).components[i], vab.components[i]));
+
+    // determinant / inverse: the float mat4 inverse uses a SSE kernel at runtime, it must stay close to the constexpr
+    // cofactor expansion
+    {
+        static_assert(cml::determinant(ma) != 0.f);
+        constexpr cml::mat4 inv_ma = cml::inverse(ma);
+        constexpr cml::dmat4 dma = ma.unsafe_cast<double>();
+        constexpr cml::dmat4 dmi = dma * cml::inverse(dma);
+        constexpr cml::dmat<5, 5> m5(3, 1, 0, 2, 1, 1, 4, 1, 0, 2, 0, 1, 5, 1, 0, 2, 0, 1, 6, 1, 1, 2, 0, 1, 7);
+        constexpr cml::dmat<5, 5> m5i = m5 * cml::inverse(m5);
+        for (size_t i = 0; i < 16; ++i)
+            CHECK(std::abs(dmi.components[i] - (i % 5 == 0 ? 1.0 : 0.0)) < 1e-12);
+        for (size_t i = 0; i < 25; ++i)
+            CHECK(std::abs(m5i.components[i] - (i % 6 == 0 ? 1.0 : 0.0)) < 1e-12);
+
+        const cml::mat4 ima = cml::inverse(ma);
+        const cml::amat4 iama = cml::inverse(ama);
+        const cml::mat4 id = ma * ima;
+        for (size_t i = 0; i < 16; ++i)
+        {
+            CHECK(std::abs(ima.components[i] - inv_ma.components[i]) <= 1e-5f * (std::abs(inv_ma.components[i]) + 1.f));
+            CHECK(std::abs(iama.components[i] - inv_ma.components[i]) <= 1e-5f * (std::abs(inv_ma.components[i]) + 1.f));
+            CHECK(std::abs(id.components[i] - (i % 5 == 0 ? 1.f : 0.f)) < 1e-5f);
+        }
+        CHECK(cml::is_equal<4>(cml::determinant(ma), float(cml::determinant(dma))));
+
+        // affine: rotation around z + scale + translation, applied as v * m
+        const cml::mat4 affine(0.f, 2.f, 0.f, 0.f, -2.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.5f, 0.f, 3.f, -4.f, 5.f, 1.f);
+        const cml::mat4 ia = cml::inverse_affine(affine);
+        const cml::mat4 ig = cml::inverse(affine);
+        const cml::vec4 p(1.f, 2.f, 3.f, 1.f);
+        const cml::vec4 back = (p * affine) * ia;
+        for (size_t i = 0; i < 16; ++i)
+            CHECK(std::abs(ia.components[i] - ig.components[i]) < 1e-6f);
+        for (size_t i = 0; i < 4; ++i)
+            CHECK(std::abs(back.components[i] - p.components[i]) < 1e-6f);
+    }
+
+    // quaternions: the float product and rotation use SSE kernels at runtime, they must stay close to the constexpr
+    // formulas, and rotate / to_mat3 / from_mat3 must agree with each other
+    {
+        constexpr cml::quat qa = cml::normalize(cml::quat(0.3f, -0.5f, 0.7f, 0.4f));
+        constexpr cml::quat qb = cml::from_axis_angle(cml::normalize(cml::vec3(1.f, 2.f, -1.f)), cml::deg(70.f));
+        constexpr cml::quat qab = qa * qb;
+        constexpr cml::vec3 v(1.5f, -2.f, 0.25f);
+        constexpr cml::vec3 rv = cml::rotate(qa, v);
+
+        const cml::quat rqab = qa * qb;
+        const cml::vec3 rrv = cml::rotate(qa, v);
+        const cml::avec3 rav = cml::rotate(qa, cml::avec3(v.x, v.y, v.z));
+        const cml::vec3 mv = v * cml::to_mat3(qa);
+        const cml::vec4 mv4 = cml::vec4(v.x, v.y, v.z, 1.f) * cml::to_mat4(qa);
+        const cml::quat back = cml::from_mat3(cml::to_mat3(qab));
+        cml::quat acc = qa;
+        acc *= qb;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            CHECK(std::abs(rqab.components[i] - qab.components[i]) < 1e-6f);
+            CHECK(std::abs(acc.components[i] - qab.components[i]) < 1e-6f);
+        }
+        for (size_t i = 0; i < 3; ++i)
+        {
+            CHECK(std::abs(rrv.components[i] - rv.components[i]) < 1e-6f);
+            CHECK(std::abs(rav.components[i] - rv.components[i]) < 1e-6f);
+            CHECK(std::abs(mv.components[i] - rv.components[i]) < 1e-5f);
+            CHECK(std::abs(mv4.components[i] - rv.components[i]) < 1e-5f);
+        }
+        CHECK(std::abs(cml::rotate(qa * qb, v).x - cml::rotate(qa, cml::rotate(qb, v)).x) < 1e-5f);
+        CHECK(std::abs(std::abs(cml::dot(back, qab)) - 1.f) < 1e-6f);
+        CHECK(std::abs(cml::length(cml::rotate(qa, v)) - cml::length(v)) < 1e-5f);
+
+        const cml::quat iqa = qa * cml::inverse(qa);
+        CHECK(std::abs(iqa.w - 1.f) < 1e-6f && std::abs(iqa.x) < 1e-6f && std::abs(iqa.y) < 1e-6f && std::abs(iqa.z) < 1e-6f);
+
+        // slerp has constant angular speed: the angle to qa grows linearly with t
+        const cml::dquat da = cml::normalize(qa.unsafe_cast<double>());
+        const cml::dquat db = cml::normalize(qb.unsafe_cast<double>());
+        const double full = std::acos(std::abs(cml::dot(da, db)));
+        for (double t = 0.0; t <= 1.0; t += 0.125)
+        {
+            const cml::dquat s = cml::slerp(da, db, t);
+            const cml::dquat n = cml::nlerp(da, db, t);
+            CHECK(std::abs(cml::length(s) - 1.0) < 1e-12);
+            CHECK(std::abs(cml::length(n) - 1.0) < 1e-12);
+            CHECK(std::abs(std::acos(std::min(1.0, std::abs(cml::dot(da, s)))) - t * full) < 1e-7);
+        }
+        constexpr cml::dquat cs = cml::slerp(cml::dquat::identity(), cml::dquat(0.0, 0.6, 0.0, 0.8), 0.3);
+        const cml::dquat rs = cml::slerp(cml::dquat::identity(), cml::dquat(0.0, 0.6, 0.0, 0.8), 0.3);
+        for (size_t i = 0; i < 4; ++i)
+            CHECK(std::abs(rs.components[i] - cs.components[i]) < 1e-14);
+    }
+
+    // batched transforms: every size up to 3 registers (and the tails), in place, and on several threads, against the
+    // single vector versions
+    {
+        const cml::mat4 tm(0.5f, 1.25f, 3.f, 0.1f, 5.3f, -6.7f, 7.f, 0.2f, 9.9f, 10.5f, 1.3f, 0.3f, 13.f, 0.7f, 1.5f, 4.f);
+        const auto close = [](const auto& a, const auto& b)
+        {
+            bool ok = true;
+            for (size_t i = 0; i < a.components.size(); ++i)
+                ok = ok && std::abs(a.components[i] - b.components[i]) <= 1e-5f * (std::abs(b.components[i]) + 1.f);
+            return ok;
+        };
+        for (size_t count = 0; count <= 25; ++count)
+        {
+            std::vector<cml::vec3> in3(count);
+            std::vector<cml::vec4> in4(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                in3[i] = cml::vec3(float(i) - 7.f, 0.5f * float(i), 3.f - float(i * i) * 0.25f);
+                in4[i] = cml::vec4(in3[i].x, in3[i].y, in3[i].z, 1.f - float(i) * 0.125f);
+            }
+            std::vector<cml::vec3> points(count), vectors(count), projected(count);
+            std::vector<cml::vec4> points4(count);
+            cml::transform_points(tm, cml::span<const cml::vec3>(in3), cml::span<cml::vec3>(points));
+            cml::transform_vectors(tm, cml::span<const cml::vec3>(in3), cml::span<cml::vec3>(vectors));
+            cml::transform_points_projective(tm, cml::span<const cml::vec3>(in3), cml::span<cml::vec3>(projected));
+            cml::transform_points4(tm, cml::span<const cml::vec4>(in4), cml::span<cml::vec4>(points4));
+            std::vector<cml::vec3> in_place = in3;
+            cml::transform_points(tm, cml::span<cml::vec3>(in_place), cml::span<cml::vec3>(in_place));
+            for (size_t i = 0; i < count; ++i)
+            {
+                CHECK(close(points[i], cml::transform_point(tm, in3[i])));
+                CHECK(close(vectors[i], cml::transform_vector(tm, in3[i])));
+                CHECK(close(projected[i], cml::transform_point_projective(tm, in3[i])));
+                CHECK(close(points4[i], in4[i] * tm));
+                CHECK(in_place[i].components == points[i].components);
+            }
+        }
+
+        // empty spans (null data): nothing to read nor write
+        cml::transform_points(tm, cml::span<const cml::vec3>(), cml::span<cml::vec3>());
+        cml::transform_vectors(tm, cml::span<const cml::vec3>(), cml::span<cml::vec3>());
+        cml::transform_points_projective(tm, cml::span<const cml::vec3>(), cml::span<cml::vec3>());
+        cml::transform_points4(tm, cml::span<const cml::vec4>(), cml::span<cml::vec4>());
+        cml::parallel::thread_pool pool(4);
+        cml::transform_points(pool, tm, cml::span<const cml::vec3>(), cml::span<cml::vec3>());
+        cml::transform_points4(pool, tm, cml::span<const cml::vec4>(), cml::span<cml::vec4>());
+
+        std::vector<cml::vec3> big(100003);
+        for (size_t i = 0; i < big.size(); ++i)
+            big[i] = cml::vec3(float(i % 101) - 50.f, float(i % 7), float(i % 13) * 0.5f);
+        std::vector<cml::vec3> single(big.size()), threaded(big.size());
+        cml::transform_points(tm, cml::span<const cml::vec3>(big), cml::span<cml::vec3>(single));
+        cml::transform_points(pool, tm, cml::span<const cml::vec3>(big), cml::span<cml::vec3>(threaded));
+        bool same = true;
+        for (size_t i = 0; i < big.size(); ++i)
+            same = same && single[i].components == threaded[i].components;
+        CHECK(same);
+
+        bool thrown = false;
+        try { cml::transform_points(tm, cml::span<const cml::vec3>(big), cml::span<cml::vec3>(threaded.data(), 10)); }
+        catch (const std::runtime_error&) { thrown = true; }
+        CHECK(thrown);
+    }
+
+    // cml::parallel on pools of 1 to 4 threads (more threads than cores is fine): same results as a plain loop, and
+    // reductions that don't depend on the thread count
+    {
+        std::vector<cml::vec3> normals(200003);
+        for (size_t i = 0; i < normals.size(); ++i)
+            normals[i] = cml::vec3(float(i % 101) - 50.5f, float(i % 7) + 1.f, float(i % 13) * 0.5f);
+        std::vector<cml::vec3> expected(normals.size());
+        std::vector<float> lengths(normals.size());
+        double expected_length = 0.0;
+        for (size_t i = 0; i < normals.size(); ++i)
+        {
+            expected[i] = cml::normalize(normals[i]);
+            lengths[i] = cml::length(normals[i]);
+        }
+        const cml::span<const cml::vec3> in(normals);
+
+        float first_sum = 0.f;
+        float first_lengths_sum = 0.f;
+        float expected_y = 0.f;
+        for (const cml::vec3& v : normals)
+            expected_y += v.y;
+        for (size_t threads = 1; threads <= 4; ++threads)
+        {
+            cml::parallel::thread_pool pool(threads);
+            CHECK(pool.size() == threads);
+
+            std::vector<cml::vec3> out(normals.size());
+            cml::parallel::transform(pool, in, cml::span<cml::vec3>(out), [](const cml::vec3& v) { return cml::normalize(v); });
+            bool same = true;
+            for (size_t i = 0; i < out.size(); ++i)
+                same = same && out[i].components == expected[i].components;
+            CHECK(same);
+
+            std::vector<cml::vec3> in_place = normals;
+            cml::parallel::for_each(pool, cml::span<cml::vec3>(in_place), [](cml::vec3& v) { v = cml::normalize(v); });
+            same = true;
+            for (size_t i = 0; i < out.size(); ++i)
+                same = same && in_place[i].components == expected[i].components;
+            CHECK(same);
+
+            std::vector<float> dots(normals.size());
+            cml::parallel::transform(pool, in, cml::span<const cml::vec3>(expected), cml::span<float>(dots), [](const cml::vec3& a, const cml::vec3& b) { return cml::dot(a, b); });
+            CHECK(cml::is_equal<4>(dots[12345], cml::length(normals[12345])));
+
+            const float sum = cml::parallel::transform_reduce(pool, in, 0.f, [](float a, float b) { return a + b; }, [](const cml::vec3& v) { return cml::length(v); });
+            const float lengths_sum = cml::parallel::reduce(pool, cml::span<const float>(lengths), 0.f);
+            if (threads == 1)
+            {
+                first_sum = sum;
+                first_lengths_sum = lengths_sum;
+            }
+            CHECK(sum == first_sum);
+            CHECK(lengths_sum == first_lengths_sum);
+            CHECK(cml::parallel::reduce(pool, in, cml::vec3(0.f)).y == expected_y); // integers, exact sums
+
+            std::atomic<size_t> calls{0};
+            bool thrown = false;
+            try
+            {
+                cml::parallel::for_each(pool, in, [&calls](const cml::vec3& v)
+                {
+                    if (v.y > 6.5f && ++calls > 3)
+                        throw std::runtime_error("stop");
+                });
+            }
+            catch (const std::runtime_error&) { thrown = true; }
+            CHECK(thrown);
+
+            // calls from inside a task run on the calling thread
+            std::vector<float> nested(64, 0.f);
+            cml::parallel::for_each(pool, cml::span<float>(nested), [&](float& f)
+            {
+                f = cml::parallel::reduce(pool, cml::span<const float>(lengths.data(), 1000), 0.f);
+            });
+            CHECK(nested[63] == nested[0] && nested[0] > 0.f);
+
+            thrown = false;
+            try { cml::parallel::transform(pool, in, cml::span<cml::vec3>(out.data(), 10), [](const cml::vec3& v) { return v; }); }
+            catch (const std::runtime_error&) { thrown = true; }
+            CHECK(thrown);
+        }
+        for (float length : lengths)
+            expected_length += length;
+        CHECK(std::abs(first_sum - expected_length) <= 1e-5 * expected_length);
+        CHECK(cml::parallel::transform_reduce(in, 0.f, [](float a, float b) { return a + b; }, [](const cml::vec3& v) { return cml::length(v); }) == first_sum);
+        CHECK(cml::parallel::chunk_size<cml::vec3>() % 16 == 0 && cml::parallel::chunk_size<cml::vec3>() * sizeof(cml::vec3) >= cml::parallel::chunk_bytes);
+    }
+
+    // products of big matrices (cache blocked loops, simd tiles at runtime): partial tiles on the last rows and
+    // columns, blocks of the common dimension and of the rows, close to a double precision reference at compile time and
+    // at runtime (the bits only differ when the compiler contracts the runtime mul / add pairs into fma)
+    {
+        constexpr auto fill = [](auto m, int seed)
+        {
+            for (size_t i = 0; i < m.components.size(); ++i)
+                m.components[i] = typename decltype(m)::value_type(static_cast<int>((i * 7919 + seed) % 201) - 100) / 37;
+            return m;
+        };
+        constexpr auto check_big = [](const auto& a, const auto& b, const auto& product)
+        {
+            constexpr size_t rows = cml::matrix_traits<std::decay_t<decltype(a)>>::dimy;
+            constexpr size_t common = cml::matrix_traits<std::decay_t<decltype(a)>>::dimx;
+            constexpr size_t cols = cml::matrix_traits<std::decay_t<decltype(b)>>::dimx;
+            bool ok = true;
+            for (size_t i = 0; i < rows; ++i)
+            {
+                for (size_t j = 0; j < cols; ++j)
+                {
+                    double expected = 0;
+                    for (size_t k = 0; k < common; ++k)
+                        expected += double(a.components[i * common + k]) * double(b.components[k * cols + j]);
+                    ok = ok && std::abs(double(product.components[i * cols + j]) - expected) <= 1e-5 * (1 + std::abs(expected));
+                }
+            }
+            return ok;
+        };
+        constexpr cml::matrix<16, 16, float> a16 = fill(cml::matrix<16, 16, float>(), 11);
+        constexpr cml::matrix<16, 16, float> b16 = fill(cml::matrix<16, 16, float>(), 5);
+        constexpr cml::matrix<16, 16, float> c16 = a16 * b16;
+        CHECK(check_big(a16, b16, c16));
+        CHECK(check_big(a16, b16, a16 * b16));
+        constexpr cml::matrix<37, 13, double> a37 = fill(cml::matrix<37, 13, double>(), 11);
+        constexpr cml::matrix<29, 37, double> b37 = fill(cml::matrix<29, 37, double>(), 5);
+        constexpr cml::matrix<29, 13, double> c37 = a37 * b37;
+        CHECK(check_big(a37, b37, c37));
+        CHECK(check_big(a37, b37, a37 * b37));
+
+        static cml::matrix<64, 64, float> a64, b64;
+        static cml::matrix<32, 128, float> a128;
+        static cml::matrix<128, 32, float> b128;
+        a64 = fill(a64, 11);
+        b64 = fill(b64, 5);
+        a128 = fill(a128, 11);
+        b128 = fill(b128, 5);
+        CHECK(check_big(a64, b64, a64 * b64));
+        CHECK(check_big(a128, b128, a128 * b128));
+        CHECK(check_big(b128, a128, b128 * a128));
+
+        // fixed point sums are exact: same bits as the scalar operators
+        const cml::matrix<40, 3, cml::f1616> af = fill(cml::matrix<40, 3, cml::f1616>(), 11);
+        const cml::matrix<50, 40, cml::f1616> bf = fill(cml::matrix<50, 40, cml::f1616>(), 5);
+        const auto cf = af * bf;
+        bool same = true;
+        for (size_t j = 0; j < 50; ++j)
+        {
+            cml::f1616 expected(0);
+            for (size_t k = 0; k < 40; ++k)
+                expected += af.components[2 * 40 + k] * bf.components[k * 50 + j];
+            same = same && cf.components[2 * 50 + j] == expected;
+        }
+        CHECK(same);
+    }
+
+    // dynamic matrices: the same results as the fixed size matrices, the big ones being split between threads
+    {
+        using dmat = cml::dynamic_matrix<float>;
+        using dvec = cml::dynamic_vector<float>;
+
+        dmat a(3, 2, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+        CHECK(a.dimx() == 3 && a.dimy() == 2 && a.size() == 6 && !a.is_vector() && a.at(1, 1) == 5.f && a.row(1)[2] == 6.f);
+        CHECK(reinterpret_cast<uintptr_t>(a.data()) % 64 == 0);
+        const dmat from_fixed(cml::matrix<3, 2, float>(1.f, 2.f, 3.f, 4.f, 5.f, 6.f));
+        CHECK(from_fixed == a && !(from_fixed != a));
+        dmat moved = std::move(a);
+        CHECK(a.empty() && a.data() == nullptr && moved == from_fixed);
+        a = moved.clone();
+        CHECK(a == moved && a.data() != moved.data());
+
+        // operators, against the fixed size ones
+        const cml::matrix<3, 2, float> fa(1.f, 2.f, 3.f, 4.f, 5.f, 6.f);
+        const cml::matrix<2, 3, float> fb(0.5f, -1.f, 2.f, 0.25f, -3.f, 1.5f);
+        const dmat b(fb);
+        CHECK(dmat(fa * fb) == a * b);
+        CHECK(dmat(fa + fa * 2.f - fa / 4.f) == a + a * 2.f - a / 4.f);
+        CHECK(dmat(fa * -1.f) == -a && dmat(2.f * fa) == 2.f * a && dmat(fa + 1.f) == a + 1.f && dmat(1.f - fa) == 1.f - a);
+        dmat product = a.clone();
+        product *= b;
+        CHECK(product == a * b);
+
+        bool thrown = false;
+        try { dmat c = a + b; }
+        catch (const std::runtime_error&) { thrown = true; }
+        CHECK(thrown);
+        thrown = false;
+        try { dmat c = a * a; }
+        catch (const std::runtime_error&) { thrown = true; }
+        CHECK(thrown);
+        thrown = false;
+        try { a.block<2, 2>(2, 0); }
+        catch (const std::runtime_error&) { thrown = true; }
+        CHECK(thrown);
+
+        // block views write to the matrix and convert to fixed size matrices
+        auto view = a.block<2, 2>(1, 0);
+        CHECK((cml::matrix<2, 2, float>(view) == cml::matrix<2, 2, float>(2.f, 3.f, 5.f, 6.f)));
+        view = cml::matrix<2, 2, float>(view) * 2.f;
+        CHECK(a == dmat(3, 2, {1.f, 4.f, 6.f, 4.f, 10.f, 12.f}));
+        const dmat& ca = a;
+        CHECK(cml::vec3(ca.block<3, 1>(0, 1)) == cml::vec3(4.f, 10.f, 12.f));
+        // a pointer and a stride, evaluated to contiguous matrices for their operators
+        static_assert(sizeof(dmat::block_type<4, 4>) == sizeof(float*) + sizeof(size_t));
+        dmat m8(8, 8, 0.f);
+        for (size_t i = 0; i < m8.size(); ++i)
+            m8[i] = float(i % 13) - 6.f;
+        const cml::mat4 m4(2.f, 0.f, 1.f, 0.f, 0.f, 1.f, 0.f, 3.f, -1.f, 0.f, 1.f, 0.f, 0.f, 2.f, 0.f, 1.f);
+        const cml::mat4 corner = m8.block<4, 4>(4, 4);
+        CHECK(corner.components[5] == m8.at(5, 5) && corner.components[14] == m8.at(6, 7));
+        CHECK((m8.block<4, 4>(4, 4) * m4 == corner * m4 && m4 * m8.block<4, 4>(4, 4) == m4 * corner && 2.f * m8.block<4, 4>(4, 4) == corner * 2.f));
+        CHECK((cml::vec4(1.f, 2.f, 3.f, 4.f) * m8.block<4, 4>(4, 4) == cml::vec4(1.f, 2.f, 3.f, 4.f) * corner && m8.block<4, 4>(4, 4) == corner));
+        m8.block<4, 4>(0, 0) = m8.block<4, 4>(4, 4);
+        m8.block<4, 4>(0, 0) *= m4;
+        CHECK((m8.block<4, 4>(0, 0) == corner * m4 && m8.at(4, 4) == corner.components[0] && m8.at(0, 4) == float(32 % 13) - 6.f));
+
+        // the constructors and moves between allocators that throw halfway give the memory back
+        throwing_copy::copies_left = 3;
+        thrown = false;
+        try { cml::dynamic_matrix<throwing_copy> throws(4, 2); }
+        catch (const std::runtime_error&) { thrown = true; }
+        CHECK(thrown && throwing_copy::live == 0);
+        throwing_copy::copies_left = 6;
+        {
+            cml::dynamic_matrix<throwing_copy, tagged_allocator<throwing_copy>> from(2, 2, throwing_copy(), tagged_allocator<throwing_copy>(1));
+            cml::dynamic_matrix<throwing_copy, tagged_allocator<throwing_copy>> to(tagged_allocator<throwing_copy>(2));
+            thrown = false;
+            try { to = std::move(from); }
+            catch (const std::runtime_error&) { thrown = true; }
+            CHECK(thrown && to.empty() && from.size() == 4 && throwing_copy::live == 4);
+        }
+        CHECK(throwing_copy::live == 0);
+
+        // big matrices: several chunks, the threaded kernels
+        dmat big_a(150, 200), big_b(170, 150);
+        for (size_t i = 0; i < big_a.size(); ++i)
+            big_a[i] = float(int(i * 7919 % 201) - 100) / 37;
+        for (size_t i = 0; i < big_b.size(); ++i)
+            big_b[i] = float(int(i * 104729 % 201) - 100) / 41;
+        const dmat big_c = big_a * big_b;
+        bool close = big_c.dimx() == 170 && big_c.dimy() == 200;
+        for (size_t y = 0; y < 200; y += 7)
+        {
+            for (size_t x = 0; x < 170; ++x)
+            {
+                double expected = 0;
+                for (size_t k = 0; k < 150; ++k)
+                    expected += double(big_a.at(k, y)) * double(big_b.at(x, k));
+                close = close && std::abs(double(big_c.at(x, y)) - expected) <= 1e-5 * (1 + std::abs(expected));
+            }
+        }
+        CHECK(close);
+        const dmat big_t = cml::transpose(big_a);
+        CHECK(big_t.dimx() == 200 && big_t.dimy() == 150 && big_t.at(17, 33) == big_a.at(33, 17) && cml::transpose(big_t) == big_a);
+        const dmat big_sum = big_a * 3.f - big_a + 1.f;
+        bool same = true;
+        for (size_t i = 0; i < big_a.size(); ++i)
+            same = same && std::abs(big_sum[i] - (big_a[i] * 3.f - big_a[i] + 1.f)) <= 1e-6f * (1.f + std::abs(big_sum[i]));
+        CHECK(same);
+
+        dvec v(300000, 1, 0.f), w(300000, 1, 0.f);
+        double expected_dot = 0;
+        for (size_t i = 0; i < v.size(); ++i)
+        {
+            v[i] = float(int(i % 97) - 48) / 16;
+            w[i] = float(int(i % 89) - 44) / 8;
+            expected_dot += double(v[i]) * double(w[i]);
+        }
+        const float d = cml::dot(v, w);
+        CHECK(std::abs(d - expected_dot) <= 1e-4 * std::abs(expected_dot) && cml::dot(v, w) == d);
+        CHECK(std::abs(cml::length(cml::normalize(v)) - 1.f) < 1e-5f && std::abs(cml::length(v) - std::sqrt(float(cml::dot(v, v)))) < 1e-3f);
+        CHECK(cml::dot(dvec(cml::vec3(1.f, 2.f, 3.f)), dvec(cml::vec3(4.f, 5.f, 6.f))) == cml::dot(cml::vec3(1.f, 2.f, 3.f), cml::vec3(4.f, 5.f, 6.f)));
+        CHECK(cml::vec3(cml::normalize(dvec(cml::vec3(1.f, 2.f, 3.f))).block<3, 1>(0, 0)) == cml::normalize(cml::vec3(1.f, 2.f, 3.f)));
+
+        // fixed point: same bits as the fixed size operators
+        const cml::matrix<4, 3, cml::f1616> fx(cml::f1616(0.5), cml::f1616(-1.25), cml::f1616(3), cml::f1616(0.75), cml::f1616(2), cml::f1616(-0.5),
+                                               cml::f1616(1.5), cml::f1616(0.125), cml::f1616(-2), cml::f1616(1), cml::f1616(0.25), cml::f1616(4));
+        const cml::matrix<3, 4, cml::f1616> fy(cml::f1616(1.5), cml::f1616(-0.75), cml::f1616(2), cml::f1616(0.375), cml::f1616(-1), cml::f1616(2.5),
+                                               cml::f1616(0.5), cml::f1616(-2.25), cml::f1616(1), cml::f1616(3), cml::f1616(-0.125), cml::f1616(0.625));
+        const cml::dynamic_matrix<cml::f1616> dfx(fx), dfy(fy);
+        CHECK(cml::dynamic_matrix<cml::f1616>(fx * fy) == dfx * dfy && cml::transpose(cml::transpose(dfx)) == dfx);
+        CHECK(cml::dynamic_matrix<cml::f1616>(fx + fx * cml::f1616(0.5)) == dfx + dfx * cml::f1616(0.5));
+
+        // allocators that don't propagate: the components are moved between the allocations
+        using tagged = cml::dynamic_matrix<double, tagged_allocator<double>>;
+        tagged t1(4, 4, 1.5, tagged_allocator<double>(1));
+        tagged t2(tagged_allocator<double>(2));
+        t2 = std::move(t1);
+        CHECK((t2.get_allocator().id == 2 && t2.size() == 16 && t2[15] == 1.5 && t1.clone().get_allocator().id == 1));
+        tagged t3(tagged_allocator<double>(2));
+        const double* storage = t2.data();
+        t3 = std::move(t2);
+        CHECK(t3.data() == storage && t2.empty());
+        CHECK((t3 * t3).get_allocator().id == 2 && (t3 * t3)[0] == 9.);
+    }
+
+    // frame arena: bump allocations, scoped rewinds, chained blocks merged at reset, containers on arena allocators
+    {
+        cml::frame_arena arena(1024);
+        CHECK(arena.capacity() == 1024 && arena.used() == 0 && arena.high_water_mark() == 0);
+        void* a = arena.allocate(10, 1);
+        void* b = arena.allocate(16, 16);
+        CHECK(reinterpret_cast<uintptr_t>(b) % 16 == 0 && static_cast<char*>(b) >= static_cast<char*>(a) + 10 && arena.used() == 32);
+        arena.deallocate(a, 10); // not the last allocation: nothing happens
+        CHECK(arena.used() == 32);
+        arena.deallocate(b, 16); // back to b, the alignment padding stays
+        CHECK(arena.used() == 16 && arena.high_water_mark() == 32);
+        {
+            cml::frame_arena::scope scope(arena);
+            cml::span<cml::mat4> mats = arena.allocate_span<cml::mat4>(4);
+            CHECK(mats.size() == 4 && reinterpret_cast<uintptr_t>(mats.data()) % alignof(cml::mat4) == 0 && mats[3] == cml::mat4());
+            CHECK(arena.used() == 16 + 4 * sizeof(cml::mat4) && arena.stats().overflows == 0);
+            // more than the block: a second one is chained
+            cml::span<float> big = arena.allocate_span<float>(1000);
+            big[999] = 1.f;
+            CHECK(arena.stats().overflows == 1 && arena.capacity() > 1024 && arena.used() >= 16 + 4 * sizeof(cml::mat4) + 4000);
+            mats[0] = cml::mat4::identity();
+            CHECK(mats[0] == cml::mat4::identity() && big[999] == 1.f);
+        }
+        CHECK(arena.used() == 16 && arena.capacity() == 1024 && arena.high_water_mark() > 4000);
+        // the next frames fit in a single block
+        const size_t high_water_mark = arena.high_water_mark();
+        arena.reset();
+        CHECK(arena.used() == 0 && arena.capacity() >= high_water_mark);
+        arena.allocate(high_water_mark, 1);
+        CHECK(arena.stats().overflows == 1 && arena.stats().allocations == 5);
+        arena.reset_high_water_mark();
+        arena.reset();
+        CHECK(arena.high_water_mark() == high_water_mark && arena.used() == 0);
+
+        // containers and batched functions on arena memory
+        using arena_mat = cml::dynamic_matrix<float, cml::arena_allocator<float>>;
+        const cml::arena_allocator<float> allocator(arena);
+        const cml::dynamic_matrix<float> reference(cml::matrix<3, 2, float>(1.f, 2.f, 3.f, 4.f, 5.f, 6.f));
+        const arena_mat m(cml::matrix<3, 2, float>(1.f, 2.f, 3.f, 4.f, 5.f, 6.f), allocator);
+        const arena_mat product = m * cml::transpose(m);
+        CHECK(&product.get_allocator().arena() == &arena && reinterpret_cast<uintptr_t>(product.data()) % 64 == 0);
+        bool same = product.size() == 4;
+        const cml::dynamic_matrix<float> expected = reference * cml::transpose(reference);
+        for (size_t i = 0; i < 4; ++i)
+            same = same && product[i] == expected[i];
+        CHECK(same);
+        CHECK(arena.used() > 0 && arena.stats().overflows == 1);
+
+        cml::frame_arena& local = cml::frame_arena::local();
+        {
+            cml::frame_arena::scope scope(local);
+            cml::soa_array<cml::vec3, cml::arena_allocator<float>> soa(100, cml::vec3(1.f, 2.f, 3.f));
+            cml::normalize_in_place(soa);
+            CHECK(cml::vec3(soa[42]) == cml::normalize(cml::vec3(1.f, 2.f, 3.f)) && local.used() > 0);
+            cml::span<cml::vec3> points = local.allocate_span<cml::vec3>(64);
+            for (size_t i = 0; i < points.size(); ++i)
+                points[i] = cml::vec3(float(i), 1.f, 2.f);
+            cml::transform_points(cml::mat4(1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 1.f, 2.f, 3.f, 1.f), points, points);
+            CHECK(points[63] == cml::vec3(64.f, 3.f, 5.f));
+        }
+        CHECK(local.used() == 0 && local.capacity() == cml::frame_arena::default_capacity);
+
+        // scoped frames over the capacity, never reset: the first one overflows, the next ones start in its big block
+        cml::frame_arena scoped(1024);
+        for (int frame = 0; frame < 2; ++frame)
+        {
+            cml::frame_arena::scope outer(scoped);
+            cml::frame_arena::scope inner(scoped);
+            scoped.allocate_span<cml::mat4>(4);
+            scoped.allocate_span<float>(1000);
+        }
+        CHECK(scoped.stats().overflows == 1 && scoped.used() == 0 && scoped.capacity() > 1024);
+    }
+
+    // block sparse matrices: duplicates summed, products against a dense double reference, same bits on any number of
+    // threads
+    {
+        using bsr = cml::bsr_mat3;
+        cml::bsr_builder<float> builder(2, 3);
+        builder.add(1, 2, cml::mat3(1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f));
+        builder.add(0, 1, cml::mat3::identity());
+        builder.add(1, 0, cml::mat3(2.f));
+        builder.add(1, 2, cml::mat3::identity());
+        builder.add_value(4, 8, 10.f); // block (1, 2), component (1, 2)
+        const bsr small = builder.build();
+        CHECK(small.block_count() == 3 && small.rows() == 6 && small.columns() == 9 && small.row_offsets()[1] == 1 && small.column_indices()[1] == 0);
+        CHECK(small.find(0, 0) == nullptr && *small.find(0, 1) == cml::mat3::identity());
+        CHECK(*small.find(1, 2) == cml::mat3(2.f, 2.f, 3.f, 4.f, 6.f, 16.f, 7.f, 8.f, 10.f));
+
+        const std::vector<cml::vec3> x3 = {cml::vec3(1.f, 2.f, 3.f), cml::vec3(4.f, 5.f, 6.f), cml::vec3(1.f, 0.f, -1.f)};
+        std::vector<cml::vec3> y2(2);
+        small.multiply(x3, y2);
+        // row 1: A_10 x_0 = 2 * (1 + 2 + 3) on each row, A_12 x_2 = (2 - 3, 4 - 16, 7 - 10)
+        CHECK(y2[0] == cml::vec3(4.f, 5.f, 6.f) && y2[1] == cml::vec3(11.f, 0.f, 9.f));
+        std::vector<cml::vec3> y3(3);
+        const std::vector<cml::vec3> e2 = {cml::vec3(1.f, 0.f, 0.f), cml::vec3(0.f, 1.f, 0.f)};
+        small.multiply_transposed(e2, y3);
+        CHECK(y3[0] == cml::vec3(2.f, 2.f, 2.f) && y3[1] == cml::vec3(1.f, 0.f, 0.f) && y3[2] == cml::vec3(4.f, 6.f, 16.f));
+
+        bool thrown = false;
+        try { small.multiply(y2, y2); }
+        catch (const std::runtime_error&) { thrown = true; }
+        CHECK(thrown);
+        thrown = false;
+        try { builder.add(2, 0, cml::mat3()); }
+        catch (const std::runtime_error&) { thrown = true; }
+        CHECK(thrown);
+
+        // big random pattern: several chunks, empty rows and columns
+        constexpr size_t block_rows = 3000, block_columns = 2500;
+        std::vector<cml::bsr_triplet<float>> triplets;
+        std::vector<cml::bsr_triplet<double>> dtriplets;
+        for (size_t i = 0; i < 40000; ++i)
+        {
+            const size_t row = i * 7919 % block_rows, column = (i * 104729 + i / 3) % block_columns;
+            if (row % 97 == 5 || column % 89 == 3)
+                continue;
+            cml::mat3 block;
+            for (size_t c = 0; c < 9; ++c)
+                block.components[c] = float(int((i * 9 + c) * 2654435761u % 201) - 100) / 64;
+            triplets.push_back({row, column, block});
+            dtriplets.push_back({row, column, cml::dmat3(block)});
+        }
+        const bsr a(block_rows, block_columns, triplets);
+        const cml::dbsr_mat3 da(block_rows, block_columns, dtriplets);
+        CHECK(a.block_count() == da.block_count() && a.block_count() < triplets.size() && a.find(5, 17) == nullptr);
+
+        std::vector<cml::vec3> x(block_columns), xt(block_rows);
+        std::vector<cml::dvec3> dx(block_columns), dxt(block_rows);
+        for (size_t i = 0; i < block_columns; ++i)
+            dx[i] = cml::dvec3(x[i] = cml::vec3(float(int(i % 17) - 8) / 4, float(int(i % 13) - 6) / 8, 1.f));
+        for (size_t i = 0; i < block_rows; ++i)
+            dxt[i] = cml::dvec3(xt[i] = cml::vec3(0.5f, float(int(i % 11) - 5) / 2, float(int(i % 7) - 3) / 4));
+        std::vector<cml::vec3> y(block_rows), yt(block_columns), y_serial(block_rows), yt_serial(block_columns);
+        std::vector<cml::dvec3> dy(block_rows), dyt(block_columns);
+        cml::parallel::thread_pool pool1(1), pool3(3);
+        a.multiply(pool3, x, y);
+        a.multiply(pool1, x, y_serial);
+        a.multiply_transposed(pool3, xt, yt);
+        a.multiply_transposed(pool1, xt, yt_serial);
+        da.multiply(dx, dy);
+        da.multiply_transposed(dxt, dyt);
+        CHECK(y == y_serial && yt == yt_serial);
+
+        // dense reference, accumulated in double from the triplets
+        std::vector<cml::dvec3> ry(block_rows, cml::dvec3(0.)), ryt(block_columns, cml::dvec3(0.));
+        for (const cml::bsr_triplet<double>& t : dtriplets)
+            for (size_t r = 0; r < 3; ++r)
+                for (size_t c = 0; c < 3; ++c)
+                {
+                    ry[t.row].components[r] += t.block.components[r * 3 + c] * dx[t.column].components[c];
+                    ryt[t.column].components[c] += dxt[t.row].components[r] * t.block.components[r * 3 + c];
+                }
+        bool close = true;
+        for (size_t i = 0; i < block_rows; ++i)
+            for (size_t r = 0; r < 3; ++r)
+                close = close && std::abs(y[i].components[r] - ry[i].components[r]) <= 1e-4 * (1 + std::abs(ry[i].components[r]))
+                              && std::abs(dy[i].components[r] - ry[i].components[r]) <= 1e-12 * (1 + std::abs(ry[i].components[r]));
+        for (size_t j = 0; j < block_columns; ++j)
+            for (size_t c = 0; c < 3; ++c)
+                close = close && std::abs(yt[j].components[c] - ryt[j].components[c]) <= 1e-4 * (1 + std::abs(ryt[j].components[c]))
+                              && std::abs(dyt[j].components[c] - ryt[j].components[c]) <= 1e-12 * (1 + std::abs(ryt[j].components[c]));
+        CHECK(close && y[5] == cml::vec3(0.f) && yt[3] == cml::vec3(0.f));
+    }
+
+    // fixed point integer kernels: the runtime (simd) results must have the same bits as the constexpr ones, with
+    // negative and inexact products (truncated toward -infinity)
+    {
+        constexpr auto check_fixed = [](auto tag)
+        {
+            using F = decltype(tag);
+            using T = typename F::value_type;
+            constexpr cml::matrix<4, 4, F> m(F(0.3), F(-1.7), F(3), F(0.9), F(-0.35), F(2), F(1.55), F(-1), F(0.2), F(4.1), F(-2.7), F(0.15), F(1), F(-0.45), F(2.3), F(0.7));
+            constexpr cml::matrix<4, 4, F> n(F(-1.1), F(0.7), F(1.3), F(2.5), F(0.15), F(-3), F(1), F(0.55), F(-0.9), F(1.3), F(-0.2), F(-2), F(3.5), F(0.35), F(1), F(0.65));
+            constexpr cml::vector<4, F> a(F(1.5), F(-0.6), F(2.2), F(-3));
+            constexpr cml::vector<4, F> b(F(0.3), F(-2.25), F(0.85), F(1.45));
+            constexpr F s(-1.7);
+            constexpr cml::matrix<4, 4, F> cmn = m * n, cadd = m + n, csub = m - n, cms = m * s, csm = s * m;
+            constexpr cml::matrix<4, 4, F> cacc = (m + n) * s;
+            constexpr cml::vector<4, F> can = a * n, cab = a + b, csb = a - b, cas = a * s;
+            constexpr F cdot = cml::dot(a, b);
+            cml::matrix<4, 4, F> acc = m;
+            acc += n;
+            acc *= s;
+            bool ok = (m * n == cmn) && (m + n == cadd) && (m - n == csub) && (m * s == cms) && (s * m == csm) && (acc == cacc)
+                   && (a * n == can) && (a + b == cab) && (a - b == csb) && (a * s == cas) && (cml::dot(a, b) == cdot);
+
+            // 16 components go through whole registers (256 bit ones with avx2); the values stay small enough for the
+            // 32 bit sums not to overflow, the 16 bit ones wrap
+            cml::vector<16, F> u, v;
+            for (size_t i = 0; i < 16; ++i)
+            {
+                const int scale = sizeof(T) == 4 ? 1024 : 1;
+                u.components[i] = F{F::from_fixed, static_cast<T>((static_cast<int>((i * 7919 + 13) % 2048) - 1024) * scale)};
+                v.components[i] = F{F::from_fixed, static_cast<T>((static_cast<int>((i * 104729 + 7) % 2048) - 1024) * scale)};
+            }
+            F expected(0);
+            for (size_t i = 0; i < 16; ++i)
+            {
+                expected += u.components[i] * v.components[i];
+                ok = ok && (u + v).components[i] == u.components[i] + v.components[i] && (u * s).components[i] == u.components[i] * s;
+            }
+            return ok && cml::dot(u, v) == expected;
+        };
+        CHECK(check_fixed(cml::f88()));
+        CHECK(check_fixed(cml::f1616()));
+        CHECK(check_fixed(cml::f0824()));
+    }
+
+    // fixed point sin / cos / atan2 / exp / log: integer only kernels, within one unit of the last place of std
+    {
+        constexpr auto check_fixed_functions = [](auto tag, double ulps)
+        {
+            using F = decltype(tag);
+            const double eps = ulps / double(1 << F::fractional_bits);
+            const double range = sizeof(typename F::value_type) == 2 ? 100.0 : 1000.0;
+            bool ok = true;
+            for (int i = -500; i <= 500; ++i)
+            {
+                const F x(range * i / 500.0);
+                const double dx = static_cast<double>(x);
+                ok &= std::abs(static_cast<double>(cml::sin(cml::radian<F>(x))) - std::sin(dx)) <= eps;
+                ok &= std::abs(static_cast<double>(cml::cos(cml::radian<F>(x))) - std::cos(dx)) <= eps;
+                const auto sc = cml::sincos(cml::radian<F>(x));
+                ok &= sc.x == cml::sin(cml::radian<F>(x)) && sc.y == cml::cos(cml::radian<F>(x));
+
+                const F y(3.0 * std::sin(i * 0.37));
+                ok &= std::abs(static_cast<double>(cml::atan2(F(3.0 * std::cos(i * 0.37)), y)) - std::atan2(static_cast<double>(y), static_cast<double>(F(3.0 * std::cos(i * 0.37))))) <= eps;
+
+                const F e(4.0 * i / 500.0);
+                const double de = static_cast<double>(e);
+                ok &= std::abs(static_cast<double>(cml::exp(e)) - std::exp(de)) <= eps * std::max(1.0, std::exp(de));
+                ok &= std::abs(static_cast<double>(cml::exp2(e)) - std::exp2(de)) <= eps * std::max(1.0, std::exp2(de));
+                if (i > 0)
+                {
+                    const F l(range * i / 500.0);
+                    ok &= std::abs(static_cast<double>(cml::log(l)) - std::log(static_cast<double>(l))) <= eps;
+                    ok &= std::abs(static_cast<double>(cml::log2(l)) - std::log2(static_cast<double>(l))) <= eps;
+                }
+            }
+            return ok;
+        };
+        CHECK(check_fixed_functions(cml::f88(), 1));
+        CHECK(check_fixed_functions(cml::f1616(), 1));
+    }
+
+    // trig tables: within lut_error_bound of std (plus the rounding of float angles), the batches give the single calls
+    {
+        double e1024 = 0, e4096 = 0, e_fixed = 0;
+        for (int i = -20000; i <= 20000; ++i)
+        {
+            const double a = i * 1e-3;
+            e1024 = std::max({e1024, std::abs(cml::lut_sin(cml::radian<double>(a)) - std::sin(a)), std::abs(cml::lut_cos(cml::radian<double>(a)) - std::cos(a))});
+            e4096 = std::max({e4096, std::abs(cml::lut_sin<4096, double>(cml::radian<double>(a)) - std::sin(a)), std::abs(cml::lut_cos<4096, double>(cml::radian<double>(a)) - std::cos(a))});
+            e_fixed = std::max(e_fixed, std::abs(cml::lut_sin<256, cml::f0824>(cml::radian<double>(a)) - std::sin(a)));
+
+            const float f = static_cast<float>(a);
+            const double tolerance = cml::lut_error_bound<1024> + std::abs(a) * std::numeric_limits<float>::epsilon();
+            CHECK(std::abs(cml::lut_sin(cml::radian<float>(f)) - std::sin(double(f))) <= tolerance);
+            const float d = static_cast<float>(i) * 0.05f;
+            CHECK(std::abs(cml::lut_cos(cml::degree<float>(d)) - std::cos(double(d) * cml::pi<double> / 180)) <= cml::lut_error_bound<1024> + std::abs(d) * 2e-2 * std::numeric_limits<float>::epsilon());
+        }
+        CHECK(e1024 <= cml::lut_error_bound<1024>);
+        CHECK((e4096 <= cml::lut_error_bound<4096, double>));
+        CHECK((e_fixed <= cml::lut_error_bound<256, cml::f0824>));
+
+        std::vector<cml::rad> angles(1000);
+        for (size_t i = 0; i < angles.size(); ++i)
+            angles[i] = cml::rad(static_cast<float>(i) * 0.37f - 150.f);
+        angles[997] = cml::rad(1e7f); // out of the 32 bit indices of the avx2 kernel
+        std::vector<float> s(angles.size()), c(angles.size()), s2(angles.size());
+        cml::lut_sincos<4096>(cml::span<cml::rad>(angles), cml::span<float>(s), cml::span<float>(c));
+        cml::lut_sin<4096>(cml::span<const cml::rad>(angles), cml::span<float>(s2));
+        for (size_t i = 0; i < angles.size(); ++i)
+        {
+            // the batches may contract the interpolation differently
+            CHECK(std::abs(s[i] - cml::lut_sin<4096>(angles[i])) <= 1e-7f && s2[i] == s[i]);
+            CHECK(std::abs(c[i] - cml::lut_sincos<4096>(angles[i]).components[1]) <= 1e-7f);
+        }
+    }
+
+    // exp / log / pow kernels: within 2 ulp of std for double (std itself is not always correctly rounded), 1 ulp for float,
+    // and the same bits at compile time and at runtime
+    {
+        const auto ulps = [](auto a, auto b)
+        {
+            using T = decltype(a);
+            if (a == b || (a != a && b != b))
+                return 0.0;
+            const T scale = std::max(std::abs(b), std::numeric_limits<T>::min());
+            return static_cast<double>(std::abs(a - b) / (scale * std::numeric_limits<T>::epsilon()));
+        };
+        double e_double = 0, e_float = 0;
+        for (int i = -20000; i <= 20000; ++i)
+        {
+            const double x = i * 0.0351;
+            const double p = std::exp(i * 0.0343);
+            const double s = i * 1e-7;
+            e_double = std::max({e_double, ulps(cml::exp(x), std::exp(x)), ulps(cml::exp2(x), std::exp2(x)), ulps(cml::expm1(x), std::expm1(x)), ulps(cml::expm1(s), std::expm1(s)),
+                                 ulps(cml::log(p), std::log(p)), ulps(cml::log2(p), std::log2(p)), ulps(cml::log1p(p), std::log1p(p)), ulps(cml::log1p(s), std::log1p(s))});
+
+            const float fx = static_cast<float>(i) * 0.00437f;
+            const float fp = static_cast<float>(p);
+            e_float = std::max({e_float, ulps(cml::exp(fx), std::exp(fx)), ulps(cml::exp2(fx), std::exp2(fx)), ulps(cml::expm1(fx), std::expm1(fx)),
+                                ulps(cml::log(fp), std::log(fp)), ulps(cml::log2(fp), std::log2(fp)), ulps(cml::log1p(fp), std::log1p(fp))});
+        }
+        CHECK(e_double <= 2.0);
+        CHECK(e_float <= 1.0);
+
+        constexpr std::array<double, 8> inputs{-745.5, -20.25, -1e-300, 0.0, 1e-12, 0.6931471805599453, 3.7, 709.5};
+        constexpr std::array<double, 8> exp_d{cml::exp(inputs[0]), cml::exp(inputs[1]), cml::exp(inputs[2]), cml::exp(inputs[3]),
+                                              cml::exp(inputs[4]), cml::exp(inputs[5]), cml::exp(inputs[6]), cml::exp(inputs[7])};
+        constexpr std::array<double, 8> log_d{cml::log(inputs[0]), cml::log(inputs[1]), cml::log(4.9e-324), cml::log(inputs[3]),
+                                              cml::log(inputs[4]), cml::log(inputs[5]), cml::log(inputs[6]), cml::log(inputs[7])};
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            CHECK(ulps(cml::exp(inputs[i]), exp_d[i]) == 0);
+            CHECK(ulps(cml::log(i == 2 ? 4.9e-324 : inputs[i]), log_d[i]) == 0);
+        }
+        CHECK(cml::exp(1000.0) == std::numeric_limits<double>::infinity() && cml::exp(-1000.f) == 0.f);
+        CHECK(cml::log(0.f) == -std::numeric_limits<float>::infinity() && std::isnan(cml::log(-2.0)));
+
+        // pow: the integer exponents by squaring against the products, the real ones against std
+        double e_pow = 0, e_powf = 0;
+        for (int i = 1; i <= 2000; ++i)
+        {
+            const double x = std::exp(i * 0.0173 - 17.0);
+            const double y = std::sin(i * 0.71) * (i % 4 == 0 ? 150.0 : 4.0);
+            e_pow = std::max(e_pow, ulps(cml::pow(x, y), std::pow(x, y)));
+            e_powf = std::max(e_powf, ulps(cml::pow(static_cast<float>(x), static_cast<float>(y)), std::pow(static_cast<float>(x), static_cast<float>(y))));
+
+            // each squaring doubles the error of the previous products
+            const int n = i % 41 - 20;
+            const double b = 1.0 + i * 1e-3;
+            CHECK(ulps(cml::pow(b, n), std::pow(b, n)) <= std::abs(n));
+            CHECK(cml::pow(-b, n) == (n % 2 ? -cml::pow(b, n) : cml::pow(b, n)));
+        }
+        CHECK(e_pow <= 1.5);
+        CHECK(e_powf <= 1.0);
+        CHECK(cml::pow<5>(1.5) == 1.5 * 1.5 * 1.5 * 1.5 * 1.5 && cml::pow<-3>(2.f) == 0.125f);
+        CHECK(std::isnan(cml::pow(-2.0, 0.5)) && cml::pow(-2.0, 3.0) == -8.0 && cml::pow(0.0, -2.0) == std::numeric_limits<double>::infinity());
+        CHECK(std::signbit(cml::pow(-0.0, 3.0)) && !std::signbit(cml::pow(-0.0, 2.0)) && !std::signbit(cml::pow(-0.0, 0.5)) && std::signbit(cml::pow(-0.f, 5.f)));
+        CHECK(cml::pow(-0.0, -3.0) == -std::numeric_limits<double>::infinity() && cml::pow(-0.0, -2.0) == std::numeric_limits<double>::infinity());
+        CHECK((cml::pow(cml::vec3(1.f, 4.f, 9.f), 0.5f) == cml::vec3(1.f, 2.f, 3.f)));
+        CHECK((cml::pow<2>(cml::imat2(1, -2, 3, 4)) == cml::imat2(1, 4, 9, 16)));
+        CHECK(std::abs(static_cast<double>(cml::pow(cml::f1616(10), cml::f1616(2.5))) - std::pow(10.0, 2.5)) <= 316.3 / 65536.0);
+    }
+
     CHECK(cml::is_equal(cml::sqrt(5.0), std::sqrt(5.0)));
     CHECK(cml::sqrt(5.0f) == std::sqrt(5.0f));
 
     CHECK(std::sqrt(5.0) == cml::sqrt(5.0));
     CHECK(std::sqrt(5.f) == cml::sqrt(5.f));
 
+    // sqrt: the constexpr path (newton) and the runtime path (sqrtss / sqrtsd) must be bit exact
+    {
+        constexpr std::array<double, 10> inputs{0.0, 1e-310, 1e-30, 0.3, 1.0, 2.0, 3.9999999999999996, 5.0, 12345.678, 1.7e308};
+        constexpr std::array<float, 10> sqrt_f{cml::sqrt(float(inputs[0])), cml::sqrt(float(inputs[1])), cml::sqrt(float(inputs[2])), cml::sqrt(float(inputs[3])), cml::sqrt(float(inputs[4])),
+                                               cml::sqrt(float(inputs[5])), cml::sqrt(float(inputs[6])), cml::sqrt(float(inputs[7])), cml::sqrt(float(inputs[8])), cml::sqrt(3.4e38f)};
+        constexpr std::array<double, 10> sqrt_d{cml::sqrt(inputs[0]), cml::sqrt(inputs[1]), cml::sqrt(inputs[2]), cml::sqrt(inputs[3]), cml::sqrt(inputs[4]),
+                                                cml::sqrt(inputs[5]), cml::sqrt(inputs[6]), cml::sqrt(inputs[7]), cml::sqrt(inputs[8]), cml::sqrt(inputs[9])};
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            const float f = i + 1 < inputs.size() ? float(inputs[i]) : 3.4e38f;
+            CHECK(cml::sqrt(f) == sqrt_f[i]);
+            CHECK(std::sqrt(f) == sqrt_f[i]);
+            CHECK(cml::sqrt(inputs[i]) == sqrt_d[i]);
+            CHECK(std::sqrt(inputs[i]) == sqrt_d[i]);
+        }
+    }
+
+    // rsqrt / normalize_fast: hardware estimate + one newton step, relative error < 2^-21, the batched versions give the
+    // same values
+    {
+        std::vector<float> fs;
+        std::vector<double> ds;
+        std::vector<cml::vec3> vs;
+        for (int i = 0; i < 37; ++i)
+        {
+            fs.push_back(float(i) * 13.7f + 1e-3f);
+            ds.push_back(double(i) * 1e5 + 1e-7);
+            vs.push_back(cml::vec3(float(i) - 18.f, 0.25f, float(i * i) * 0.5f));
+        }
+        fs.push_back(0.f);
+        fs.push_back(1e-40f);
+        ds.push_back(1e300);
+        std::vector<float> frs(fs.size());
+        std::vector<double> drs(ds.size());
+        std::vector<cml::vec3> vns(vs.size());
+        cml::rsqrt(cml::span<const float>(fs), cml::span<float>(frs));
+        cml::rsqrt(cml::span<const double>(ds), cml::span<double>(drs));
+        cml::normalize_fast(cml::span<const cml::vec3>(vs), cml::span<cml::vec3>(vns));
+        for (size_t i = 0; i < fs.size(); ++i)
+        {
+            CHECK(frs[i] == cml::rsqrt(fs[i]));
+            CHECK(fs[i] == 0.f ? std::isinf(frs[i]) : std::abs(frs[i] * std::sqrt(double(fs[i])) - 1.0) < 0x1p-21);
+        }
+        for (size_t i = 0; i < ds.size(); ++i)
+        {
+            CHECK(drs[i] == cml::rsqrt(ds[i]));
+            CHECK(std::abs(drs[i] * std::sqrt(ds[i]) - 1.0) < 0x1p-21);
+        }
+        for (size_t i = 0; i < vs.size(); ++i)
+        {
+            CHECK(vns[i].components == cml::normalize_fast(vs[i]).components);
+            CHECK(std::abs(cml::length(vns[i]) - 1.f) < 1e-6f);
+        }
+
+        CHECK(cml::rsqrt(cml::f1616(2)).data == 46341); // 2^16 / sqrt(2) == 46340.95
+        const cml::f1616vec3 fv = cml::normalize_fast(cml::f1616vec3(cml::f1616(1), cml::f1616(2), cml::f1616(2)));
+        CHECK(std::abs(float(fv.components[2]) - 2.f / 3.f) < 1e-4f);
+    }
+
+    // swizzles of float vec4 (shuffles at runtime) match the constexpr component by component paths
+    {
+        constexpr cml::vec4 v(1.5f, -2.f, 3.25f, 4.f);
+        constexpr cml::vec4 o(0.5f, 8.f, -1.f, 2.5f);
+        constexpr cml::vec4 read = [](cml::vec4 x) { return cml::vec4(x._<'zxwx'>()); }(v);
+        constexpr cml::vec4 write = [](cml::vec4 x, cml::vec4 y) { x._<'ywxz'>() = y; return x; }(v, o);
+        constexpr cml::vec4 add = [](cml::vec4 x, cml::vec4 y) { x._<'wzyx'>() += y; return x; }(v, o);
+        constexpr cml::vec4 div = [](cml::vec4 x, cml::vec4 y) { x._<'yxwz'>() /= y._<'wzyx'>(); return x; }(v, o);
+        constexpr cml::vec4 swap = [](cml::vec4 x) { x._<'wzyx'>() = x; return x; }(v);
+
+        cml::vec4 x = v;
+        CHECK(cml::vec4(x._<'zxwx'>()) == read);
+        x._<'ywxz'>() = o;
+        CHECK(x == write);
+        x = v;
+        x._<'wzyx'>() += o;
+        CHECK(x == add);
+        x = v;
+        cml::vec4 y = o;
+        x._<'yxwz'>() /= y._<'wzyx'>();
+        CHECK(x == div);
+        x = v;
+        x._<'wzyx'>() = x;
+        CHECK(x == swap);
+        CHECK(x == cml::vec4(4.f, 3.25f, -2.f, 1.5f));
+        x = v;
+        x._<'xx'>() *= 2.f;
+        x._<'zw'>() = x._<'xy'>();
+        CHECK(x == cml::vec4(6.f, -2.f, 6.f, -2.f));
+    }
+
+    // soa_array gives the same results as the vector functions applied one element at a time
+    {
+        cml::soa_array<cml::vec3> a;
+        cml::soa_array<cml::vec3> b;
+        for (int i = 0; i < 19; ++i)
+        {
+            a.push_back(cml::vec3(float(i) + 0.5f, 2.f - float(i), float(i * i) * 0.25f));
+            b.push_back(cml::vec3(1.f - float(i), float(i) * 0.75f, 3.f));
+        }
+        const cml::soa_array<cml::vec3> sum = a + b * 2.f;
+        const cml::soa_array<cml::vec3> crs = cml::cross(a, b);
+        const cml::soa_array<cml::vec3> nrm = cml::normalize(a - cml::vec3(1, 1, 1));
+        const std::vector<float> dots = cml::dot(a, b);
+        const std::vector<float> lens = cml::length(a);
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            const cml::vec3 va = a[i];
+            const cml::vec3 vb = b[i];
+            CHECK(sum[i].components == (va + vb * 2.f).components);
+            CHECK(crs[i].components == cml::cross(va, vb).components);
+            CHECK(nrm[i].components == cml::normalize(va - cml::vec3(1, 1, 1)).components);
+            CHECK(dots[i] == cml::dot(va, vb));
+            CHECK(lens[i] == cml::length(va));
+        }
+
+        // the proxy writes through to the streams
+        a[3] = cml::vec3(7, 8, 9);
+        a[4] = cml::vec3(a[4]) + cml::vec3(1, 1, 1);
+        CHECK(a.data(0)[3] == 7.f && a.data(1)[3] == 8.f && a.data(2)[3] == 9.f);
+        const cml::vec3 a4 = a[4];
+        CHECK(a4.components == cml::vec3(5.5f, -1.f, 5.f).components);
+
+        // lazy expressions: one pass, same values as the eager operators
+        const cml::vec3 t(0.5f, -1.f, 2.f);
+        const cml::vec3 eager = cml::vec3(a[5]) + cml::vec3(b[5]) * 2.f - t / 4.f;
+        const cml::vec3 fused = cml::lazy(a[5]) + cml::lazy(b[5]) * 2.f - cml::lazy(t) / 4.f;
+        CHECK(fused.components == eager.components);
+
+        cml::soa_array<cml::vec3> p = a;
+        p += cml::lazy(b) * 0.5f - t;
+        const cml::soa_array<cml::vec3> q = cml::lazy(a) - cml::lazy(p) * 2.f;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            const cml::vec3 pi = p[i];
+            CHECK(pi.components == (cml::vec3(a[i]) + (cml::vec3(b[i]) * 0.5f - t)).components);
+            CHECK(q[i].components == (cml::vec3(a[i]) - pi * 2.f).components);
+        }
+
+        // the soa_arrays of an expression must have the same size, even when the result is a new array
+        cml::soa_array<cml::vec3> shorter(a.size() - 1);
+        bool thrown = false;
+        try { p = cml::lazy(a) + cml::lazy(shorter); }
+        catch (const std::runtime_error&) { thrown = true; }
+        CHECK(thrown && p.size() == a.size());
+        thrown = false;
+        try { p += cml::lazy(a) * 2.f - cml::lazy(shorter); }
+        catch (const std::runtime_error&) { thrown = true; }
+        CHECK(thrown);
+
+        cml::soa_array<cml::dvec4> d(10, cml::dvec4(1, 2, 3, 4));
+        d *= 2.0;
+        const cml::dvec4 d9 = d[9];
+        CHECK(d9.components == cml::dvec4(2, 4, 6, 8).components);
+
+        cml::soa_array<cml::f88vec3> f(5, cml::f88vec3(cml::f88(1.5f), cml::f88(2), cml::f88(-1)));
+        f += f;
+        CHECK(float(f[2].components[0]) == 3.f && float(f[2].components[2]) == -2.f);
+    }
+
     auto rad_value = 30.0;
     auto rad = cml::drad(cml::ddeg(rad_value));
     STD_COMPARE(rad, cml::sin, std::sin);
     STD_COMPARE(rad, cml::cos, std::cos);
     STD_COMPARE(rad, cml::tan, std::tan);
 
+    // the runtime sin / cos are range reduced: big angles keep their precision
+    for (double a : {100.0, -1234.5678, 54321.0, 100000.25, 1e7})
+    {
+        CHECK(cml::is_equal<2>(cml::sin(cml::drad(a)), std::sin(a)));
+        CHECK(cml::is_equal<2>(cml::cos(cml::drad(a)), std::cos(a)));
+        CHECK(cml::is_equal<2>(cml::sin(cml::rad(float(a))), std::sin(float(a))));
+        CHECK(cml::is_equal<2>(cml::cos(cml::rad(float(a))), std::cos(float(a))));
+    }
+
+    // sincos shares the reduction, the batched version gives the same bits as the single angle one
+    {
+        const cml::dvec2 sc = cml::sincos(cml::drad(1234.5678));
+        CHECK(sc.components[0] == cml::sin(cml::drad(1234.5678)));
+        CHECK(sc.components[1] == cml::cos(cml::drad(1234.5678)));
+
+        cml::deg angles[11] = {cml::deg(0.f), cml::deg(30.f), cml::deg(-45.f), cml::deg(90.f), cml::deg(180.f), cml::deg(-270.f),
+                               cml::deg(1234.5f), cml::deg(1e9f), cml::deg(360.f * 1000.f), cml::deg(12.25f), cml::deg(-7.5f)};
+        float sins[11];
+        float coss[11];
+        cml::sincos(cml::span<cml::deg>(angles), cml::span<float>(sins), cml::span<float>(coss));
+        for (size_t i = 0; i < 11; ++i)
+        {
+            CHECK(sins[i] == cml::sincos(angles[i]).components[0]);
+            CHECK(coss[i] == cml::sincos(angles[i]).components[1]);
+            CHECK(cml::is_equal<2>(sins[i], cml::sin(angles[i])));
+        }
+
+        std::vector<cml::drad> dangles;
+        for (int i = 0; i < 37; ++i)
+            dangles.push_back(cml::drad(i * 0.7 - 12.0));
+        std::vector<double> dsins(dangles.size());
+        std::vector<double> dcoss(dangles.size());
+        cml::sincos(cml::span<const cml::drad>(dangles), cml::span<double>(dsins), cml::span<double>(dcoss));
+        for (size_t i = 0; i < dangles.size(); ++i)
+        {
+            CHECK(dsins[i] == cml::sincos(dangles[i]).components[0] && dcoss[i] == cml::sincos(dangles[i]).components[1]);
+            CHECK(cml::is_equal<2>(dsins[i], std::sin(static_cast<double>(dangles[i]))));
+            CHECK(cml::is_equal<2>(dcoss[i], std::cos(static_cast<double>(dangles[i]))));
+        }
+    }
+
     STD_COMPARE(rad, cml::asin, std::asin);
     STD_COMPARE(rad, cml::acos, std::acos);
     STD_COMPARE(rad, cml::atan, std::atan);